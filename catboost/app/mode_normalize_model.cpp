@@ -37,6 +37,8 @@ namespace {
         int ThreadCount;
         TVector<TPathWithScheme> PoolPaths;
         bool PrintScaleAndBias = false;
+        bool MergeAndReorderTrees = false;
+        TMaybe<ECtrIndexFormat> CtrIndexFormat;
 
         TModeParams(int argc, const char* argv[]) {
             auto parser = NLastGetopt::TOpts();
@@ -56,6 +58,16 @@ namespace {
                 .StoreTrue(&PrintScaleAndBias)
                 .Help("Print input and resulting scale and bias")
                 ;
+            parser.AddLongOption("merge-and-reorder-trees").NoArgument()
+                .StoreTrue(&MergeAndReorderTrees)
+                .Help("Merge oblivious trees with identical splits and reorder trees for faster apply."
+                      " Tree indices of the output model differ from the input model")
+                ;
+            parser.AddLongOption("ctr-index-format").RequiredArgument("FORMAT")
+                .Handler1T<TStringBuf>([=](auto format){ CtrIndexFormat = FromString<ECtrIndexFormat>(format); })
+                .Help("Hash index format of ctr tables, one of " + GetEnumAllNames<ECtrIndexFormat>() + "."
+                      " Fingerprint takes about half the memory, model exporters support only Dense")
+                ;
             parser.AddLongOption("logging-level").RequiredArgument("LEVEL")
                 .Handler1T<TStringBuf>([=](auto level){ LoggingLevel = FromString<ELoggingLevel>(level); })
                 .Help("Logging level, one of " + GetEnumAllNames<ELoggingLevel>())
@@ -91,7 +103,11 @@ namespace {
 
             TFullModel model = ReadModel(modeParams.ModelFileName, modeParams.ModelType);
             CB_ENSURE(model.GetTreeCount() > 0, "Cannot normalize empty model");
-            CB_ENSURE(model.GetDimensionsCount() == 1, "No sense in normalizing a multiclass/multiregression model");
+            const bool needNormalization = modeParams.PoolPaths || modeParams.Scale.Defined() || modeParams.Bias.Defined();
+            CB_ENSURE(
+                model.GetDimensionsCount() == 1 || !needNormalization,
+                "No sense in normalizing a multiclass/multiregression model"
+            );
             TScaleAndBias inputScaleAndBias = model.GetScaleAndBias();
             if (modeParams.PrintScaleAndBias) {
                 Cout << "Input model"
@@ -114,7 +130,21 @@ namespace {
                 model.SetScaleAndBias({scale, bias});
             }
 
-            if (inputScaleAndBias != model.GetScaleAndBias() || modeParams.OutputModelFileName) {
+            if (modeParams.MergeAndReorderTrees) {
+                const size_t inputTreeCount = model.GetTreeCount();
+                model.ModelTrees.GetMutable()->MergeAndReorderObliviousTrees();
+                model.UpdateDynamicData();
+                CATBOOST_INFO_LOG << "Merged " << inputTreeCount << " trees into " << model.GetTreeCount() << Endl;
+            }
+
+            if (modeParams.CtrIndexFormat.Defined()) {
+                SetCtrIndexFormat(*modeParams.CtrIndexFormat, &model);
+            }
+
+            const bool isModelChanged = inputScaleAndBias != model.GetScaleAndBias()
+                || modeParams.MergeAndReorderTrees
+                || modeParams.CtrIndexFormat.Defined();
+            if (isModelChanged || modeParams.OutputModelFileName) {
                 if (modeParams.PrintScaleAndBias) {
                     Cout << "Output model"
                         << " scale " << model.GetScaleAndBias().Scale
@@ -44,7 +44,9 @@ struct TObjectImportancesParams {
             .DefaultValue("object_importances.tsv");
         parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
             .StoreResult(&ThreadCount);
-        parser.AddLongOption("update-method", "Should be one of: SinglePoint, TopKLeaves, AllPoints or TopKLeaves:top=2 to set the top size in TopKLeaves method.")
+        parser.AddLongOption("update-method", "Should be one of: SinglePoint, TopKLeaves, AllPoints or TopKLeaves:top=2 to set the top size in TopKLeaves method."
+            " Add top_trees=N (e.g. SinglePoint:top_trees=50 or TopKLeaves:top=2;top_trees=50) to make each object affect only"
+            " the N trees its leaves depend on most; this approximation is faster for models with many trees.")
             .StoreResult(&UpdateMethod)
             .DefaultValue("SinglePoint");
     }
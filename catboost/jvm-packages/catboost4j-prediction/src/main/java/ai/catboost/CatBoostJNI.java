@@ -2,6 +2,9 @@ package ai.catboost;
 
 import javax.annotation.Nullable;
 import javax.validation.constraints.NotNull;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 class CatBoostJNI {
     final void catBoostHashCatFeature(
@@ -132,4 +135,26 @@ class CatBoostJNI {
             final @NotNull double[] predictions) throws CatBoostError {
         CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredict(handle, numericFeatures, catFeatureHashes, predictions));
     }
+
+    final void catBoostModelPredictDirect(
+            final long handle,
+            final int documentCount,
+            final @Nullable FloatBuffer numericFeatures,
+            final int numericFeatureCount,
+            final int numericRowStride,
+            final @Nullable IntBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int catRowStride,
+            final @NotNull DoubleBuffer predictions) throws CatBoostError {
+        CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredictDirect(
+            handle,
+            documentCount,
+            numericFeatures,
+            numericFeatureCount,
+            numericRowStride,
+            catFeatureHashes,
+            catFeatureCount,
+            catRowStride,
+            predictions));
+    }
 }
@@ -2,6 +2,9 @@ package ai.catboost;
 
 import javax.annotation.Nullable;
 import javax.validation.constraints.NotNull;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 class CatBoostJNIImpl {
     final static void checkCall(@Nullable String message) throws CatBoostError {
@@ -119,4 +122,16 @@ class CatBoostJNIImpl {
             @Nullable float[][] numericFeatures,
             @Nullable int[][] catFeatureHashes,
             @NotNull double[] predictions);
+
+    @Nullable
+    final static native String catBoostModelPredictDirect(
+            long handle,
+            int documentCount,
+            @Nullable FloatBuffer numericFeatures,
+            int numericFeatureCount,
+            int numericRowStride,
+            @Nullable IntBuffer catFeatureHashes,
+            int catFeatureCount,
+            int catRowStride,
+            @NotNull DoubleBuffer predictions);
 }
@@ -5,6 +5,11 @@ import javax.validation.constraints.NotNull;
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.Buffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 import java.util.ArrayList;
 import java.util.Collections;
@@ -472,6 +477,68 @@ public class CatBoostModel implements AutoCloseable {
         return prediction;
     }
 
+    private static void checkDirectBuffer(
+            final @Nullable Buffer buffer,
+            final @Nullable ByteOrder order,
+            final @NotNull String name) throws CatBoostError {
+        if (buffer == null) {
+            return;
+        }
+        if (!buffer.isDirect()) {
+            throw new CatBoostError("`" + name + "` must be a direct buffer");
+        }
+        if (order != ByteOrder.nativeOrder()) {
+            throw new CatBoostError("`" + name + "` must use native byte order");
+        }
+    }
+
+    /**
+     * Apply model to a batch of objects stored in direct NIO buffers.
+     *
+     * Features are read and predictions are written in place, without copying data through JNI, so this is the
+     * cheapest way to apply model to large batches. Buffers must be direct and use native byte order (e.g. created
+     * with {@code ByteBuffer.allocateDirect(size).order(ByteOrder.nativeOrder()).asFloatBuffer()}). Data is addressed
+     * from the beginning of each buffer, buffer position and limit are ignored.
+     *
+     * @param documentCount       Number of objects.
+     * @param numericFeatures     Row-major numeric features matrix, may be null if model has no numeric features.
+     * @param numericFeatureCount Number of numeric features in a row.
+     * @param numericRowStride    Distance (in elements) between beginnings of consecutive rows of numeric features.
+     * @param catFeatureHashes    Row-major categoric feature hashes matrix computed by
+     *                            {@link #hashCategoricalFeature(String)}, may be null if model has no categoric
+     *                            features.
+     * @param catFeatureCount     Number of categoric features in a row.
+     * @param catRowStride        Distance (in elements) between beginnings of consecutive rows of categoric features.
+     * @param predictions         Model predictions, indexed as [objectIndex * predictionDimension + dimension].
+     * @throws CatBoostError In case of error within native library.
+     */
+    public void predict(
+            final int documentCount,
+            final @Nullable FloatBuffer numericFeatures,
+            final int numericFeatureCount,
+            final int numericRowStride,
+            final @Nullable IntBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int catRowStride,
+            final @NotNull DoubleBuffer predictions) throws CatBoostError {
+        checkDirectBuffer(numericFeatures, numericFeatures == null ? null : numericFeatures.order(), "numericFeatures");
+        checkDirectBuffer(catFeatureHashes, catFeatureHashes == null ? null : catFeatureHashes.order(), "catFeatureHashes");
+        if (predictions == null) {
+            throw new CatBoostError("`predictions` is null");
+        }
+        checkDirectBuffer(predictions, predictions.order(), "predictions");
+        NativeLib.handle().catBoostModelPredictDirect(
+            handle,
+            documentCount,
+            numericFeatures,
+            numericFeatureCount,
+            numericRowStride,
+            catFeatureHashes,
+            catFeatureCount,
+            catRowStride,
+            predictions);
+    }
+
     @Override
     protected void finalize() throws Throwable {
         try {
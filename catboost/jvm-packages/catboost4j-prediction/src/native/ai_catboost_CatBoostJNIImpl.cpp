@@ -921,5 +921,105 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
     Y_END_JNI_API_CALL();
 }
 
+// Returns typed view over the whole memory region of direct NIO buffer (buffer `position` and `limit`
+// are ignored, just like `GetDirectBufferAddress` does). Null buffer is treated as an empty one.
+template <typename T>
+static TArrayRef<T> GetDirectBufferData(JNIEnv* const jenv, const jobject buffer) {
+    if (jenv->IsSameObject(buffer, NULL) == JNI_TRUE) {
+        return {};
+    }
+
+    const auto address = jenv->GetDirectBufferAddress(buffer);
+    CB_ENSURE(address, "buffer is not a direct buffer or JVM doesn't support direct buffer access");
+    const auto capacity = jenv->GetDirectBufferCapacity(buffer);
+    CB_ENSURE(capacity >= 0, "failed to get direct buffer capacity");
+    return MakeArrayRef(static_cast<T*>(address), SafeIntegerCast<size_t>(capacity));
+}
+
+// Splits row-major matrix stored in `data` into row views; no data is copied.
+template <typename T>
+static TVector<TConstArrayRef<T>> MakeMatrixRows(
+    const TConstArrayRef<T> data,
+    const size_t documentCount,
+    const size_t columnCount,
+    const size_t rowStride) {
+
+    TVector<TConstArrayRef<T>> rows;
+    if (!columnCount) {
+        return rows;
+    }
+
+    CB_ENSURE(rowStride >= columnCount, "row stride is less than column count: " LabeledOutput(rowStride, columnCount));
+    const size_t requiredSize = (documentCount - 1) * rowStride + columnCount;
+    CB_ENSURE(
+        data.size() >= requiredSize,
+        "buffer is too small: " LabeledOutput(data.size(), requiredSize, documentCount, rowStride));
+
+    rows.yresize(documentCount);
+    for (size_t i = 0; i < documentCount; ++i) {
+        rows[i] = MakeArrayRef(data.data() + i * rowStride, columnCount);
+    }
+    return rows;
+}
+
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictDirect
+  (JNIEnv* jenv, jclass, jlong jhandle, jint jdocumentCount, jobject jnumericFeatures, jint jnumericFeatureCount, jint jnumericRowStride, jobject jcatFeatureHashes, jint jcatFeatureCount, jint jcatRowStride, jobject jpredictions) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+
+    CB_ENSURE(jdocumentCount >= 0, "negative document count: " LabeledOutput(jdocumentCount));
+    CB_ENSURE(
+        jnumericFeatureCount >= 0 && jnumericRowStride >= 0 && jcatFeatureCount >= 0 && jcatRowStride >= 0,
+        "negative feature count or row stride: "
+        LabeledOutput(jnumericFeatureCount, jnumericRowStride, jcatFeatureCount, jcatRowStride));
+
+    const size_t documentCount = jdocumentCount;
+    if (documentCount == 0) {
+        return nullptr;
+    }
+
+    const size_t modelPredictionSize = model->GetDimensionsCount();
+    const size_t minNumericFeatureCount = model->GetNumFloatFeatures();
+    const size_t minCatFeatureCount = model->GetNumCatFeatures();
+    const auto numericFeatures = GetDirectBufferData<const float>(jenv, jnumericFeatures);
+    const auto catFeatureHashes = GetDirectBufferData<const int>(jenv, jcatFeatureHashes);
+    const auto predictions = GetDirectBufferData<double>(jenv, jpredictions);
+    const size_t numericFeatureCount = numericFeatures ? SafeIntegerCast<size_t>(jnumericFeatureCount) : 0;
+    const size_t catFeatureCount = catFeatureHashes ? SafeIntegerCast<size_t>(jcatFeatureCount) : 0;
+
+    CB_ENSURE(
+        numericFeatureCount >= minNumericFeatureCount,
+        LabeledOutput(numericFeatureCount, minNumericFeatureCount));
+
+    CB_ENSURE(
+        catFeatureCount >= minCatFeatureCount,
+        LabeledOutput(catFeatureCount, minCatFeatureCount));
+
+    CB_ENSURE(
+        predictions.size() >= documentCount * modelPredictionSize,
+        "`predictions` buffer is too small, must be at least document count * model prediction dimension: "
+        LabeledOutput(predictions.size(), documentCount * modelPredictionSize));
+
+    const auto numericFeatureMatrixRows = MakeMatrixRows(
+        numericFeatures,
+        documentCount,
+        numericFeatureCount,
+        SafeIntegerCast<size_t>(jnumericRowStride));
+    const auto catFeatureMatrixRows = MakeMatrixRows(
+        catFeatureHashes,
+        documentCount,
+        catFeatureCount,
+        SafeIntegerCast<size_t>(jcatRowStride));
+
+    model->Calc(
+        numericFeatureMatrixRows,
+        catFeatureMatrixRows,
+        MakeArrayRef(predictions.data(), documentCount * modelPredictionSize));
+
+    Y_END_JNI_API_CALL();
+}
+
 #undef Y_BEGIN_JNI_API_CALL
 #undef Y_END_JNI_API_CALL
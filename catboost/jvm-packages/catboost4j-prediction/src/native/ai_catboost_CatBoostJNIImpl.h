@@ -161,6 +161,14 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
 JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict__J_3_3F_3_3I_3D
   (JNIEnv *, jclass, jlong, jobjectArray, jobjectArray, jdoubleArray);
 
+/*
+ * Class:     ai_catboost_CatBoostJNIImpl
+ * Method:    catBoostModelPredictDirect
+ * Signature: (JILjava/nio/FloatBuffer;IILjava/nio/IntBuffer;IILjava/nio/DoubleBuffer;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictDirect
+  (JNIEnv *, jclass, jlong, jint, jobject, jint, jint, jobject, jint, jint, jobject);
+
 #ifdef __cplusplus
 }
 #endif
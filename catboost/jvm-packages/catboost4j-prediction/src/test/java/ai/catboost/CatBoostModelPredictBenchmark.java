@@ -0,0 +1,95 @@
+package ai.catboost;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
+import java.util.Random;
+
+/**
+ * Compares batch prediction via Java arrays with prediction via direct NIO buffers.
+ *
+ * Not a unit test, run manually:
+ *   mvn test-compile exec:java -Dexec.mainClass=ai.catboost.CatBoostModelPredictBenchmark -Dexec.classpathScope=test
+ */
+public class CatBoostModelPredictBenchmark {
+    private static final int DOCUMENT_COUNT = 100000;
+    private static final int ITERATION_COUNT = 20;
+
+    public static void main(String[] args) throws CatBoostError, IOException {
+        try (final CatBoostModel model = CatBoostModel.loadModel(
+                ClassLoader.getSystemResourceAsStream("models/model.cbm"))) {
+            int numericFeatureCount = 0;
+            int catFeatureCount = 0;
+            for (CatBoostModel.Feature feature : model.getFeatures()) {
+                if (feature instanceof CatBoostModel.FloatFeature) {
+                    ++numericFeatureCount;
+                } else if (feature instanceof CatBoostModel.CatFeature) {
+                    ++catFeatureCount;
+                }
+            }
+            final int predictionDimension = model.getPredictionDimension();
+
+            final Random random = new Random(0);
+            final float[][] numericFeatures = new float[DOCUMENT_COUNT][numericFeatureCount];
+            final int[][] catFeatureHashes = new int[DOCUMENT_COUNT][catFeatureCount];
+            final FloatBuffer numericFeaturesBuffer = ByteBuffer
+                .allocateDirect(DOCUMENT_COUNT * numericFeatureCount * 4)
+                .order(ByteOrder.nativeOrder())
+                .asFloatBuffer();
+            final IntBuffer catFeatureHashesBuffer = ByteBuffer
+                .allocateDirect(DOCUMENT_COUNT * catFeatureCount * 4)
+                .order(ByteOrder.nativeOrder())
+                .asIntBuffer();
+            final DoubleBuffer predictionsBuffer = ByteBuffer
+                .allocateDirect(DOCUMENT_COUNT * predictionDimension * 8)
+                .order(ByteOrder.nativeOrder())
+                .asDoubleBuffer();
+
+            for (int i = 0; i < DOCUMENT_COUNT; ++i) {
+                for (int j = 0; j < numericFeatureCount; ++j) {
+                    numericFeatures[i][j] = random.nextFloat();
+                    numericFeaturesBuffer.put(numericFeatures[i][j]);
+                }
+                for (int j = 0; j < catFeatureCount; ++j) {
+                    catFeatureHashes[i][j] = CatBoostModel.hashCategoricalFeature(String.valueOf(random.nextInt(100)));
+                    catFeatureHashesBuffer.put(catFeatureHashes[i][j]);
+                }
+            }
+
+            final CatBoostPredictions predictions = new CatBoostPredictions(DOCUMENT_COUNT, predictionDimension);
+
+            long arraysNanos = Long.MAX_VALUE;
+            long buffersNanos = Long.MAX_VALUE;
+            for (int iteration = 0; iteration < ITERATION_COUNT; ++iteration) {
+                long start = System.nanoTime();
+                model.predict(numericFeatures, catFeatureHashes, predictions);
+                arraysNanos = Math.min(arraysNanos, System.nanoTime() - start);
+
+                start = System.nanoTime();
+                model.predict(
+                    DOCUMENT_COUNT,
+                    numericFeaturesBuffer,
+                    numericFeatureCount,
+                    numericFeatureCount,
+                    catFeatureHashesBuffer,
+                    catFeatureCount,
+                    catFeatureCount,
+                    predictionsBuffer);
+                buffersNanos = Math.min(buffersNanos, System.nanoTime() - start);
+            }
+
+            for (int i = 0; i < DOCUMENT_COUNT * predictionDimension; ++i) {
+                if (predictions.getRawData()[i] != predictionsBuffer.get(i)) {
+                    throw new IllegalStateException("predictions differ at " + String.valueOf(i));
+                }
+            }
+
+            System.out.println("documents: " + String.valueOf(DOCUMENT_COUNT));
+            System.out.println("arrays:         " + String.valueOf(arraysNanos / 1000) + " us");
+            System.out.println("direct buffers: " + String.valueOf(buffersNanos / 1000) + " us");
+        }
+    }
+}
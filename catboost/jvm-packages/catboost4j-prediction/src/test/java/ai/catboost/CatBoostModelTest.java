@@ -6,6 +6,11 @@ import org.junit.Test;
 
 import javax.validation.constraints.NotNull;
 import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 import static org.junit.Assert.fail;
 
@@ -891,4 +896,77 @@ public class CatBoostModelTest {
             assertEqual(expected, model.predict(numericFeatures, catFeatures));
         }
     }
+
+    static FloatBuffer allocateDirectFloats(final int size) {
+        return ByteBuffer.allocateDirect(size * 4).order(ByteOrder.nativeOrder()).asFloatBuffer();
+    }
+
+    static IntBuffer allocateDirectInts(final int size) {
+        return ByteBuffer.allocateDirect(size * 4).order(ByteOrder.nativeOrder()).asIntBuffer();
+    }
+
+    static DoubleBuffer allocateDirectDoubles(final int size) {
+        return ByteBuffer.allocateDirect(size * 8).order(ByteOrder.nativeOrder()).asDoubleBuffer();
+    }
+
+    @Test
+    public void testSuccessfulPredictDirectBuffers() throws CatBoostError {
+        try(final CatBoostModel model = loadTestModel()) {
+            // rows are padded to check that stride is respected
+            final FloatBuffer numericFeatures = allocateDirectFloats(3 * 3);
+            numericFeatures.put(new float[]{
+                    0.5f, 1.5f, Float.NaN,
+                    0.7f, 6.4f, Float.NaN,
+                    -2.0f, -1.0f, Float.NaN});
+            final IntBuffer catFeatures = allocateDirectInts(3 * 4);
+            catFeatures.put(new int[]{
+                    -805065478, 2136526169, 785836961, 0,
+                    1982436109, 1400211492, 1076941191, 0,
+                    -1883343840, -1452597217, 2122455585, 0});
+            final DoubleBuffer predictions = allocateDirectDoubles(3);
+            model.predict(3, numericFeatures, 2, 3, catFeatures, 3, 4, predictions);
+
+            final double[] data = new double[3];
+            predictions.rewind();
+            predictions.get(data);
+            final CatBoostPredictions expected = new CatBoostPredictions(3, 1, new double[]{
+                    0.04666924366060905,
+                    0.026244613740247648,
+                    0.03094452158737013});
+            assertEqual(expected, new CatBoostPredictions(3, 1, data));
+        }
+    }
+
+    @Test
+    public void testFailPredictDirectBuffersNotDirect() throws CatBoostError {
+        try(final CatBoostModel model = loadNumericOnlyTestModel()) {
+            try {
+                final FloatBuffer numericFeatures = FloatBuffer.wrap(new float[]{0.1f, 0.3f, 0.2f});
+                model.predict(1, numericFeatures, 3, 3, null, 0, 0, allocateDirectDoubles(1));
+                fail();
+            } catch (CatBoostError e) {
+            }
+        }
+    }
+
+    @Test
+    public void testFailPredictDirectBuffersInsufficientSize() throws CatBoostError {
+        try(final CatBoostModel model = loadTestModel()) {
+            try {
+                final FloatBuffer numericFeatures = allocateDirectFloats(2 * 2);
+                final IntBuffer catFeatures = allocateDirectInts(3 * 3);
+                model.predict(3, numericFeatures, 2, 2, catFeatures, 3, 3, allocateDirectDoubles(3));
+                fail();
+            } catch (CatBoostError e) {
+            }
+
+            try {
+                final FloatBuffer numericFeatures = allocateDirectFloats(3 * 2);
+                final IntBuffer catFeatures = allocateDirectInts(3 * 3);
+                model.predict(3, numericFeatures, 2, 2, catFeatures, 3, 3, allocateDirectDoubles(2));
+                fail();
+            } catch (CatBoostError e) {
+            }
+        }
+    }
 }
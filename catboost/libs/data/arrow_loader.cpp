@@ -0,0 +1,691 @@
+#include "arrow_loader.h"
+
+#include "baseline.h"
+
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
+#include <catboost/private/libs/data_types/groupid.h>
+#include <catboost/private/libs/data_util/exists_checker.h>
+#include <catboost/private/libs/labels/helpers.h>
+
+#include <library/cpp/object_factory/object_factory.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
+#include <util/generic/scope.h>
+#include <util/generic/singleton.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
+
+#include <cmath>
+#include <cstring>
+
+
+namespace {
+
+    bool IsIntegerFormat(TStringBuf format) {
+        return (format.size() == 1) && TStringBuf("cCsSiIlL").Contains(format[0]);
+    }
+
+    bool IsNumericFormat(TStringBuf format) {
+        return IsIntegerFormat(format) || (format == "f") || (format == "g");
+    }
+
+    bool IsStringFormat(TStringBuf format) {
+        return (format == "u") || (format == "U");
+    }
+
+    bool IsNumeric(const ArrowSchema& schema) {
+        return !schema.dictionary && IsNumericFormat(schema.format);
+    }
+
+    bool IsDictionaryOfStrings(const ArrowSchema& schema) {
+        return schema.dictionary && IsIntegerFormat(schema.format) && IsStringFormat(schema.dictionary->format);
+    }
+
+    bool IsStringLike(const ArrowSchema& schema) {
+        return (!schema.dictionary && IsStringFormat(schema.format)) || IsDictionaryOfStrings(schema);
+    }
+
+    bool IsInteger(const ArrowSchema& schema) {
+        return !schema.dictionary && IsIntegerFormat(schema.format);
+    }
+
+
+    template <class TFunc>
+    void DispatchNumericFormat(TStringBuf format, TFunc&& func) {
+        switch (format[0]) {
+            case 'c': func(i8()); break;
+            case 'C': func(ui8()); break;
+            case 's': func(i16()); break;
+            case 'S': func(ui16()); break;
+            case 'i': func(i32()); break;
+            case 'I': func(ui32()); break;
+            case 'l': func(i64()); break;
+            case 'L': func(ui64()); break;
+            case 'f': func(float()); break;
+            case 'g': func(double()); break;
+            default:
+                CB_ENSURE(false, "Arrow data: unsupported numeric format \"" << format << '"');
+        }
+    }
+
+    bool HasNulls(const ArrowArray& array) {
+        // null_count can be -1 if it has not been computed yet
+        return (array.null_count != 0) && (array.n_buffers > 0) && array.buffers[0];
+    }
+
+    bool IsValid(const ArrowArray& array, i64 idx) {
+        if (!HasNulls(array)) {
+            return true;
+        }
+        const i64 bitIdx = array.offset + idx;
+        return (static_cast<const ui8*>(array.buffers[0])[bitIdx >> 3] >> (bitIdx & 7)) & 1;
+    }
+
+    template <class T>
+    TConstArrayRef<T> GetValues(const ArrowArray& array) {
+        return TConstArrayRef<T>(static_cast<const T*>(array.buffers[1]) + array.offset, array.length);
+    }
+
+    template <class TOffset>
+    TStringBuf GetStringValueImpl(const ArrowArray& array, i64 idx) {
+        const TOffset* offsets = static_cast<const TOffset*>(array.buffers[1]) + array.offset;
+        const char* data = static_cast<const char*>(array.buffers[2]);
+        return TStringBuf(data + offsets[idx], data + offsets[idx + 1]);
+    }
+
+    template <class TIndex>
+    i64 GetDictionaryIndex(TIndex index, const ArrowArray& dictionary) {
+        const i64 dictionaryIndex = static_cast<i64>(index);
+        CB_ENSURE(
+            0 <= dictionaryIndex && dictionaryIndex < dictionary.length,
+            "Arrow data: dictionary index " << dictionaryIndex << " is out of range [0, " << dictionary.length << ")"
+        );
+        return dictionaryIndex;
+    }
+
+    TStringBuf GetStringValue(const ArrowSchema& schema, const ArrowArray& array, i64 idx) {
+        if (!IsValid(array, idx)) {
+            return TStringBuf();
+        }
+        return (*schema.format == 'u') ?
+            GetStringValueImpl<i32>(array, idx) :
+            GetStringValueImpl<i64>(array, idx);
+    }
+
+    // func is called with (objectIdx, value, isValid)
+    template <class T, class TFunc>
+    void ForEachNumericValue(TConstArrayRef<const ArrowArray*> chunks, TFunc&& func) {
+        ui32 objectIdx = 0;
+        for (const ArrowArray* chunk : chunks) {
+            const auto values = GetValues<T>(*chunk);
+            for (auto i : xrange(chunk->length)) {
+                func(objectIdx++, values[i], IsValid(*chunk, i));
+            }
+        }
+    }
+
+    /* func is called with (objectIdx, value)
+     * null values are passed as empty strings, integers are passed in decimal representation
+     *   to be consistent with data read from text formats
+     */
+    template <class TFunc>
+    void ForEachStringValue(
+        const ArrowSchema& schema,
+        TConstArrayRef<const ArrowArray*> chunks,
+        TFunc&& func
+    ) {
+        if (IsInteger(schema)) {
+            DispatchNumericFormat(
+                schema.format,
+                [&] (auto typeTag) {
+                    ForEachNumericValue<decltype(typeTag)>(
+                        chunks,
+                        [&] (ui32 objectIdx, auto value, bool isValid) {
+                            func(objectIdx, isValid ? TStringBuf(ToString(value)) : TStringBuf());
+                        }
+                    );
+                }
+            );
+        } else if (IsDictionaryOfStrings(schema)) {
+            ui32 objectIdx = 0;
+            for (const ArrowArray* chunk : chunks) {
+                CB_ENSURE(chunk->dictionary, "Arrow data: dictionary-encoded array has no dictionary");
+                DispatchNumericFormat(
+                    schema.format,
+                    [&] (auto typeTag) {
+                        const auto indices = GetValues<decltype(typeTag)>(*chunk);
+                        for (auto i : xrange(chunk->length)) {
+                            func(
+                                objectIdx++,
+                                IsValid(*chunk, i) ?
+                                    GetStringValue(
+                                        *schema.dictionary,
+                                        *chunk->dictionary,
+                                        GetDictionaryIndex(indices[i], *chunk->dictionary)
+                                    ) :
+                                    TStringBuf()
+                            );
+                        }
+                    }
+                );
+            }
+        } else {
+            ui32 objectIdx = 0;
+            for (const ArrowArray* chunk : chunks) {
+                for (auto i : xrange(chunk->length)) {
+                    func(objectIdx++, GetStringValue(schema, *chunk, i));
+                }
+            }
+        }
+    }
+
+    void CheckStreamCall(ArrowArrayStream* stream, int errorCode, TStringBuf callName) {
+        if (errorCode) {
+            const char* lastError = stream->get_last_error ? stream->get_last_error(stream) : nullptr;
+            CB_ENSURE(
+                false,
+                "Arrow data: ArrowArrayStream::" << callName << " failed with error code " << errorCode
+                << (lastError ? ": " : "") << (lastError ? lastError : "")
+            );
+        }
+    }
+
+    void CheckColumnType(ui32 columnIdx, EColumn columnType, const ArrowSchema& schema) {
+        bool isCompatible = false;
+        switch (columnType) {
+            case EColumn::Num:
+            case EColumn::Weight:
+            case EColumn::GroupWeight:
+            case EColumn::Baseline:
+                isCompatible = IsNumeric(schema);
+                break;
+            case EColumn::Label:
+                isCompatible = IsNumeric(schema) || IsStringLike(schema);
+                break;
+            case EColumn::Categ:
+            case EColumn::GroupId:
+            case EColumn::SubgroupId:
+                isCompatible = IsInteger(schema) || IsStringLike(schema);
+                break;
+            case EColumn::Text:
+                isCompatible = IsStringLike(schema);
+                break;
+            case EColumn::Timestamp:
+                isCompatible = IsInteger(schema);
+                break;
+            case EColumn::SampleId:
+            case EColumn::Auxiliary:
+                isCompatible = true;
+                break;
+            default:
+                CB_ENSURE(
+                    false,
+                    "Arrow data: column #" << columnIdx << ": column type " << columnType << " is not supported"
+                );
+        }
+        CB_ENSURE(
+            isCompatible,
+            "Arrow data: column #" << columnIdx << " of type " << columnType
+            << " has incompatible Arrow format \"" << schema.format << '"'
+            << (schema.dictionary ? " (dictionary-encoded)" : "")
+        );
+    }
+
+
+    class TArrowCStreamRegistry {
+    public:
+        ui64 Register(ArrowArrayStream* stream) {
+            CB_ENSURE(stream, "Arrow data: ArrowArrayStream is null");
+            with_lock (Lock) {
+                const ui64 streamId = NextStreamId++;
+                Streams.emplace(streamId, stream);
+                return streamId;
+            }
+        }
+
+        bool Unregister(ui64 streamId) {
+            with_lock (Lock) {
+                return Streams.erase(streamId) != 0;
+            }
+        }
+
+        ArrowArrayStream* Take(ui64 streamId) {
+            with_lock (Lock) {
+                const auto it = Streams.find(streamId);
+                CB_ENSURE(
+                    it != Streams.end(),
+                    "Arrow data: stream " << streamId << " is not registered or has already been loaded"
+                );
+                ArrowArrayStream* stream = it->second;
+                Streams.erase(it);
+                return stream;
+            }
+        }
+
+    private:
+        TAdaptiveLock Lock;
+        ui64 NextStreamId = 1;
+        THashMap<ui64, ArrowArrayStream*> Streams;
+    };
+}
+
+
+namespace NCB {
+
+    TArrowArrayHolder::TArrowArrayHolder(ArrowArray* array) {
+        std::memcpy(&Array, array, sizeof(ArrowArray));
+        array->release = nullptr;
+    }
+
+    TArrowArrayHolder::~TArrowArrayHolder() {
+        if (Array.release) {
+            Array.release(&Array);
+        }
+    }
+
+    TArrowSchemaHolder::TArrowSchemaHolder(ArrowSchema* schema) {
+        std::memcpy(&Schema, schema, sizeof(ArrowSchema));
+        schema->release = nullptr;
+    }
+
+    TArrowSchemaHolder::~TArrowSchemaHolder() {
+        if (Schema.release) {
+            Schema.release(&Schema);
+        }
+    }
+
+
+    ui64 RegisterArrowCStream(ArrowArrayStream* stream) {
+        return Singleton<TArrowCStreamRegistry>()->Register(stream);
+    }
+
+    bool UnregisterArrowCStream(ui64 streamId) {
+        return Singleton<TArrowCStreamRegistry>()->Unregister(streamId);
+    }
+
+    TString MakeArrowCStreamPoolPath(ui64 streamId) {
+        return TString("arrow-c-stream://") + ToString(streamId);
+    }
+
+
+    static ArrowArrayStream* TakeArrowArrayStream(const TPathWithScheme& poolPath) {
+        ui64 streamId = 0;
+        CB_ENSURE(
+            TryFromString<ui64>(poolPath.Path, streamId),
+            "Arrow data: path \"" << poolPath.Path << "\" is not an id of a registered ArrowArrayStream"
+        );
+        return Singleton<TArrowCStreamRegistry>()->Take(streamId);
+    }
+
+    TArrowDataLoader::TArrowDataLoader(TDatasetLoaderPullArgs&& args)
+        : TArrowDataLoader(TakeArrowArrayStream(args.PoolPath), std::move(args.CommonArgs))
+    {
+    }
+
+    TArrowDataLoader::TArrowDataLoader(ArrowArrayStream* stream, TDatasetLoaderCommonArgs&& args)
+        : Args(std::move(args))
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TArrowDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TArrowDataLoader:GroupWeightsFilePath does not exist");
+        CB_ENSURE(!Args.BaselineFilePath.Inited() || CheckExists(Args.BaselineFilePath),
+                  "TArrowDataLoader:BaselineFilePath does not exist");
+        CB_ENSURE(!Args.TimestampsFilePath.Inited() || CheckExists(Args.TimestampsFilePath),
+                  "TArrowDataLoader:TimestampsFilePath does not exist");
+        CB_ENSURE(!Args.FeatureNamesPath.Inited() || CheckExists(Args.FeatureNamesPath),
+                  "TArrowDataLoader:FeatureNamesPath does not exist");
+
+        CB_ENSURE(stream && stream->release, "Arrow data: ArrowArrayStream is null or has already been released");
+        Y_SCOPE_EXIT(stream) {
+            stream->release(stream);
+        };
+
+        ArrowSchema schema;
+        CheckStreamCall(stream, stream->get_schema(stream, &schema), "get_schema");
+        Schema = MakeIntrusive<TArrowSchemaHolder>(&schema);
+        const ArrowSchema& structSchema = Schema->Get();
+        CB_ENSURE(
+            TStringBuf(structSchema.format) == "+s",
+            "Arrow data: top-level schema must be a struct (\"+s\"), got \"" << structSchema.format << '"'
+        );
+
+        ui64 objectCount = 0;
+        while (true) {
+            ArrowArray batch;
+            CheckStreamCall(stream, stream->get_next(stream, &batch), "get_next");
+            if (!batch.release) { // end of stream
+                break;
+            }
+            auto batchHolder = MakeIntrusive<TArrowArrayHolder>(&batch);
+            const ArrowArray& structArray = batchHolder->Get();
+            CB_ENSURE(
+                structArray.n_children == structSchema.n_children,
+                "Arrow data: record batch has " << structArray.n_children << " columns, but schema has "
+                << structSchema.n_children
+            );
+            CB_ENSURE(
+                (structArray.offset == 0) && !HasNulls(structArray),
+                "Arrow data: sliced or nullable top-level struct arrays are not supported"
+            );
+            for (auto columnIdx : xrange(structArray.n_children)) {
+                CB_ENSURE(
+                    structArray.children[columnIdx]->length == structArray.length,
+                    "Arrow data: column #" << columnIdx << " length is not equal to record batch length"
+                );
+            }
+            if (structArray.length) {
+                objectCount += structArray.length;
+                Batches.push_back(std::move(batchHolder));
+            }
+        }
+        CB_ENSURE(objectCount, "Arrow data: no data rows");
+        CB_ENSURE(
+            objectCount <= Max<ui32>(),
+            "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+        );
+        ObjectCount = (ui32)objectCount;
+
+        CB_ENSURE(
+            (Args.DatasetSubset.Range.Begin == 0) && (Args.DatasetSubset.Range.End >= ObjectCount),
+            "Arrow data: loading a subset of objects is not supported"
+        );
+
+        const ui32 columnCount = SafeIntegerCast<ui32>(structSchema.n_children);
+        TVector<TColumn> columns = Args.CdProvider->GetColumnsDescription(columnCount);
+        CB_ENSURE(
+            columns.size() == columnCount,
+            "Arrow data has " << columnCount << " columns, but column description specifies " << columns.size()
+        );
+
+        TVector<TString> headerColumns;
+        TMaybe<ERawTargetType> targetType;
+        for (auto columnIdx : xrange(columnCount)) {
+            const ArrowSchema& columnSchema = GetColumnSchema(columnIdx);
+            headerColumns.push_back(columnSchema.name ? columnSchema.name : "");
+
+            auto& column = columns[columnIdx];
+            if (!Args.CdProvider->Inited() && (column.Type == EColumn::Num) && !IsNumeric(columnSchema)) {
+                column.Type = EColumn::Categ;
+            }
+            CheckColumnType(columnIdx, column.Type, columnSchema);
+
+            if (column.Type == EColumn::Label) {
+                const auto columnTargetType = IsNumeric(columnSchema) ? ERawTargetType::Float : ERawTargetType::String;
+                CB_ENSURE(
+                    !targetType || (*targetType == columnTargetType),
+                    "Arrow data: all label columns must be either numeric or string"
+                );
+                targetType = columnTargetType;
+            }
+        }
+
+        auto columnsDescription = TDataColumnsMetaInfo{ std::move(columns) };
+
+        const TVector<TString> featureNames = GetFeatureNames(
+            columnsDescription,
+            headerColumns,
+            Args.FeatureNamesPath
+        );
+
+        TBaselineReader baselineReader(Args.BaselineFilePath, ClassLabelsToStrings(Args.ClassLabels));
+
+        DataMetaInfo = TDataMetaInfo(
+            std::move(columnsDescription),
+            targetType.GetOrElse(ERawTargetType::None),
+            Args.GroupWeightsFilePath.Inited(),
+            Args.TimestampsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            baselineReader.GetBaselineCount(),
+            &featureNames,
+            Args.ClassLabels
+        );
+
+        ProcessIgnoredFeaturesList(
+            Args.IgnoredFeatures,
+            /*allFeaturesIgnoredMessage*/ Nothing(),
+            &DataMetaInfo,
+            &FeatureIgnored
+        );
+    }
+
+    const ArrowSchema& TArrowDataLoader::GetColumnSchema(ui32 columnIdx) const {
+        return *Schema->Get().children[columnIdx];
+    }
+
+    TVector<const ArrowArray*> TArrowDataLoader::GetColumnChunks(ui32 columnIdx) const {
+        TVector<const ArrowArray*> chunks;
+        chunks.reserve(Batches.size());
+        for (const auto& batch : Batches) {
+            chunks.push_back(batch->Get().children[columnIdx]);
+        }
+        return chunks;
+    }
+
+    ITypedSequencePtr<float> TArrowDataLoader::GetFloatSequence(ui32 columnIdx) const {
+        if ((Batches.size() == 1) && !HasNulls(*Batches[0]->Get().children[columnIdx])) {
+            const ArrowArray& array = *Batches[0]->Get().children[columnIdx];
+            ITypedSequencePtr<float> result;
+            DispatchNumericFormat(
+                GetColumnSchema(columnIdx).format,
+                [&] (auto typeTag) {
+                    using TStoredValue = decltype(typeTag);
+                    result = MakeIntrusive<TTypeCastArrayHolder<float, TStoredValue>>(
+                        TMaybeOwningConstArrayHolder<TStoredValue>::CreateOwning(
+                            GetValues<TStoredValue>(array),
+                            Batches[0]
+                        )
+                    );
+                }
+            );
+            return result;
+        }
+        return MakeIntrusive<TTypeCastArrayHolder<float, float>>(GetFloatColumn(columnIdx));
+    }
+
+    TVector<float> TArrowDataLoader::GetFloatColumn(ui32 columnIdx) const {
+        TVector<float> result;
+        result.yresize(ObjectCount);
+        DispatchNumericFormat(
+            GetColumnSchema(columnIdx).format,
+            [&] (auto typeTag) {
+                ForEachNumericValue<decltype(typeTag)>(
+                    GetColumnChunks(columnIdx),
+                    [&] (ui32 objectIdx, auto value, bool isValid) {
+                        result[objectIdx] = isValid ? static_cast<float>(value) : std::nanf("");
+                    }
+                );
+            }
+        );
+        return result;
+    }
+
+    TVector<TString> TArrowDataLoader::GetStringColumn(ui32 columnIdx) const {
+        TVector<TString> result(ObjectCount);
+        ForEachStringValue(
+            GetColumnSchema(columnIdx),
+            GetColumnChunks(columnIdx),
+            [&] (ui32 objectIdx, TStringBuf value) {
+                result[objectIdx] = TString(value);
+            }
+        );
+        return result;
+    }
+
+    TVector<ui32> TArrowDataLoader::GetCatFeatureHashes(
+        ui32 columnIdx,
+        ui32 flatFeatureIdx,
+        IRawFeaturesOrderDataVisitor* visitor
+    ) const {
+        TVector<ui32> result;
+        result.yresize(ObjectCount);
+
+        const ArrowSchema& schema = GetColumnSchema(columnIdx);
+        if (!IsDictionaryOfStrings(schema)) {
+            ForEachStringValue(
+                schema,
+                GetColumnChunks(columnIdx),
+                [&] (ui32 objectIdx, TStringBuf value) {
+                    result[objectIdx] = visitor->GetCatFeatureValue(flatFeatureIdx, value);
+                }
+            );
+            return result;
+        }
+
+        TMaybe<ui32> nullHash;
+        TVector<ui32> dictionaryHashes;
+        ui32 objectIdx = 0;
+        for (const ArrowArray* chunk : GetColumnChunks(columnIdx)) {
+            CB_ENSURE(chunk->dictionary, "Arrow data: dictionary-encoded array has no dictionary");
+            const ArrowArray& dictionary = *chunk->dictionary;
+            dictionaryHashes.yresize(dictionary.length);
+            for (auto i : xrange(dictionary.length)) {
+                dictionaryHashes[i] = visitor->GetCatFeatureValue(
+                    flatFeatureIdx,
+                    GetStringValue(*schema.dictionary, dictionary, i)
+                );
+            }
+            DispatchNumericFormat(
+                schema.format,
+                [&] (auto typeTag) {
+                    const auto indices = GetValues<decltype(typeTag)>(*chunk);
+                    for (auto i : xrange(chunk->length)) {
+                        if (IsValid(*chunk, i)) {
+                            result[objectIdx] = dictionaryHashes[GetDictionaryIndex(indices[i], dictionary)];
+                        } else {
+                            if (!nullHash) {
+                                nullHash = visitor->GetCatFeatureValue(flatFeatureIdx, TStringBuf());
+                            }
+                            result[objectIdx] = *nullHash;
+                        }
+                        ++objectIdx;
+                    }
+                }
+            );
+        }
+        return result;
+    }
+
+    void TArrowDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        visitor->Start(
+            DataMetaInfo,
+            ObjectCount,
+            Args.ObjectsOrder,
+            TVector<TIntrusivePtr<IResourceHolder>>(Batches.begin(), Batches.end())
+        );
+
+        const auto& columns = DataMetaInfo.ColumnsInfo->Columns;
+        const bool loadFeatures = Args.DatasetSubset.HasFeatures;
+
+        ui32 flatFeatureIdx = 0;
+        ui32 targetIdx = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange(SafeIntegerCast<ui32>(columns.size()))) {
+            const EColumn columnType = columns[columnIdx].Type;
+            if (IsFactorColumn(columnType)) {
+                if (loadFeatures && !FeatureIgnored[flatFeatureIdx]) {
+                    switch (columnType) {
+                        case EColumn::Num:
+                            visitor->AddFloatFeature(flatFeatureIdx, GetFloatSequence(columnIdx));
+                            break;
+                        case EColumn::Categ:
+                            visitor->AddCatFeature(
+                                flatFeatureIdx,
+                                TMaybeOwningConstArrayHolder<ui32>::CreateOwning(
+                                    GetCatFeatureHashes(columnIdx, flatFeatureIdx, visitor)
+                                )
+                            );
+                            break;
+                        case EColumn::Text:
+                            visitor->AddTextFeature(
+                                flatFeatureIdx,
+                                TMaybeOwningConstArrayHolder<TString>::CreateOwning(GetStringColumn(columnIdx))
+                            );
+                            break;
+                        default:
+                            CB_ENSURE_INTERNAL(false, "Unexpected feature column type " << columnType);
+                    }
+                }
+                ++flatFeatureIdx;
+                continue;
+            }
+
+            switch (columnType) {
+                case EColumn::Label:
+                    if (DataMetaInfo.TargetType == ERawTargetType::Float) {
+                        visitor->AddTarget(targetIdx, GetFloatSequence(columnIdx));
+                    } else {
+                        visitor->AddTarget(targetIdx, TConstArrayRef<TString>(GetStringColumn(columnIdx)));
+                    }
+                    ++targetIdx;
+                    break;
+                case EColumn::Baseline:
+                    visitor->AddBaseline(baselineIdx++, GetFloatColumn(columnIdx));
+                    break;
+                case EColumn::Weight:
+                    visitor->AddWeights(GetFloatColumn(columnIdx));
+                    break;
+                case EColumn::GroupWeight:
+                    visitor->AddGroupWeights(GetFloatColumn(columnIdx));
+                    break;
+                case EColumn::GroupId:
+                    ForEachStringValue(
+                        GetColumnSchema(columnIdx),
+                        GetColumnChunks(columnIdx),
+                        [&] (ui32 objectIdx, TStringBuf value) {
+                            visitor->AddGroupId(objectIdx, CalcGroupIdFor(value));
+                        }
+                    );
+                    break;
+                case EColumn::SubgroupId:
+                    ForEachStringValue(
+                        GetColumnSchema(columnIdx),
+                        GetColumnChunks(columnIdx),
+                        [&] (ui32 objectIdx, TStringBuf value) {
+                            visitor->AddSubgroupId(objectIdx, CalcSubgroupIdFor(value));
+                        }
+                    );
+                    break;
+                case EColumn::Timestamp:
+                    DispatchNumericFormat(
+                        GetColumnSchema(columnIdx).format,
+                        [&] (auto typeTag) {
+                            ForEachNumericValue<decltype(typeTag)>(
+                                GetColumnChunks(columnIdx),
+                                [&] (ui32 objectIdx, auto value, bool isValid) {
+                                    visitor->AddTimestamp(objectIdx, isValid ? static_cast<ui64>(value) : 0);
+                                }
+                            );
+                        }
+                    );
+                    break;
+                default: // SampleId, Auxiliary
+                    break;
+            }
+        }
+
+        SetGroupWeights(Args.GroupWeightsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+        SetPairs(Args.PairsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+        SetBaseline(
+            Args.BaselineFilePath,
+            ObjectCount,
+            Args.DatasetSubset,
+            ClassLabelsToStrings(DataMetaInfo.ClassLabels),
+            visitor
+        );
+        SetTimestamps(Args.TimestampsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+
+        visitor->Finish();
+    }
+
+    namespace {
+        TDatasetLoaderFactory::TRegistrator<TArrowDataLoader> ArrowDataLoaderReg("arrow-c-stream");
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "arrow_c_data.h"
+#include "loader.h"
+
+#include <catboost/libs/helpers/resource_holder.h>
+
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    // owns the data passed through Arrow C data interface, calls release callback in destructor
+    class TArrowArrayHolder : public IResourceHolder {
+    public:
+        // moves data from array, array->release is set to nullptr
+        explicit TArrowArrayHolder(ArrowArray* array);
+        ~TArrowArrayHolder();
+
+        const ArrowArray& Get() const {
+            return Array;
+        }
+
+    private:
+        ArrowArray Array;
+    };
+
+    class TArrowSchemaHolder : public IResourceHolder {
+    public:
+        // moves data from schema, schema->release is set to nullptr
+        explicit TArrowSchemaHolder(ArrowSchema* schema);
+        ~TArrowSchemaHolder();
+
+        const ArrowSchema& Get() const {
+            return Schema;
+        }
+
+    private:
+        ArrowSchema Schema;
+    };
+
+
+    /*
+     * Datasets passed as Apache Arrow C streams (ArrowArrayStream) are registered in the process and
+     *   referenced by an opaque id in the path with scheme, ids that are not registered are rejected
+     *   by the loader.
+     *
+     * The stream is consumed by the loader: it is unregistered, all record batches are read and the
+     *   stream is released. Record batches themselves are kept alive by the resulting data provider
+     *   because numeric columns without nulls are used zero-copy.
+     */
+    ui64 RegisterArrowCStream(ArrowArrayStream* stream);
+
+    // the stream is not released, returns false if it is not registered (e.g. it has already been consumed)
+    bool UnregisterArrowCStream(ui64 streamId);
+
+    TString MakeArrowCStreamPoolPath(ui64 streamId);
+
+
+    /*
+     * Loads a dataset from Apache Arrow record batches with a struct ("+s") schema, columns of the struct
+     *   are dataset columns.
+     *
+     * Column types are taken from the column description (if specified), otherwise the first column is
+     *   the label, string and dictionary-encoded columns are categorical features and the rest are numeric
+     *   features. Column names from the schema are used as feature names if not specified in the column
+     *   description.
+     *
+     * Supported Arrow types:
+     *   - integer and floating point types for numeric features and float data (label, weights, baseline),
+     *   - utf8, large utf8 and dictionary-encoded utf8 for categorical and text features and string labels,
+     *   - integer types for categorical features, group ids and timestamps.
+     */
+    class TArrowDataLoader : public IRawFeaturesOrderDatasetLoader {
+    public:
+        explicit TArrowDataLoader(TDatasetLoaderPullArgs&& args);
+
+        TArrowDataLoader(ArrowArrayStream* stream, TDatasetLoaderCommonArgs&& args);
+
+        void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+    private:
+        const ArrowSchema& GetColumnSchema(ui32 columnIdx) const;
+
+        // [batchIdx]
+        TVector<const ArrowArray*> GetColumnChunks(ui32 columnIdx) const;
+
+        // zero-copy if data consists of a single batch without nulls, nulls are converted to NaNs
+        ITypedSequencePtr<float> GetFloatSequence(ui32 columnIdx) const;
+
+        TVector<float> GetFloatColumn(ui32 columnIdx) const;
+
+        // nulls are converted to empty strings
+        TVector<TString> GetStringColumn(ui32 columnIdx) const;
+
+        // dictionary-encoded columns are hashed once per dictionary value
+        TVector<ui32> GetCatFeatureHashes(
+            ui32 columnIdx,
+            ui32 flatFeatureIdx,
+            IRawFeaturesOrderDataVisitor* visitor
+        ) const;
+
+    private:
+        TDatasetLoaderCommonArgs Args;
+
+        TIntrusivePtr<TArrowSchemaHolder> Schema;
+        TVector<TIntrusivePtr<TArrowArrayHolder>> Batches;
+        ui32 ObjectCount = 0;
+
+        TDataMetaInfo DataMetaInfo;
+        TVector<bool> FeatureIgnored; // [flatFeatureIdx]
+    };
+
+}
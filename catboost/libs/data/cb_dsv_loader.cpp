@@ -9,6 +9,7 @@
 #include <library/cpp/object_factory/object_factory.h>
 #include <library/cpp/string_utils/csv/csv.h>
 
+#include <util/generic/cast.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
@@ -145,10 +146,16 @@ namespace NCB {
     }
 
     void TCBDsvDataLoader::ProcessBlock(IRawObjectsOrderDataVisitor* visitor) {
-        visitor->StartNextBlock(AsyncRowProcessor.GetParseBufferSize());
+        const ui32 blockSize = SafeIntegerCast<ui32>(AsyncRowProcessor.GetParseBufferSize());
+        visitor->StartNextBlock(blockSize);
 
         auto& columnsDescription = DataMetaInfo.ColumnsInfo->Columns;
 
+        const ui32 floatFeatureCount = DataMetaInfo.FeaturesLayout->GetFloatFeatureCount();
+        const ui32 catFeatureCount = DataMetaInfo.FeaturesLayout->GetCatFeatureCount();
+        FloatFeaturesBlock.yresize(size_t(blockSize) * floatFeatureCount);
+        CatFeaturesBlock.yresize(size_t(blockSize) * catFeatureCount);
+
         auto parseBlock = [&](TString& line, int lineIdx) {
             const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
 
@@ -156,11 +163,15 @@ namespace NCB {
             ui32 targetId = 0;
             ui32 baselineIdx = 0;
 
-            TVector<float> floatFeatures;
-            floatFeatures.yresize(featuresLayout.GetFloatFeatureCount());
+            TArrayRef<float> floatFeatures(
+                FloatFeaturesBlock.data() + size_t(lineIdx) * floatFeatureCount,
+                floatFeatureCount
+            );
 
-            TVector<ui32> catFeatures;
-            catFeatures.yresize(featuresLayout.GetCatFeatureCount());
+            TArrayRef<ui32> catFeatures(
+                CatFeaturesBlock.data() + size_t(lineIdx) * catFeatureCount,
+                catFeatureCount
+            );
 
             TVector<TString> textFeatures;
             textFeatures.yresize(featuresLayout.GetTextFeatureCount());
@@ -284,12 +295,6 @@ namespace NCB {
                     tokenIdx == columnsDescription.size(),
                     "wrong column count: expected " << columnsDescription.ysize() << ", found " << tokenIdx
                 );
-                if (!floatFeatures.empty()) {
-                    visitor->AddAllFloatFeatures(lineIdx, floatFeatures);
-                }
-                if (!catFeatures.empty()) {
-                    visitor->AddAllCatFeatures(lineIdx, catFeatures);
-                }
                 if (!textFeatures.empty()) {
                     visitor->AddAllTextFeatures(lineIdx, textFeatures);
                 }
@@ -312,6 +317,13 @@ namespace NCB {
 
         AsyncRowProcessor.ProcessBlock(parseBlock);
 
+        if (floatFeatureCount) {
+            visitor->AddAllFloatFeaturesBlock(/*localObjectOffset*/ 0, blockSize, FloatFeaturesBlock);
+        }
+        if (catFeatureCount) {
+            visitor->AddAllCatFeaturesBlock(/*localObjectOffset*/ 0, blockSize, CatFeaturesBlock);
+        }
+
         if (BaselineReader.Inited()) {
             auto parseBaselineBlock = [&](TString &line, int inBlockIdx) {
 
@@ -75,6 +75,10 @@ namespace NCB {
         THolder<NCB::ILineDataReader> LineDataReader;
         TBaselineReader BaselineReader;
 
+        // features of the current block in row-major order, passed to visitor in bulk
+        TVector<float> FloatFeaturesBlock; // [lineIdx * floatFeatureCount + floatFeatureIdx]
+        TVector<ui32> CatFeaturesBlock; // [lineIdx * catFeatureCount + catFeatureIdx]
+
         // cached
         TMutex ObjectCountMutex;
         TMaybe<ui32> ObjectCount;
@@ -195,6 +195,14 @@ namespace NCB {
             );
         }
 
+        void AddAllFloatFeaturesBlock(
+            ui32 localObjectOffset,
+            ui32 objectCount,
+            TConstArrayRef<float> features
+        ) override {
+            FloatFeaturesStorage.SetBlock(Cursor + localObjectOffset, objectCount, features);
+        }
+
         ui32 GetCatFeatureValue(ui32 flatFeatureIdx, TStringBuf feature) override {
             auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
             ui32 hashVal = CalcCatFeatureHash(feature);
@@ -238,6 +246,14 @@ namespace NCB {
             );
         }
 
+        void AddAllCatFeaturesBlock(
+            ui32 localObjectOffset,
+            ui32 objectCount,
+            TConstArrayRef<ui32> features
+        ) override {
+            CatFeaturesStorage.SetBlock(Cursor + localObjectOffset, objectCount, features);
+        }
+
         void AddCatFeatureDefaultValue(ui32 flatFeatureIdx, TStringBuf feature) override {
             auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
             CatFeaturesStorage.SetDefaultValue(catFeatureIdx, GetCatFeatureValue(flatFeatureIdx, feature));
@@ -311,6 +327,13 @@ namespace NCB {
             );
             FloatTarget[flatTargetIdx][Cursor + localObjectIdx] = value;
         }
+        void AddTargetBlock(ui32 flatTargetIdx, ui32 localObjectOffset, TConstArrayRef<float> values) override {
+            Y_ASSERT(
+                (Data.MetaInfo.TargetType == ERawTargetType::Float) ||
+                (Data.MetaInfo.TargetType == ERawTargetType::Integer)
+            );
+            Copy(values.begin(), values.end(), FloatTarget[flatTargetIdx].begin() + Cursor + localObjectOffset);
+        }
         void AddBaseline(ui32 localObjectIdx, ui32 baselineIdx, float value) override {
             Data.TargetData.Baseline[baselineIdx][Cursor + localObjectIdx] = value;
         }
@@ -834,6 +857,69 @@ namespace NCB {
                 );
             }
 
+            /* features are in row-major order: [objectIdx - objectOffset][perTypeFeatureIdx]
+             *
+             * transposed into per-feature storage by tiles of FEATURE_TILE_SIZE features x OBJECT_TILE_SIZE
+             * objects so that both source rows and destination columns parts stay in cache,
+             * object ranges of OBJECT_CHUNK_SIZE and feature tiles are processed in parallel
+             */
+            void SetBlock(ui32 objectOffset, ui32 objectCount, TConstArrayRef<T> features) {
+                constexpr ui32 FEATURE_TILE_SIZE = 16;
+                constexpr ui32 OBJECT_TILE_SIZE = 64;
+                constexpr ui32 OBJECT_CHUNK_SIZE = 4096;
+
+                if (!objectCount) {
+                    return;
+                }
+                const ui32 featureCount = SafeIntegerCast<ui32>(features.size() / objectCount);
+                CB_ENSURE_INTERNAL(
+                    size_t(featureCount) * objectCount == features.size(),
+                    "features block size is not a multiple of object count"
+                );
+                if (!featureCount) {
+                    return;
+                }
+
+                const ui32 featureTileCount = CeilDiv(featureCount, FEATURE_TILE_SIZE);
+                const ui32 objectChunkCount = CeilDiv(objectCount, OBJECT_CHUNK_SIZE);
+
+                LocalExecutor->ExecRangeWithThrow(
+                    [&] (int taskIdx) {
+                        const ui32 featureBegin = (taskIdx % featureTileCount) * FEATURE_TILE_SIZE;
+                        const ui32 featureEnd = Min(featureBegin + FEATURE_TILE_SIZE, featureCount);
+                        const ui32 chunkBegin = (taskIdx / featureTileCount) * OBJECT_CHUNK_SIZE;
+                        const ui32 chunkEnd = Min(chunkBegin + OBJECT_CHUNK_SIZE, objectCount);
+
+                        for (ui32 tileBegin = chunkBegin; tileBegin < chunkEnd; tileBegin += OBJECT_TILE_SIZE) {
+                            const ui32 tileEnd = Min(tileBegin + OBJECT_TILE_SIZE, chunkEnd);
+                            for (auto perTypeFeatureIdx : xrange(featureBegin, featureEnd)) {
+                                const T* src = features.data() + perTypeFeatureIdx;
+                                const bool isDense
+                                    = (perTypeFeatureIdx < PerFeatureData.size())
+                                        && (PerFeatureCallbacks[perTypeFeatureIdx] == SetDenseFeature);
+                                if (isDense) {
+                                    T* dst = PerFeatureData[perTypeFeatureIdx].DenseDstView.data() + objectOffset;
+                                    for (auto objectIdx : xrange(tileBegin, tileEnd)) {
+                                        dst[objectIdx] = src[size_t(objectIdx) * featureCount];
+                                    }
+                                } else {
+                                    for (auto objectIdx : xrange(tileBegin, tileEnd)) {
+                                        Set(
+                                            TFeatureIdx<FeatureType>(perTypeFeatureIdx),
+                                            objectOffset + objectIdx,
+                                            src[size_t(objectIdx) * featureCount]
+                                        );
+                                    }
+                                }
+                            }
+                        }
+                    },
+                    0,
+                    SafeIntegerCast<int>(featureTileCount * objectChunkCount),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+            }
+
             void SetDefaultValue(TFeatureIdx<FeatureType> perTypeFeatureIdx, T value) {
                 if (*perTypeFeatureIdx >= PerFeatureData.size()) {
                     for (auto perTypeFeatureIdx : xrange(PerFeatureData.size(), size_t(*perTypeFeatureIdx + 1))) {
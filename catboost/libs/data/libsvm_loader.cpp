@@ -170,6 +170,8 @@ namespace NCB {
     void TLibSvmDataLoader::ProcessBlock(IRawObjectsOrderDataVisitor* visitor) {
         visitor->StartNextBlock(AsyncRowProcessor.GetParseBufferSize());
 
+        TargetBlock.yresize(AsyncRowProcessor.GetParseBufferSize());
+
         auto parseBlock = [&](TString& line, int lineIdx) {
             const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
 
@@ -198,9 +200,7 @@ namespace NCB {
                     token = (*lineIterator).Token();
 
                     CB_ENSURE(token.length() != 0, "empty values not supported for Label");
-                    float label;
-                    CB_ENSURE(TryFromString(token, label), "Target value must be float");
-                    visitor->AddTarget(lineIdx, label);
+                    CB_ENSURE(TryFromString(token, TargetBlock[lineIdx]), "Target value must be float");
 
                     ++tokenCount;
                     ++lineIterator;
@@ -302,6 +302,8 @@ namespace NCB {
 
         AsyncRowProcessor.ProcessBlock(parseBlock);
 
+        visitor->AddTargetBlock(/*flatTargetIdx*/ 0, /*localObjectOffset*/ 0, TargetBlock);
+
         if (BaselineReader.Inited()) {
             auto parseBaselineBlock = [&](TString &line, int inBlockIdx) {
 
@@ -84,6 +84,9 @@ namespace NCB {
         THolder<NCB::ILineDataReader> LineDataReader;
         TBaselineReader BaselineReader;
 
+        // targets of the current block, passed to visitor in bulk
+        TVector<float> TargetBlock; // [lineIdx]
+
         // cached
         TMutex ObjectCountMutex;
         TMaybe<ui32> ObjectCount;
@@ -0,0 +1,320 @@
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/data/visitor.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+// forwards per-object methods only, so block methods of IRawObjectsOrderDataVisitor use default implementations
+class TPerObjectForwardingVisitor final : public IRawObjectsOrderDataVisitor {
+public:
+    explicit TPerObjectForwardingVisitor(IRawObjectsOrderDataVisitor* dst)
+        : Dst(dst)
+    {}
+
+    void SetGroupWeights(TVector<float>&& groupWeights) override {
+        Dst->SetGroupWeights(std::move(groupWeights));
+    }
+    void SetBaseline(TVector<TVector<float>>&& baseline) override {
+        Dst->SetBaseline(std::move(baseline));
+    }
+    void SetPairs(TVector<TPair>&& pairs) override {
+        Dst->SetPairs(std::move(pairs));
+    }
+    void SetTimestamps(TVector<ui64>&& timestamps) override {
+        Dst->SetTimestamps(std::move(timestamps));
+    }
+    TMaybeData<TConstArrayRef<TGroupId>> GetGroupIds() const override {
+        return Dst->GetGroupIds();
+    }
+
+    void Start(
+        bool inBlock,
+        const TDataMetaInfo& metaInfo,
+        bool haveUnknownNumberOfSparseFeatures,
+        ui32 objectCount,
+        EObjectsOrder objectsOrder,
+        TVector<TIntrusivePtr<IResourceHolder>> resourceHolders
+    ) override {
+        Dst->Start(
+            inBlock,
+            metaInfo,
+            haveUnknownNumberOfSparseFeatures,
+            objectCount,
+            objectsOrder,
+            std::move(resourceHolders));
+    }
+    void StartNextBlock(ui32 blockSize) override {
+        Dst->StartNextBlock(blockSize);
+    }
+
+    void AddGroupId(ui32 localObjectIdx, TGroupId value) override {
+        Dst->AddGroupId(localObjectIdx, value);
+    }
+    void AddSubgroupId(ui32 localObjectIdx, TSubgroupId value) override {
+        Dst->AddSubgroupId(localObjectIdx, value);
+    }
+    void AddTimestamp(ui32 localObjectIdx, ui64 value) override {
+        Dst->AddTimestamp(localObjectIdx, value);
+    }
+
+    void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
+        Dst->AddFloatFeature(localObjectIdx, flatFeatureIdx, feature);
+    }
+    void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
+        Dst->AddAllFloatFeatures(localObjectIdx, features);
+    }
+    void AddAllFloatFeatures(
+        ui32 localObjectIdx,
+        TConstPolymorphicValuesSparseArray<float, ui32> features
+    ) override {
+        Dst->AddAllFloatFeatures(localObjectIdx, std::move(features));
+    }
+
+    ui32 GetCatFeatureValue(ui32 flatFeatureIdx, TStringBuf feature) override {
+        return Dst->GetCatFeatureValue(flatFeatureIdx, feature);
+    }
+    void AddCatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
+        Dst->AddCatFeature(localObjectIdx, flatFeatureIdx, feature);
+    }
+    void AddAllCatFeatures(ui32 localObjectIdx, TConstArrayRef<ui32> features) override {
+        Dst->AddAllCatFeatures(localObjectIdx, features);
+    }
+    void AddAllCatFeatures(
+        ui32 localObjectIdx,
+        TConstPolymorphicValuesSparseArray<ui32, ui32> features
+    ) override {
+        Dst->AddAllCatFeatures(localObjectIdx, std::move(features));
+    }
+    void AddCatFeatureDefaultValue(ui32 flatFeatureIdx, TStringBuf feature) override {
+        Dst->AddCatFeatureDefaultValue(flatFeatureIdx, feature);
+    }
+
+    void AddTextFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
+        Dst->AddTextFeature(localObjectIdx, flatFeatureIdx, feature);
+    }
+    void AddTextFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, const TString& feature) override {
+        Dst->AddTextFeature(localObjectIdx, flatFeatureIdx, feature);
+    }
+    void AddAllTextFeatures(ui32 localObjectIdx, TConstArrayRef<TString> features) override {
+        Dst->AddAllTextFeatures(localObjectIdx, features);
+    }
+    void AddAllTextFeatures(
+        ui32 localObjectIdx,
+        TConstPolymorphicValuesSparseArray<TString, ui32> features
+    ) override {
+        Dst->AddAllTextFeatures(localObjectIdx, std::move(features));
+    }
+
+    void AddEmbeddingFeature(
+        ui32 localObjectIdx,
+        ui32 flatFeatureIdx,
+        TMaybeOwningConstArrayHolder<float> feature
+    ) override {
+        Dst->AddEmbeddingFeature(localObjectIdx, flatFeatureIdx, std::move(feature));
+    }
+
+    void AddTarget(ui32 localObjectIdx, const TString& value) override {
+        Dst->AddTarget(localObjectIdx, value);
+    }
+    void AddTarget(ui32 localObjectIdx, float value) override {
+        Dst->AddTarget(localObjectIdx, value);
+    }
+    void AddTarget(ui32 flatTargetIdx, ui32 localObjectIdx, const TString& value) override {
+        Dst->AddTarget(flatTargetIdx, localObjectIdx, value);
+    }
+    void AddTarget(ui32 flatTargetIdx, ui32 localObjectIdx, float value) override {
+        Dst->AddTarget(flatTargetIdx, localObjectIdx, value);
+    }
+    void AddBaseline(ui32 localObjectIdx, ui32 baselineIdx, float value) override {
+        Dst->AddBaseline(localObjectIdx, baselineIdx, value);
+    }
+    void AddWeight(ui32 localObjectIdx, float value) override {
+        Dst->AddWeight(localObjectIdx, value);
+    }
+    void AddGroupWeight(ui32 localObjectIdx, float value) override {
+        Dst->AddGroupWeight(localObjectIdx, value);
+    }
+
+    void Finish() override {
+        Dst->Finish();
+    }
+
+private:
+    IRawObjectsOrderDataVisitor* Dst;
+};
+
+
+Y_UNIT_TEST_SUITE(RawObjectsOrderDataProviderBuilder) {
+    struct TRowMajorData {
+        ui32 ObjectCount = 0;
+        TDataMetaInfo MetaInfo;
+        TVector<float> FloatFeatures; // [objectIdx * floatFeatureCount + floatFeatureIdx]
+        TVector<ui32> CatFeatures; // [objectIdx * catFeatureCount + catFeatureIdx]
+        TVector<TVector<float>> Target; // [targetIdx][objectIdx]
+    };
+
+    // more than one features tile and objects chunk of TFeaturesStorage::SetBlock
+    static TRowMajorData GenerateData() {
+        constexpr ui32 floatFeatureCount = 37;
+        constexpr ui32 catFeatureCount = 19;
+        TRowMajorData data;
+        data.ObjectCount = 9000;
+
+        // dense, sparse and ignored features of both types
+        auto featuresLayout = MakeIntrusive<TFeaturesLayout>();
+        for (auto floatFeatureIdx : xrange(floatFeatureCount)) {
+            featuresLayout->AddFeature(
+                TFeatureMetaInfo(
+                    EFeatureType::Float,
+                    "f" + ToString(floatFeatureIdx),
+                    /*isSparse*/ floatFeatureIdx % 5 == 1,
+                    /*isIgnored*/ floatFeatureIdx % 7 == 3
+                )
+            );
+        }
+        for (auto catFeatureIdx : xrange(catFeatureCount)) {
+            featuresLayout->AddFeature(
+                TFeatureMetaInfo(
+                    EFeatureType::Categorical,
+                    "c" + ToString(catFeatureIdx),
+                    /*isSparse*/ catFeatureIdx % 4 == 2,
+                    /*isIgnored*/ catFeatureIdx % 6 == 5
+                )
+            );
+        }
+        data.MetaInfo.FeaturesLayout = featuresLayout;
+        data.MetaInfo.TargetType = ERawTargetType::Float;
+        data.MetaInfo.TargetCount = 2;
+
+        TFastRng64 rand(0);
+        data.FloatFeatures.yresize(data.ObjectCount * floatFeatureCount);
+        for (auto& value : data.FloatFeatures) {
+            // sparse features get mostly default values
+            value = rand.GenRand() % 3 ? 0.0f : rand.GenRandReal1();
+        }
+        data.CatFeatures.yresize(data.ObjectCount * catFeatureCount);
+        for (auto& value : data.CatFeatures) {
+            value = rand.Uniform(10);
+        }
+        data.Target.resize(data.MetaInfo.TargetCount);
+        for (auto& target : data.Target) {
+            target.yresize(data.ObjectCount);
+            for (auto& value : target) {
+                value = rand.GenRandReal1();
+            }
+        }
+        return data;
+    }
+
+    // object ranges of AddAll*FeaturesBlock calls
+    static const TVector<std::pair<ui32, ui32>> Blocks = {{0, 1}, {1, 5000}, {5000, 5063}, {5063, 9000}};
+
+    static void VisitByObjects(const TRowMajorData& data, IRawObjectsOrderDataVisitor* visitor) {
+        const ui32 floatFeatureCount = data.MetaInfo.FeaturesLayout->GetFloatFeatureCount();
+        const ui32 catFeatureCount = data.MetaInfo.FeaturesLayout->GetCatFeatureCount();
+        visitor->Start(
+            /*inBlock*/ false,
+            data.MetaInfo,
+            /*haveUnknownNumberOfSparseFeatures*/ false,
+            data.ObjectCount,
+            EObjectsOrder::Undefined,
+            {}
+        );
+        visitor->StartNextBlock(data.ObjectCount);
+        for (auto objectIdx : xrange(data.ObjectCount)) {
+            visitor->AddAllFloatFeatures(
+                objectIdx,
+                MakeArrayRef(data.FloatFeatures).subspan(objectIdx * floatFeatureCount, floatFeatureCount)
+            );
+            visitor->AddAllCatFeatures(
+                objectIdx,
+                MakeArrayRef(data.CatFeatures).subspan(objectIdx * catFeatureCount, catFeatureCount)
+            );
+            for (auto targetIdx : xrange(data.Target.size())) {
+                visitor->AddTarget(targetIdx, objectIdx, data.Target[targetIdx][objectIdx]);
+            }
+        }
+        visitor->Finish();
+    }
+
+    static void VisitByBlocks(const TRowMajorData& data, IRawObjectsOrderDataVisitor* visitor) {
+        const ui32 floatFeatureCount = data.MetaInfo.FeaturesLayout->GetFloatFeatureCount();
+        const ui32 catFeatureCount = data.MetaInfo.FeaturesLayout->GetCatFeatureCount();
+        visitor->Start(
+            /*inBlock*/ false,
+            data.MetaInfo,
+            /*haveUnknownNumberOfSparseFeatures*/ false,
+            data.ObjectCount,
+            EObjectsOrder::Undefined,
+            {}
+        );
+        visitor->StartNextBlock(data.ObjectCount);
+        for (auto [blockBegin, blockEnd] : Blocks) {
+            const ui32 blockSize = blockEnd - blockBegin;
+            visitor->AddAllFloatFeaturesBlock(
+                blockBegin,
+                blockSize,
+                MakeArrayRef(data.FloatFeatures).subspan(blockBegin * floatFeatureCount, blockSize * floatFeatureCount)
+            );
+            visitor->AddAllCatFeaturesBlock(
+                blockBegin,
+                blockSize,
+                MakeArrayRef(data.CatFeatures).subspan(blockBegin * catFeatureCount, blockSize * catFeatureCount)
+            );
+            for (auto targetIdx : xrange(data.Target.size())) {
+                visitor->AddTargetBlock(
+                    targetIdx,
+                    blockBegin,
+                    MakeArrayRef(data.Target[targetIdx]).subspan(blockBegin, blockSize)
+                );
+            }
+        }
+        visitor->Finish();
+    }
+
+    Y_UNIT_TEST(TestAddBlocks) {
+        const TRowMajorData data = GenerateData();
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const auto buildDataProvider = [&] (auto&& visit) {
+            TDataProviderClosure dataProviderClosure(
+                EDatasetVisitorType::RawObjectsOrder,
+                TDataProviderBuilderOptions(),
+                &localExecutor
+            );
+            visit(dataProviderClosure.GetVisitor<IRawObjectsOrderDataVisitor>());
+            return dataProviderClosure.GetResult();
+        };
+
+        const auto expectedDataProvider = buildDataProvider(
+            [&] (IRawObjectsOrderDataVisitor* visitor) {
+                VisitByObjects(data, visitor);
+            }
+        );
+
+        // builder overrides of block methods
+        const auto blocksDataProvider = buildDataProvider(
+            [&] (IRawObjectsOrderDataVisitor* visitor) {
+                VisitByBlocks(data, visitor);
+            }
+        );
+        UNIT_ASSERT(*blocksDataProvider == *expectedDataProvider);
+
+        // default implementations of block methods
+        const auto forwardedBlocksDataProvider = buildDataProvider(
+            [&] (IRawObjectsOrderDataVisitor* visitor) {
+                TPerObjectForwardingVisitor forwardingVisitor(visitor);
+                VisitByBlocks(data, &forwardingVisitor);
+            }
+        );
+        UNIT_ASSERT(*forwardedBlocksDataProvider == *expectedDataProvider);
+    }
+}
@@ -0,0 +1,551 @@
+#include <catboost/libs/data/ut/lib/for_data_provider.h>
+#include <catboost/libs/data/ut/lib/for_loader.h>
+
+#include <catboost/libs/data/arrow_loader.h>
+#include <catboost/libs/data/load_data.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/scope.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+#include <cmath>
+#include <cstring>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+namespace {
+
+    // Minimal Arrow C data interface producer, all data is owned by the producer objects
+    struct TTestArrowArray {
+        TString Format;
+        TString Name;
+        i64 Length = 0;
+        i64 NullCount = 0;
+        TVector<ui8> Validity; // empty if there're no nulls
+        TVector<char> Values; // fixed-size values or utf8 offsets
+        TString Chars; // utf8 data
+        TVector<THolder<TTestArrowArray>> Children;
+        THolder<TTestArrowArray> Dictionary;
+
+        TVector<const void*> Buffers;
+        TVector<ArrowSchema*> ChildSchemas;
+        TVector<ArrowArray*> ChildArrays;
+        ArrowSchema Schema;
+        ArrowArray Array;
+
+    public:
+        static void ReleaseSchema(ArrowSchema* schema) {
+            schema->release = nullptr;
+        }
+
+        static void ReleaseArray(ArrowArray* array) {
+            array->release = nullptr;
+        }
+
+        void Export() {
+            Buffers.clear();
+            Buffers.push_back(Validity.empty() ? nullptr : Validity.data());
+            if (Format != "+s") {
+                Buffers.push_back(Values.data());
+            }
+            if (Format == "u") {
+                Buffers.push_back(Chars.data());
+            }
+
+            ChildSchemas.clear();
+            ChildArrays.clear();
+            for (auto& child : Children) {
+                child->Export();
+                ChildSchemas.push_back(&child->Schema);
+                ChildArrays.push_back(&child->Array);
+            }
+            if (Dictionary) {
+                Dictionary->Export();
+            }
+
+            Schema = ArrowSchema{
+                Format.c_str(),
+                Name.c_str(),
+                /*metadata*/ nullptr,
+                /*flags*/ ARROW_FLAG_NULLABLE,
+                (i64)Children.size(),
+                ChildSchemas.data(),
+                Dictionary ? &Dictionary->Schema : nullptr,
+                &ReleaseSchema,
+                /*private_data*/ nullptr
+            };
+            Array = ArrowArray{
+                Length,
+                NullCount,
+                /*offset*/ 0,
+                (i64)Buffers.size(),
+                (i64)Children.size(),
+                Buffers.data(),
+                ChildArrays.data(),
+                Dictionary ? &Dictionary->Array : nullptr,
+                &ReleaseArray,
+                /*private_data*/ nullptr
+            };
+        }
+    };
+
+    template <class T>
+    THolder<TTestArrowArray> MakeNumericArray(TStringBuf format, const TVector<T>& values) {
+        auto result = MakeHolder<TTestArrowArray>();
+        result->Format = format;
+        result->Length = values.size();
+        result->Values.yresize(values.size() * sizeof(T));
+        std::memcpy(result->Values.data(), values.data(), result->Values.size());
+        return result;
+    }
+
+    template <class T>
+    THolder<TTestArrowArray> MakeNullableNumericArray(TStringBuf format, const TVector<TMaybe<T>>& values) {
+        TVector<T> storedValues;
+        for (const auto& value : values) {
+            storedValues.push_back(value.GetOrElse(T()));
+        }
+        auto result = MakeNumericArray<T>(format, storedValues);
+        result->Validity.resize((values.size() + 7) / 8);
+        for (auto i : xrange(values.size())) {
+            if (values[i]) {
+                result->Validity[i / 8] |= ui8(1) << (i % 8);
+            } else {
+                ++result->NullCount;
+            }
+        }
+        return result;
+    }
+
+    THolder<TTestArrowArray> MakeStringArray(const TVector<TMaybe<TString>>& values) {
+        auto result = MakeHolder<TTestArrowArray>();
+        result->Format = "u";
+        result->Length = values.size();
+        result->Validity.resize((values.size() + 7) / 8);
+
+        TVector<i32> offsets = {0};
+        for (auto i : xrange(values.size())) {
+            if (values[i]) {
+                result->Validity[i / 8] |= ui8(1) << (i % 8);
+                result->Chars += *values[i];
+            } else {
+                ++result->NullCount;
+            }
+            offsets.push_back(result->Chars.size());
+        }
+        if (!result->NullCount) {
+            result->Validity.clear();
+        }
+        result->Values.yresize(offsets.size() * sizeof(i32));
+        std::memcpy(result->Values.data(), offsets.data(), result->Values.size());
+        return result;
+    }
+
+    THolder<TTestArrowArray> MakeDictionaryArray(const TVector<i32>& indices, const TVector<TString>& dictionary) {
+        auto result = MakeNumericArray<i32>("i", indices);
+        result->Dictionary = MakeStringArray(TVector<TMaybe<TString>>(dictionary.begin(), dictionary.end()));
+        return result;
+    }
+
+    THolder<TTestArrowArray> MakeRecordBatch(TVector<std::pair<TString, THolder<TTestArrowArray>>>&& columns) {
+        auto result = MakeHolder<TTestArrowArray>();
+        result->Format = "+s";
+        result->Length = columns[0].second->Length;
+        for (auto& [name, column] : columns) {
+            column->Name = name;
+            result->Children.push_back(std::move(column));
+        }
+        result->Export();
+        return result;
+    }
+
+    class TTestArrowStream {
+    public:
+        explicit TTestArrowStream(TVector<THolder<TTestArrowArray>>&& batches)
+            : Batches(std::move(batches))
+        {
+            Stream.get_schema = &GetSchema;
+            Stream.get_next = &GetNext;
+            Stream.get_last_error = &GetLastError;
+            Stream.release = &Release;
+            Stream.private_data = this;
+        }
+
+        ArrowArrayStream* Get() {
+            return &Stream;
+        }
+
+    private:
+        static TTestArrowStream* This(ArrowArrayStream* stream) {
+            return static_cast<TTestArrowStream*>(stream->private_data);
+        }
+
+        static int GetSchema(ArrowArrayStream* stream, ArrowSchema* out) {
+            *out = This(stream)->Batches[0]->Schema;
+            return 0;
+        }
+
+        static int GetNext(ArrowArrayStream* stream, ArrowArray* out) {
+            auto* self = This(stream);
+            if (self->NextBatchIdx == self->Batches.size()) {
+                out->release = nullptr;
+            } else {
+                *out = self->Batches[self->NextBatchIdx++]->Array;
+                out->release = &ReleaseBatch;
+                out->private_data = self;
+            }
+            return 0;
+        }
+
+        static const char* GetLastError(ArrowArrayStream*) {
+            return nullptr;
+        }
+
+        static void Release(ArrowArrayStream* stream) {
+            This(stream)->StreamReleased = true;
+            stream->release = nullptr;
+        }
+
+        static void ReleaseBatch(ArrowArray* array) {
+            ++static_cast<TTestArrowStream*>(array->private_data)->ReleasedBatchCount;
+            array->release = nullptr;
+        }
+
+    public:
+        bool StreamReleased = false;
+        ui32 ReleasedBatchCount = 0;
+
+    private:
+        TVector<THolder<TTestArrowArray>> Batches;
+        size_t NextBatchIdx = 0;
+        ArrowArrayStream Stream;
+    };
+
+    TDataProviderPtr ReadArrowDataset(const TString& poolPath, TStringBuf cdFileData) {
+        TVector<THolder<TTempFile>> srcDataFiles;
+        NCatboostOptions::TColumnarPoolFormatParams columnarPoolFormatParams;
+        SaveDataToTempFile(cdFileData, &columnarPoolFormatParams.CdFilePath, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        return ReadDataset(
+            /*taskType*/Nothing(),
+            TPathWithScheme(poolPath),
+            /*pairsFilePath*/TPathWithScheme(),
+            /*groupWeightsFilePath*/TPathWithScheme(),
+            /*timestampsFilePath*/TPathWithScheme(),
+            /*baselineFilePath*/TPathWithScheme(),
+            /*featureNamesPath*/TPathWithScheme(),
+            columnarPoolFormatParams,
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            TDatasetSubset::MakeColumns(),
+            /*classLabels*/Nothing(),
+            &localExecutor
+        );
+    }
+
+    TDataProviderPtr ReadArrowDataset(TTestArrowStream* stream, TStringBuf cdFileData) {
+        const ui64 streamId = RegisterArrowCStream(stream->Get());
+        Y_SCOPE_EXIT(streamId) {
+            UnregisterArrowCStream(streamId);
+        };
+        return ReadArrowDataset(MakeArrowCStreamPoolPath(streamId), cdFileData);
+    }
+
+}
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromArrow) {
+
+    Y_UNIT_TEST(ReadDataset) {
+        TVector<THolder<TTestArrowArray>> batches;
+        {
+            TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+            columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f, 1.0f}));
+            columns.emplace_back("f0", MakeNumericArray<double>("g", {0.1, 0.97}));
+            columns.emplace_back("c0", MakeDictionaryArray({1, 0}, {"a", "b"}));
+            columns.emplace_back("c1", MakeStringArray({TString("x"), Nothing()}));
+            columns.emplace_back("t0", MakeStringArray({TString("hello world"), TString("foo")}));
+            batches.push_back(MakeRecordBatch(std::move(columns)));
+        }
+        {
+            TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+            columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f}));
+            columns.emplace_back("f0", MakeNumericArray<double>("g", {0.13}));
+            columns.emplace_back("c0", MakeDictionaryArray({1}, {"b", "c"}));
+            columns.emplace_back("c1", MakeStringArray({TString("y")}));
+            columns.emplace_back("t0", MakeStringArray({TString("bar baz")}));
+            batches.push_back(MakeRecordBatch(std::move(columns)));
+        }
+        TTestArrowStream stream(std::move(batches));
+
+        TDataProviderPtr dataProvider = ReadArrowDataset(
+            &stream,
+            AsStringBuf(
+                "0\tTarget\n"
+                "1\tNum\tf0\n"
+                "2\tCateg\tc0\n"
+                "3\tCateg\tc1\n"
+                "4\tText\tt0\n"
+            )
+        );
+        UNIT_ASSERT(stream.StreamReleased);
+        UNIT_ASSERT_VALUES_EQUAL(stream.ReleasedBatchCount, 0);
+
+
+        TExpectedRawData expectedData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::Num, "f0"},
+            {EColumn::Categ, "c0"},
+            {EColumn::Categ, "c1"},
+            {EColumn::Text, "t0"}
+        };
+
+        TVector<TString> featureId = {"f0", "c0", "c1", "t0"};
+
+        expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), ERawTargetType::Float, false, false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+        expectedData.Objects.FloatFeatures = {
+            TVector<float>{0.1f, 0.97f, 0.13f},
+        };
+        expectedData.Objects.CatFeatures = {
+            TVector<TStringBuf>{"b", "a", "c"},
+            TVector<TStringBuf>{"x", "", "y"},
+        };
+        expectedData.Objects.TextFeatures = {
+            TVector<TStringBuf>{"hello world", "foo", "bar baz"},
+        };
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(3);
+        expectedData.Target.TargetType = ERawTargetType::Float;
+        TVector<TVector<TString>> rawTarget{{"0", "1", "0"}};
+        expectedData.Target.Target.assign(rawTarget.begin(), rawTarget.end());
+        expectedData.Target.Weights = TWeights<float>(3);
+        expectedData.Target.GroupWeights = TWeights<float>(3);
+
+        Compare<TRawObjectsDataProvider>(std::move(dataProvider), expectedData);
+
+        // record batches are owned by the data provider
+        UNIT_ASSERT_VALUES_EQUAL(stream.ReleasedBatchCount, 2);
+    }
+
+    Y_UNIT_TEST(ReadDatasetWithDefaultColumnsDescription) {
+        TVector<THolder<TTestArrowArray>> batches;
+        {
+            TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+            columns.emplace_back("Target", MakeNumericArray<i32>("i", {1, 0, 1, 1}));
+            columns.emplace_back("x", MakeNumericArray<float>("f", {0.5f, 0.25f, 0.0f, 1.0f}));
+            columns.emplace_back("s", MakeStringArray({TString("u"), TString("v"), TString("u"), TString("w")}));
+            batches.push_back(MakeRecordBatch(std::move(columns)));
+        }
+        TTestArrowStream stream(std::move(batches));
+
+        TDataProviderPtr dataProvider = ReadArrowDataset(&stream, /*cdFileData*/ TStringBuf());
+        UNIT_ASSERT(stream.StreamReleased);
+        UNIT_ASSERT_VALUES_EQUAL(stream.ReleasedBatchCount, 0);
+
+
+        TExpectedRawData expectedData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::Num, ""},
+            {EColumn::Categ, ""}
+        };
+
+        TVector<TString> featureId = {"x", "s"};
+
+        expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), ERawTargetType::Float, false, false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+        expectedData.Objects.FloatFeatures = {
+            TVector<float>{0.5f, 0.25f, 0.0f, 1.0f},
+        };
+        expectedData.Objects.CatFeatures = {
+            TVector<TStringBuf>{"u", "v", "u", "w"},
+        };
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(4);
+        expectedData.Target.TargetType = ERawTargetType::Float;
+        TVector<TVector<TString>> rawTarget{{"1", "0", "1", "1"}};
+        expectedData.Target.Target.assign(rawTarget.begin(), rawTarget.end());
+        expectedData.Target.Weights = TWeights<float>(4);
+        expectedData.Target.GroupWeights = TWeights<float>(4);
+
+        Compare<TRawObjectsDataProvider>(std::move(dataProvider), expectedData);
+
+        UNIT_ASSERT_VALUES_EQUAL(stream.ReleasedBatchCount, 1);
+    }
+
+    Y_UNIT_TEST(IncompatibleColumnType) {
+        TVector<THolder<TTestArrowArray>> batches;
+        {
+            TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+            columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f, 1.0f}));
+            columns.emplace_back("t0", MakeNumericArray<float>("f", {0.1f, 0.2f}));
+            batches.push_back(MakeRecordBatch(std::move(columns)));
+        }
+        TTestArrowStream stream(std::move(batches));
+
+        UNIT_ASSERT_EXCEPTION(
+            ReadArrowDataset(&stream, AsStringBuf("0\tTarget\n1\tText\tt0\n")),
+            TCatBoostException
+        );
+        UNIT_ASSERT(stream.StreamReleased);
+        UNIT_ASSERT_VALUES_EQUAL(stream.ReleasedBatchCount, 1);
+    }
+
+    Y_UNIT_TEST(ReadNumericColumnsWithNulls) {
+        const float nan = std::nanf("");
+
+        // single batch: f0 and f1 have nulls and are copied, f2 has no nulls and is used in place
+        {
+            TVector<THolder<TTestArrowArray>> batches;
+            {
+                TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+                columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f, 1.0f, 1.0f}));
+                columns.emplace_back("f0", MakeNullableNumericArray<float>("f", {0.5f, Nothing(), 0.25f}));
+                columns.emplace_back("f1", MakeNullableNumericArray<i32>("i", {Nothing(), 3, Nothing()}));
+                columns.emplace_back("f2", MakeNumericArray<double>("g", {0.1, 0.2, 0.3}));
+                batches.push_back(MakeRecordBatch(std::move(columns)));
+            }
+            TTestArrowStream stream(std::move(batches));
+
+            TDataProviderPtr dataProvider = ReadArrowDataset(
+                &stream,
+                AsStringBuf("0\tTarget\n1\tNum\tf0\n2\tNum\tf1\n3\tNum\tf2\n")
+            );
+
+            TExpectedRawData expectedData;
+
+            TDataColumnsMetaInfo dataColumnsMetaInfo;
+            dataColumnsMetaInfo.Columns = {
+                {EColumn::Label, ""},
+                {EColumn::Num, "f0"},
+                {EColumn::Num, "f1"},
+                {EColumn::Num, "f2"}
+            };
+
+            TVector<TString> featureId = {"f0", "f1", "f2"};
+
+            expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), ERawTargetType::Float, false, false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+            expectedData.Objects.FloatFeatures = {
+                TVector<float>{0.5f, nan, 0.25f},
+                TVector<float>{nan, 3.0f, nan},
+                TVector<float>{0.1f, 0.2f, 0.3f},
+            };
+
+            expectedData.ObjectsGrouping = TObjectsGrouping(3);
+            expectedData.Target.TargetType = ERawTargetType::Float;
+            TVector<TVector<TString>> rawTarget{{"0", "1", "1"}};
+            expectedData.Target.Target.assign(rawTarget.begin(), rawTarget.end());
+            expectedData.Target.Weights = TWeights<float>(3);
+            expectedData.Target.GroupWeights = TWeights<float>(3);
+
+            Compare<TRawObjectsDataProvider>(std::move(dataProvider), expectedData);
+        }
+
+        // several batches: values are always copied, nulls in one of the chunks
+        {
+            TVector<THolder<TTestArrowArray>> batches;
+            {
+                TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+                columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f, 1.0f}));
+                columns.emplace_back("f0", MakeNumericArray<double>("g", {0.5, 0.75}));
+                batches.push_back(MakeRecordBatch(std::move(columns)));
+            }
+            {
+                TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+                columns.emplace_back("Target", MakeNumericArray<float>("f", {1.0f, 0.0f}));
+                columns.emplace_back("f0", MakeNullableNumericArray<double>("g", {Nothing(), 0.125}));
+                batches.push_back(MakeRecordBatch(std::move(columns)));
+            }
+            TTestArrowStream stream(std::move(batches));
+
+            TDataProviderPtr dataProvider = ReadArrowDataset(&stream, AsStringBuf("0\tTarget\n1\tNum\tf0\n"));
+
+            TExpectedRawData expectedData;
+
+            TDataColumnsMetaInfo dataColumnsMetaInfo;
+            dataColumnsMetaInfo.Columns = {
+                {EColumn::Label, ""},
+                {EColumn::Num, "f0"}
+            };
+
+            TVector<TString> featureId = {"f0"};
+
+            expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), ERawTargetType::Float, false, false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+            expectedData.Objects.FloatFeatures = {
+                TVector<float>{0.5f, 0.75f, nan, 0.125f},
+            };
+
+            expectedData.ObjectsGrouping = TObjectsGrouping(4);
+            expectedData.Target.TargetType = ERawTargetType::Float;
+            TVector<TVector<TString>> rawTarget{{"0", "1", "1", "0"}};
+            expectedData.Target.Target.assign(rawTarget.begin(), rawTarget.end());
+            expectedData.Target.Weights = TWeights<float>(4);
+            expectedData.Target.GroupWeights = TWeights<float>(4);
+
+            Compare<TRawObjectsDataProvider>(std::move(dataProvider), expectedData);
+        }
+    }
+
+    Y_UNIT_TEST(UnregisteredStream) {
+        TVector<THolder<TTestArrowArray>> batches;
+        {
+            TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+            columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f, 1.0f}));
+            columns.emplace_back("f0", MakeNumericArray<float>("f", {0.1f, 0.2f}));
+            batches.push_back(MakeRecordBatch(std::move(columns)));
+        }
+        TTestArrowStream stream(std::move(batches));
+        const auto cdFileData = AsStringBuf("0\tTarget\n1\tNum\tf0\n");
+
+        const ui64 streamId = RegisterArrowCStream(stream.Get());
+        UNIT_ASSERT(UnregisterArrowCStream(streamId));
+        UNIT_ASSERT(!UnregisterArrowCStream(streamId));
+        UNIT_ASSERT_EXCEPTION(ReadArrowDataset(MakeArrowCStreamPoolPath(streamId), cdFileData), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(ReadArrowDataset("arrow-c-stream://not_an_id", cdFileData), TCatBoostException);
+        UNIT_ASSERT(!stream.StreamReleased);
+
+        // a stream can be loaded only once
+        const ui64 loadedStreamId = RegisterArrowCStream(stream.Get());
+        ReadArrowDataset(MakeArrowCStreamPoolPath(loadedStreamId), cdFileData);
+        UNIT_ASSERT(stream.StreamReleased);
+        UNIT_ASSERT(!UnregisterArrowCStream(loadedStreamId));
+        UNIT_ASSERT_EXCEPTION(
+            ReadArrowDataset(MakeArrowCStreamPoolPath(loadedStreamId), cdFileData),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(DictionaryIndexOutOfRange) {
+        for (i32 index : {2, -1}) {
+            TVector<THolder<TTestArrowArray>> batches;
+            {
+                TVector<std::pair<TString, THolder<TTestArrowArray>>> columns;
+                columns.emplace_back("Target", MakeNumericArray<float>("f", {0.0f, 1.0f}));
+                columns.emplace_back("c0", MakeDictionaryArray({0, index}, {"a", "b"}));
+                batches.push_back(MakeRecordBatch(std::move(columns)));
+            }
+            TTestArrowStream stream(std::move(batches));
+
+            UNIT_ASSERT_EXCEPTION(
+                ReadArrowDataset(&stream, AsStringBuf("0\tTarget\n1\tCateg\tc0\n")),
+                TCatBoostException
+            );
+        }
+    }
+}
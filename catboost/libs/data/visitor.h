@@ -16,10 +16,12 @@
 #include <catboost/private/libs/quantization_schema/schema.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/system/types.h>
 
 
@@ -102,6 +104,27 @@ namespace NCB {
 
         // for sparse float features default value is always assumed to be 0.0f
 
+        /* Bulk version of AddAllFloatFeatures for dense data of objects
+         *   [localObjectOffset, localObjectOffset + objectCount)
+         * features are in row-major order: [localObjectIdx - localObjectOffset][perTypeFeatureIdx]
+         *
+         * default implementation calls AddAllFloatFeatures for each object
+         */
+        virtual void AddAllFloatFeaturesBlock(
+            ui32 localObjectOffset,
+            ui32 objectCount,
+            TConstArrayRef<float> features
+        ) {
+            AddRowMajorBlockByObjects(
+                localObjectOffset,
+                objectCount,
+                features,
+                [this] (ui32 localObjectIdx, TConstArrayRef<float> objectFeatures) {
+                    AddAllFloatFeatures(localObjectIdx, objectFeatures);
+                }
+            );
+        }
+
         virtual ui32 GetCatFeatureValue(ui32 flatFeatureIdx, TStringBuf feature) = 0;
         // localObjectIdx may be used as hint for sampling
         virtual ui32 GetCatFeatureValue(ui32 /* localObjectIdx */, ui32 flatFeatureIdx, TStringBuf feature) {
@@ -114,6 +137,22 @@ namespace NCB {
             TConstPolymorphicValuesSparseArray<ui32, ui32> features
         ) = 0;
 
+        // bulk version of AddAllCatFeatures, same layout as in AddAllFloatFeaturesBlock
+        virtual void AddAllCatFeaturesBlock(
+            ui32 localObjectOffset,
+            ui32 objectCount,
+            TConstArrayRef<ui32> features
+        ) {
+            AddRowMajorBlockByObjects(
+                localObjectOffset,
+                objectCount,
+                features,
+                [this] (ui32 localObjectIdx, TConstArrayRef<ui32> objectFeatures) {
+                    AddAllCatFeatures(localObjectIdx, objectFeatures);
+                }
+            );
+        }
+
         // for sparse data
         virtual void AddCatFeatureDefaultValue(ui32 flatFeatureIdx, TStringBuf feature) = 0;
 
@@ -141,8 +180,32 @@ namespace NCB {
         virtual void AddWeight(ui32 localObjectIdx, float value) = 0;
         virtual void AddGroupWeight(ui32 localObjectIdx, float value) = 0;
 
+        // bulk version of AddTarget for objects [localObjectOffset, localObjectOffset + values.size())
+        virtual void AddTargetBlock(ui32 flatTargetIdx, ui32 localObjectOffset, TConstArrayRef<float> values) {
+            for (auto i : xrange(SafeIntegerCast<ui32>(values.size()))) {
+                AddTarget(flatTargetIdx, localObjectOffset + i, values[i]);
+            }
+        }
+
         virtual void Finish() = 0;
 
+    private:
+        template <class T, class TAddObjectFunc>
+        static void AddRowMajorBlockByObjects(
+            ui32 localObjectOffset,
+            ui32 objectCount,
+            TConstArrayRef<T> features,
+            TAddObjectFunc&& addObjectFunc
+        ) {
+            if (!objectCount) {
+                return;
+            }
+            const size_t featureCount = features.size() / objectCount;
+            Y_ASSERT(features.size() == featureCount * objectCount);
+            for (auto i : xrange(objectCount)) {
+                addObjectFunc(localObjectOffset + i, features.subspan(i * featureCount, featureCount));
+            }
+        }
     };
 
 
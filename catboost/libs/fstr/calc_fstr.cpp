@@ -2,6 +2,7 @@
 
 #include "compare_documents.h"
 #include "feature_str.h"
+#include "loss_function_change.h"
 #include "shap_values.h"
 #include "shap_interaction_values.h"
 #include "util.h"
@@ -263,7 +264,11 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
     }
 
     ui32 totalDocumentCount = dataProvider.ObjectsData->GetObjectCount();
-    ui32 maxDocuments = Min(totalDocumentCount, Max(ui32(2e5), ui32(2e9 / dataProvider.ObjectsData->GetFeaturesLayout()->GetExternalFeatureCount())));
+    // for symmetric trees SHAP values are precalculated by leaf and only trees that use each feature are processed
+    //  (see TFeatureLossChangeCalcer), so the whole dataset is used
+    ui32 maxDocuments = model.IsOblivious()
+        ? totalDocumentCount
+        : Min(totalDocumentCount, Max(ui32(2e5), ui32(2e9 / dataProvider.ObjectsData->GetFeaturesLayout()->GetExternalFeatureCount())));
 
     const auto dataset = GetSubset(dataProvider, maxDocuments, localExecutor);
 
@@ -294,6 +299,10 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
         &preparedTrees,
         calcType
     );
+    THolder<TFeatureLossChangeCalcer> featureLossChangeCalcer;
+    if (model.IsOblivious() && preparedTrees.CalcShapValuesByLeafForAllTrees) {
+        featureLossChangeCalcer = MakeHolder<TFeatureLossChangeCalcer>(model, preparedTrees, featuresCount);
+    }
     TVector<TMetricHolder> scores(featuresCount + 1);
 
     TConstArrayRef<TQueryInfo> targetQueriesInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());
@@ -303,6 +312,13 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
 
     ui32 blockCount = queriesInfo.empty() ? documentCount : queriesInfo.size();
     ui32 blockSize = Min(ui32(10000), ui32(1e6) / (featuresCount * approx.ysize())); // shapValues[blockSize][featuresCount][dim] double
+    if (featureLossChangeCalcer) {
+        ui32 maxQuerySize = 1;
+        for (const auto& query : queriesInfo) {
+            maxQuerySize = Max(maxQuerySize, query.GetSize());
+        }
+        blockSize = Max(featureLossChangeCalcer->GetMaxDocumentBlockSize(localExecutor->GetThreadCount()) / maxQuerySize, ui32(1));
+    }
 
     NCatboostOptions::TLossDescription lossDescription;
     CB_ENSURE(TryGetLossDescription(model, &lossDescription), "No loss_function in model params");
@@ -348,39 +364,64 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
                 localExecutor
             );
         }
-        scores.back().Add(
-            metric->Eval(approx, targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd, *localExecutor)
+        const TMetricHolder baseScore = metric->Eval(
+            approx,
+            targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()),
+            GetWeights(*targetData),
+            queriesInfo,
+            queryBegin,
+            queryEnd,
+            *localExecutor
         );
-        TVector<TVector<TVector<double>>> shapValues;
-        CalcShapValuesInternalForFeature(
-            preparedTrees,
-            model,
-            0,
-            begin,
-            end,
-            featuresCount,
-            objectsData,
-            &shapValues,
-            localExecutor,
-            calcType);
-
-        for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
-            NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
-            blockParams.SetBlockCountToThreadCount();
-            localExecutor->ExecRange([&](ui32 docIdx) {
-                for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
-                }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-            scores[featureIdx].Add(
-                    metric->Eval(approx, targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd,
-                                 *localExecutor)
+        scores.back().Add(baseScore);
+        if (featureLossChangeCalcer) {
+            featureLossChangeCalcer->AddScores(
+                objectsData,
+                *metric,
+                approx,
+                targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()),
+                GetWeights(*targetData),
+                queriesInfo,
+                queryBegin,
+                queryEnd,
+                begin,
+                end,
+                baseScore,
+                localExecutor,
+                &scores
             );
-            localExecutor->ExecRange([&](ui32 docIdx) {
-                for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] += shapValues[docIdx - begin][featureIdx][dimensionIdx];
-                }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+        } else {
+            TVector<TVector<TVector<double>>> shapValues;
+            CalcShapValuesInternalForFeature(
+                preparedTrees,
+                model,
+                0,
+                begin,
+                end,
+                featuresCount,
+                objectsData,
+                &shapValues,
+                localExecutor,
+                calcType);
+
+            for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
+                NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
+                blockParams.SetBlockCountToThreadCount();
+                localExecutor->ExecRange([&](ui32 docIdx) {
+                    for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
+                        approx[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                    }
+                }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+                scores[featureIdx].Add(
+                        metric->Eval(approx, targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd,
+                                     *localExecutor)
+                );
+                localExecutor->ExecRange([&](ui32 docIdx) {
+                    for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
+                        approx[dimensionIdx][docIdx] += shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                    }
+                }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+            }
         }
         if (needYetiRankPairs) {
             for (ui32 queryIndex = queryBegin; queryIndex < queryEnd; ++queryIndex) {
@@ -0,0 +1,181 @@
+#include "loss_function_change.h"
+
+#include <catboost/private/libs/algo/model_quantization_adapter.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/model/cpu/quantization.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+
+using namespace NCB;
+
+
+// leaf indices of a block of documents for all trees and per worker approx buffers take at most this amount of memory
+static constexpr ui64 MaxDocumentBlockBuffersSize = 256 << 20;
+
+
+TFeatureLossChangeCalcer::TFeatureLossChangeCalcer(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    int featuresCount
+)
+    : Model(model)
+    , ApproxDimension(model.ModelTrees->GetDimensionsCount())
+    , FeatureTrees(featuresCount)
+{
+    CB_ENSURE_INTERNAL(
+        model.IsOblivious() && preparedTrees.CalcShapValuesByLeafForAllTrees,
+        "TFeatureLossChangeCalcer requires symmetric trees with SHAP values precalculated by leaf"
+    );
+    const auto treeSizes = model.ModelTrees->GetTreeSizes();
+    for (auto treeIdx : xrange(model.GetTreeCount())) {
+        const size_t leafCount = size_t(1) << treeSizes[treeIdx];
+        const auto& shapValuesByLeaf = preparedTrees.ShapValuesByLeafForAllTrees[treeIdx];
+
+        // index in FeatureTrees[featureIdx] for features used in this tree
+        TVector<int> featureTreeIdx(featuresCount, -1);
+        for (auto leafIdx : xrange(leafCount)) {
+            for (const TShapValue& shapValue : shapValuesByLeaf[leafIdx]) {
+                auto& featureTrees = FeatureTrees[shapValue.Feature];
+                if (featureTreeIdx[shapValue.Feature] == -1) {
+                    featureTreeIdx[shapValue.Feature] = featureTrees.ysize();
+                    featureTrees.emplace_back();
+                    featureTrees.back().TreeIdx = treeIdx;
+                    featureTrees.back().LeafContributions.resize(leafCount * ApproxDimension);
+                }
+                double* leafContributions
+                    = featureTrees[featureTreeIdx[shapValue.Feature]].LeafContributions.data()
+                        + leafIdx * ApproxDimension;
+                for (auto dimension : xrange(ApproxDimension)) {
+                    leafContributions[dimension] += shapValue.Value[dimension];
+                }
+            }
+        }
+    }
+}
+
+int TFeatureLossChangeCalcer::GetWorkerCount(int threadCount) const {
+    return Max<int>(Min<int>(threadCount + 1, FeatureTrees.size()), 1);
+}
+
+ui32 TFeatureLossChangeCalcer::GetMaxDocumentBlockSize(int threadCount) const {
+    const ui64 leafIndicesSize = Model.GetTreeCount() * sizeof(NModelEvaluation::TCalcerIndexType);
+    // featureApprox and contributions in each worker
+    const ui64 workerBuffersSize = GetWorkerCount(threadCount) * (ApproxDimension + 1) * sizeof(double);
+    return Max<ui64>(Min<ui64>(MaxDocumentBlockBuffersSize / (leafIndicesSize + workerBuffersSize), Max<ui32>()), 1);
+}
+
+void TFeatureLossChangeCalcer::AddScores(
+    const TObjectsDataProvider& objectsData,
+    const IMetric& metric,
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weights,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    ui32 queryBegin,
+    ui32 queryEnd,
+    ui32 begin,
+    ui32 end,
+    const TMetricHolder& baseScore,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TMetricHolder>* scores
+) const {
+    CB_ENSURE(begin <= end && end <= objectsData.GetObjectCount());
+    const ui32 documentCount = end - begin;
+    const size_t treeCount = Model.GetTreeCount();
+    const ui32 featuresCount = FeatureTrees.size();
+
+    // [treeIdx * documentCount + documentIdx]
+    TVector<NModelEvaluation::TCalcerIndexType> leafIndices;
+    leafIndices.yresize(treeCount * documentCount);
+    {
+        const ui32 chunkSize = NModelEvaluation::FORMULA_EVALUATION_BLOCK_SIZE;
+        localExecutor->ExecRangeWithThrow(
+            [&] (int chunkIdx) {
+                const ui32 chunkBegin = chunkIdx * chunkSize;
+                const ui32 chunkEnd = Min(chunkBegin + chunkSize, documentCount);
+                const ui32 chunkDocumentCount = chunkEnd - chunkBegin;
+                auto quantizedFeatures = MakeQuantizedFeaturesForEvaluator(
+                    Model,
+                    objectsData,
+                    begin + chunkBegin,
+                    begin + chunkEnd
+                );
+                TVector<NModelEvaluation::TCalcerIndexType> chunkLeafIndices(chunkDocumentCount * treeCount);
+                Model.GetCurrentEvaluator()->CalcLeafIndexes(quantizedFeatures.Get(), 0, treeCount, chunkLeafIndices);
+                for (auto documentIdx : xrange(chunkDocumentCount)) {
+                    for (auto treeIdx : xrange(treeCount)) {
+                        leafIndices[treeIdx * documentCount + chunkBegin + documentIdx]
+                            = chunkLeafIndices[documentIdx * treeCount + treeIdx];
+                    }
+                }
+            },
+            0,
+            CeilDiv(documentCount, chunkSize),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+    // metric is evaluated on the block only, so object indices in queries are shifted to the block start
+    TVector<TQueryInfo> blockQueriesInfo;
+    ui32 evalEnd = documentCount;
+    if (!queriesInfo.empty()) {
+        blockQueriesInfo.assign(queriesInfo.begin() + queryBegin, queriesInfo.begin() + queryEnd);
+        for (auto& queryInfo : blockQueriesInfo) {
+            queryInfo.Begin -= begin;
+            queryInfo.End -= begin;
+        }
+        evalEnd = queryEnd - queryBegin;
+    }
+    const TConstArrayRef<float> blockTarget = target.empty() ? target : target.subspan(begin, documentCount);
+    const TConstArrayRef<float> blockWeights = weights.empty() ? weights : weights.subspan(begin, documentCount);
+
+    const int workerCount = GetWorkerCount(localExecutor->GetThreadCount());
+    localExecutor->ExecRangeWithThrow(
+        [&] (int workerIdx) {
+            // metric evaluation is sequential, features are processed in parallel
+            NPar::TLocalExecutor sequentialExecutor;
+            TVector<TVector<double>> featureApprox(ApproxDimension, TVector<double>(documentCount));
+            TVector<double> contributions(documentCount);
+            for (ui32 featureIdx = workerIdx; featureIdx < featuresCount; featureIdx += workerCount) {
+                const auto& featureTrees = FeatureTrees[featureIdx];
+                if (featureTrees.empty()) {
+                    (*scores)[featureIdx].Add(baseScore);
+                    continue;
+                }
+                for (auto dimension : xrange(ApproxDimension)) {
+                    Fill(contributions.begin(), contributions.end(), 0.0);
+                    for (const auto& featureTree : featureTrees) {
+                        const auto* treeLeafIndices = leafIndices.data() + featureTree.TreeIdx * documentCount;
+                        const double* leafContributions = featureTree.LeafContributions.data();
+                        for (auto documentIdx : xrange(documentCount)) {
+                            contributions[documentIdx]
+                                += leafContributions[treeLeafIndices[documentIdx] * ApproxDimension + dimension];
+                        }
+                    }
+                    const double* docApprox = approx[dimension].data() + begin;
+                    double* docFeatureApprox = featureApprox[dimension].data();
+                    for (auto documentIdx : xrange(documentCount)) {
+                        docFeatureApprox[documentIdx] = docApprox[documentIdx] - contributions[documentIdx];
+                    }
+                }
+                (*scores)[featureIdx].Add(
+                    metric.Eval(
+                        featureApprox,
+                        blockTarget,
+                        blockWeights,
+                        blockQueriesInfo,
+                        0,
+                        evalEnd,
+                        sequentialExecutor
+                    )
+                );
+            }
+        },
+        0,
+        workerCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "shap_prepared_trees.h"
+
+#include <catboost/libs/data/objects.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/private/libs/data_types/query.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+/*
+ * Evaluates metric on approxes with the contribution (SHAP value) of each feature removed for symmetric trees
+ *   with SHAP values precalculated by leaf (preparedTrees.CalcShapValuesByLeafForAllTrees).
+ *
+ * Trees that use each feature are indexed once, leaf indices are calculated once for all trees and for each
+ *   feature only the contributions of its trees are subtracted, so the cost per feature is proportional to the
+ *   number of trees that use it. Features are processed in parallel.
+ */
+class TFeatureLossChangeCalcer {
+public:
+    TFeatureLossChangeCalcer(
+        const TFullModel& model,
+        const TShapPreparedTrees& preparedTrees,
+        int featuresCount
+    );
+
+    /*
+     * Adds metric values with contributions of each feature removed for objects [begin, end)
+     *   (queries [queryBegin, queryEnd) if queriesInfo is not empty) to (*scores)[featureIdx].
+     * baseScore is the metric value for the same objects with unchanged approx.
+     */
+    void AddScores(
+        const NCB::TObjectsDataProvider& objectsData,
+        const IMetric& metric,
+        const TVector<TVector<double>>& approx, // [dim][docIdx]
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weights,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        ui32 queryBegin,
+        ui32 queryEnd,
+        ui32 begin,
+        ui32 end,
+        const TMetricHolder& baseScore,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<TMetricHolder>* scores // [featureIdx]
+    ) const;
+
+    // Maximum number of documents for AddScores call to keep leaf indices and approx buffers in memory limits.
+    ui32 GetMaxDocumentBlockSize(int threadCount) const;
+
+private:
+    struct TFeatureTree {
+        ui32 TreeIdx = 0;
+        TVector<double> LeafContributions; // [leafIdx * approxDimension + dimension]
+    };
+
+private:
+    // features are split between this number of workers in AddScores
+    int GetWorkerCount(int threadCount) const;
+
+private:
+    const TFullModel& Model;
+    int ApproxDimension;
+    TVector<TVector<TFeatureTree>> FeatureTrees; // [featureIdx]
+};
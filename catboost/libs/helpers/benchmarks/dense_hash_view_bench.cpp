@@ -0,0 +1,87 @@
+#include <catboost/libs/helpers/dense_hash_view.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using namespace NCatboost;
+
+// batched lookups of random hashes, half of them are present in the index
+struct THashViewBenchData {
+    static constexpr size_t BatchSize = 4096;
+    static constexpr size_t BatchCount = 16;
+
+public:
+    explicit THashViewBenchData(size_t uniqueHashCount) {
+        TFastRng64 rand(0);
+        TVector<ui64> uniqueHashes;
+        for (auto i : xrange(uniqueHashCount)) {
+            Y_UNUSED(i);
+            uniqueHashes.push_back(rand.GenRand());
+        }
+
+        DenseBuckets.resize(TDenseIndexHashBuilder::GetProperBucketsCount(uniqueHashCount));
+        TDenseIndexHashBuilder denseBuilder(DenseBuckets);
+        FingerprintData.resize(TFingerprintIndexHashBuilder::GetProperDataSize(uniqueHashCount));
+        TFingerprintIndexHashBuilder fingerprintBuilder(FingerprintData);
+        for (auto i : xrange(uniqueHashCount)) {
+            denseBuilder.SetIndex(uniqueHashes[i], i);
+            fingerprintBuilder.SetIndex(uniqueHashes[i], i);
+        }
+
+        for (auto i : xrange(BatchSize * BatchCount)) {
+            Y_UNUSED(i);
+            Hashes.push_back(rand.GenRand() % 2 ? uniqueHashes[rand.Uniform(uniqueHashCount)] : rand.GenRand());
+        }
+        Indexes.resize(BatchSize);
+    }
+
+    template <class TView>
+    void Run(const TView& view, size_t iterations) {
+        for (auto i : xrange(iterations)) {
+            const TConstArrayRef<ui64> batchHashes(Hashes.data() + (i % BatchCount) * BatchSize, BatchSize);
+            view.GetIndexes(batchHashes, Indexes);
+            Y_DO_NOT_OPTIMIZE_AWAY(Indexes);
+        }
+    }
+
+public:
+    TVector<TBucket> DenseBuckets;
+    TVector<ui8> FingerprintData;
+    TVector<ui64> Hashes;
+    TVector<ui32> Indexes;
+};
+
+// fits into L2 cache
+static THashViewBenchData& GetSmallTableData() {
+    static THashViewBenchData data(1 << 14);
+    return data;
+}
+
+// much larger than LLC
+static THashViewBenchData& GetLargeTableData() {
+    static THashViewBenchData data(1 << 22);
+    return data;
+}
+
+Y_CPU_BENCHMARK(DenseIndexHashViewSmall, iface) {
+    auto& data = GetSmallTableData();
+    data.Run(TDenseIndexHashView(data.DenseBuckets), iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(FingerprintIndexHashViewSmall, iface) {
+    auto& data = GetSmallTableData();
+    data.Run(TFingerprintIndexHashView(data.FingerprintData), iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(DenseIndexHashViewLarge, iface) {
+    auto& data = GetLargeTableData();
+    data.Run(TDenseIndexHashView(data.DenseBuckets), iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(FingerprintIndexHashViewLarge, iface) {
+    auto& data = GetLargeTableData();
+    data.Run(TFingerprintIndexHashView(data.FingerprintData), iface.Iterations());
+}
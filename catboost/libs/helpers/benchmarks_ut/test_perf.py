@@ -0,0 +1,5 @@
+import yatest
+
+
+def test(metrics):
+    metrics.set_benchmark(yatest.common.execute_benchmark("catboost/libs/helpers/benchmarks/benchmarks"))
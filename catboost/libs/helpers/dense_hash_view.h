@@ -1,8 +1,17 @@
 #pragma once
 
+#include <library/cpp/sse/sse.h>
+
 #include <util/digest/numeric.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/utility.h>
+#include <util/generic/yexception.h>
+#include <util/system/compiler.h>
+#include <util/system/yassert.h>
+
+#include <cmath>
 
 namespace NCatboost {
 
@@ -54,6 +63,22 @@ namespace NCatboost {
             return NotFoundIndex;
         }
 
+        // batched GetIndex: home buckets of the following hashes are prefetched while probing the current one
+        void GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui32> indexes) const {
+            Y_ASSERT(hashes.size() == indexes.size());
+            constexpr size_t prefetchDistance = 8;
+            const size_t count = hashes.size();
+            for (size_t i = 0; i < Min(count, prefetchDistance); ++i) {
+                Y_PREFETCH_READ(Buckets.data() + (hashes[i] & HashMask), 3);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (i + prefetchDistance < count) {
+                    Y_PREFETCH_READ(Buckets.data() + (hashes[i + prefetchDistance] & HashMask), 3);
+                }
+                indexes[i] = GetIndex(hashes[i]);
+            }
+        }
+
         size_t CountNonEmptyBuckets() const {
             return CountIf(
                 Buckets,
@@ -118,4 +143,214 @@ namespace NCatboost {
         ui32 BinCount = 0;
         TArrayRef<TBucket> Buckets;
     };
+
+    /* Storage of TFingerprintIndexHashView is SlotCount 7-bit fingerprints followed by SlotCount buckets.
+     * Slots are probed by groups of GroupSize: fingerprints of all slots of a group are compared at once,
+     * buckets are read only for matching slots. Group fingerprints are 16 bytes in a separate array, so they never
+     * cross a cache line, and hash and index of a slot are adjacent, so a hit usually reads one more cache line.
+     */
+    struct TFingerprintIndexLayout {
+        static constexpr ui32 GroupSize = 16;
+        static constexpr ui8 EmptyFingerprint = 0x80;
+        static constexpr size_t SlotSize = sizeof(ui8) + sizeof(TBucket);
+        static constexpr size_t GroupDataSize = GroupSize * SlotSize;
+
+    public:
+        static ui8 GetFingerprint(ui64 hash) {
+            return (ui8)(hash >> 57);
+        }
+
+        // bit i is set if groupFingerprints[i] == fingerprint
+        static ui32 MatchFingerprint(const ui8* groupFingerprints, ui8 fingerprint) {
+#ifdef ARCADIA_SSE
+            const __m128i fingerprints = _mm_loadu_si128((const __m128i*)groupFingerprints);
+            return (ui32)_mm_movemask_epi8(_mm_cmpeq_epi8(fingerprints, _mm_set1_epi8((char)fingerprint)));
+#else
+            ui32 result = 0;
+            for (ui32 slot = 0; slot < GroupSize; ++slot) {
+                result |= ui32(groupFingerprints[slot] == fingerprint) << slot;
+            }
+            return result;
+#endif
+        }
+
+        static size_t GetGroupCount(size_t dataSize) {
+            Y_ENSURE(
+                dataSize != 0 && dataSize % GroupDataSize == 0,
+                "Fingerprint hash view data size must be a positive multiple of " << GroupDataSize
+            );
+            return dataSize / GroupDataSize;
+        }
+    };
+
+    /* Compact alternative to TDenseIndexHashView for large tables: 13 bytes per slot at 7/8 load factor
+     * instead of 12 bytes per bucket at 1/4..1/2 load factor, home group is hash % GroupCount
+     * so there's no rounding of the table size to a power of 2
+     */
+    class TFingerprintIndexHashView {
+    public:
+        static_assert(TFingerprintIndexLayout::SlotSize == 13, "Expected 13 bytes per fingerprint hash view slot");
+        static constexpr ui32 NotFoundIndex = TDenseIndexHashView::NotFoundIndex;
+
+    public:
+        explicit TFingerprintIndexHashView(TConstArrayRef<ui8> data)
+            : GroupCount(TFingerprintIndexLayout::GetGroupCount(data.size()))
+            , Fingerprints(data.data())
+            , Buckets((const TBucket*)(data.data() + GroupCount * TFingerprintIndexLayout::GroupSize))
+        {
+        }
+
+        size_t GetGroupCount() const {
+            return GroupCount;
+        }
+
+        ui32 GetIndex(ui64 hash) const {
+            const ui8 fingerprint = TFingerprintIndexLayout::GetFingerprint(hash);
+            // builder guarantees that there's an empty slot so the loop terminates
+            for (size_t groupIdx = hash % GroupCount; ; groupIdx = NextGroup(groupIdx)) {
+                const ui8* groupFingerprints = GetGroupFingerprints(groupIdx);
+                const TBucket* groupBuckets = GetGroupBuckets(groupIdx);
+                for (ui32 matches = TFingerprintIndexLayout::MatchFingerprint(groupFingerprints, fingerprint);
+                     matches;
+                     matches &= matches - 1)
+                {
+                    const TBucket& bucket = groupBuckets[CountTrailingZeroBits(matches)];
+                    if (bucket.Hash == hash) {
+                        return bucket.IndexValue;
+                    }
+                }
+                if (TFingerprintIndexLayout::MatchFingerprint(groupFingerprints, TFingerprintIndexLayout::EmptyFingerprint)) {
+                    return NotFoundIndex;
+                }
+            }
+        }
+
+        /* batched GetIndex with two prefetch stages: home group fingerprints of hashes 2 * prefetchDistance ahead,
+         * then the bucket of the first fingerprint match for hashes prefetchDistance ahead
+         */
+        void GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui32> indexes) const {
+            Y_ASSERT(hashes.size() == indexes.size());
+            constexpr size_t prefetchDistance = 8;
+            const size_t count = hashes.size();
+            for (size_t i = 0; i < Min(count, 2 * prefetchDistance); ++i) {
+                PrefetchFingerprints(hashes[i]);
+            }
+            for (size_t i = 0; i < Min(count, prefetchDistance); ++i) {
+                PrefetchBucket(hashes[i]);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (i + 2 * prefetchDistance < count) {
+                    PrefetchFingerprints(hashes[i + 2 * prefetchDistance]);
+                }
+                if (i + prefetchDistance < count) {
+                    PrefetchBucket(hashes[i + prefetchDistance]);
+                }
+                indexes[i] = GetIndex(hashes[i]);
+            }
+        }
+
+        template <class TFunc> // TFunc(ui64 hash, ui32 index)
+        void ForEachIndex(TFunc&& func) const {
+            for (size_t slot = 0; slot < GroupCount * TFingerprintIndexLayout::GroupSize; ++slot) {
+                if (Fingerprints[slot] != TFingerprintIndexLayout::EmptyFingerprint) {
+                    func(Buckets[slot].Hash, Buckets[slot].IndexValue);
+                }
+            }
+        }
+
+    private:
+        size_t NextGroup(size_t groupIdx) const {
+            return (groupIdx + 1 == GroupCount) ? 0 : groupIdx + 1;
+        }
+
+        const ui8* GetGroupFingerprints(size_t groupIdx) const {
+            return Fingerprints + groupIdx * TFingerprintIndexLayout::GroupSize;
+        }
+
+        const TBucket* GetGroupBuckets(size_t groupIdx) const {
+            return Buckets + groupIdx * TFingerprintIndexLayout::GroupSize;
+        }
+
+        void PrefetchFingerprints(ui64 hash) const {
+            Y_PREFETCH_READ(GetGroupFingerprints(hash % GroupCount), 3);
+        }
+
+        // only home group is considered, fingerprints are expected to be already in cache
+        void PrefetchBucket(ui64 hash) const {
+            const size_t groupIdx = hash % GroupCount;
+            const ui32 matches = TFingerprintIndexLayout::MatchFingerprint(
+                GetGroupFingerprints(groupIdx),
+                TFingerprintIndexLayout::GetFingerprint(hash));
+            if (matches) {
+                Y_PREFETCH_READ(GetGroupBuckets(groupIdx) + CountTrailingZeroBits(matches), 3);
+            }
+        }
+
+    private:
+        size_t GroupCount = 0;
+        const ui8* Fingerprints = nullptr;
+        const TBucket* Buckets = nullptr;
+    };
+
+    class TFingerprintIndexHashBuilder {
+    public:
+        explicit TFingerprintIndexHashBuilder(TArrayRef<ui8> data)
+            : GroupCount(TFingerprintIndexLayout::GetGroupCount(data.size()))
+            , Fingerprints(data.data())
+            , Buckets((TBucket*)(data.data() + GroupCount * TFingerprintIndexLayout::GroupSize))
+        {
+            const size_t slotCount = GroupCount * TFingerprintIndexLayout::GroupSize;
+            std::fill(Fingerprints, Fingerprints + slotCount, TFingerprintIndexLayout::EmptyFingerprint);
+            const TBucket emptyBucket = {TBucket::InvalidHashValue, 0};
+            std::fill(Buckets, Buckets + slotCount, emptyBucket);
+        }
+
+        void SetIndex(ui64 hash, ui32 index) {
+            const ui8 fingerprint = TFingerprintIndexLayout::GetFingerprint(hash);
+            for (size_t groupIdx = hash % GroupCount, probeCount = 0;
+                 probeCount < GroupCount;
+                 groupIdx = (groupIdx + 1 == GroupCount) ? 0 : groupIdx + 1, ++probeCount)
+            {
+                ui8* groupFingerprints = Fingerprints + groupIdx * TFingerprintIndexLayout::GroupSize;
+                TBucket* groupBuckets = Buckets + groupIdx * TFingerprintIndexLayout::GroupSize;
+                for (ui32 matches = TFingerprintIndexLayout::MatchFingerprint(groupFingerprints, fingerprint);
+                     matches;
+                     matches &= matches - 1)
+                {
+                    const TBucket& bucket = groupBuckets[CountTrailingZeroBits(matches)];
+                    if (bucket.Hash == hash) {
+                        Y_ASSERT(bucket.IndexValue == index);
+                        return;
+                    }
+                }
+                const ui32 emptySlots = TFingerprintIndexLayout::MatchFingerprint(
+                    groupFingerprints,
+                    TFingerprintIndexLayout::EmptyFingerprint);
+                if (emptySlots) {
+                    const ui32 slot = CountTrailingZeroBits(emptySlots);
+                    groupFingerprints[slot] = fingerprint;
+                    groupBuckets[slot] = {hash, index};
+                    ++ElementCount;
+                    // lookups stop at the first group with an empty slot
+                    Y_ENSURE(ElementCount < GroupCount * TFingerprintIndexLayout::GroupSize, "Fingerprint hash view is full");
+                    return;
+                }
+            }
+            ythrow yexception() << "Fingerprint hash view is full";
+        }
+
+        // size of the data in bytes
+        static size_t GetProperDataSize(size_t uniqueElementsCount, float loadFactor = 0.875f) {
+            const size_t slotCount = (size_t)std::ceil(uniqueElementsCount / loadFactor);
+            // at least one slot must stay empty
+            const size_t groupCount = slotCount / TFingerprintIndexLayout::GroupSize + 1;
+            return groupCount * TFingerprintIndexLayout::GroupDataSize;
+        }
+
+    private:
+        size_t ElementCount = 0;
+        size_t GroupCount = 0;
+        ui8* Fingerprints = nullptr;
+        TBucket* Buckets = nullptr;
+    };
 }
@@ -0,0 +1,85 @@
+#include <catboost/libs/helpers/dense_hash_view.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+using namespace NCatboost;
+
+
+Y_UNIT_TEST_SUITE(TDenseIndexHashViewTest) {
+    Y_UNIT_TEST(TestGetIndexes) {
+        TFastRng64 rand(0);
+
+        const size_t uniqueHashCount = 1000;
+        TVector<TBucket> buckets(TDenseIndexHashBuilder::GetProperBucketsCount(uniqueHashCount));
+        TDenseIndexHashBuilder builder(buckets);
+        TVector<ui64> hashes;
+        for (auto i : xrange(uniqueHashCount)) {
+            Y_UNUSED(i);
+            hashes.push_back(rand.GenRand());
+            builder.AddIndex(hashes.back());
+        }
+        // absent hashes
+        for (auto i : xrange(uniqueHashCount)) {
+            Y_UNUSED(i);
+            hashes.push_back(rand.GenRand());
+        }
+
+        TDenseIndexHashView view(buckets);
+        TVector<ui32> indexes(hashes.size());
+        view.GetIndexes(hashes, indexes);
+        for (auto i : xrange(hashes.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(indexes[i], view.GetIndex(hashes[i]));
+            if (i < uniqueHashCount) {
+                UNIT_ASSERT_VALUES_EQUAL(indexes[i], i);
+            }
+        }
+
+        // shorter than prefetch distance
+        view.GetIndexes(MakeArrayRef(hashes.data(), 3), MakeArrayRef(indexes.data(), 3));
+        for (auto i : xrange(3)) {
+            UNIT_ASSERT_VALUES_EQUAL(indexes[i], (ui32)i);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TFingerprintIndexHashViewTest) {
+    Y_UNIT_TEST(TestGetIndex) {
+        TFastRng64 rand(0);
+
+        for (size_t uniqueHashCount : {0, 1, 15, 16, 1000}) {
+            TVector<ui8> data(TFingerprintIndexHashBuilder::GetProperDataSize(uniqueHashCount));
+            TFingerprintIndexHashBuilder builder(data);
+            TVector<ui64> hashes;
+            for (auto i : xrange(uniqueHashCount)) {
+                hashes.push_back(rand.GenRand());
+                builder.SetIndex(hashes.back(), i);
+            }
+            // absent hashes
+            for (auto i : xrange(uniqueHashCount + 1)) {
+                Y_UNUSED(i);
+                hashes.push_back(rand.GenRand());
+            }
+
+            TFingerprintIndexHashView view(data);
+            TVector<ui32> indexes(hashes.size());
+            view.GetIndexes(hashes, indexes);
+            for (auto i : xrange(hashes.size())) {
+                UNIT_ASSERT_VALUES_EQUAL(indexes[i], view.GetIndex(hashes[i]));
+                const ui32 expected = i < uniqueHashCount ? (ui32)i : TFingerprintIndexHashView::NotFoundIndex;
+                UNIT_ASSERT_VALUES_EQUAL(indexes[i], expected);
+            }
+
+            size_t visitedCount = 0;
+            view.ForEachIndex([&](ui64 hash, ui32 index) {
+                UNIT_ASSERT_VALUES_EQUAL(hashes[index], hash);
+                ++visitedCount;
+            });
+            UNIT_ASSERT_VALUES_EQUAL(visitedCount, uniqueHashCount);
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "quantization.h"
 
+#include <util/generic/ptr.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
 
@@ -34,6 +35,34 @@ namespace NCB::NModelEvaluation {
         size_t docCountInBlock,
         bool calcIndexesOnly = false);
 
+    /**
+     * Compact copy of model leaf values for models whose leaf table doesn't fit in CPU cache.
+     * Stored value v of tree t is restored as TreeBiases[t] + TreeScales[t] * v. For Float precision scale is 1
+     *  and bias is 0, for UI16 and UI8 leaf values of each tree are uniformly quantized between their min and max.
+     * MaxAbsError bounds the error of the restored sum of raw leaf values over all trees (before model scale):
+     *  Float: sum over trees of max |leaf value| * 2^-24,
+     *  UI16, UI8: sum over trees of (max leaf value - min leaf value) / (2 * (2^bits - 1)).
+     * Restored values are accumulated in double: the results of a document block stay in L1 cache anyway, and
+     *  float accumulation would add rounding error growing with the number of trees beyond MaxAbsError.
+     */
+    struct TCompactLeafValues {
+        ELeafValuesPrecision Precision = ELeafValuesPrecision::Double;
+        TVector<float> FloatValues;
+        TVector<ui16> UI16Values;
+        TVector<ui8> UI8Values;
+        TVector<double> TreeScales;
+        TVector<double> TreeBiases;
+        double MaxAbsError = 0.0;
+    };
+
+    TCompactLeafValues BuildCompactLeafValues(const TModelTrees& trees, ELeafValuesPrecision precision);
+
+    //! Same as GetCalcTreesFunction, but takes leaf values from leafValues, the function holds a reference to them
+    TTreeCalcFunction GetCalcTreesWithCompactLeafValuesFunction(
+        const TModelTrees& trees,
+        TAtomicSharedPtr<const TCompactLeafValues> leafValues,
+        size_t docCountInBlock);
+
     template <class X>
     inline X* GetAligned(X* val) {
         uintptr_t off = ((uintptr_t)val) & 0xf;
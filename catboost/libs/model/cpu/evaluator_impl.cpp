@@ -3,9 +3,12 @@
 #include <library/cpp/sse/sse.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/xrange.h>
 #include <util/stream/format.h>
 #include <util/system/compiler.h>
 
+#include <cmath>
 #include <cstring>
 
 namespace NCB::NModelEvaluation {
@@ -282,7 +285,7 @@ namespace NCB::NModelEvaluation {
                     resultsTmpArray.yresize(docCountInBlock * trees.GetDimensionsCount());
                     alignedResultsPtr = resultsTmpArray.data();
                 }
-                memset(alignedResultsPtr, 0, neededMemory);
+                memcpy(alignedResultsPtr, resultsPtr, neededMemory);
             }
             auto treeEnd4 = treeStart + (((treeEnd - treeStart) | 0x3) ^ 0x3);
             for (size_t treeId = treeStart; treeId < treeEnd4; treeId += 4) {
@@ -692,6 +695,85 @@ namespace NCB::NModelEvaluation {
 #endif
 
 
+    /* QuickScorer evaluation of non-symmetric trees without one-hot splits:
+     *  for each split that the document goes right on, exits on its left side are cleared from
+     *  the tree bitvector, the lowest remaining exit is the one reached by the document.
+     */
+    template <bool IsSingleClassModel, bool CalcLeafIndexesOnly = false>
+    inline void CalcNonSymmetricTreesBitvectors(
+        const TModelTrees& trees,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict resultsPtr
+    ) {
+        constexpr size_t chunkSize = TNonSymmetricTreesBitvectors::TreeChunkSize;
+        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+        const auto& bitvectors = trees.GetNonSymmetricTreesBitvectors();
+        const ui8* __restrict splitIdxPtr = bitvectors.SplitIdx.data();
+        const ui8* __restrict splitTreeIdxPtr = bitvectors.SplitTreeIdxInChunk.data();
+        const ui64* __restrict splitRightMasksPtr = bitvectors.SplitRightMasks.data();
+        const ui32* __restrict exitLeafValueOffsetsPtr = bitvectors.ExitLeafValueOffsets.data();
+        const double* __restrict leafValuesPtr = trees.GetLeafValues().data();
+        const auto firstLeafOffsets = trees.GetFirstLeafOffsets();
+        const auto approxDimension = trees.GetDimensionsCount();
+
+        Y_ASSERT(docCountInBlock <= FORMULA_EVALUATION_BLOCK_SIZE);
+        ui64 exitMasks[chunkSize * FORMULA_EVALUATION_BLOCK_SIZE]; // [treeIdxInChunk][docId]
+
+        for (size_t chunkStart = treeStart - treeStart % chunkSize; chunkStart < treeEnd; chunkStart += chunkSize) {
+            std::fill(exitMasks, exitMasks + chunkSize * docCountInBlock, Max<ui64>());
+            const size_t chunkIdx = chunkStart / chunkSize;
+            for (auto featureSplitsIdx : xrange(
+                bitvectors.ChunkFeatureSplitsOffsets[chunkIdx],
+                bitvectors.ChunkFeatureSplitsOffsets[chunkIdx + 1]))
+            {
+                const auto& featureSplits = bitvectors.FeatureSplits[featureSplitsIdx];
+                const ui8* __restrict binFeaturePtr = binFeatures + featureSplits.FeatureIndex * docCountInBlock;
+                const ui8 maxFeatureValue = *MaxElement(binFeaturePtr, binFeaturePtr + docCountInBlock);
+                for (ui32 splitId = featureSplits.SplitsBegin; splitId < featureSplits.SplitsEnd; ++splitId) {
+                    const ui8 borderVal = splitIdxPtr[splitId];
+                    if (borderVal > maxFeatureValue) {
+                        break;
+                    }
+                    const ui64 rightMask = splitRightMasksPtr[splitId];
+                    ui64* __restrict treeExitMasks = exitMasks + splitTreeIdxPtr[splitId] * docCountInBlock;
+                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                        treeExitMasks[docId] &= (binFeaturePtr[docId] >= borderVal) ? rightMask : Max<ui64>();
+                    }
+                }
+            }
+            for (size_t treeId = Max(chunkStart, treeStart); treeId < Min(chunkStart + chunkSize, treeEnd); ++treeId) {
+                const ui64* __restrict treeExitMasks = exitMasks + (treeId - chunkStart) * docCountInBlock;
+                const ui32* __restrict treeExitLeafValueOffsets =
+                    exitLeafValueOffsetsPtr + bitvectors.TreeExitsOffsets[treeId];
+                if constexpr (CalcLeafIndexesOnly) {
+                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                        const ui32 firstValueIdx = treeExitLeafValueOffsets[CountTrailingZeroBits(treeExitMasks[docId])];
+                        Y_ASSERT((firstValueIdx - firstLeafOffsets[treeId]) % approxDimension == 0);
+                        indexesVec[docId] = ((firstValueIdx - firstLeafOffsets[treeId]) / approxDimension);
+                    }
+                    indexesVec += docCountInBlock;
+                } else if constexpr (IsSingleClassModel) {
+                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                        resultsPtr[docId] +=
+                            leafValuesPtr[treeExitLeafValueOffsets[CountTrailingZeroBits(treeExitMasks[docId])]];
+                    }
+                } else {
+                    auto resultWritePtr = resultsPtr;
+                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                        const ui32 firstValueIdx = treeExitLeafValueOffsets[CountTrailingZeroBits(treeExitMasks[docId])];
+                        for (int classId = 0; classId < (int)approxDimension; ++classId, ++resultWritePtr) {
+                            *resultWritePtr += leafValuesPtr[firstValueIdx + classId];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     template <bool IsSingleClassModel, bool NeedXorMask, bool CalcIndexesOnly>
     inline void CalcNonSymmetricTreesSingle(
         const TModelTrees& trees,
@@ -760,6 +842,13 @@ namespace NCB::NModelEvaluation {
         }
     };
 
+    template <bool IsSingleClassModel, bool CalcLeafIndexesOnly>
+    struct CalcNonSymmetricTreesBitvectorsInstantiationGetter {
+        TTreeCalcFunction operator()() const {
+            return CalcNonSymmetricTreesBitvectors<IsSingleClassModel, CalcLeafIndexesOnly>;
+        }
+    };
+
     template <template <bool...> class TFunctor, bool... params>
     struct FunctorTemplateParamsSubstitutor {
         static auto Call() {
@@ -785,7 +874,282 @@ namespace NCB::NModelEvaluation {
         const bool isSingleDoc = (docCountInBlock == 1);
         const bool isSingleClassModel = (trees.GetDimensionsCount() == 1);
         const bool needXorMask = !trees.GetOneHotFeatures().empty();
+        if (!areTreesOblivious && !isSingleDoc && trees.GetNonSymmetricTreesBitvectors().IsAvailable()) {
+            return FunctorTemplateParamsSubstitutor<CalcNonSymmetricTreesBitvectorsInstantiationGetter>::Call(
+                isSingleClassModel, calcIndexesOnly);
+        }
         return FunctorTemplateParamsSubstitutor<CalcTreeFunctionInstantiationGetter>::Call(
             areTreesOblivious, isSingleDoc, isSingleClassModel, needXorMask, calcIndexesOnly);
     }
+
+    template <typename TStoredValue>
+    static void QuantizeTreeLeafValues(
+        TConstArrayRef<double> treeLeafValues,
+        double minValue,
+        double scale,
+        TStoredValue* dst
+    ) {
+        for (size_t valueIdx : xrange(treeLeafValues.size())) {
+            dst[valueIdx] = scale > 0 ? static_cast<TStoredValue>(std::round((treeLeafValues[valueIdx] - minValue) / scale)) : 0;
+        }
+    }
+
+    TCompactLeafValues BuildCompactLeafValues(const TModelTrees& trees, ELeafValuesPrecision precision) {
+        TCompactLeafValues result;
+        result.Precision = precision;
+        if (precision == ELeafValuesPrecision::Double) {
+            return result;
+        }
+        const auto& leafValues = trees.GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+        const auto treeLeafCounts = trees.GetTreeLeafCounts();
+        const size_t approxDimension = trees.GetDimensionsCount();
+        result.TreeScales.resize(trees.GetTreeCount(), 1.0);
+        result.TreeBiases.resize(trees.GetTreeCount(), 0.0);
+        switch (precision) {
+            case ELeafValuesPrecision::Float:
+                result.FloatValues.assign(leafValues.begin(), leafValues.end());
+                break;
+            case ELeafValuesPrecision::UI16:
+                result.UI16Values.yresize(leafValues.size());
+                break;
+            case ELeafValuesPrecision::UI8:
+                result.UI8Values.yresize(leafValues.size());
+                break;
+            default:
+                Y_UNREACHABLE();
+        }
+        for (size_t treeId : xrange(trees.GetTreeCount())) {
+            const auto treeLeafValues = MakeArrayRef(leafValues).Slice(
+                firstLeafOffsets[treeId],
+                treeLeafCounts[treeId] * approxDimension);
+            const auto [minIt, maxIt] = MinMaxElement(treeLeafValues.begin(), treeLeafValues.end());
+            if (precision == ELeafValuesPrecision::Float) {
+                result.MaxAbsError += Max(Abs(*minIt), Abs(*maxIt)) * std::ldexp(1.0, -24);
+                continue;
+            }
+            const double maxStoredValue = precision == ELeafValuesPrecision::UI16 ? Max<ui16>() : Max<ui8>();
+            const double scale = (*maxIt - *minIt) / maxStoredValue;
+            result.TreeScales[treeId] = scale;
+            result.TreeBiases[treeId] = *minIt;
+            result.MaxAbsError += scale / 2;
+            if (precision == ELeafValuesPrecision::UI16) {
+                QuantizeTreeLeafValues(treeLeafValues, *minIt, scale, result.UI16Values.data() + firstLeafOffsets[treeId]);
+            } else {
+                QuantizeTreeLeafValues(treeLeafValues, *minIt, scale, result.UI8Values.data() + firstLeafOffsets[treeId]);
+            }
+        }
+        return result;
+    }
+
+    template <typename TStoredValue, typename TIndexType>
+    Y_FORCE_INLINE void AddCompactTreeLeafValues(
+        const TStoredValue* __restrict treeValues,
+        double scale,
+        const TIndexType* __restrict indexesPtr,
+        size_t docCountInBlock,
+        size_t approxDimension,
+        double* __restrict writePtr
+    ) {
+        if (approxDimension == 1) {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                writePtr[docId] += scale * treeValues[indexesPtr[docId]];
+            }
+        } else {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const TStoredValue* leafValuePtr = treeValues + indexesPtr[docId] * approxDimension;
+                for (size_t dim = 0; dim < approxDimension; ++dim) {
+                    writePtr[dim] += scale * leafValuePtr[dim];
+                }
+                writePtr += approxDimension;
+            }
+        }
+    }
+
+    static void AddTreeBiases(
+        const TModelTrees& trees,
+        const TCompactLeafValues& leafValues,
+        size_t docCountInBlock,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict results
+    ) {
+        const double biasSum = Accumulate(leafValues.TreeBiases.begin() + treeStart, leafValues.TreeBiases.begin() + treeEnd, 0.0);
+        if (biasSum != 0.0) {
+            for (size_t idx = 0; idx < docCountInBlock * trees.GetDimensionsCount(); ++idx) {
+                results[idx] += biasSum;
+            }
+        }
+    }
+
+    // Same as CalcTreesBlockedImpl for trees with compact leaf values: leaf indexes of oblivious trees of depth
+    //  up to 8 are computed with SSE kernels, values are restored from compact storage right after that
+    template <typename TStoredValue, bool NeedXorMask, int SSEBlockCount>
+    static void CalcTreesBlockedWithCompactLeafValuesImpl(
+        const TModelTrees& trees,
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVecUI32,
+        size_t treeStart,
+        size_t treeEnd,
+        const TStoredValue* storedValues,
+        TConstArrayRef<double> treeScales,
+        double* __restrict resultsPtr
+    ) {
+        const TRepackedBin* treeSplitsCurPtr =
+            trees.GetRepackedBins().data() + trees.GetTreeStartOffsets()[treeStart];
+        ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
+        const auto firstLeafOffsetsPtr = trees.GetFirstLeafOffsets().data();
+        const size_t approxDimension = trees.GetDimensionsCount();
+        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+            const auto curTreeSize = trees.GetTreeSizes()[treeId];
+            const TStoredValue* treeValues = storedValues + firstLeafOffsetsPtr[treeId];
+            memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
+#ifdef _sse3_
+            if (curTreeSize <= 8) {
+                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr,
+                                                           curTreeSize);
+                AddCompactTreeLeafValues(treeValues, treeScales[treeId], indexesVec, docCountInBlock, approxDimension, resultsPtr);
+            } else {
+#else
+            {
+#endif
+                CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVecUI32, treeSplitsCurPtr,
+                                                 curTreeSize);
+                AddCompactTreeLeafValues(treeValues, treeScales[treeId], indexesVecUI32, docCountInBlock, approxDimension, resultsPtr);
+            }
+            treeSplitsCurPtr += curTreeSize;
+        }
+    }
+
+    template <typename TStoredValue, bool NeedXorMask>
+    static void CalcTreesBlockedWithCompactLeafValues(
+        const TModelTrees& trees,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        const TStoredValue* storedValues,
+        TConstArrayRef<double> treeScales,
+        double* __restrict resultsPtr
+    ) {
+        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+        switch (docCountInBlock / SSE_BLOCK_SIZE) {
+    #define CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(SSEBlockCount) \
+            case SSEBlockCount: \
+                CalcTreesBlockedWithCompactLeafValuesImpl<TStoredValue, NeedXorMask, SSEBlockCount>( \
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, storedValues, treeScales, resultsPtr); \
+                break;
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(0)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(1)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(2)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(3)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(4)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(5)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(6)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(7)
+            CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES(8)
+    #undef CALC_TREES_BLOCKED_WITH_COMPACT_LEAF_VALUES
+            default:
+                Y_UNREACHABLE();
+        }
+    }
+
+    // Other tree layouts and single documents: leaf indexes are computed by index-only kernels for a chunk of
+    //  trees at once, so index buffer stays in L1 cache
+    template <typename TStoredValue>
+    static void CalcTreesChunkedWithCompactLeafValues(
+        const TTreeCalcFunction& calcIndexes,
+        const TModelTrees& trees,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TVector<TCalcerIndexType>* chunkIndexes,
+        size_t treeStart,
+        size_t treeEnd,
+        const TStoredValue* storedValues,
+        TConstArrayRef<double> treeScales,
+        double* __restrict results
+    ) {
+        constexpr size_t treeChunkSize = 64;
+        chunkIndexes->yresize(docCountInBlock * treeChunkSize);
+        const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+        const size_t approxDimension = trees.GetDimensionsCount();
+        for (size_t chunkStart = treeStart; chunkStart < treeEnd; chunkStart += treeChunkSize) {
+            const size_t chunkEnd = Min(treeEnd, chunkStart + treeChunkSize);
+            calcIndexes(trees, quantizedData, docCountInBlock, chunkIndexes->data(), chunkStart, chunkEnd, nullptr);
+            const TCalcerIndexType* indexesPtr = chunkIndexes->data();
+            for (size_t treeId = chunkStart; treeId < chunkEnd; ++treeId) {
+                AddCompactTreeLeafValues(
+                    storedValues + firstLeafOffsets[treeId],
+                    treeScales[treeId],
+                    indexesPtr,
+                    docCountInBlock,
+                    approxDimension,
+                    results);
+                indexesPtr += docCountInBlock;
+            }
+        }
+    }
+
+    template <typename TStoredValue>
+    static TTreeCalcFunction GetCalcTreesWithCompactLeafValuesFunctionImpl(
+        const TModelTrees& trees,
+        TAtomicSharedPtr<const TCompactLeafValues> leafValues,
+        const TStoredValue* storedValues,
+        size_t docCountInBlock
+    ) {
+        if (trees.IsOblivious() && docCountInBlock > 1) {
+            const bool needXorMask = !trees.GetOneHotFeatures().empty();
+            return [leafValues, storedValues, needXorMask] (
+                const TModelTrees& trees,
+                const TCPUEvaluatorQuantizedData* quantizedData,
+                size_t docCountInBlock,
+                TCalcerIndexType* __restrict indexesVec,
+                size_t treeStart,
+                size_t treeEnd,
+                double* __restrict results
+            ) {
+                if (needXorMask) {
+                    CalcTreesBlockedWithCompactLeafValues<TStoredValue, true>(
+                        trees, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, storedValues, leafValues->TreeScales, results);
+                } else {
+                    CalcTreesBlockedWithCompactLeafValues<TStoredValue, false>(
+                        trees, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, storedValues, leafValues->TreeScales, results);
+                }
+                AddTreeBiases(trees, *leafValues, docCountInBlock, treeStart, treeEnd, results);
+            };
+        }
+        return [calcIndexes = GetCalcTreesFunction(trees, docCountInBlock, /*calcIndexesOnly*/ true), leafValues, storedValues, chunkIndexes = TVector<TCalcerIndexType>()] (
+            const TModelTrees& trees,
+            const TCPUEvaluatorQuantizedData* quantizedData,
+            size_t docCountInBlock,
+            TCalcerIndexType* __restrict,
+            size_t treeStart,
+            size_t treeEnd,
+            double* __restrict results
+        ) mutable {
+            CalcTreesChunkedWithCompactLeafValues(
+                calcIndexes, trees, quantizedData, docCountInBlock, &chunkIndexes, treeStart, treeEnd, storedValues, leafValues->TreeScales, results);
+            AddTreeBiases(trees, *leafValues, docCountInBlock, treeStart, treeEnd, results);
+        };
+    }
+
+    TTreeCalcFunction GetCalcTreesWithCompactLeafValuesFunction(
+        const TModelTrees& trees,
+        TAtomicSharedPtr<const TCompactLeafValues> leafValues,
+        size_t docCountInBlock
+    ) {
+        Y_ASSERT(leafValues && leafValues->Precision != ELeafValuesPrecision::Double);
+        switch (leafValues->Precision) {
+            case ELeafValuesPrecision::Float:
+                return GetCalcTreesWithCompactLeafValuesFunctionImpl(trees, leafValues, leafValues->FloatValues.data(), docCountInBlock);
+            case ELeafValuesPrecision::UI16:
+                return GetCalcTreesWithCompactLeafValuesFunctionImpl(trees, leafValues, leafValues->UI16Values.data(), docCountInBlock);
+            case ELeafValuesPrecision::UI8:
+                return GetCalcTreesWithCompactLeafValuesFunctionImpl(trees, leafValues, leafValues->UI8Values.data(), docCountInBlock);
+            default:
+                Y_UNREACHABLE();
+        }
+    }
 }
@@ -3,6 +3,9 @@
 
 #include "evaluator.h"
 
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
+
 namespace NCB::NModelEvaluation {
     namespace NDetail {
         template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor, typename TTextFeatureAccessor>
@@ -18,10 +21,13 @@ namespace NCB::NModelEvaluation {
             size_t treeEnd,
             EPredictionType predictionType,
             TArrayRef<double> results,
-            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr,
+            TAtomicSharedPtr<const TCompactLeafValues> compactLeafValues = nullptr
         ) {
             const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
-            auto calcTrees = GetCalcTreesFunction(trees, blockSize);
+            auto calcTrees = compactLeafValues
+                ? GetCalcTreesWithCompactLeafValuesFunction(trees, compactLeafValues, blockSize)
+                : GetCalcTreesFunction(trees, blockSize);
             if (trees.GetTreeCount() == 0) {
                 Fill(results.begin(), results.end(), trees.GetScaleAndBias().Bias);
                 return;
@@ -64,6 +70,114 @@ namespace NCB::NModelEvaluation {
             );
         }
 
+        // multiple of 4 to keep the same tree grouping (and summation order) as in CalcTreesBlocked
+        constexpr size_t BINARY_DECISION_STAGE_TREE_COUNT = 64;
+
+        template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor, typename TTextFeatureAccessor>
+        inline void CalcBinaryDecisionsGeneric(
+            const TModelTrees& trees,
+            const TIntrusivePtr<ICtrProvider>& ctrProvider,
+            const TIntrusivePtr<TTextProcessingCollection>& textProcessingCollection,
+            TFloatFeatureAccessor floatFeatureAccessor,
+            TCatFeatureAccessor catFeaturesAccessor,
+            TTextFeatureAccessor textFeatureAccessor,
+            size_t docCount,
+            double rawThreshold,
+            TArrayRef<double> results,
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr
+        ) {
+            CB_ENSURE(trees.GetDimensionsCount() == 1, "Binary decisions are supported only for single-dimensional models");
+            CB_ENSURE(
+                results.size() == docCount,
+                "`results` size is insufficient: " << LabeledOutput(results.size(), docCount)
+            );
+            const auto scaleAndBias = trees.GetScaleAndBias();
+            const size_t treeCount = trees.GetTreeCount();
+            if (treeCount == 0) {
+                Fill(results.begin(), results.end(), double(scaleAndBias.Bias > rawThreshold));
+                return;
+            }
+            const auto& remainingMinSums = trees.GetRemainingTreesMinLeafSums();
+            const auto& remainingMaxSums = trees.GetRemainingTreesMaxLeafSums();
+            const size_t bucketCount = trees.GetEffectiveBinaryFeaturesBucketsCount();
+            const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+
+            TVector<double> partialSums(blockSize);
+            TVector<TCalcerIndexType> indexesVec(blockSize);
+            TVector<ui32> activeDocs(blockSize);
+            TVector<ui32> keptPositions(blockSize);
+            TVector<ui8> compactedBins(blockSize * bucketCount);
+            TCPUEvaluatorQuantizedData compactedData;
+            size_t blockStart = 0;
+            ProcessDocsInBlocks(
+                trees,
+                ctrProvider,
+                textProcessingCollection,
+                floatFeatureAccessor,
+                catFeaturesAccessor,
+                textFeatureAccessor,
+                docCount,
+                blockSize,
+                [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
+                    auto blockResults = results.Slice(blockStart, docCountInBlock);
+                    blockStart += docCountInBlock;
+                    Fill(partialSums.begin(), partialSums.begin() + docCountInBlock, 0.0);
+                    Iota(activeDocs.begin(), activeDocs.begin() + docCountInBlock, 0);
+                    size_t activeCount = docCountInBlock;
+                    const TCPUEvaluatorQuantizedData* stageData = quantizedData;
+                    for (size_t stageStart = 0; activeCount > 0; stageStart += BINARY_DECISION_STAGE_TREE_COUNT) {
+                        const size_t stageEnd = Min(treeCount, stageStart + BINARY_DECISION_STAGE_TREE_COUNT);
+                        GetCalcTreesFunction(trees, activeCount)(
+                            trees,
+                            stageData,
+                            activeCount,
+                            activeCount == 1 ? nullptr : indexesVec.data(),
+                            stageStart,
+                            stageEnd,
+                            partialSums.data()
+                        );
+                        size_t keptCount = 0;
+                        for (size_t position = 0; position < activeCount; ++position) {
+                            const double sum = partialSums[position];
+                            double lowerBound = scaleAndBias.Scale * (sum + remainingMinSums[stageEnd]) + scaleAndBias.Bias;
+                            double upperBound = scaleAndBias.Scale * (sum + remainingMaxSums[stageEnd]) + scaleAndBias.Bias;
+                            if (lowerBound > upperBound) {
+                                DoSwap(lowerBound, upperBound);
+                            }
+                            if (lowerBound > rawThreshold || upperBound <= rawThreshold) {
+                                blockResults[activeDocs[position]] = lowerBound > rawThreshold;
+                            } else {
+                                partialSums[keptCount] = sum;
+                                activeDocs[keptCount] = activeDocs[position];
+                                keptPositions[keptCount] = position;
+                                ++keptCount;
+                            }
+                        }
+                        Y_ASSERT(stageEnd < treeCount || keptCount == 0);
+                        if (keptCount == 0 || keptCount == activeCount) {
+                            activeCount = keptCount;
+                            continue;
+                        }
+                        // bins are laid out as [bucketIdx * activeCount + position], and destination index never
+                        // exceeds source index, so compaction may be done in place
+                        const ui8* srcBins = stageData->QuantizedData.data();
+                        for (size_t bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
+                            const ui8* srcBucket = srcBins + bucketIdx * activeCount;
+                            ui8* dstBucket = compactedBins.data() + bucketIdx * keptCount;
+                            for (size_t keptIdx = 0; keptIdx < keptCount; ++keptIdx) {
+                                dstBucket[keptIdx] = srcBucket[keptPositions[keptIdx]];
+                            }
+                        }
+                        compactedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
+                            MakeArrayRef(compactedBins.data(), bucketCount * keptCount));
+                        stageData = &compactedData;
+                        activeCount = keptCount;
+                    }
+                },
+                featureInfo
+            );
+        }
+
         class TCpuEvaluator final : public IModelEvaluator {
         public:
             explicit TCpuEvaluator(const TFullModel& fullModel)
@@ -88,6 +202,15 @@ namespace NCB::NModelEvaluation {
                 return ModelTrees->GetTreeCount();
             }
 
+            TCpuEvaluator(const TCpuEvaluator& other)
+                : ModelTrees(other.ModelTrees)
+                , CtrProvider(other.CtrProvider)
+                , TextProcessingCollection(other.TextProcessingCollection)
+                , PredictionType(other.PredictionType)
+                , ExtFeatureLayout(other.ExtFeatureLayout)
+                , CompactLeafValues(other.GetCompactLeafValues())
+            {}
+
             TModelEvaluatorPtr Clone() const override {
                 return new TCpuEvaluator(*this);
             }
@@ -96,9 +219,23 @@ namespace NCB::NModelEvaluation {
                 return ModelTrees->GetDimensionsCount();
             }
 
+            /**
+             * Supported properties:
+             *  LeafValuesPrecision: Double (default), Float, UI16 or UI8 - precision of leaf values used for
+             *   evaluation, see TCompactLeafValues for error bounds
+             */
             void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
-                CB_ENSURE(false, "CPU evaluator don't have any properties. Got: " << propName);
-                Y_UNUSED(propValue);
+                CB_ENSURE(propName == "LeafValuesPrecision", "CPU evaluator don't have property " << propName);
+                ELeafValuesPrecision precision;
+                CB_ENSURE(TryFromString(propValue, precision), "Unknown leaf values precision: " << propValue);
+                TAtomicSharedPtr<const TCompactLeafValues> compactLeafValues;
+                if (precision != ELeafValuesPrecision::Double) {
+                    compactLeafValues = MakeAtomicShared<TCompactLeafValues>(BuildCompactLeafValues(*ModelTrees, precision));
+                }
+                with_lock(CompactLeafValuesLock) {
+                    DoSwap(CompactLeafValues, compactLeafValues);
+                }
+                // previous values are released here unless they are used by in-flight calls
             }
 
             void CalcFlatTransposed(
@@ -159,7 +296,8 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    GetCompactLeafValues()
                 );
             }
 
@@ -173,20 +311,7 @@ namespace NCB::NModelEvaluation {
                 if (!featureInfo) {
                     featureInfo = ExtFeatureLayout.Get();
                 }
-                auto expectedFlatVecSize = ModelTrees->GetFlatFeatureVectorExpectedSize();
-                if (featureInfo && featureInfo->FlatIndexes) {
-                    CB_ENSURE(
-                        featureInfo->FlatIndexes->size() >= expectedFlatVecSize,
-                        "Feature layout FlatIndexes expected to be at least " << expectedFlatVecSize << " long"
-                    );
-                    expectedFlatVecSize = *MaxElement(featureInfo->FlatIndexes->begin(), featureInfo->FlatIndexes->end());
-                }
-                for (const auto& flatFeaturesVec : features) {
-                    CB_ENSURE(
-                        flatFeaturesVec.size() >= expectedFlatVecSize,
-                        "insufficient flat features vector size: " << flatFeaturesVec.size() << " expected: " << expectedFlatVecSize
-                    );
-                }
+                ValidateFlatFeatures(features, featureInfo);
                 CalcGeneric(
                     *ModelTrees,
                     CtrProvider,
@@ -203,6 +328,35 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    featureInfo,
+                    GetCompactLeafValues()
+                );
+            }
+
+            void CalcFlatBinaryDecisions(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                double rawThreshold,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                if (!featureInfo) {
+                    featureInfo = ExtFeatureLayout.Get();
+                }
+                ValidateFlatFeatures(features, featureInfo);
+                CalcBinaryDecisionsGeneric(
+                    *ModelTrees,
+                    CtrProvider,
+                    TextProcessingCollection,
+                    [&features](TFeaturePosition position, size_t index) -> float {
+                        return features[index][position.FlatIndex];
+                    },
+                    [&features](TFeaturePosition position, size_t index) -> int {
+                        return ConvertFloatCatFeatureToIntHash(features[index][position.FlatIndex]);
+                    },
+                    TCpuEvaluator::TextFeatureAccessorStub,
+                    features.size(),
+                    rawThreshold,
+                    results,
                     featureInfo
                 );
             }
@@ -237,7 +391,8 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    GetCompactLeafValues()
                 );
             }
 
@@ -296,7 +451,8 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    GetCompactLeafValues()
                 );
             }
 
@@ -355,7 +511,8 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    GetCompactLeafValues()
                 );
             }
 
@@ -436,11 +593,10 @@ namespace NCB::NModelEvaluation {
                 CB_ENSURE(cpuQuantizedFeatures->BlocksCount * FORMULA_EVALUATION_BLOCK_SIZE >= cpuQuantizedFeatures->ObjectsCount);
                 std::fill(results.begin(), results.end(), 0.0);
                 auto subBlockSize = Min<size_t>(FORMULA_EVALUATION_BLOCK_SIZE, cpuQuantizedFeatures->ObjectsCount);
-                auto calcFunction = GetCalcTreesFunction(
-                    *ModelTrees,
-                    subBlockSize,
-                    false
-                );
+                const auto compactLeafValues = GetCompactLeafValues();
+                auto calcFunction = compactLeafValues
+                    ? GetCalcTreesWithCompactLeafValuesFunction(*ModelTrees, compactLeafValues, subBlockSize)
+                    : GetCalcTreesFunction(*ModelTrees, subBlockSize, false);
                 CB_ENSURE(results.size() == ModelTrees->GetDimensionsCount() * cpuQuantizedFeatures->ObjectsCount);
                 TVector<TCalcerIndexType> indexesVec(subBlockSize);
                 double* resultPtr = results.data();
@@ -510,6 +666,26 @@ namespace NCB::NModelEvaluation {
             }
 
         private:
+            void ValidateFlatFeatures(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                const TFeatureLayout* featureInfo
+            ) const {
+                auto expectedFlatVecSize = ModelTrees->GetFlatFeatureVectorExpectedSize();
+                if (featureInfo && featureInfo->FlatIndexes) {
+                    CB_ENSURE(
+                        featureInfo->FlatIndexes->size() >= expectedFlatVecSize,
+                        "Feature layout FlatIndexes expected to be at least " << expectedFlatVecSize << " long"
+                    );
+                    expectedFlatVecSize = *MaxElement(featureInfo->FlatIndexes->begin(), featureInfo->FlatIndexes->end());
+                }
+                for (const auto& flatFeaturesVec : features) {
+                    CB_ENSURE(
+                        flatFeaturesVec.size() >= expectedFlatVecSize,
+                        "insufficient flat features vector size: " << flatFeaturesVec.size() << " expected: " << expectedFlatVecSize
+                    );
+                }
+            }
+
             template <typename TCatFeatureContainer = TConstArrayRef<int>>
             void ValidateInputFeatures(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
@@ -579,6 +755,12 @@ namespace NCB::NModelEvaluation {
                 }
             }
 
+            TAtomicSharedPtr<const TCompactLeafValues> GetCompactLeafValues() const {
+                with_lock(CompactLeafValuesLock) {
+                    return CompactLeafValues;
+                }
+            }
+
             static TStringBuf TextFeatureAccessorStub(TFeaturePosition position, size_t index) {
                 Y_UNUSED(position, index);
                 CB_ENSURE(false, "This type of apply interface is not implemented with text features yet");
@@ -589,6 +771,9 @@ namespace NCB::NModelEvaluation {
             const TIntrusivePtr<TTextProcessingCollection> TextProcessingCollection;
             EPredictionType PredictionType = EPredictionType::RawFormulaVal;
             TMaybe<TFeatureLayout> ExtFeatureLayout;
+            // Calc calls work with a snapshot of the pointer, so SetProperty can replace the values concurrently
+            TAtomicSharedPtr<const TCompactLeafValues> CompactLeafValues;
+            mutable TAdaptiveLock CompactLeafValuesLock;
         };
     }
 
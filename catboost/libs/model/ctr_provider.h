@@ -36,6 +36,12 @@ public:
         const TConstArrayRef<TOneHotFeature> oheFeatures,
         const TConstArrayRef<TCatFeature> catFeatures) = 0;
 
+    /* called after SetupBinFeatureIndexes with the ctrs that will be passed to CalcCtrs,
+     * providers can precompute per-model evaluation data here
+     */
+    virtual void SetupUsedModelCtrs(const TVector<TModelCtr>& /*usedModelCtrs*/) {
+    }
+
     virtual void AddCtrCalcerData(TCtrValueTable&& valueTable) = 0;
     virtual bool IsSerializable() const {
         return false;
@@ -3,6 +3,8 @@
 #include "flatbuffers_serializer_helper.h"
 #include <catboost/libs/model/flatbuffers/ctr_data.fbs.h>
 
+#include <util/digest/city.h>
+#include <util/digest/multi.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/stream/input.h>
@@ -15,33 +17,36 @@ void TCtrValueTable::Save(IOutputStream* s) const {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
     TModelPartsCachingSerializer serializer;
+    TConstArrayRef<NCatboost::TBucket> indexBuckets;
+    TConstArrayRef<ui8> fingerprintIndex;
+    TConstArrayRef<ui8> ctrBlob;
     if (HoldsAlternative<TSolidTable>(Impl)) {
         auto& solid = Get<TSolidTable>(Impl);
-        auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) solid.IndexBuckets.data(),
-                                                sizeof(NCatboost::TBucket) * solid.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(solid.CTRBlob);
-        auto ctrValueTable = CreateTCtrValueTable(
-            serializer.FlatbufBuilder,
-            serializer.GetOffset(ModelCtrBase),
-            indexHashOffset,
-            ctrBlob,
-            CounterDenominator,
-            TargetClassesCount);
-        serializer.FlatbufBuilder.Finish(ctrValueTable);
+        indexBuckets = solid.IndexBuckets;
+        fingerprintIndex = solid.FingerprintIndex;
+        ctrBlob = solid.CTRBlob;
     } else {
         auto& thin = Get<TThinTable>(Impl);
-        auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) thin.IndexBuckets.data(),
-                                                sizeof(NCatboost::TBucket) * thin.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(thin.CTRBlob.data(), thin.CTRBlob.size());
-        auto ctrValueTable = CreateTCtrValueTable(
-            serializer.FlatbufBuilder,
-            serializer.GetOffset(ModelCtrBase),
-            indexHashOffset,
-            ctrBlob,
-            CounterDenominator,
-            TargetClassesCount);
-        serializer.FlatbufBuilder.Finish(ctrValueTable);
+        indexBuckets = thin.IndexBuckets;
+        fingerprintIndex = thin.FingerprintIndex;
+        ctrBlob = thin.CTRBlob;
     }
+    auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) indexBuckets.data(),
+                                            sizeof(NCatboost::TBucket) * indexBuckets.size());
+    Offset<Vector<ui8>> fingerprintIndexOffset = 0;
+    if (!fingerprintIndex.empty()) {
+        fingerprintIndexOffset = serializer.FlatbufBuilder.CreateVector(fingerprintIndex.data(), fingerprintIndex.size());
+    }
+    auto ctrBlobOffset = serializer.FlatbufBuilder.CreateVector(ctrBlob.data(), ctrBlob.size());
+    auto ctrValueTable = CreateTCtrValueTable(
+        serializer.FlatbufBuilder,
+        serializer.GetOffset(ModelCtrBase),
+        indexHashOffset,
+        ctrBlobOffset,
+        CounterDenominator,
+        TargetClassesCount,
+        fingerprintIndexOffset);
+    serializer.FlatbufBuilder.Finish(ctrValueTable);
     SaveSize(s, serializer.FlatbufBuilder.GetSize());
     s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
 }
@@ -64,7 +69,105 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     TargetClassesCount = ctrValueTable->TargetClassesCount();
     solid.IndexBuckets.assign((NCatboost::TBucket*)ctrValueTable->IndexHashRaw()->data(),
                               (NCatboost::TBucket*)(ctrValueTable->IndexHashRaw()->data() + ctrValueTable->IndexHashRaw()->size()));
+    if (const auto* fingerprintIndexRaw = ctrValueTable->FingerprintIndexRaw()) {
+        CB_ENSURE(
+            fingerprintIndexRaw->size() % NCatboost::TFingerprintIndexLayout::GroupDataSize == 0,
+            "Corrupted ctr value table: bad fingerprint index size"
+        );
+        solid.FingerprintIndex.assign(
+            fingerprintIndexRaw->data(),
+            fingerprintIndexRaw->data() + fingerprintIndexRaw->size());
+    }
 
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::SetIndexFormat(ECtrIndexFormat indexFormat) {
+    if (GetIndexFormat() == indexFormat) {
+        return;
+    }
+    if (HoldsAlternative<TThinTable>(Impl)) {
+        TSolidTable solid;
+        Get<TThinTable>(Impl).ToSolidTable(&solid);
+        Impl = std::move(solid);
+        SharedData.Reset();
+    }
+    auto& solid = Get<TSolidTable>(Impl);
+    if (indexFormat == ECtrIndexFormat::Fingerprint) {
+        const NCatboost::TDenseIndexHashView denseView(solid.IndexBuckets);
+        const size_t uniqueValuesCount = denseView.CountNonEmptyBuckets();
+        solid.FingerprintIndex.resize(
+            NCatboost::TFingerprintIndexHashBuilder::GetProperDataSize(uniqueValuesCount));
+        NCatboost::TFingerprintIndexHashBuilder builder(solid.FingerprintIndex);
+        for (const auto& bucket : denseView.GetBuckets()) {
+            if (bucket.Hash != NCatboost::TBucket::InvalidHashValue) {
+                builder.SetIndex(bucket.Hash, bucket.IndexValue);
+            }
+        }
+        solid.IndexBuckets.clear();
+        solid.IndexBuckets.shrink_to_fit();
+    } else {
+        const NCatboost::TFingerprintIndexHashView fingerprintView(solid.FingerprintIndex);
+        size_t uniqueValuesCount = 0;
+        fingerprintView.ForEachIndex([&](ui64, ui32) { ++uniqueValuesCount; });
+        solid.IndexBuckets.resize(NCatboost::TDenseIndexHashBuilder::GetProperBucketsCount(uniqueValuesCount));
+        NCatboost::TDenseIndexHashBuilder builder(solid.IndexBuckets);
+        fingerprintView.ForEachIndex([&](ui64 hash, ui32 index) { builder.SetIndex(hash, index); });
+        solid.FingerprintIndex.clear();
+        solid.FingerprintIndex.shrink_to_fit();
+    }
+}
+
+void TCtrValueTable::MakeDataShareable() {
+    if (SharedData) {
+        return;
+    }
+    if (HoldsAlternative<TThinTable>(Impl)) {
+        TSolidTable solid;
+        Get<TThinTable>(Impl).ToSolidTable(&solid);
+        Impl = std::move(solid);
+    }
+    SharedData = MakeAtomicShared<TSolidTable>(std::move(Get<TSolidTable>(Impl)));
+    Impl = TThinTable{SharedData->IndexBuckets, SharedData->FingerprintIndex, SharedData->CTRBlob};
+}
+
+void TCtrValueTable::ShareData(const TCtrValueTable& source) {
+    CB_ENSURE_INTERNAL(source.SharedData, "Ctr value table data is not shareable");
+    CB_ENSURE_INTERNAL(HasEqualData(source), "Only equal ctr value table data can be shared");
+    Impl = source.Impl;
+    SharedData = source.SharedData;
+}
+
+size_t TCtrValueTable::GetDataSize() const {
+    return GetIndexBuckets().size() * sizeof(NCatboost::TBucket)
+        + GetFingerprintIndex().size()
+        + GetTypedArrayRefForBlobData<ui8>().size();
+}
+
+template <class T>
+static ui64 CalcArrayHash(TConstArrayRef<T> array) {
+    return CityHash64(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(T));
+}
+
+ui64 TCtrValueTable::GetDataHash() const {
+    return MultiHash(
+        CounterDenominator,
+        TargetClassesCount,
+        CalcArrayHash(GetIndexBuckets()),
+        CalcArrayHash(GetFingerprintIndex()),
+        CalcArrayHash(GetTypedArrayRefForBlobData<ui8>())
+    );
+}
+
+bool TCtrValueTable::HasEqualData(const TCtrValueTable& other) const {
+    auto equalArrays = [] (auto lhs, auto rhs) {
+        return lhs.size() == rhs.size()
+            && (lhs.empty() || memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(lhs[0])) == 0);
+    };
+    return CounterDenominator == other.CounterDenominator
+        && TargetClassesCount == other.TargetClassesCount
+        && equalArrays(GetIndexBuckets(), other.GetIndexBuckets())
+        && equalArrays(GetFingerprintIndex(), other.GetFingerprintIndex())
+        && equalArrays(GetTypedArrayRefForBlobData<ui8>(), other.GetTypedArrayRefForBlobData<ui8>());
+}
@@ -3,8 +3,10 @@
 #include "online_ctr.h"
 
 #include <catboost/libs/helpers/dense_hash_view.h>
+#include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
 #include <util/generic/variant.h>
 #include <util/generic/vector.h>
 #include <util/stream/fwd.h>
@@ -14,27 +16,38 @@
 #include <tuple>
 
 
+enum class ECtrIndexFormat {
+    Dense,       // TDenseIndexHashView, compatible with all model exporters
+    Fingerprint  // TFingerprintIndexHashView, about half the memory for large tables
+};
+
 class TCtrValueTable {
+    // only one of IndexBuckets and FingerprintIndex is non-empty
     struct TSolidTable {
         TVector<NCatboost::TBucket> IndexBuckets;
+        TVector<ui8> FingerprintIndex; // TFingerprintIndexHashView data
         TVector<ui8> CTRBlob;
 
     public:
         bool operator==(const TSolidTable& other) const {
-            return std::tie(IndexBuckets, CTRBlob) == std::tie(other.IndexBuckets, other.CTRBlob);
+            return std::tie(IndexBuckets, FingerprintIndex, CTRBlob)
+                == std::tie(other.IndexBuckets, other.FingerprintIndex, other.CTRBlob);
         }
     };
     struct TThinTable {
         TConstArrayRef<NCatboost::TBucket> IndexBuckets;
+        TConstArrayRef<ui8> FingerprintIndex;
         TConstArrayRef<ui8> CTRBlob;
 
     public:
         bool operator==(const TThinTable& other) const {
-            return std::tie(IndexBuckets, CTRBlob) == std::tie(other.IndexBuckets, other.CTRBlob);
+            return std::tie(IndexBuckets, FingerprintIndex, CTRBlob)
+                == std::tie(other.IndexBuckets, other.FingerprintIndex, other.CTRBlob);
         }
 
         void ToSolidTable(TSolidTable* table) {
             table->IndexBuckets.assign(IndexBuckets.begin(), IndexBuckets.end());
+            table->FingerprintIndex.assign(FingerprintIndex.begin(), FingerprintIndex.end());
             table->CTRBlob.assign(CTRBlob.begin(), CTRBlob.end());
         }
     };
@@ -46,8 +59,7 @@ public:
     }
 
     bool operator==(const TCtrValueTable& other) const {
-        return std::tie(CounterDenominator, TargetClassesCount, Impl) ==
-               std::tie(other.CounterDenominator, other.TargetClassesCount, other.Impl);
+        return HasEqualData(other);
     }
 
     template <typename T>
@@ -78,7 +90,16 @@ public:
         );
     }
 
+    ECtrIndexFormat GetIndexFormat() const {
+        return GetFingerprintIndex().empty() ? ECtrIndexFormat::Dense : ECtrIndexFormat::Fingerprint;
+    }
+
+    // only for ECtrIndexFormat::Dense
     NCatboost::TDenseIndexHashView GetIndexHashViewer() const {
+        CB_ENSURE(
+            GetIndexFormat() == ECtrIndexFormat::Dense,
+            "Ctr value table has fingerprint index, convert it to dense index first"
+        );
         if (HoldsAlternative<TSolidTable>(Impl)) {
             auto& solid = Get<TSolidTable>(Impl);
             return NCatboost::TDenseIndexHashView(solid.IndexBuckets);
@@ -88,12 +109,53 @@ public:
         }
     }
 
+    // batched bucket index lookup for any index format
+    void GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui32> indexes) const {
+        if (GetIndexFormat() == ECtrIndexFormat::Fingerprint) {
+            NCatboost::TFingerprintIndexHashView(GetFingerprintIndex()).GetIndexes(hashes, indexes);
+        } else {
+            GetIndexHashViewer().GetIndexes(hashes, indexes);
+        }
+    }
+
     NCatboost::TDenseIndexHashBuilder GetIndexHashBuilder(size_t uniqueValuesCount) {
         auto& solid = Get<TSolidTable>(Impl);
+        solid.FingerprintIndex.clear();
         auto bucketCount = NCatboost::TDenseIndexHashBuilder::GetProperBucketsCount(uniqueValuesCount);
         solid.IndexBuckets.resize(bucketCount);
         return NCatboost::TDenseIndexHashBuilder(solid.IndexBuckets);
     }
+
+    // rebuilds hash index in the given format, table becomes solid
+    void SetIndexFormat(ECtrIndexFormat indexFormat);
+
+    /* Data of tables with equal content can be shared (e.g. between models, see TModelRegistry):
+     * MakeDataShareable moves data to a reference counted storage and makes the table a view of it,
+     * ShareData makes this table a view of the shareable data of the source table.
+     * Shared data is read-only, SetIndexFormat makes a solid copy.
+     */
+    void MakeDataShareable();
+    void ShareData(const TCtrValueTable& source);
+
+    // number of tables that use the data, 1 if the data is not shared
+    long GetDataUseCount() const {
+        return SharedData ? SharedData.RefCount() : 1;
+    }
+
+    // identifies the shared data, nullptr if the data is not shared
+    const void* GetSharedDataId() const {
+        return SharedData.Get();
+    }
+
+    // size of index and ctr blob in bytes
+    size_t GetDataSize() const;
+
+    // hash of the data, tables with equal data have the same hash
+    ui64 GetDataHash() const;
+
+    // compares data only, ModelCtrBase can be different
+    bool HasEqualData(const TCtrValueTable& other) const;
+
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
@@ -104,6 +166,25 @@ public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
     int TargetClassesCount = 0;
+private:
+    TConstArrayRef<NCatboost::TBucket> GetIndexBuckets() const {
+        if (HoldsAlternative<TSolidTable>(Impl)) {
+            return Get<TSolidTable>(Impl).IndexBuckets;
+        } else {
+            return Get<TThinTable>(Impl).IndexBuckets;
+        }
+    }
+
+    TConstArrayRef<ui8> GetFingerprintIndex() const {
+        if (HoldsAlternative<TSolidTable>(Impl)) {
+            return Get<TSolidTable>(Impl).FingerprintIndex;
+        } else {
+            return Get<TThinTable>(Impl).FingerprintIndex;
+        }
+    }
+
 private:
     TVariant<TSolidTable, TThinTable> Impl;
+    // owner of the data viewed by TThinTable for shared data, empty otherwise
+    TAtomicSharedPtr<TSolidTable> SharedData;
 };
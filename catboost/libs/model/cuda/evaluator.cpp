@@ -193,6 +193,18 @@ namespace NCB::NModelEvaluation {
                 Ctx.EvalData(dataInput, treeStart, treeEnd, results, PredictionType);
             }
 
+            void CalcFlatBinaryDecisions(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                double rawThreshold,
+                TArrayRef<double> results,
+                const TFeatureLayout*
+            ) const override {
+                Y_UNUSED(features);
+                Y_UNUSED(rawThreshold);
+                Y_UNUSED(results);
+                ythrow yexception() << "Unimplemented on GPU";
+            }
+
             void CalcFlatSingle(
                 TConstArrayRef<float> features,
                 size_t treeStart,
@@ -8,6 +8,13 @@ namespace NCB { // split due to CUDA-compiler inability to support nested namesp
             Probability,
             Class
         };
+
+        enum class ELeafValuesPrecision {
+            Double,
+            Float,
+            UI16,
+            UI8
+        };
     }
 }
 
@@ -134,6 +134,18 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
                 CalcFlat(featureRefs, 0, GetTreeCount(), results, featureInfo);
             }
 
+            /**
+             * Binary class decisions for single-dimensional models: results[objectIndex] is 1.0 if raw formula
+             *  value is greater than rawThreshold and 0.0 otherwise. Result doesn't depend on prediction type.
+             * Implementations may stop evaluating an object as soon as remaining trees can't change its decision.
+             */
+            virtual void CalcFlatBinaryDecisions(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                double rawThreshold,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const = 0;
+
             virtual void CalcFlatSingle(
                 TConstArrayRef<float> features,
                 size_t treeStart,
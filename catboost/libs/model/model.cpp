@@ -24,6 +24,7 @@
 #include <util/generic/cast.h>
 #include <util/generic/fwd.h>
 #include <util/generic/guid.h>
+#include <util/generic/map.h>
 #include <util/generic/variant.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
@@ -233,6 +234,120 @@ TModelTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
     );
 }
 
+namespace {
+    struct TNonSymmetricTreeSplitMask {
+        ui16 FeatureIndex = 0;
+        ui8 SplitIdx = 0;
+        ui8 TreeIdxInChunk = 0;
+        ui64 RightMask = 0;
+    };
+}
+
+// Numbers exits of the subtree from left to right and returns the mask of these exits
+static ui64 AddNonSymmetricSubtreeExits(
+    TConstArrayRef<TNonSymmetricTreeStepNode> stepNodes,
+    TConstArrayRef<ui32> nodeIdToLeafId,
+    TConstArrayRef<TRepackedBin> repackedBins,
+    ui32 nodeIdx,
+    ui32 treeIdxInChunk,
+    ui32 treeExitsOffset,
+    TVector<ui32>* exitLeafValueOffsets,
+    TVector<TNonSymmetricTreeSplitMask>* splitMasks
+) {
+    const auto addExit = [&] () {
+        const ui64 exitMask = 1ull << (exitLeafValueOffsets->size() - treeExitsOffset);
+        exitLeafValueOffsets->push_back(nodeIdToLeafId[nodeIdx]);
+        return exitMask;
+    };
+    const auto& node = stepNodes[nodeIdx];
+    if (node.LeftSubtreeDiff == 0 && node.RightSubtreeDiff == 0) {
+        return addExit();
+    }
+    const auto addSubtreeExits = [&] (ui16 diff) {
+        if (diff == 0) {
+            return addExit();
+        }
+        return AddNonSymmetricSubtreeExits(
+            stepNodes,
+            nodeIdToLeafId,
+            repackedBins,
+            nodeIdx + diff,
+            treeIdxInChunk,
+            treeExitsOffset,
+            exitLeafValueOffsets,
+            splitMasks);
+    };
+    const ui64 leftMask = addSubtreeExits(node.LeftSubtreeDiff);
+    const ui64 rightMask = addSubtreeExits(node.RightSubtreeDiff);
+    auto& splitMask = splitMasks->emplace_back();
+    splitMask.FeatureIndex = repackedBins[nodeIdx].FeatureIndex;
+    splitMask.SplitIdx = repackedBins[nodeIdx].SplitIdx;
+    splitMask.TreeIdxInChunk = treeIdxInChunk;
+    splitMask.RightMask = ~leftMask;
+    return leftMask | rightMask;
+}
+
+static TNonSymmetricTreesBitvectors BuildNonSymmetricTreesBitvectors(
+    TConstArrayRef<int> treeSizes,
+    TConstArrayRef<int> treeStartOffsets,
+    TConstArrayRef<TNonSymmetricTreeStepNode> stepNodes,
+    TConstArrayRef<ui32> nodeIdToLeafId,
+    TConstArrayRef<TRepackedBin> repackedBins
+) {
+    for (auto treeIdx : xrange(treeSizes.size())) {
+        size_t exitCount = 0;
+        for (auto nodeIdx : xrange(treeStartOffsets[treeIdx], treeStartOffsets[treeIdx] + treeSizes[treeIdx])) {
+            const auto& node = stepNodes[nodeIdx];
+            exitCount += (node.LeftSubtreeDiff == 0 && node.RightSubtreeDiff == 0)
+                ? 1
+                : (node.LeftSubtreeDiff == 0) + (node.RightSubtreeDiff == 0);
+        }
+        if (exitCount > TNonSymmetricTreesBitvectors::MaxExitCount) {
+            return {};
+        }
+    }
+
+    TNonSymmetricTreesBitvectors bitvectors;
+    bitvectors.ChunkFeatureSplitsOffsets.push_back(0);
+    bitvectors.TreeExitsOffsets.push_back(0);
+    TVector<TNonSymmetricTreeSplitMask> splitMasks;
+    constexpr size_t chunkSize = TNonSymmetricTreesBitvectors::TreeChunkSize;
+    for (size_t chunkStart = 0; chunkStart < treeSizes.size(); chunkStart += chunkSize) {
+        splitMasks.clear();
+        for (auto treeIdx : xrange(chunkStart, Min(chunkStart + chunkSize, treeSizes.size()))) {
+            AddNonSymmetricSubtreeExits(
+                stepNodes,
+                nodeIdToLeafId,
+                repackedBins,
+                treeStartOffsets[treeIdx],
+                treeIdx - chunkStart,
+                bitvectors.TreeExitsOffsets.back(),
+                &bitvectors.ExitLeafValueOffsets,
+                &splitMasks);
+            bitvectors.TreeExitsOffsets.push_back(bitvectors.ExitLeafValueOffsets.size());
+        }
+        StableSort(
+            splitMasks,
+            [] (const auto& lhs, const auto& rhs) {
+                return std::tie(lhs.FeatureIndex, lhs.SplitIdx) < std::tie(rhs.FeatureIndex, rhs.SplitIdx);
+            });
+        for (const auto& splitMask : splitMasks) {
+            const ui32 splitIdx = bitvectors.SplitIdx.size();
+            if (bitvectors.FeatureSplits.size() == bitvectors.ChunkFeatureSplitsOffsets.back()
+                || bitvectors.FeatureSplits.back().FeatureIndex != splitMask.FeatureIndex)
+            {
+                bitvectors.FeatureSplits.push_back({splitMask.FeatureIndex, splitIdx, splitIdx});
+            }
+            ++bitvectors.FeatureSplits.back().SplitsEnd;
+            bitvectors.SplitIdx.push_back(splitMask.SplitIdx);
+            bitvectors.SplitTreeIdxInChunk.push_back(splitMask.TreeIdxInChunk);
+            bitvectors.SplitRightMasks.push_back(splitMask.RightMask);
+        }
+        bitvectors.ChunkFeatureSplitsOffsets.push_back(bitvectors.FeatureSplits.size());
+    }
+    return bitvectors;
+}
+
 void TModelTrees::UpdateRuntimeData() const {
     struct TFeatureSplitId {
         ui32 FeatureIdx = 0;
@@ -243,11 +358,13 @@ void TModelTrees::UpdateRuntimeData() const {
     auto& ref = RuntimeData.GetRef();
 
     ref.TreeFirstLeafOffsets.resize(TreeSizes.size());
+    TVector<size_t> treeLeafCounts(TreeSizes.size());
     if (IsOblivious()) {
         size_t currentOffset = 0;
         for (size_t i = 0; i < TreeSizes.size(); ++i) {
             ref.TreeFirstLeafOffsets[i] = currentOffset;
-            currentOffset += (1 << TreeSizes[i]) * ApproxDimension;
+            treeLeafCounts[i] = size_t(1) << TreeSizes[i];
+            currentOffset += treeLeafCounts[i] * ApproxDimension;
         }
     } else {
         for (size_t treeId = 0; treeId < TreeSizes.size(); ++treeId) {
@@ -273,6 +390,19 @@ void TModelTrees::UpdateRuntimeData() const {
             Y_ASSERT(valueNodeCount > 0);
             Y_ASSERT(maxLeafValueIndex == minLeafValueIndex + (valueNodeCount - 1) * ApproxDimension);
             ref.TreeFirstLeafOffsets[treeId] = minLeafValueIndex;
+            treeLeafCounts[treeId] = valueNodeCount;
+        }
+    }
+    if (ApproxDimension == 1) {
+        ref.RemainingTreesMinLeafSums.assign(TreeSizes.size() + 1, 0.0);
+        ref.RemainingTreesMaxLeafSums.assign(TreeSizes.size() + 1, 0.0);
+        for (size_t treeId = TreeSizes.size(); treeId > 0; --treeId) {
+            const auto treeLeafValuesBegin = LeafValues.begin() + ref.TreeFirstLeafOffsets[treeId - 1];
+            const auto treeLeafValuesEnd = treeLeafValuesBegin + treeLeafCounts[treeId - 1];
+            ref.RemainingTreesMinLeafSums[treeId - 1]
+                = ref.RemainingTreesMinLeafSums[treeId] + *MinElement(treeLeafValuesBegin, treeLeafValuesEnd);
+            ref.RemainingTreesMaxLeafSums[treeId - 1]
+                = ref.RemainingTreesMaxLeafSums[treeId] + *MaxElement(treeLeafValuesBegin, treeLeafValuesEnd);
         }
     }
 
@@ -379,6 +509,14 @@ void TModelTrees::UpdateRuntimeData() const {
         }
         ref.RepackedBins.push_back(rb);
     }
+    if (!IsOblivious() && OneHotFeatures.empty()) {
+        ref.NonSymmetricTreesBitvectors = BuildNonSymmetricTreesBitvectors(
+            TreeSizes,
+            TreeStartOffsets,
+            NonSymmetricStepNodes,
+            NonSymmetricNodeIdToLeafId,
+            ref.RepackedBins);
+    }
 }
 
 void TModelTrees::DropUnusedFeatures() {
@@ -428,6 +566,71 @@ void TModelTrees::ConvertObliviousToAsymmetric() {
     UpdateRuntimeData();
 }
 
+void TModelTrees::MergeAndReorderObliviousTrees() {
+    CB_ENSURE(IsOblivious(), "Only oblivious trees can be merged");
+    const auto& firstLeafOffsets = GetFirstLeafOffsets();
+
+    struct TMergedTree {
+        TVector<int> Splits;
+        TVector<int> SortedSplits;
+        TVector<double> LeafValues;
+        TVector<double> LeafWeights;
+    };
+    TVector<TMergedTree> mergedTrees;
+    TMap<TVector<int>, size_t> mergedTreeIdxBySplits;
+    for (size_t treeId = 0; treeId < TreeSizes.size(); ++treeId) {
+        TVector<int> splits(
+            TreeSplits.begin() + TreeStartOffsets[treeId],
+            TreeSplits.begin() + TreeStartOffsets[treeId] + TreeSizes[treeId]);
+        const size_t leafCount = 1ull << TreeSizes[treeId];
+        const double* treeLeafValues = LeafValues.data() + firstLeafOffsets[treeId];
+        const double* treeLeafWeights = LeafWeights.empty()
+            ? nullptr
+            : LeafWeights.data() + firstLeafOffsets[treeId] / ApproxDimension;
+
+        // leaf weights are sums of learn object weights, so the merged tree keeps weights of its first tree
+        const auto [mergedTreeIdxIt, isNewTree] = mergedTreeIdxBySplits.emplace(splits, mergedTrees.size());
+        if (isNewTree) {
+            auto& mergedTree = mergedTrees.emplace_back();
+            mergedTree.SortedSplits = splits;
+            Sort(mergedTree.SortedSplits);
+            mergedTree.Splits = std::move(splits);
+            mergedTree.LeafValues.assign(treeLeafValues, treeLeafValues + leafCount * ApproxDimension);
+            if (treeLeafWeights) {
+                mergedTree.LeafWeights.assign(treeLeafWeights, treeLeafWeights + leafCount);
+            }
+        } else {
+            auto& mergedTree = mergedTrees[mergedTreeIdxIt->second];
+            for (auto valueIdx : xrange(leafCount * ApproxDimension)) {
+                mergedTree.LeafValues[valueIdx] += treeLeafValues[valueIdx];
+            }
+        }
+    }
+
+    StableSort(
+        mergedTrees,
+        [] (const TMergedTree& lhs, const TMergedTree& rhs) {
+            return lhs.SortedSplits < rhs.SortedSplits;
+        });
+
+    const bool hasLeafWeights = !LeafWeights.empty();
+    TreeSplits.clear();
+    TreeSizes.clear();
+    TreeStartOffsets.clear();
+    LeafValues.clear();
+    LeafWeights.clear();
+    for (const auto& mergedTree : mergedTrees) {
+        TreeStartOffsets.push_back(TreeSplits.size());
+        TreeSizes.push_back(mergedTree.Splits.size());
+        TreeSplits.insert(TreeSplits.end(), mergedTree.Splits.begin(), mergedTree.Splits.end());
+        LeafValues.insert(LeafValues.end(), mergedTree.LeafValues.begin(), mergedTree.LeafValues.end());
+        if (hasLeafWeights) {
+            LeafWeights.insert(LeafWeights.end(), mergedTree.LeafWeights.begin(), mergedTree.LeafWeights.end());
+        }
+    }
+    UpdateRuntimeData();
+}
+
 TVector<ui32> TModelTrees::GetTreeLeafCounts() const {
     const auto& firstLeafOfsets = GetFirstLeafOffsets();
     Y_ASSERT(IsSorted(firstLeafOfsets.begin(), firstLeafOfsets.end()));
@@ -525,6 +728,14 @@ void TFullModel::CalcFlatSingle(
     GetCurrentEvaluator()->CalcFlatSingle(features, treeStart, treeEnd, results, featureInfo);
 }
 
+void TFullModel::CalcFlatBinaryDecisions(
+    TConstArrayRef<TConstArrayRef<float>> features,
+    double rawThreshold,
+    TArrayRef<double> results,
+    const TFeatureLayout* featureInfo) const {
+    GetCurrentEvaluator()->CalcFlatBinaryDecisions(features, rawThreshold, results, featureInfo);
+}
+
 void TFullModel::CalcFlatTransposed(
     TConstArrayRef<TConstArrayRef<float>> transposedFeatures,
     size_t treeStart,
@@ -701,6 +912,7 @@ void TFullModel::UpdateDynamicData() {
             ModelTrees->GetFloatFeatures(),
             ModelTrees->GetOneHotFeatures(),
             ModelTrees->GetCatFeatures());
+        CtrProvider->SetupUsedModelCtrs(ModelTrees->GetUsedModelCtrs());
     }
     with_lock(CurrentEvaluatorLock) {
         Evaluator.Reset();
@@ -749,6 +961,19 @@ void SetModelExternalFeatureNames(const TVector<TString>& featureNames, TFullMod
     forest.ApplyFeatureNames(featureNames);
 }
 
+void SetCtrIndexFormat(ECtrIndexFormat indexFormat, TFullModel* model) {
+    if (!model->CtrProvider) {
+        return;
+    }
+    auto* staticCtrProvider = dynamic_cast<const TStaticCtrProvider*>(model->CtrProvider.Get());
+    CB_ENSURE(staticCtrProvider, "Ctr index format can be changed only for static ctr provider");
+    // provider may be shared with model copies
+    TIntrusivePtr<ICtrProvider> ctrProvider = staticCtrProvider->Clone();
+    dynamic_cast<TStaticCtrProvider*>(ctrProvider.Get())->SetIndexFormat(indexFormat);
+    model->CtrProvider = ctrProvider;
+    model->UpdateDynamicData();
+}
+
 static TMaybe<NCatboostOptions::TLossDescription> GetLossDescription(const TFullModel& model) {
     TMaybe<NCatboostOptions::TLossDescription> lossDescription;
     if (model.ModelInfo.contains("loss_function")) {
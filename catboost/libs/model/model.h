@@ -85,6 +85,45 @@ struct TNonSymmetricTreeStepNode {
     }
 };
 
+/**
+ * Non-symmetric trees in QuickScorer layout, built at model load for block evaluation.
+ *
+ * Exits of each tree (node and side pairs that end the path) are numbered from left to right,
+ *  so the exit of a document is the lowest exit that is not on the left side of any split
+ *  the document goes right on. Trees are grouped in chunks of TreeChunkSize, splits of a chunk
+ *  are grouped by binary feature bucket and sorted by SplitIdx, so for each bucket the splits
+ *  that a document goes right on form a prefix.
+ */
+struct TNonSymmetricTreesBitvectors {
+    static constexpr size_t TreeChunkSize = 16;
+    static constexpr size_t MaxExitCount = 64;
+
+    struct TFeatureSplits {
+        ui16 FeatureIndex = 0;
+        ui32 SplitsBegin = 0;
+        ui32 SplitsEnd = 0;
+    };
+
+    TVector<TFeatureSplits> FeatureSplits;
+    //! Offset of first TFeatureSplits of each tree chunk in FeatureSplits, size is chunkCount + 1
+    TVector<ui32> ChunkFeatureSplitsOffsets;
+
+    TVector<ui8> SplitIdx;
+    TVector<ui8> SplitTreeIdxInChunk;
+    //! Exits that stay reachable if the document goes right on the split
+    TVector<ui64> SplitRightMasks;
+
+    //! Offset of first exit of each tree in ExitLeafValueOffsets, size is treeCount + 1
+    TVector<ui32> TreeExitsOffsets;
+    //! Offset of exit values in leaf values array
+    TVector<ui32> ExitLeafValueOffsets;
+
+public:
+    bool IsAvailable() const {
+        return !TreeExitsOffsets.empty();
+    }
+};
+
 struct TModelTrees {
 public:
     /**
@@ -124,6 +163,14 @@ public:
 
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
+
+        //! Empty for oblivious trees, trees with one-hot splits or with more than MaxExitCount exits
+        TNonSymmetricTreesBitvectors NonSymmetricTreesBitvectors;
+
+        //! Sums of per-tree min (max) leaf values over trees [treeIdx, treeCount), treeCount + 1 elements.
+        //! Filled only for single-dimensional models
+        TVector<double> RemainingTreesMinLeafSums;
+        TVector<double> RemainingTreesMaxLeafSums;
     };
 
 public:
@@ -170,6 +217,14 @@ public:
 
     void ConvertObliviousToAsymmetric();
 
+    /**
+     * Merge oblivious trees with identical split sequences by summing their leaf values,
+     *  then order trees by their sorted binary features, so that consecutive trees read close features.
+     * Predictions of the whole model are kept up to floating point summation order, tree indices are not:
+     *  use it only for serving models that are applied with all trees.
+     */
+    void MergeAndReorderObliviousTrees();
+
     /**
      * Method for oblivious trees serialization with repeated parts caching
      * @param serializer our caching flatbuffers serializator
@@ -410,6 +465,21 @@ public:
         return RuntimeData->TreeFirstLeafOffsets;
     }
 
+    const TNonSymmetricTreesBitvectors& GetNonSymmetricTreesBitvectors() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->NonSymmetricTreesBitvectors;
+    }
+
+    const TVector<double>& GetRemainingTreesMinLeafSums() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->RemainingTreesMinLeafSums;
+    }
+
+    const TVector<double>& GetRemainingTreesMaxLeafSums() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        return RuntimeData->RemainingTreesMaxLeafSums;
+    }
+
     const double* GetFirstLeafPtrForTree(size_t treeIdx) const {
         CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
         return &LeafValues[RuntimeData->TreeFirstLeafOffsets[treeIdx]];
@@ -890,6 +960,21 @@ public:
         CalcFlatSingle(features, result);
     }
 
+    /**
+     * Binary class decisions for single-dimensional models on flat feature vectors.
+     * Objects whose decision can't be changed by the remaining trees are not evaluated further, so this is
+     *  cheaper than CalcFlat when most objects are far from the threshold.
+     * @param[in] features vector of flat features array reference, same as in CalcFlat
+     * @param[in] rawThreshold decision threshold on raw formula value (including scale and bias)
+     * @param[out] results results[objectIndex] is 1.0 if raw formula value > rawThreshold, 0.0 otherwise
+     */
+    void CalcFlatBinaryDecisions(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        double rawThreshold,
+        TArrayRef<double> results,
+        const TFeatureLayout* featureInfo = nullptr
+    ) const;
+
     /**
      * Evaluate raw formula predictions on user data. Uses model trees for interval [treeStart, treeEnd)
      * @param[in] floatFeatures
@@ -1150,6 +1235,12 @@ TVector<TString> GetModelUsedFeaturesNames(const TFullModel& model);
 
 void SetModelExternalFeatureNames(const TVector<TString>& featureNames, TFullModel* model);
 
+/**
+ * Rebuild hash indexes of static ctr tables in the given format, format is kept on save and load.
+ * Model exporters and model sum support only ECtrIndexFormat::Dense.
+ */
+void SetCtrIndexFormat(ECtrIndexFormat indexFormat, TFullModel* model);
+
 TFullModel SumModels(
     const TVector<const TFullModel*> modelVector,
     const TVector<double>& weights,
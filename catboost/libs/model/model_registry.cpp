@@ -0,0 +1,210 @@
+#include "model_registry.h"
+
+#include "static_ctr_provider.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/private/libs/text_features/text_processing_collection.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/utility.h>
+
+
+template <class T>
+static size_t GetArraySize(TConstArrayRef<T> array) {
+    return array.size() * sizeof(T);
+}
+
+TModelRegistry::TModelPtr TModelRegistry::LoadModel(
+    const TString& name,
+    const TString& modelFile,
+    EModelType format
+) {
+    return SetModel(name, ReadModel(modelFile, format));
+}
+
+TModelRegistry::TModelPtr TModelRegistry::SetModel(const TString& name, TFullModel&& model) {
+    ShareCtrTables(&model);
+    ShareTextProcessingParts(&model);
+    model.UpdateDynamicData();
+    // evaluator is created before publishing so that the first Calc calls of the new version do not wait for it
+    model.GetCurrentEvaluator();
+
+    auto sharedModel = MakeAtomicShared<TFullModel>();
+    sharedModel->Swap(model);
+    const TModelPtr modelPtr = sharedModel;
+
+    TModelPtr previousModel = modelPtr;
+    with_lock(ModelsLock) {
+        DoSwap(Models[name], previousModel);
+    }
+    // previous version is destroyed here unless it is used by in-flight calls
+    previousModel.Reset();
+    ReleaseUnusedParts();
+    return modelPtr;
+}
+
+bool TModelRegistry::RemoveModel(const TString& name) {
+    TModelPtr removedModel;
+    with_lock(ModelsLock) {
+        auto modelIt = Models.find(name);
+        if (modelIt == Models.end()) {
+            return false;
+        }
+        removedModel = modelIt->second;
+        Models.erase(modelIt);
+    }
+    removedModel.Reset();
+    ReleaseUnusedParts();
+    return true;
+}
+
+TModelRegistry::TModelPtr TModelRegistry::GetModel(const TString& name) const {
+    TModelPtr model = FindModel(name);
+    CB_ENSURE(model, "Model registry has no model with name " << name);
+    return model;
+}
+
+TModelRegistry::TModelPtr TModelRegistry::FindModel(const TString& name) const {
+    with_lock(ModelsLock) {
+        auto modelIt = Models.find(name);
+        return modelIt != Models.end() ? modelIt->second : TModelPtr();
+    }
+}
+
+TVector<TString> TModelRegistry::GetModelNames() const {
+    TVector<TString> names;
+    with_lock(ModelsLock) {
+        names.reserve(Models.size());
+        for (const auto& [name, model] : Models) {
+            names.push_back(name);
+        }
+    }
+    Sort(names);
+    return names;
+}
+
+// shared ctr data used by the model, data of several tables of the model with equal content is listed once
+static THashSet<const void*> GetSharedCtrDataIds(const TFullModel& model) {
+    THashSet<const void*> dataIds;
+    const auto* staticCtrProvider = dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get());
+    if (staticCtrProvider) {
+        for (const auto& [ctrBase, valueTable] : staticCtrProvider->CtrData.LearnCtrs) {
+            if (valueTable.GetSharedDataId()) {
+                dataIds.insert(valueTable.GetSharedDataId());
+            }
+        }
+    }
+    return dataIds;
+}
+
+TModelMemoryUsage TModelRegistry::GetMemoryUsage(const TString& name) const {
+    TModelPtr model;
+    TVector<TModelPtr> publishedModels;
+    with_lock(ModelsLock) {
+        auto modelIt = Models.find(name);
+        CB_ENSURE(modelIt != Models.end(), "Model registry has no model with name " << name);
+        model = modelIt->second;
+        publishedModels.reserve(Models.size());
+        for (const auto& [modelName, publishedModel] : Models) {
+            publishedModels.push_back(publishedModel);
+        }
+    }
+
+    TModelMemoryUsage memoryUsage;
+    const TModelTrees& trees = *model->ModelTrees;
+    memoryUsage.TreesSize = GetArraySize(trees.GetTreeSplits())
+        + GetArraySize(trees.GetTreeSizes())
+        + GetArraySize(trees.GetTreeStartOffsets())
+        + GetArraySize(trees.GetNonSymmetricStepNodes())
+        + GetArraySize(trees.GetNonSymmetricNodeIdToLeafId())
+        + GetArraySize(trees.GetLeafValues())
+        + GetArraySize(trees.GetLeafWeights());
+
+    const auto* staticCtrProvider = dynamic_cast<const TStaticCtrProvider*>(model->CtrProvider.Get());
+    if (staticCtrProvider) {
+        // users of shared data are the published models, previous versions still used by in-flight calls
+        //   are not counted
+        THashMap<const void*, ui32> sharedDataUserCount;
+        for (const auto& publishedModel : publishedModels) {
+            for (const void* dataId : GetSharedCtrDataIds(*publishedModel)) {
+                ++sharedDataUserCount[dataId];
+            }
+        }
+        THashSet<const void*> countedDataIds;
+        for (const auto& [ctrBase, valueTable] : staticCtrProvider->CtrData.LearnCtrs) {
+            const void* dataId = valueTable.GetSharedDataId();
+            if (dataId && !countedDataIds.insert(dataId).second) {
+                continue;
+            }
+            const ui32 userCount = dataId ? sharedDataUserCount.at(dataId) : 1;
+            if (userCount == 1) {
+                memoryUsage.CtrTablesSize += valueTable.GetDataSize();
+            } else {
+                memoryUsage.SharedCtrTablesSize += valueTable.GetDataSize() / userCount;
+            }
+        }
+    }
+    return memoryUsage;
+}
+
+void TModelRegistry::ReleaseUnusedParts() {
+    with_lock(PartsLock) {
+        for (auto tablesIt = CtrTables.begin(); tablesIt != CtrTables.end();) {
+            EraseIf(tablesIt->second, [] (const TCtrValueTable& table) { return table.GetDataUseCount() == 1; });
+            if (tablesIt->second.empty()) {
+                CtrTables.erase(tablesIt++);
+            } else {
+                ++tablesIt;
+            }
+        }
+        EraseNodesIf(Dictionaries, [] (const auto& item) { return item.second.RefCount() == 1; });
+        EraseNodesIf(FeatureCalcers, [] (const auto& item) { return item.second.RefCount() == 1; });
+    }
+}
+
+void TModelRegistry::ShareCtrTables(TFullModel* model) {
+    if (!model->CtrProvider) {
+        return;
+    }
+    auto* staticCtrProvider = dynamic_cast<TStaticCtrProvider*>(model->CtrProvider.Get());
+    if (!staticCtrProvider) {
+        return;
+    }
+    if (model->CtrProvider.RefCount() > 1) {
+        // provider may be shared with model copies
+        model->CtrProvider = staticCtrProvider->Clone();
+        staticCtrProvider = dynamic_cast<TStaticCtrProvider*>(model->CtrProvider.Get());
+    }
+    with_lock(PartsLock) {
+        for (auto& [ctrBase, valueTable] : staticCtrProvider->CtrData.LearnCtrs) {
+            auto& tables = CtrTables[valueTable.GetDataHash()];
+            auto sharedTable = FindIf(tables, [&] (const TCtrValueTable& table) { return table.HasEqualData(valueTable); });
+            if (sharedTable == tables.end()) {
+                valueTable.MakeDataShareable();
+                tables.push_back(valueTable);
+            } else {
+                valueTable.ShareData(*sharedTable);
+            }
+        }
+    }
+}
+
+void TModelRegistry::ShareTextProcessingParts(TFullModel* model) {
+    if (!model->TextProcessingCollection) {
+        return;
+    }
+    // collection may be shared with model copies
+    auto collection = MakeIntrusive<NCB::TTextProcessingCollection>(*model->TextProcessingCollection);
+    with_lock(PartsLock) {
+        collection->ReplaceSharedParts(
+            [&] (const NCB::TDictionaryPtr& dictionary) {
+                return Dictionaries.emplace(dictionary->Id(), dictionary).first->second;
+            },
+            [&] (const NCB::TTextFeatureCalcerPtr& calcer) {
+                return FeatureCalcers.emplace(calcer->Id(), calcer).first->second;
+            }
+        );
+    }
+    model->TextProcessingCollection = collection;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ctr_value_table.h"
+#include "model.h"
+
+#include <catboost/libs/helpers/guid.h>
+#include <catboost/private/libs/text_features/feature_calcer.h>
+#include <catboost/private/libs/text_processing/dictionary.h>
+
+#include <util/generic/hash.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/mutex.h>
+#include <util/system/types.h>
+
+
+/*
+ * Shared ctr tables are split between the models published in the registry that use them, previous model
+ *   versions kept alive by in-flight calls are not counted.
+ * Text processing parts (dictionaries and feature calcers) are not included.
+ */
+struct TModelMemoryUsage {
+    size_t TreesSize = 0;
+    size_t CtrTablesSize = 0; // ctr tables used by this model only
+    size_t SharedCtrTablesSize = 0; // size of each ctr table used by several models divided by the number of models
+
+public:
+    size_t GetTotal() const {
+        return TreesSize + CtrTablesSize + SharedCtrTablesSize;
+    }
+};
+
+/*
+ * Holds named models, equal parts of different models (ctr value tables compared by content,
+ *   text dictionaries and feature calcers compared by Id) are stored once.
+ *
+ * Models are published as shared pointers: SetModel replaces a model atomically, Calc calls on the
+ *   model pointer obtained by GetModel before the replacement keep using the previous version until
+ *   the pointer is released. All methods are thread-safe.
+ */
+class TModelRegistry {
+public:
+    using TModelPtr = TAtomicSharedPtr<const TFullModel>;
+
+public:
+    // Reads the model and publishes it under the name, replaces the current model with this name if any
+    TModelPtr LoadModel(const TString& name, const TString& modelFile, EModelType format = EModelType::CatboostBinary);
+
+    // Shares equal parts of the model with other models and publishes it under the name
+    TModelPtr SetModel(const TString& name, TFullModel&& model);
+
+    // Returns false if there is no model with this name
+    bool RemoveModel(const TString& name);
+
+    TModelPtr GetModel(const TString& name) const;
+    TModelPtr FindModel(const TString& name) const; // nullptr if there is no model with this name
+    TVector<TString> GetModelNames() const;
+
+    TModelMemoryUsage GetMemoryUsage(const TString& name) const;
+
+    // Parts of removed and replaced models are released when they are no longer used by in-flight calls.
+    // Called by SetModel and RemoveModel, can be called explicitly after the last reference to the previous
+    //   model versions is released.
+    void ReleaseUnusedParts();
+
+private:
+    void ShareCtrTables(TFullModel* model);
+    void ShareTextProcessingParts(TFullModel* model);
+
+private:
+    mutable TMutex ModelsLock;
+    THashMap<TString, TModelPtr> Models;
+
+    TMutex PartsLock;
+    // tables with shareable data, one for each distinct content
+    THashMap<ui64, TVector<TCtrValueTable>> CtrTables; // data hash -> tables
+    THashMap<NCB::TGuid, NCB::TDictionaryPtr> Dictionaries;
+    THashMap<NCB::TGuid, NCB::TTextFeatureCalcerPtr> FeatureCalcers;
+};
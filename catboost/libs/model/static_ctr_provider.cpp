@@ -6,6 +6,44 @@
 #include <util/string/cast.h>
 
 
+TAtomicSharedPtr<const TStaticCtrEvaluationPlan> TStaticCtrProvider::BuildEvaluationPlan(
+    const TVector<TModelCtr>& neededCtrs
+) const {
+    auto plan = MakeAtomicShared<TStaticCtrEvaluationPlan>();
+    plan->ModelCtrs = neededCtrs;
+    if (neededCtrs.empty()) {
+        return plan;
+    }
+    // projections and ctr order must be the same as in CompressModelCtrs because it defines result layout
+    for (const auto& compressedModelCtr : NCB::CompressModelCtrs(plan->ModelCtrs)) {
+        const auto& proj = *compressedModelCtr.Projection;
+        auto& projection = plan->Projections.emplace_back();
+        for (const auto feature : proj.CatFeatures) {
+            projection.TransposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
+        }
+        for (const auto feature : proj.BinFeatures) {
+            projection.BinarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
+        }
+        for (const auto feature : proj.OneHotFeatures) {
+            projection.BinarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
+        }
+        const TCtrValueTable* previousLearnCtr = nullptr;
+        for (const auto* ctr : compressedModelCtr.ModelCtrs) {
+            const TCtrValueTable* learnCtr = &CtrData.LearnCtrs.at(ctr->Base);
+            projection.Ctrs.push_back({ctr, learnCtr, learnCtr == previousLearnCtr});
+            previousLearnCtr = learnCtr;
+        }
+    }
+    return plan;
+}
+
+void TStaticCtrProvider::SetupUsedModelCtrs(const TVector<TModelCtr>& usedModelCtrs) {
+    ResetEvaluationPlan();
+    if (HasNeededCtrs(usedModelCtrs)) {
+        ResetEvaluationPlan(BuildEvaluationPlan(usedModelCtrs));
+    }
+}
+
 void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
                                   const TConstArrayRef<ui8>& binarizedFeatures,
                                   const TConstArrayRef<ui32>& hashedCatFeatures,
@@ -14,35 +52,32 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
     if (neededCtrs.empty()) {
         return;
     }
-    auto compressedModelCtrs = NCB::CompressModelCtrs(neededCtrs);
+    auto plan = GetEvaluationPlan();
+    if (!plan || plan->ModelCtrs != neededCtrs) {
+        // not the ctrs the provider was set up with
+        plan = BuildEvaluationPlan(neededCtrs);
+    }
+
     size_t samplesCount = docCount;
     TVector<ui64> ctrHashes(samplesCount);
-    TVector<ui64> buckets(samplesCount);
+    TVector<ui32> buckets(samplesCount);
     size_t resultIdx = 0;
     float* resultPtr = result.data();
-    TVector<int> transposedCatFeatureIndexes;
-    TVector<TBinFeatureIndexValue> binarizedIndexes;
-    for (size_t idx = 0; idx < compressedModelCtrs.size(); ++idx) {
-        auto& proj = *compressedModelCtrs[idx].Projection;
-        binarizedIndexes.clear();
-        transposedCatFeatureIndexes.clear();
-        for (const auto feature : proj.CatFeatures) {
-            transposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
-        }
-        for (const auto feature : proj.BinFeatures ) {
-            binarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
-        }
-        for (const auto feature : proj.OneHotFeatures ) {
-            binarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
-        }
-        CalcHashes(binarizedFeatures, hashedCatFeatures, transposedCatFeatureIndexes, binarizedIndexes, docCount, &ctrHashes);
-        for (const auto& ctr: compressedModelCtrs[idx].ModelCtrs) {
-            auto& learnCtr = CtrData.LearnCtrs.at(ctr->Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
+    for (const auto& projection : plan->Projections) {
+        CalcHashes(
+            binarizedFeatures,
+            hashedCatFeatures,
+            projection.TransposedCatFeatureIndexes,
+            projection.BinarizedIndexes,
+            docCount,
+            &ctrHashes);
+        for (const auto& planCtr : projection.Ctrs) {
+            const auto* ctr = planCtr.ModelCtr;
+            auto& learnCtr = *planCtr.LearnCtr;
             const ECtrType ctrType = ctr->Base.CtrType;
             auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
+            if (!planCtr.SameLearnCtrAsPrevious) {
+                learnCtr.GetIndexes(ctrHashes, buckets);
             }
             if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
                 const auto emptyVal = ctr->Calc(0.f, 0.f);
@@ -133,6 +168,7 @@ bool TStaticCtrProvider::HasNeededCtrs(const TVector<TModelCtr>& neededCtrs) con
 void TStaticCtrProvider::SetupBinFeatureIndexes(const TConstArrayRef<TFloatFeature> floatFeatures,
                                                 const TConstArrayRef<TOneHotFeature> oheFeatures,
                                                 const TConstArrayRef<TCatFeature> catFeatures) {
+    ResetEvaluationPlan();
     ui32 currentIndex = 0;
     FloatFeatureIndexes.clear();
     for (const auto& floatFeature : floatFeatures) {
@@ -6,11 +6,36 @@
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/hash.h>
+#include <util/generic/ptr.h>
 #include <util/generic/utility.h>
+#include <util/generic/vector.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
 
 #include <functional>
 
 
+/* Everything CalcCtrs needs that depends only on the model: ctrs grouped by projection,
+ * resolved feature indexes and value tables
+ */
+struct TStaticCtrEvaluationPlan {
+    struct TCtr {
+        const TModelCtr* ModelCtr;
+        const TCtrValueTable* LearnCtr;
+        bool SameLearnCtrAsPrevious; // buckets computed for the previous ctr can be reused
+    };
+
+    struct TProjection {
+        TVector<int> TransposedCatFeatureIndexes;
+        TVector<TBinFeatureIndexValue> BinarizedIndexes;
+        TVector<TCtr> Ctrs;
+    };
+
+public:
+    TVector<TModelCtr> ModelCtrs; // copy of neededCtrs, TCtr::ModelCtr points here
+    TVector<TProjection> Projections;
+};
+
 class TStaticCtrProvider: public ICtrProvider {
 public:
     TStaticCtrProvider() = default;
@@ -32,16 +57,21 @@ public:
         const TConstArrayRef<TFloatFeature> floatFeatures,
         const TConstArrayRef<TOneHotFeature> oheFeatures,
         const TConstArrayRef<TCatFeature> catFeatures) override;
+
+    void SetupUsedModelCtrs(const TVector<TModelCtr>& usedModelCtrs) override;
+
     bool IsSerializable() const override {
         return true;
     }
 
     void AddCtrCalcerData(TCtrValueTable&& valueTable) override {
+        ResetEvaluationPlan();
         auto ctrBase = valueTable.ModelCtrBase;
         CtrData.LearnCtrs[ctrBase] = std::move(valueTable);
     }
 
     void DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) override {
+        ResetEvaluationPlan();
         TCtrData ctrData;
         for (auto& base: usedModelCtrBase) {
             ctrData.LearnCtrs[base] = std::move(CtrData.LearnCtrs[base]);
@@ -49,11 +79,19 @@ public:
         DoSwap(CtrData, ctrData);
     }
 
+    void SetIndexFormat(ECtrIndexFormat indexFormat) {
+        ResetEvaluationPlan();
+        for (auto& [ctrBase, valueTable] : CtrData.LearnCtrs) {
+            valueTable.SetIndexFormat(indexFormat);
+        }
+    }
+
     void Save(IOutputStream* out) const override {
         ::Save(out, CtrData);
     }
 
     void Load(IInputStream* inp) override {
+        ResetEvaluationPlan();
         ::Load(inp, CtrData);
     }
 
@@ -77,10 +115,31 @@ public:
 
 public:
     TCtrData CtrData;
+private:
+    TAtomicSharedPtr<const TStaticCtrEvaluationPlan> BuildEvaluationPlan(const TVector<TModelCtr>& neededCtrs) const;
+
+    TAtomicSharedPtr<const TStaticCtrEvaluationPlan> GetEvaluationPlan() const {
+        with_lock(EvaluationPlanLock) {
+            return EvaluationPlan;
+        }
+    }
+
+    void ResetEvaluationPlan(TAtomicSharedPtr<const TStaticCtrEvaluationPlan> plan = nullptr) {
+        with_lock(EvaluationPlanLock) {
+            DoSwap(EvaluationPlan, plan);
+        }
+        // previous plan is destroyed here unless it is used by in-flight CalcCtrs calls
+    }
+
 private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+
+    // built in SetupUsedModelCtrs, reset when feature indexes or ctr tables change.
+    // Provider is shared by model copies, so CalcCtrs works with a snapshot of the pointer.
+    TAtomicSharedPtr<const TStaticCtrEvaluationPlan> EvaluationPlan;
+    mutable TAdaptiveLock EvaluationPlanLock; // guards EvaluationPlan pointer only
 };
 
 class TStaticCtrOnFlightSerializationProvider: public ICtrProvider {
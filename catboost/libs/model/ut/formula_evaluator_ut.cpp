@@ -1,13 +1,19 @@
 #include <catboost/libs/model/ut/lib/model_test_helpers.h>
 
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/data/data_provider_builders.h>
 #include <catboost/libs/model/cpu/evaluator.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <catboost/private/libs/text_features/ut/lib/text_features_data.h>
 
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
 using namespace NCB;
 using namespace NCB::NModelEvaluation;
 
@@ -70,6 +76,32 @@ void CheckFlatCalcResult(
     }
 }
 
+static void CheckCompactLeafValues(const TFullModel& model, TFastRng64* rng) {
+    const size_t docCount = 300;
+    TVector<TVector<float>> data(docCount, TVector<float>(3));
+    for (auto& doc : data) {
+        for (auto& value : doc) {
+            value = rng->GenRandReal1();
+        }
+    }
+    const auto features = GetFeatureRef(data);
+    TVector<double> expectedPredicts(docCount);
+    model.CalcFlat(features, expectedPredicts);
+
+    for (auto precision : {ELeafValuesPrecision::Float, ELeafValuesPrecision::UI16, ELeafValuesPrecision::UI8}) {
+        const double maxAbsError = 2.0 * BuildCompactLeafValues(*model.ModelTrees, precision).MaxAbsError + 1e-9;
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        evaluator->SetProperty("LeafValuesPrecision", ToString(precision));
+        for (auto [batchStart, batchSize] : TVector<std::pair<size_t, size_t>>{{0, docCount}, {5, 37}, {11, 1}}) {
+            TVector<double> predicts(batchSize);
+            evaluator->CalcFlat(MakeArrayRef(features).Slice(batchStart, batchSize), predicts);
+            for (size_t docId : xrange(batchSize)) {
+                UNIT_ASSERT_DOUBLES_EQUAL(predicts[docId], expectedPredicts[batchStart + docId], maxAbsError);
+            }
+        }
+    }
+}
+
 Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
     Y_UNIT_TEST(TestFlatCalcFloat) {
         auto model = SimpleFloatModel();
@@ -105,6 +137,70 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         CheckFlatCalcResult(model, expectedPredicts, expectedLeafIndexes);
     }
 
+    Y_UNIT_TEST(TestMergeAndReorderTrees) {
+        auto model = SimpleFloatModel(3);
+        model.ModelTrees.GetMutable()->MergeAndReorderObliviousTrees();
+        model.UpdateDynamicData();
+        UNIT_ASSERT_VALUES_EQUAL(model.GetTreeCount(), 1);
+        TVector<double> expectedPredicts;
+        for (int sampleId : xrange(8)) {
+            expectedPredicts.push_back(111.0 * sampleId);
+        }
+        CheckFlatCalcResult(model, expectedPredicts, xrange<ui32>(8));
+
+        auto mixedModel = SimpleFloatModel(0);
+        TModelTrees* trees = mixedModel.ModelTrees.GetMutable();
+        for (const auto& tree : TVector<TVector<int>>{{302}, {300, 301, 302}, {300}, {300, 301, 302}}) {
+            trees->AddBinTree(tree);
+            for (int leafIndex = 0; leafIndex < (1 << tree.ysize()); ++leafIndex) {
+                trees->AddLeafValue(0.25 * leafIndex + tree.ysize());
+            }
+        }
+        mixedModel.UpdateDynamicData();
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        mixedModel.CalcFlat(FLOAT_FEATURES, predicts);
+
+        mixedModel.ModelTrees.GetMutable()->MergeAndReorderObliviousTrees();
+        mixedModel.UpdateDynamicData();
+        UNIT_ASSERT_VALUES_EQUAL(mixedModel.GetTreeCount(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(mixedModel.ModelTrees->GetTreeSizes()[0], 1);
+        UNIT_ASSERT_VALUES_EQUAL(mixedModel.ModelTrees->GetTreeSizes()[1], 3);
+        UNIT_ASSERT_VALUES_EQUAL(mixedModel.ModelTrees->GetTreeSizes()[2], 1);
+        TVector<double> mergedPredicts(FLOAT_FEATURES.size());
+        mixedModel.CalcFlat(FLOAT_FEATURES, mergedPredicts);
+        for (auto sampleId : xrange(FLOAT_FEATURES.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(predicts[sampleId], mergedPredicts[sampleId], 1e-9);
+        }
+    }
+
+    Y_UNIT_TEST(TestCompactLeafValues) {
+        TFastRng64 rng(3);
+        TVector<TFloatFeature> floatFeatures;
+        for (int featureIdx : xrange(3)) {
+            floatFeatures.push_back(TFloatFeature{false, featureIdx, featureIdx, {}, ""});
+        }
+        TObliviousTreeBuilder builder(floatFeatures, TVector<TCatFeature>{}, TVector<TTextFeature>{}, 1);
+        // trees deeper than 8 are evaluated without sse index kernels
+        for (size_t treeDepth : {0, 1, 3, 6, 8, 10}) {
+            for (size_t treeIdx = 0; treeIdx < 10; ++treeIdx) {
+                TVector<TModelSplit> splits;
+                for (size_t splitIdx = 0; splitIdx < treeDepth; ++splitIdx) {
+                    splits.push_back(TModelSplit(TFloatSplit(rng.Uniform(3), 0.01f * rng.Uniform(1, 100))));
+                }
+                TVector<TVector<double>> leafValues(1, TVector<double>(size_t(1) << treeDepth));
+                for (auto& value : leafValues[0]) {
+                    value = rng.GenRandReal1();
+                }
+                builder.AddTree(splits, leafValues);
+            }
+        }
+        TFullModel model;
+        builder.Build(model.ModelTrees.GetMutable());
+        model.UpdateDynamicData();
+        model.SetScaleAndBias({-2.0, 0.5});
+        CheckCompactLeafValues(model, &rng);
+    }
+
     Y_UNIT_TEST(TestFlatCalcOnDeepTree) {
         const size_t treeDepth = 9;
         auto model = SimpleDeepTreeModel(treeDepth);
@@ -160,6 +256,76 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         UNIT_ASSERT_NO_EXCEPTION(applyBatch());
     }
 
+    static TVector<float> CalcCtrs(
+        ICtrProvider* ctrProvider,
+        const TVector<TModelCtr>& neededCtrs,
+        TConstArrayRef<ui8> binarizedFeatures,
+        TConstArrayRef<ui32> hashedCatFeatures,
+        size_t docCount
+    ) {
+        TVector<float> result(neededCtrs.size() * docCount);
+        ctrProvider->CalcCtrs(neededCtrs, binarizedFeatures, hashedCatFeatures, docCount, result);
+        return result;
+    }
+
+    Y_UNIT_TEST(TestCtrEvaluationPlan) {
+        const auto model = TrainCatOnlyModel();
+        const TModelTrees& trees = *model.ModelTrees;
+        const TVector<TModelCtr> usedCtrs = trees.GetUsedModelCtrs();
+        UNIT_ASSERT(!usedCtrs.empty());
+        UNIT_ASSERT(dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get()));
+
+        // provider of the model is set up with used ctrs and has an evaluation plan, its clone has not
+        auto providerWithPlan = model.CtrProvider;
+        auto providerWithoutPlan = model.CtrProvider->Clone();
+        providerWithoutPlan->SetupBinFeatureIndexes(
+            trees.GetFloatFeatures(),
+            trees.GetOneHotFeatures(),
+            trees.GetCatFeatures()
+        );
+
+        const TVector<TStringBuf> catValues[] = {{"a", "b", "c", "x"}, {"d", "e", "f", "y"}, {"g", "h", "k", "z"}};
+        const size_t docCount = 200;
+        TFastRng64 rng(0);
+        TVector<ui32> hashedCatFeatures;
+        for (const auto& catFeature : trees.GetCatFeatures()) {
+            if (!catFeature.UsedInModel()) {
+                continue;
+            }
+            const auto& values = catValues[catFeature.Position.Index];
+            for (size_t doc = 0; doc < docCount; ++doc) {
+                hashedCatFeatures.push_back(CalcCatFeatureHash(values[rng.Uniform(values.size())]));
+            }
+        }
+        TVector<ui8> binarizedFeatures(trees.GetEffectiveBinaryFeaturesBucketsCount() * docCount);
+        for (auto& value : binarizedFeatures) {
+            value = rng.Uniform(4);
+        }
+
+        const auto expectedCtrs = CalcCtrs(
+            providerWithoutPlan.Get(),
+            usedCtrs,
+            binarizedFeatures,
+            hashedCatFeatures,
+            docCount
+        );
+        UNIT_ASSERT_EQUAL(
+            CalcCtrs(providerWithPlan.Get(), usedCtrs, binarizedFeatures, hashedCatFeatures, docCount),
+            expectedCtrs
+        );
+        UNIT_ASSERT_EQUAL(
+            CalcCtrs(providerWithPlan.Get(), trees.GetUsedModelCtrs(), binarizedFeatures, hashedCatFeatures, docCount),
+            expectedCtrs
+        );
+
+        // ctrs other than the ones the provider is set up with
+        const TVector<TModelCtr> someCtrs(usedCtrs.begin(), usedCtrs.begin() + (usedCtrs.size() + 1) / 2);
+        UNIT_ASSERT_EQUAL(
+            CalcCtrs(providerWithPlan.Get(), someCtrs, binarizedFeatures, hashedCatFeatures, docCount),
+            CalcCtrs(providerWithoutPlan.Get(), someCtrs, binarizedFeatures, hashedCatFeatures, docCount)
+        );
+    }
+
     static void CheckCalcTextResult(
         const TFullModel& model,
         TConstArrayRef<TVector<TStringBuf>> transposedTextFeatures,
@@ -259,6 +425,18 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
     }
 }
 
+static THolder<TNonSymmetricTreeNode> MakeRandomNonSymmetricTree(int maxDepth, TFastRng64* rng) {
+    auto node = MakeHolder<TNonSymmetricTreeNode>();
+    if (maxDepth == 0 || rng->Uniform(4) == 0) {
+        node->Value = rng->GenRandReal1();
+        return node;
+    }
+    node->SplitCondition = TModelSplit(TFloatSplit(rng->Uniform(3), 0.1f * rng->Uniform(1, 10)));
+    node->Left = MakeRandomNonSymmetricTree(maxDepth - 1, rng);
+    node->Right = MakeRandomNonSymmetricTree(maxDepth - 1, rng);
+    return node;
+}
+
 Y_UNIT_TEST_SUITE(TNonSymmetricTreeModel) {
     Y_UNIT_TEST(TestFlatCalcFloat) {
         auto modelCalcer = SimpleAsymmetricModel();
@@ -283,4 +461,115 @@ Y_UNIT_TEST_SUITE(TNonSymmetricTreeModel) {
         deserializedModel.Load(&strStream);
         CheckFlatCalcResult(deserializedModel, canonVals, expectedLeafIndexes);
     }
+
+    Y_UNIT_TEST(TestBlockCalcMatchesSingleCalc) {
+        TFastRng64 rng(42);
+        TVector<TFloatFeature> floatFeatures;
+        for (int featureIdx : xrange(3)) {
+            floatFeatures.push_back(TFloatFeature{false, featureIdx, featureIdx, {}, ""});
+        }
+        TNonSymmetricTreeModelBuilder builder(floatFeatures, TVector<TCatFeature>{}, TVector<TTextFeature>{}, 1);
+        const size_t treeCount = 40;
+        for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+            builder.AddTree(MakeRandomNonSymmetricTree(/*maxDepth*/ 5, &rng));
+        }
+        TFullModel model;
+        builder.Build(model.ModelTrees.GetMutable());
+        model.UpdateDynamicData();
+        UNIT_ASSERT(model.ModelTrees->GetNonSymmetricTreesBitvectors().IsAvailable());
+
+        const size_t docCount = 300;
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        for (auto [treeStart, treeEnd] : TVector<std::pair<size_t, size_t>>{{0, treeCount}, {5, 37}}) {
+            TVector<double> predicts(docCount);
+            model.CalcFlat(features, treeStart, treeEnd, predicts);
+            TVector<ui32> leafIndexes(docCount * (treeEnd - treeStart));
+            model.CalcLeafIndexes(features, {}, treeStart, treeEnd, leafIndexes);
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                TVector<double> docPredict(1);
+                model.CalcFlatSingle(features[docId], treeStart, treeEnd, docPredict);
+                UNIT_ASSERT_DOUBLES_EQUAL(predicts[docId], docPredict[0], 1e-9);
+
+                TVector<ui32> docLeafIndexes(treeEnd - treeStart);
+                model.CalcLeafIndexesSingle(features[docId], {}, treeStart, treeEnd, docLeafIndexes);
+                for (size_t treeIdx = 0; treeIdx < treeEnd - treeStart; ++treeIdx) {
+                    UNIT_ASSERT_VALUES_EQUAL(leafIndexes[docId * (treeEnd - treeStart) + treeIdx], docLeafIndexes[treeIdx]);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestCompactLeafValues) {
+        TFastRng64 rng(5);
+        TVector<TFloatFeature> floatFeatures;
+        for (int featureIdx : xrange(3)) {
+            floatFeatures.push_back(TFloatFeature{false, featureIdx, featureIdx, {}, ""});
+        }
+        TNonSymmetricTreeModelBuilder builder(floatFeatures, TVector<TCatFeature>{}, TVector<TTextFeature>{}, 1);
+        for (size_t treeIdx = 0; treeIdx < 100; ++treeIdx) {
+            builder.AddTree(MakeRandomNonSymmetricTree(/*maxDepth*/ 6, &rng));
+        }
+        TFullModel model;
+        builder.Build(model.ModelTrees.GetMutable());
+        model.UpdateDynamicData();
+        model.SetScaleAndBias({-2.0, 0.5});
+
+        CheckCompactLeafValues(model, &rng);
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        UNIT_ASSERT_EXCEPTION(evaluator->SetProperty("LeafValuesPrecision", "UI4"), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestBinaryDecisionsMatchCalcFlat) {
+        TFastRng64 rng(17);
+        TVector<TFloatFeature> floatFeatures;
+        for (int featureIdx : xrange(3)) {
+            floatFeatures.push_back(TFloatFeature{false, featureIdx, featureIdx, {}, ""});
+        }
+        TNonSymmetricTreeModelBuilder builder(floatFeatures, TVector<TCatFeature>{}, TVector<TTextFeature>{}, 1);
+        for (size_t treeIdx = 0; treeIdx < 150; ++treeIdx) {
+            builder.AddTree(MakeRandomNonSymmetricTree(/*maxDepth*/ 4, &rng));
+        }
+        TFullModel model;
+        builder.Build(model.ModelTrees.GetMutable());
+        model.UpdateDynamicData();
+
+        const size_t docCount = 1000;
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        for (const auto& scaleAndBias : TVector<TScaleAndBias>{{1.0, 0.0}, {-0.5, 3.0}}) {
+            model.SetScaleAndBias(scaleAndBias);
+            TVector<double> predicts(docCount);
+            model.CalcFlat(features, predicts);
+            TVector<double> sortedPredicts = predicts;
+            Sort(sortedPredicts);
+            for (double quantile : {0.01, 0.5, 0.99}) {
+                const size_t thresholdIdx = quantile * docCount;
+                const double threshold = 0.5 * (sortedPredicts[thresholdIdx] + sortedPredicts[thresholdIdx + 1]);
+                for (auto [batchStart, batchSize] : TVector<std::pair<size_t, size_t>>{{0, docCount}, {7, 1}, {300, 131}}) {
+                    TVector<double> decisions(batchSize);
+                    model.CalcFlatBinaryDecisions(
+                        MakeArrayRef(features).Slice(batchStart, batchSize),
+                        threshold,
+                        decisions
+                    );
+                    for (size_t docId : xrange(batchSize)) {
+                        UNIT_ASSERT_VALUES_EQUAL(decisions[docId], double(predicts[batchStart + docId] > threshold));
+                    }
+                }
+            }
+        }
+    }
 }
@@ -0,0 +1,167 @@
+#include <catboost/libs/model/ut/lib/model_test_helpers.h>
+
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_registry.h>
+#include <catboost/private/libs/text_features/ut/lib/text_features_data.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+
+using namespace NCB;
+
+
+static TVector<double> CalcCatOnlyModel(const TFullModel& model) {
+    const TVector<TStringBuf> catFeatures[] = {{"a", "b", "c"}, {"d", "e", "f"}, {"g", "h", "k"}};
+    TVector<double> results(3);
+    model.Calc({}, catFeatures, results);
+    return results;
+}
+
+Y_UNIT_TEST_SUITE(TModelRegistry) {
+    Y_UNIT_TEST(TestCtrTablesAreShared) {
+        const auto model = TrainCatOnlyModel();
+        const TString serializedModel = SerializeModel(model);
+        const auto expectedResults = CalcCatOnlyModel(model);
+
+        TModelRegistry registry;
+        registry.SetModel("first", DeserializeModel(serializedModel));
+        const auto singleUsage = registry.GetMemoryUsage("first");
+        UNIT_ASSERT(singleUsage.CtrTablesSize > 0);
+        UNIT_ASSERT_VALUES_EQUAL(singleUsage.SharedCtrTablesSize, 0);
+
+        // copy of the model shares ctr provider with the original one
+        registry.SetModel("second", TFullModel(model));
+        for (const auto& name : {"first", "second"}) {
+            const auto usage = registry.GetMemoryUsage(name);
+            UNIT_ASSERT_VALUES_EQUAL(usage.CtrTablesSize, 0);
+            UNIT_ASSERT(usage.SharedCtrTablesSize > 0);
+            UNIT_ASSERT(usage.SharedCtrTablesSize <= singleUsage.CtrTablesSize / 2);
+            UNIT_ASSERT_EQUAL(CalcCatOnlyModel(*registry.GetModel(name)), expectedResults);
+        }
+        UNIT_ASSERT_EQUAL(*registry.GetModel("second"), model);
+
+        UNIT_ASSERT(registry.RemoveModel("second"));
+        UNIT_ASSERT(!registry.RemoveModel("second"));
+        UNIT_ASSERT_EQUAL(registry.GetModelNames(), TVector<TString>{"first"});
+        const auto usage = registry.GetMemoryUsage("first");
+        UNIT_ASSERT_VALUES_EQUAL(usage.CtrTablesSize, singleUsage.CtrTablesSize);
+        UNIT_ASSERT_VALUES_EQUAL(usage.SharedCtrTablesSize, 0);
+
+        // shared tables are saved as regular ones
+        const auto reloadedModel = DeserializeModel(SerializeModel(*registry.GetModel("first")));
+        UNIT_ASSERT_EQUAL(CalcCatOnlyModel(reloadedModel), expectedResults);
+    }
+
+    Y_UNIT_TEST(TestHotSwap) {
+        const auto catModel = TrainCatOnlyModel();
+        const auto expectedResults = CalcCatOnlyModel(catModel);
+
+        TModelRegistry registry;
+        registry.SetModel("model", TFullModel(catModel));
+        const auto inFlightModel = registry.GetModel("model");
+
+        const auto floatModel = SimpleFloatModel(2);
+        registry.SetModel("model", TFullModel(floatModel));
+        UNIT_ASSERT_EQUAL(*registry.GetModel("model"), floatModel);
+        UNIT_ASSERT(!registry.FindModel("other"));
+        UNIT_ASSERT_EXCEPTION(registry.GetModel("other"), TCatBoostException);
+
+        // previous version is alive while it is used
+        UNIT_ASSERT_EQUAL(CalcCatOnlyModel(*inFlightModel), expectedResults);
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetMemoryUsage("model").CtrTablesSize, 0);
+    }
+
+    Y_UNIT_TEST(TestMemoryUsageCountsPublishedModelsOnly) {
+        const auto catModel = TrainCatOnlyModel();
+        const auto expectedResults = CalcCatOnlyModel(catModel);
+
+        TModelRegistry registry;
+        registry.SetModel("first", TFullModel(catModel));
+        const auto singleUsage = registry.GetMemoryUsage("first");
+        registry.SetModel("second", TFullModel(catModel));
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetMemoryUsage("first").CtrTablesSize, 0);
+
+        // in-flight previous version of the second model still uses the shared tables
+        const auto inFlightModel = registry.GetModel("second");
+        registry.SetModel("second", SimpleFloatModel(2));
+        const auto usage = registry.GetMemoryUsage("first");
+        UNIT_ASSERT_VALUES_EQUAL(usage.CtrTablesSize, singleUsage.CtrTablesSize);
+        UNIT_ASSERT_VALUES_EQUAL(usage.SharedCtrTablesSize, 0);
+        UNIT_ASSERT_EQUAL(CalcCatOnlyModel(*inFlightModel), expectedResults);
+    }
+
+    Y_UNIT_TEST(TestTextProcessingPartsAreShared) {
+        TVector<NCBTest::TTextFeature> features;
+        TVector<NCBTest::TTokenizedTextFeature> tokenizedFeatures;
+        TVector<TDigitizer> digitizers;
+        TVector<TTextFeatureCalcerPtr> calcers;
+        TVector<TVector<ui32>> perFeatureDigitizers;
+        TVector<TVector<ui32>> perTokenizedFeatureCalcers;
+
+        NCBTest::CreateTextDataForTest(
+            &features,
+            &tokenizedFeatures,
+            &digitizers,
+            &calcers,
+            &perFeatureDigitizers,
+            &perTokenizedFeatureCalcers
+        );
+
+        auto textProcessingCollection = MakeIntrusive<TTextProcessingCollection>(
+            digitizers,
+            calcers,
+            perFeatureDigitizers,
+            perTokenizedFeatureCalcers
+        );
+
+        TVector<TVector<TStringBuf>> textFeatures;
+        for (auto& feature: features) {
+            textFeatures.emplace_back(feature.begin(), feature.end());
+        }
+        TVector<double> expectedResults(textProcessingCollection->TotalNumberOfOutputFeatures() * features[0].size());
+        const auto model = SimpleTextModel(
+            textProcessingCollection,
+            MakeConstArrayRef(textFeatures),
+            MakeArrayRef(expectedResults)
+        );
+        const TString serializedModel = SerializeModel(model);
+
+        TModelRegistry registry;
+        registry.SetModel("first", DeserializeModel(serializedModel));
+        registry.SetModel("second", DeserializeModel(serializedModel));
+        const auto firstModel = registry.GetModel("first");
+        const auto secondModel = registry.GetModel("second");
+        for (auto digitizerId : xrange(digitizers.size())) {
+            UNIT_ASSERT_EQUAL(
+                firstModel->TextProcessingCollection->GetDictionary(digitizerId).Get(),
+                secondModel->TextProcessingCollection->GetDictionary(digitizerId).Get()
+            );
+        }
+        for (auto calcerId : xrange(calcers.size())) {
+            UNIT_ASSERT_EQUAL(
+                firstModel->TextProcessingCollection->GetCalcer(calcerId).Get(),
+                secondModel->TextProcessingCollection->GetCalcer(calcerId).Get()
+            );
+        }
+
+        const ui32 docCount = features[0].size();
+        TVector<TVector<TStringBuf>> transposedTextFeatures;
+        for (ui32 docId : xrange(docCount)) {
+            auto& docTextFeatures = transposedTextFeatures.emplace_back();
+            for (const auto& feature : features) {
+                docTextFeatures.emplace_back(feature[docId]);
+            }
+        }
+        // each tree of the model uses one estimated feature
+        for (const auto& registeredModel : {firstModel, secondModel}) {
+            TVector<double> results(docCount);
+            for (ui32 treeIdx : xrange(registeredModel->GetTreeCount())) {
+                registeredModel->Calc({}, {}, transposedTextFeatures, treeIdx, treeIdx + 1, results);
+                for (ui32 docId : xrange(docCount)) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(expectedResults[treeIdx * docCount + docId], results[docId], 1e-8);
+                }
+            }
+        }
+    }
+}
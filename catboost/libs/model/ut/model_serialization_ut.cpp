@@ -4,6 +4,7 @@
 #include <catboost/libs/model/model_build_helper.h>
 #include <catboost/libs/model/model_export/json_model_helpers.h>
 #include <catboost/libs/model/model_export/model_exporter.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <catboost/private/libs/algo/apply.h>
 #include <catboost/private/libs/algo/learn_context.h>
@@ -39,6 +40,43 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         DoSerializeDeserialize(trainedModel);
     }
 
+    Y_UNIT_TEST(TestSerializeDeserializeFingerprintCtrIndex) {
+        const TFullModel denseModel = TrainCatOnlyModel();
+        // seen and unseen categories
+        const TVector<TVector<TStringBuf>> catFeatures = {
+            {"a", "d", "g"},
+            {"b", "f", "k"},
+            {"c", "unseen", "h"},
+            {"unseen", "e", "unseen"}
+        };
+        TVector<double> expectedPredicts(catFeatures.size());
+        denseModel.Calc({}, catFeatures, expectedPredicts);
+
+        TFullModel fingerprintModel = denseModel;
+        SetCtrIndexFormat(ECtrIndexFormat::Fingerprint, &fingerprintModel);
+        TStringStream strStream;
+        fingerprintModel.Save(&strStream);
+        TFullModel deserializedModel;
+        deserializedModel.Load(&strStream);
+        UNIT_ASSERT_EQUAL(fingerprintModel, deserializedModel);
+        const auto* ctrProvider = dynamic_cast<const TStaticCtrProvider*>(deserializedModel.CtrProvider.Get());
+        UNIT_ASSERT(ctrProvider && !ctrProvider->CtrData.LearnCtrs.empty());
+        for (const auto& [ctrBase, valueTable] : ctrProvider->CtrData.LearnCtrs) {
+            UNIT_ASSERT_EQUAL(valueTable.GetIndexFormat(), ECtrIndexFormat::Fingerprint);
+        }
+
+        TVector<double> predicts(catFeatures.size());
+        deserializedModel.Calc({}, catFeatures, predicts);
+        UNIT_ASSERT_EQUAL(predicts, expectedPredicts);
+        for (const auto& docCatFeatures : catFeatures) {
+            TVector<double> docPredict(1);
+            deserializedModel.Calc({}, TVector<TVector<TStringBuf>>{docCatFeatures}, docPredict);
+            TVector<double> expectedDocPredict(1);
+            denseModel.Calc({}, TVector<TVector<TStringBuf>>{docCatFeatures}, expectedDocPredict);
+            UNIT_ASSERT_EQUAL(docPredict, expectedDocPredict);
+        }
+    }
+
     Y_UNIT_TEST(TestSerializeDeserializeCoreML) {
         TFullModel trainedModel = TrainFloatCatboostModel();
         TStringStream strStream;
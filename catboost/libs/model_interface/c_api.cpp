@@ -177,10 +177,39 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* mo
     return true;
 }
 
+CATBOOST_API bool CalcModelPredictionWithHashedCatFeaturesStrided(ModelCalcerHandle* modelHandle, size_t docCount,
+                                                     const float* floatFeatures, size_t floatFeaturesSize, size_t floatFeaturesStride,
+                                                     const int* catFeatures, size_t catFeaturesSize, size_t catFeaturesStride,
+                                                     double* result, size_t resultSize) {
+    try {
+        CB_ENSURE(floatFeaturesStride >= floatFeaturesSize, "float features stride is less than float feature count");
+        CB_ENSURE(catFeaturesStride >= catFeaturesSize, "cat features stride is less than cat feature count");
+        TVector<TConstArrayRef<float>> floatFeaturesVec(docCount);
+        TVector<TConstArrayRef<int>> catFeaturesVec(catFeaturesSize ? docCount : 0);
+        for (size_t i = 0; i < docCount; ++i) {
+            floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures + i * floatFeaturesStride, floatFeaturesSize);
+        }
+        for (size_t i = 0; i < catFeaturesVec.size(); ++i) {
+            catFeaturesVec[i] = TConstArrayRef<int>(catFeatures + i * catFeaturesStride, catFeaturesSize);
+        }
+        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 CATBOOST_API int GetStringCatFeatureHash(const char* data, size_t size) {
     return CalcCatFeatureHash(TStringBuf(data, size));
 }
 
+CATBOOST_API void GetStringCatFeatureHashes(const char** data, const size_t* sizes, size_t count, int* hashes) {
+    for (size_t i = 0; i < count; ++i) {
+        hashes[i] = CalcCatFeatureHash(TStringBuf(data[i], sizes[i]));
+    }
+}
+
 CATBOOST_API int GetIntegerCatFeatureHash(long long val) {
     TStringBuilder valStr;
     valStr << val;
@@ -171,6 +171,32 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeatures(
     const int** catFeatures, size_t catFeaturesSize,
     double* result, size_t resultSize);
 
+/**
+ * Calculate raw model predictions on float features and hashed categorical feature values stored
+ * in contiguous row-major matrices.
+ * Unlike CalcModelPredictionWithHashedCatFeatures no per-object pointer arrays are required.
+ * @param calcer model handle
+ * @param docCount object count
+ * @param floatFeatures pointer to the first row of float features matrix
+ * @param floatFeaturesSize float feature count
+ * @param floatFeaturesStride distance (in elements) between beginnings of consecutive rows of floatFeatures,
+ * should not be less than floatFeaturesSize
+ * @param catFeatures pointer to the first row of hashed categorical features matrix
+ * @param catFeaturesSize categorical feature count
+ * @param catFeaturesStride distance (in elements) between beginnings of consecutive rows of catFeatures,
+ * should not be less than catFeaturesSize
+ * @param result pointer to user allocated results vector
+ * @param resultSize result size should be equal to modelApproxDimension * docCount
+ * (e.g. for non multiclass models should be equal to docCount)
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelPredictionWithHashedCatFeaturesStrided(
+    ModelCalcerHandle* modelHandle,
+    size_t docCount,
+    const float* floatFeatures, size_t floatFeaturesSize, size_t floatFeaturesStride,
+    const int* catFeatures, size_t catFeaturesSize, size_t catFeaturesStride,
+    double* result, size_t resultSize);
+
 /**
  * Get hash for given string value
  * @param data we don't expect data to be zero terminated, so pass correct size
@@ -179,6 +205,15 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeatures(
  */
 CATBOOST_API int GetStringCatFeatureHash(const char* data, size_t size);
 
+/**
+ * Get hashes for a batch of string values
+ * @param data array of string pointers, we don't expect strings to be zero terminated
+ * @param sizes array of string lengths
+ * @param count number of strings
+ * @param hashes pointer to user allocated array of size count
+ */
+CATBOOST_API void GetStringCatFeatureHashes(const char** data, const size_t* sizes, size_t count, int* hashes);
+
 /**
  * Special case for hash calculation - integer hash.
  * Internally we cast value to string and then calulcate string hash function.
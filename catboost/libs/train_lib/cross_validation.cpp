@@ -28,13 +28,21 @@
 #include <util/generic/scope.h>
 #include <util/generic/ymath.h>
 #include <util/generic/maybe.h>
+#include <util/stream/format.h>
 #include <util/stream/labeled.h>
 #include <util/string/cast.h>
 #include <util/system/compiler.h>
+#include <util/system/event.h>
+#include <util/system/guard.h>
 #include <util/system/hp_timer.h>
+#include <util/system/mem_info.h>
+#include <util/system/rusage.h>
+#include <util/system/spinlock.h>
 
+#include <atomic>
 #include <cmath>
 #include <numeric>
+#include <thread>
 
 
 using namespace NCB;
@@ -302,9 +310,6 @@ void TrainBatch(
     NPar::TLocalExecutor* localExecutor,
     TMaybe<ui32>* upToIteration) { // exclusive bound, if not inited - init from profile data
 
-    // don't output data from folds training
-    TSetLoggingSilent silentMode;
-
     const size_t batchStartIteration = foldContext->MetricValuesOnTest.size();
     Y_ASSERT(
         !batchStartIteration ||
@@ -492,6 +497,169 @@ void UpdatePermutationBlockSize(
     }
 }
 
+/* Samples process RSS while folds are trained: peak RSS of a fold is the maximum of samples taken between
+ * its start and finish. RSS is process-wide, so if folds are trained concurrently their peaks include each other.
+ */
+class TFoldPeakRssSampler {
+public:
+    TFoldPeakRssSampler(size_t foldCount, TDuration samplingPeriod)
+        : StartRss(foldCount, 0)
+        , PeakRss(foldCount, 0)
+        , IsTraining(foldCount, false)
+    {
+        Sampler = std::thread(
+            [this, samplingPeriod] () {
+                while (!Stopped.WaitT(samplingPeriod)) {
+                    Sample();
+                }
+            }
+        );
+    }
+
+    ~TFoldPeakRssSampler() {
+        Stopped.Signal();
+        Sampler.join();
+    }
+
+    void StartFold(size_t foldIdx) {
+        const ui64 rss = NMemInfo::GetMemInfo().RSS;
+        with_lock (Lock) {
+            StartRss[foldIdx] = rss;
+            PeakRss[foldIdx] = rss;
+            IsTraining[foldIdx] = true;
+        }
+    }
+
+    void FinishFold(size_t foldIdx) {
+        const ui64 rss = NMemInfo::GetMemInfo().RSS;
+        with_lock (Lock) {
+            PeakRss[foldIdx] = Max(PeakRss[foldIdx], rss);
+            IsTraining[foldIdx] = false;
+        }
+    }
+
+    // call after all folds are finished
+    ui64 GetStartRss(size_t foldIdx) const {
+        return StartRss[foldIdx];
+    }
+
+    ui64 GetPeakRss(size_t foldIdx) const {
+        return PeakRss[foldIdx];
+    }
+
+private:
+    void Sample() {
+        const ui64 rss = NMemInfo::GetMemInfo().RSS;
+        with_lock (Lock) {
+            for (auto foldIdx : xrange(IsTraining.size())) {
+                if (IsTraining[foldIdx]) {
+                    PeakRss[foldIdx] = Max(PeakRss[foldIdx], rss);
+                }
+            }
+        }
+    }
+
+private:
+    TVector<ui64> StartRss; // [foldIdx]
+    TVector<ui64> PeakRss; // [foldIdx]
+    TVector<bool> IsTraining; // [foldIdx]
+    TAdaptiveLock Lock;
+    TManualEvent Stopped;
+    std::thread Sampler;
+};
+
+/* Each fold is trained up to globalMaxIteration in a single TrainBatch call on a dedicated executor.
+ * Folds are dispatched dynamically among ParallelFoldCount workers so that workers that finished short
+ * folds pick up remaining ones. Fold learning state is released right after training, only the metric
+ * values and last eval result are kept in foldContexts.
+ * Overfitting detector is not supported: folds are trained without checking the averaged metric.
+ */
+static void TrainFoldsIndependently(
+    const NCatboostOptions::TCatBoostOptions& catboostOptions,
+    const TMaybe<TCustomObjectiveDescriptor>& objectiveDescriptor,
+    const TMaybe<TCustomMetricDescriptor>& evalMetricDescriptor,
+    const TLabelConverter& labelConverter,
+    TConstArrayRef<THolder<IMetric>> metrics,
+    TConstArrayRef<bool> skipMetricOnTrain,
+    ui32 parallelFoldCount,
+    ELoggingLevel loggingLevel,
+    IModelTrainer* modelTrainer,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TFoldContext>* foldContexts
+) {
+    const ui32 globalMaxIteration = catboostOptions.BoostingOptions->IterationCount;
+    const int workerCount = (int)Min<size_t>(parallelFoldCount, foldContexts->size());
+    const int threadsPerWorker = Max(1, (localExecutor->GetThreadCount() + 1) / workerCount);
+
+    TVector<THolder<NPar::TLocalExecutor>> workerExecutors;
+    for (auto workerIdx : xrange(workerCount)) {
+        Y_UNUSED(workerIdx);
+        workerExecutors.push_back(MakeHolder<NPar::TLocalExecutor>());
+        workerExecutors.back()->RunAdditionalThreads(threadsPerWorker - 1);
+    }
+
+    CATBOOST_INFO_LOG << "CrossValidation: training " << foldContexts->size() << " folds independently in "
+        << workerCount << " concurrent tasks with " << threadsPerWorker << " threads each" << Endl;
+
+    TVector<double> foldTrainingTime(foldContexts->size(), 0.0); // [foldIdx]
+    TFoldPeakRssSampler rssSampler(foldContexts->size(), TDuration::MilliSeconds(50));
+
+    {
+        /* don't output data from folds training
+         * log priority is process-global, so it is changed once here and not by concurrent TrainBatch calls
+         */
+        TSetLoggingSilent silentMode;
+
+        std::atomic<size_t> nextFoldIdx{0};
+        localExecutor->ExecRangeWithThrow(
+            [&] (int workerIdx) {
+                for (size_t foldIdx = nextFoldIdx++; foldIdx < foldContexts->size(); foldIdx = nextFoldIdx++) {
+                    auto& foldContext = (*foldContexts)[foldIdx];
+
+                    THPTimer timer;
+                    rssSampler.StartFold(foldIdx);
+                    TMaybe<ui32> upToIteration = globalMaxIteration;
+                    TrainBatch(
+                        catboostOptions,
+                        objectiveDescriptor,
+                        evalMetricDescriptor,
+                        labelConverter,
+                        metrics,
+                        skipMetricOnTrain,
+                        /*maxTimeSpentOnFixedCostRatio*/ 0.0, // unused because upToIteration is already defined
+                        globalMaxIteration,
+                        globalMaxIteration,
+                        /*isErrorTrackerActive*/ false,
+                        loggingLevel,
+                        &foldContext,
+                        modelTrainer,
+                        workerExecutors[workerIdx].Get(),
+                        &upToIteration);
+                    foldTrainingTime[foldIdx] = timer.Passed();
+                    rssSampler.FinishFold(foldIdx);
+
+                    // learning continuation is not needed, release approxes, permutations and CTR data
+                    foldContext.LearnProgress.Destroy();
+                }
+            },
+            0,
+            workerCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    for (auto foldIdx : xrange(foldContexts->size())) {
+        const ui64 startRss = rssSampler.GetStartRss(foldIdx);
+        const ui64 peakRss = rssSampler.GetPeakRss(foldIdx);
+        CATBOOST_INFO_LOG << "CrossValidation: Trained fold " << foldIdx << '/' << foldContexts->size()
+            << " in " << FloatToString(foldTrainingTime[foldIdx], PREC_NDIGITS, 2) << " sec"
+            << ", peak process RSS during the fold training = " << HumanReadableSize(peakRss, SF_BYTES)
+            << " (+" << HumanReadableSize(peakRss - startRss, SF_BYTES) << " since the fold start"
+            << (workerCount > 1 ? ", including concurrently trained folds)" : ")") << Endl;
+    }
+    CATBOOST_INFO_LOG << "CrossValidation: peak process RSS = "
+        << HumanReadableSize(TRusage::Get().MaxRss, SF_BYTES) << Endl;
+}
+
 void CrossValidate(
     NJson::TJsonValue plainJsonParams,
     const TMaybe<TCustomObjectiveDescriptor>& objectiveDescriptor,
@@ -691,6 +859,27 @@ void CrossValidate(
 
     ui32 globalMaxIteration = catBoostOptions.BoostingOptions->IterationCount;
 
+    const bool trainFoldsIndependently = cvParams.ParallelFoldCount > 1;
+    if (trainFoldsIndependently) {
+        CB_ENSURE(taskType == ETaskType::CPU, "Independent training of CV folds is supported only on CPU");
+        CB_ENSURE(
+            !errorTracker.IsActive(),
+            "Overfitting detector is not supported for independent training of CV folds (parallel fold count > 1)"
+        );
+        TrainFoldsIndependently(
+            catBoostOptions,
+            objectiveDescriptor,
+            evalMetricDescriptor,
+            labelConverter,
+            metrics,
+            skipMetricOnTrain,
+            cvParams.ParallelFoldCount,
+            loggingLevel,
+            modelTrainerHolder.Get(),
+            localExecutor,
+            &foldContexts);
+    }
+
     TProfileInfo profile(globalMaxIteration);
 
     ui32 iteration = 0;
@@ -706,26 +895,34 @@ void CrossValidate(
          * will be of different size
          */
         TMaybe<ui32> batchEndIteration;
+        if (trainFoldsIndependently) {
+            // all folds have already been trained, only aggregate metrics
+            batchEndIteration = globalMaxIteration;
+        }
 
-        for (auto foldIdx : xrange(foldContexts.size())) {
+        for (auto foldIdx : xrange(trainFoldsIndependently ? 0 : foldContexts.size())) {
             THPTimer timer;
 
-            TrainBatch(
-                catBoostOptions,
-                objectiveDescriptor,
-                evalMetricDescriptor,
-                labelConverter,
-                metrics,
-                skipMetricOnTrain,
-                cvParams.MaxTimeSpentOnFixedCostRatio,
-                cvParams.DevMaxIterationsBatchSize,
-                globalMaxIteration,
-                errorTracker.IsActive(),
-                loggingLevel,
-                &foldContexts[foldIdx],
-                modelTrainerHolder.Get(),
-                localExecutor,
-                &batchEndIteration);
+            {
+                // don't output data from folds training
+                TSetLoggingSilent silentMode;
+                TrainBatch(
+                    catBoostOptions,
+                    objectiveDescriptor,
+                    evalMetricDescriptor,
+                    labelConverter,
+                    metrics,
+                    skipMetricOnTrain,
+                    cvParams.MaxTimeSpentOnFixedCostRatio,
+                    cvParams.DevMaxIterationsBatchSize,
+                    globalMaxIteration,
+                    errorTracker.IsActive(),
+                    loggingLevel,
+                    &foldContexts[foldIdx],
+                    modelTrainerHolder.Get(),
+                    localExecutor,
+                    &batchEndIteration);
+            }
 
             Y_ASSERT(batchEndIteration); // should be inited right after the first iteration of the first fold
             CATBOOST_INFO_LOG << "CrossValidation: Processed batch of iterations [" << batchStartIteration
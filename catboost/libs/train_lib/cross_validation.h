@@ -207,6 +207,7 @@ public:
 
 };
 
+// log priority is not changed here, callers silence the process-global logger around training
 void TrainBatch(
     const NCatboostOptions::TCatBoostOptions& catboostOption,
     const TMaybe<TCustomObjectiveDescriptor>& objectiveDescriptor,
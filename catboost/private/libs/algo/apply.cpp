@@ -14,6 +14,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/cast.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 
 #include <cmath>
 
@@ -217,6 +218,125 @@ TVector<TVector<double>> ApplyModelMulti(
     return approxes;
 }
 
+void ApplyModelFlat(
+    const TFullModel& model,
+    TConstArrayRef<float> features,
+    size_t objectCount,
+    size_t featureCount,
+    bool isColumnMajor,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount,
+    TArrayRef<double> results)
+{
+    CB_ENSURE(
+        !model.HasCategoricalFeatures() && !model.HasTextFeatures(),
+        "Applying model to flat float features is not supported for models with categorical or text features"
+    );
+    CB_ENSURE(features.size() == objectCount * featureCount, "Features size doesn't match objects and features count");
+    CB_ENSURE(
+        EqualToOneOf(predictionType, EPredictionType::RawFormulaVal, EPredictionType::Exponent, EPredictionType::Probability),
+        "Prediction type " << predictionType << " is not supported for flat features"
+    );
+    const size_t approxDimension = model.GetDimensionsCount();
+    CB_ENSURE(
+        predictionType != EPredictionType::Exponent || approxDimension == 1,
+        "Prediction type " << predictionType << " is supported for flat features only for single-dimensional models"
+    );
+
+    /* Single-dimensional predictions are calculated by the evaluator in place.
+     * Predictions of multi-dimensional models are calculated from raw values by PrepareEvalForInternalApprox
+     *  as in ApplyModelMulti: it takes the loss function (softmax or sigmoid per dimension) and
+     *  the external class labels of the model into account.
+     */
+    size_t resultDimension;
+    if (approxDimension == 1) {
+        resultDimension = (predictionType == EPredictionType::Probability) ? 2 : 1;
+    } else {
+        const TExternalLabelsHelper externalLabelsHelper(model);
+        resultDimension
+            = (externalLabelsHelper.IsInitialized() && (externalLabelsHelper.GetExternalApproxDimension() > 1)) ?
+                externalLabelsHelper.GetExternalApproxDimension()
+                : approxDimension;
+    }
+    CB_ENSURE(
+        results.size() == objectCount * resultDimension,
+        "Results size " << results.size() << " doesn't match expected " << objectCount * resultDimension
+    );
+    if (objectCount == 0) {
+        return;
+    }
+    FixupTreeEnd(model.GetTreeCount(), begin, &end);
+
+    auto evaluator = model.GetCurrentEvaluator()->Clone();
+    evaluator->SetPredictionType(NModelEvaluation::EPredictionType::RawFormulaVal);
+    if (approxDimension == 1) {
+        if (predictionType == EPredictionType::Exponent) {
+            evaluator->SetPredictionType(NModelEvaluation::EPredictionType::Exponent);
+        } else if (predictionType == EPredictionType::Probability) {
+            evaluator->SetPredictionType(NModelEvaluation::EPredictionType::Probability);
+        }
+    }
+
+    const auto blockParams = GetBlockParams(threadCount, SafeIntegerCast<int>(objectCount), end - begin);
+    const auto applyOnBlock = [&](int blockId) {
+        const size_t blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+        const size_t blockLastIdx = Min<size_t>(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
+        const size_t blockObjectCount = blockLastIdx - blockFirstIdx;
+
+        TVector<double> blockApproxFlat; // used for multi-dimensional models only
+        TArrayRef<double> blockApprox;
+        if (approxDimension == 1) {
+            blockApprox = results.Slice(blockFirstIdx * resultDimension, blockObjectCount);
+        } else {
+            blockApproxFlat.yresize(blockObjectCount * approxDimension);
+            blockApprox = blockApproxFlat;
+        }
+        if (isColumnMajor) {
+            TVector<TConstArrayRef<float>> featureColumns(Reserve(featureCount));
+            for (auto featureIdx : xrange(featureCount)) {
+                featureColumns.push_back(features.Slice(featureIdx * objectCount + blockFirstIdx, blockObjectCount));
+            }
+            evaluator->CalcFlatTransposed(featureColumns, begin, end, blockApprox);
+        } else {
+            TVector<TConstArrayRef<float>> objectRows(Reserve(blockObjectCount));
+            for (auto objectIdx : xrange(blockFirstIdx, blockLastIdx)) {
+                objectRows.push_back(features.Slice(objectIdx * featureCount, featureCount));
+            }
+            evaluator->CalcFlat(objectRows, begin, end, blockApprox);
+        }
+
+        double* blockResults = results.data() + blockFirstIdx * resultDimension;
+        if (approxDimension > 1) {
+            TVector<TVector<double>> approx(approxDimension, TVector<double>(blockObjectCount));
+            for (auto objectIdx : xrange(blockObjectCount)) {
+                for (auto dim : xrange(approxDimension)) {
+                    approx[dim][objectIdx] = blockApproxFlat[objectIdx * approxDimension + dim];
+                }
+            }
+            const auto prediction = PrepareEvalForInternalApprox(predictionType, model, approx);
+            CB_ENSURE_INTERNAL(prediction.size() == resultDimension, "Unexpected prediction dimension");
+            for (auto objectIdx : xrange(blockObjectCount)) {
+                for (auto dim : xrange(resultDimension)) {
+                    blockResults[objectIdx * resultDimension + dim] = prediction[dim][objectIdx];
+                }
+            }
+        } else if (predictionType == EPredictionType::Probability) {
+            // in place from the end: probability of object i moves to 2 * i + 1, so it is never overwritten early
+            for (size_t objectIdx = blockObjectCount; objectIdx > 0; --objectIdx) {
+                const double probability = blockResults[objectIdx - 1];
+                blockResults[2 * (objectIdx - 1)] = 1 - probability;
+                blockResults[2 * (objectIdx - 1) + 1] = probability;
+            }
+        }
+    };
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(Min<int>(threadCount, blockParams.GetBlockCount()) - 1);
+    executor.ExecRangeWithThrow(applyOnBlock, 0, blockParams.GetBlockCount(), TLocalExecutor::WAIT_COMPLETE);
+}
+
 TMinMax<double> ApplyModelForMinMax(
     const TFullModel& model,
     const NCB::TObjectsDataProvider& objectsData,
@@ -342,6 +462,89 @@ TModelCalcerOnPool::TModelCalcerOnPool(
     );
 }
 
+void TModelCalcerOnPool::AddApproxMultiFlat(int begin, int end, TArrayRef<double> flatApprox) {
+    const ui32 approxDimension = Model->GetDimensionsCount();
+    CB_ENSURE_INTERNAL(
+        flatApprox.size() == ObjectsData->GetObjectCount() * approxDimension,
+        "Unexpected approx buffer size " << flatApprox.size()
+    );
+    if (BlockParams.FirstId == BlockParams.LastId) {
+        return;
+    }
+    FixupTreeEnd(Model->GetTreeCount(), begin, &end);
+    ApproxBuffersForThreads.resize(BlockParams.GetBlockCount());
+
+    Executor->ExecRangeWithThrow(
+        [&, this](int blockId) {
+            const int blockFirstId = BlockParams.FirstId + blockId * BlockParams.GetBlockSize();
+            const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
+            const size_t blockApproxSize = (blockLastId - blockFirstId) * approxDimension;
+
+            // evaluator overwrites its output, so evaluate into a buffer and accumulate
+            TVector<double>& blockApprox = ApproxBuffersForThreads[blockId];
+            blockApprox.yresize(blockApproxSize);
+            ModelEvaluator->Calc(QuantizedDataForThreads[blockId].Get(), begin, end, blockApprox);
+
+            double* dst = flatApprox.data() + blockFirstId * approxDimension;
+            for (size_t i = 0; i < blockApproxSize; ++i) {
+                dst[i] += blockApprox[i];
+            }
+        },
+        0,
+        BlockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+TStagedModelCalcerOnPool::TStagedModelCalcerOnPool(
+    const TFullModel& model,
+    TObjectsDataProviderPtr objectsData,
+    NPar::TLocalExecutor* executor,
+    int treeBegin,
+    int treeEnd,
+    int evalPeriod)
+    : Model(&model)
+    , Executor(executor)
+    , ModelCalcer(model, objectsData, executor)
+    , TreeEnd(treeEnd ? treeEnd : SafeIntegerCast<int>(model.GetTreeCount()))
+    , EvalPeriod(evalPeriod)
+    , CurrentTreeEnd(treeBegin)
+{
+    CB_ENSURE(
+        0 <= treeBegin && TreeEnd <= SafeIntegerCast<int>(model.GetTreeCount()),
+        "Out of range tree range [" << treeBegin << ", " << TreeEnd << ")"
+    );
+    CB_ENSURE(EvalPeriod > 0, "Eval period must be positive, got " << EvalPeriod);
+    FlatApprox.resize(objectsData->GetObjectCount() * model.GetDimensionsCount(), 0.0);
+}
+
+bool TStagedModelCalcerOnPool::Next() {
+    if (CurrentTreeEnd >= TreeEnd) {
+        return false;
+    }
+    const int stageEnd = Min(CurrentTreeEnd + EvalPeriod, TreeEnd);
+    ModelCalcer.AddApproxMultiFlat(CurrentTreeEnd, stageEnd, FlatApprox);
+    CurrentTreeEnd = stageEnd;
+    return true;
+}
+
+void TStagedModelCalcerOnPool::GetApprox(
+    const EPredictionType predictionType,
+    TVector<TVector<double>>* approx) const
+{
+    const size_t approxDimension = Model->GetDimensionsCount();
+    const size_t docCount = FlatApprox.size() / approxDimension;
+    approx->resize(approxDimension);
+    for (auto dim : xrange(approxDimension)) {
+        (*approx)[dim].yresize(docCount);
+        for (auto doc : xrange(docCount)) {
+            (*approx)[dim][doc] = FlatApprox[approxDimension * doc + dim];
+        }
+    }
+    if (predictionType != EPredictionType::InternalRawFormulaVal) {
+        *approx = PrepareEvalForInternalApprox(predictionType, *Model, *approx, Executor);
+    }
+}
+
 TLeafIndexCalcerOnPool::TLeafIndexCalcerOnPool(
     const TFullModel& model,
     NCB::TObjectsDataProviderPtr objectsData,
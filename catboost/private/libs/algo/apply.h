@@ -9,6 +9,7 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 
@@ -46,6 +47,28 @@ TVector<TVector<double>> ApplyModelMulti(
     int end = 0,
     int threadCount = 1);
 
+/**
+ * Apply model to a dense matrix of flat float features without creating an objects data provider.
+ * Evaluator reads features in place and writes predictions directly to results.
+ * @param features objectCount x featureCount matrix, row-major (features of an object are contiguous)
+ *  or column-major if isColumnMajor
+ * @param predictionType RawFormulaVal, Exponent (single-dimensional models only) or Probability,
+ *  predictions are the same as the ones of ApplyModelMulti
+ * @param results [objectIdx * resultDimension + dim], resultDimension is 2 (probabilities of both classes)
+ *  for Probability of single-dimensional model and external model dimensions count (classes count) otherwise
+ */
+void ApplyModelFlat(
+    const TFullModel& model,
+    TConstArrayRef<float> features,
+    size_t objectCount,
+    size_t featureCount,
+    bool isColumnMajor,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount,
+    TArrayRef<double> results);
+
 TMinMax<double> ApplyModelForMinMax(
     const TFullModel& model,
     const NCB::TObjectsDataProvider& objectsData,
@@ -71,6 +94,9 @@ public:
         TVector<double>* flatApproxBuffer,
         TVector<TVector<double>>* approx);
 
+    // add raw values of trees [begin, end) to flatApprox, [objectIdx * approxDimension + dim]
+    void AddApproxMultiFlat(int begin, int end, TArrayRef<double> flatApprox);
+
 private:
     const TFullModel* Model;
     NCB::NModelEvaluation::TConstModelEvaluatorPtr ModelEvaluator;
@@ -78,6 +104,48 @@ private:
     NPar::TLocalExecutor* Executor;
     NPar::TLocalExecutor::TExecRangeParams BlockParams;
     TVector<TIntrusivePtr<NCB::NModelEvaluation::IQuantizedData>> QuantizedDataForThreads;
+    TVector<TVector<double>> ApproxBuffersForThreads; // used only in AddApproxMultiFlat
+};
+
+
+/*
+ * Staged prediction for learning curves and eval_period:
+ * features are quantized once, running approx sums are kept for every object
+ * and each Next() evaluates only the next evalPeriod trees
+ */
+class TStagedModelCalcerOnPool {
+public:
+    TStagedModelCalcerOnPool(
+        const TFullModel& model,
+        NCB::TObjectsDataProviderPtr objectsData,
+        NPar::TLocalExecutor* executor,
+        int treeBegin,
+        int treeEnd, // 0 means all trees
+        int evalPeriod);
+
+    // returns false if all trees have already been applied
+    bool Next();
+
+    // approxes are calculated for trees [treeBegin, GetCurrentTreeEnd())
+    int GetCurrentTreeEnd() const {
+        return CurrentTreeEnd;
+    }
+
+    // [objectIdx * approxDimension + dim]
+    TConstArrayRef<double> GetFlatApprox() const {
+        return FlatApprox;
+    }
+
+    void GetApprox(const EPredictionType predictionType, TVector<TVector<double>>* approx) const;
+
+private:
+    const TFullModel* Model;
+    NPar::TLocalExecutor* Executor;
+    TModelCalcerOnPool ModelCalcer;
+    int TreeEnd;
+    int EvalPeriod;
+    int CurrentTreeEnd;
+    TVector<double> FlatApprox;
 };
 
 
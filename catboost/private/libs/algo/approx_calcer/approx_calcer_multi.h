@@ -45,6 +45,7 @@ void CalcLeafValuesMulti(
     float l2Regularizer = learnerOptions.L2Reg;
 
     TVector<TSumMulti> leafDers(isLeafwise ? 1 : leafCount, MakeZeroDers(approxDimension, estimationMethod, error.GetHessianType()));
+    TLeafDersMultiBuffers leafDersBuffers; // iteration scratch space
 
     bool haveBacktrackingObjective;
     double minimizationSign;
@@ -75,6 +76,7 @@ void CalcLeafValuesMulti(
             recalcLeafWeights,
             estimationMethod,
             localExecutor,
+            &leafDersBuffers,
             &leafDers
         );
 
@@ -94,6 +96,8 @@ void CalcLeafValuesMulti(
             l2Regularizer,
             sumWeight,
             learnSampleCount,
+            localExecutor,
+            &leafDersBuffers,
             leafDeltas
         );
     };
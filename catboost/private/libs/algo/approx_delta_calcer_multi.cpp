@@ -40,6 +40,7 @@ void CalcApproxDeltaMulti(
     const double scaledL2Regularizer = ScaleL2Reg(l2Regularizer, fold.GetSumWeight(), fold.GetLearnSampleCount());
 
     TVector<TSumMulti> leafDers(leafCount, MakeZeroDers(approxDimension, estimationMethod, error.GetHessianType()));
+    TLeafDersMultiBuffers leafDersBuffers; // iteration scratch space
 
     const auto leafUpdaterFunc = [&] (
         bool recalcLeafWeights,
@@ -57,6 +58,7 @@ void CalcApproxDeltaMulti(
             recalcLeafWeights,
             estimationMethod,
             ctx->LocalExecutor,
+            &leafDersBuffers,
             &leafDers
         );
         AddLangevinNoiseToLeafDerivativesSum(
@@ -72,6 +74,8 @@ void CalcApproxDeltaMulti(
             l2Regularizer,
             bt.BodySumWeight,
             bt.BodyFinish,
+            ctx->LocalExecutor,
+            &leafDersBuffers,
             leafDeltas
         );
     };
@@ -92,6 +96,8 @@ void CalcApproxDeltaMulti(
         TVector<double> curDelta(approxDimension);
         TVector<double> curDer(approxDimension);
         THessianInfo curDer2(approxDimension * useHessian, error.GetHessianType());
+        TVector<float> curTarget(fold.LearnTarget.size());
+        TNewtonMultiBuffers newtonBuffers;
 
         auto updateApproxesImpl = [&](auto useHessian, auto isMultiRegression, auto useWeights) {
             for (int docIdx = bt.BodyFinish; docIdx < bt.TailFinish; ++docIdx) {
@@ -99,7 +105,6 @@ void CalcApproxDeltaMulti(
                 for (auto dim : xrange(approxDimension)) {
                     curApprox[dim] = bt.Approx[dim][docIdx] + (*approxDeltas)[dim][docIdx];
                 }
-                TVector<float> curTarget(fold.LearnTarget.size());
                 for (auto dim : xrange(curTarget.size())) {
                     curTarget[dim] = fold.LearnTarget[dim][docIdx];
                 }
@@ -111,7 +116,7 @@ void CalcApproxDeltaMulti(
                         error.CalcDersMulti(curApprox, target[0][docIdx], w, &curDer, &curDer2);
                     }
                     curLeafDers.AddDerDer2(curDer, curDer2);
-                    CalcDeltaNewtonMulti(curLeafDers, l2Regularizer, bt.BodySumWeight, bt.BodyFinish, &curDelta);
+                    CalcDeltaNewtonMulti(curLeafDers, l2Regularizer, bt.BodySumWeight, bt.BodyFinish, &newtonBuffers, &curDelta);
                 } else {
                     Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
                     if (isMultiRegression) {
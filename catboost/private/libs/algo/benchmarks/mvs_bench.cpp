@@ -0,0 +1,46 @@
+#include <catboost/private/libs/algo/fold.h>
+#include <catboost/private/libs/algo/mvs.h>
+
+#include <catboost/libs/helpers/restorable_rng.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+// MVS sampling of a plain fold together with calculation of sample weighted derivatives
+static void RunMvsSampling(int approxDimension, size_t iterations) {
+    const int sampleCount = 1000000;
+
+    TRestorableFastRng64 rand(0);
+    TFold fold;
+    fold.SampleWeights.resize(sampleCount, 1);
+    TFold::TBodyTail bt(0, 0, sampleCount, sampleCount, (double)sampleCount);
+    bt.WeightedDerivatives.resize(approxDimension, TVector<double>(sampleCount));
+    bt.SampleWeightedDerivatives.resize(approxDimension, TVector<double>(sampleCount));
+    for (auto& derivatives : bt.WeightedDerivatives) {
+        for (auto& der : derivatives) {
+            der = rand.GenRandReal1() - 0.5;
+        }
+    }
+    fold.BodyTailArr.emplace_back(std::move(bt));
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+    const TMvsSampler sampler(sampleCount, /*sampleRate*/ 0.2, /*lambda*/ 1.0f);
+
+    for (auto i : xrange(iterations)) {
+        Y_UNUSED(i);
+        sampler.GenSampleWeightsWithWeightedData(/*leafValues*/ {}, &rand, &localExecutor, &fold);
+        Y_DO_NOT_OPTIMIZE_AWAY(fold.SampleWeights);
+    }
+}
+
+Y_CPU_BENCHMARK(MvsSamplingDimension1, iface) {
+    RunMvsSampling(1, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(MvsSamplingDimension10, iface) {
+    RunMvsSampling(10, iface.Iterations());
+}
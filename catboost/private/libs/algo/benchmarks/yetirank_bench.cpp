@@ -0,0 +1,62 @@
+#include <catboost/private/libs/algo/yetirank_helpers.h>
+
+#include <catboost/private/libs/options/loss_description.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+// one iteration of YetiRank pairs generation for queries of the given size, total document count is fixed
+static void RunYetiRankPairsGeneration(ui32 querySize, size_t iterations) {
+    const ui32 documentCount = 20000;
+    const ui32 queryCount = documentCount / querySize;
+
+    TFastRng64 rand(0);
+    TVector<double> approxes(documentCount);
+    TVector<float> relevances(documentCount);
+    for (auto docId : xrange(documentCount)) {
+        approxes[docId] = rand.GenRandReal1() + 0.5;
+        relevances[docId] = rand.Uniform(5);
+    }
+    TVector<TQueryInfo> queriesInfo;
+    for (auto queryIdx : xrange(queryCount)) {
+        queriesInfo.emplace_back(queryIdx * querySize, (queryIdx + 1) * querySize);
+    }
+
+    const auto lossDescription = NCatboostOptions::ParseLossDescription("YetiRank");
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+
+    for (auto i : xrange(iterations)) {
+        UpdatePairsForYetiRank(
+            approxes,
+            relevances,
+            lossDescription,
+            /*randomSeed*/ i,
+            /*queryBegin*/ 0,
+            /*queryEnd*/ queryCount,
+            &queriesInfo,
+            &localExecutor
+        );
+        Y_DO_NOT_OPTIMIZE_AWAY(queriesInfo);
+    }
+}
+
+Y_CPU_BENCHMARK(YetiRankPairsQuerySize20, iface) {
+    RunYetiRankPairsGeneration(20, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(YetiRankPairsQuerySize200, iface) {
+    RunYetiRankPairsGeneration(200, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(YetiRankPairsQuerySize2000, iface) {
+    RunYetiRankPairsGeneration(2000, iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(YetiRankPairsQuerySize20000, iface) {
+    RunYetiRankPairsGeneration(20000, iface.Iterations());
+}
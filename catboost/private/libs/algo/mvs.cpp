@@ -78,41 +78,66 @@ double TMvsSampler::GetLambda(
     return mean * mean;
 }
 
-double TMvsSampler::CalculateThreshold(
-    TVector<double>::iterator candidatesBegin,
-    TVector<double>::iterator candidatesEnd,
-    double sumOfSmallCurrent,
-    ui32 numberOfLargeCurrent,
-    double sampleSize) const {
-
-    double threshold = *candidatesBegin;
-    auto middleBegin = std::partition(candidatesBegin, candidatesEnd, [threshold](double candidate) {
-        return candidate < threshold;
-    });
-    auto middleEnd = std::partition(middleBegin, candidatesEnd, [threshold](double candidate) {
-        return candidate <= threshold;
-    });
-
-    double sumOfSmallUpdate = Accumulate(candidatesBegin, middleBegin, 0.0);
-    ui32 numberOfLargeUpdate = candidatesEnd - middleEnd;
-    ui32 numberOfMiddle = middleEnd - middleBegin;
-    double sumOfMiddle = numberOfMiddle * threshold;
-
-    double estimatedSampleSize =
-        (sumOfSmallCurrent + sumOfSmallUpdate) / threshold + numberOfLargeCurrent + numberOfLargeUpdate + numberOfMiddle;
-    if (estimatedSampleSize > sampleSize) {
-        if (middleEnd != candidatesEnd) {
-            sumOfSmallCurrent += sumOfMiddle + sumOfSmallUpdate;
-            return CalculateThreshold(middleEnd, candidatesEnd, sumOfSmallCurrent, numberOfLargeCurrent, sampleSize);
+/*
+ * Threshold t solves sum(min(1, candidate / t)) = sampleSize.
+ * The candidates range containing t is narrowed with median pivots, so selection is linear in the worst case.
+ */
+double TMvsSampler::CalculateThreshold(TArrayRef<double> candidates, double sampleSize) const {
+    auto candidatesBegin = candidates.begin();
+    auto candidatesEnd = candidates.end();
+    double sumOfSmallCurrent = 0;
+    ui32 numberOfLargeCurrent = 0;
+    while (true) {
+        const auto pivot = candidatesBegin + (candidatesEnd - candidatesBegin) / 2;
+        std::nth_element(candidatesBegin, pivot, candidatesEnd);
+        const double threshold = *pivot;
+        auto middleBegin = std::partition(candidatesBegin, candidatesEnd, [threshold](double candidate) {
+            return candidate < threshold;
+        });
+        auto middleEnd = std::partition(middleBegin, candidatesEnd, [threshold](double candidate) {
+            return candidate <= threshold;
+        });
+
+        double sumOfSmallUpdate = Accumulate(candidatesBegin, middleBegin, 0.0);
+        ui32 numberOfLargeUpdate = candidatesEnd - middleEnd;
+        ui32 numberOfMiddle = middleEnd - middleBegin;
+        double sumOfMiddle = numberOfMiddle * threshold;
+
+        double estimatedSampleSize =
+            (sumOfSmallCurrent + sumOfSmallUpdate) / threshold + numberOfLargeCurrent + numberOfLargeUpdate + numberOfMiddle;
+        if (estimatedSampleSize > sampleSize) {
+            if (middleEnd != candidatesEnd) {
+                sumOfSmallCurrent += sumOfMiddle + sumOfSmallUpdate;
+                candidatesBegin = middleEnd;
+            } else {
+                return (sumOfSmallCurrent + sumOfSmallUpdate + sumOfMiddle) / (sampleSize - numberOfLargeCurrent);
+            }
         } else {
-            return (sumOfSmallCurrent + sumOfSmallUpdate + sumOfMiddle) / (sampleSize - numberOfLargeCurrent);
+            if (middleBegin != candidatesBegin) {
+                numberOfLargeCurrent += numberOfLargeUpdate + numberOfMiddle;
+                candidatesEnd = middleBegin;
+            } else {
+                return sumOfSmallCurrent / (sampleSize - numberOfLargeCurrent - numberOfMiddle - numberOfLargeUpdate);
+            }
         }
-    } else {
-        if (middleBegin != candidatesBegin) {
-            numberOfLargeCurrent += numberOfLargeUpdate + numberOfMiddle;
-            return CalculateThreshold(candidatesBegin, middleBegin, sumOfSmallCurrent, numberOfLargeCurrent, sampleSize);
-        } else {
-            return sumOfSmallCurrent / (sampleSize - numberOfLargeCurrent - numberOfMiddle - numberOfLargeUpdate);
+    }
+}
+
+// same as CalcWeightedData in tensor_search_helpers.cpp for objects [begin, end) of plain fold
+static void CalcWeightedDataInRange(ui32 begin, ui32 end, TFold* fold) {
+    TFold::TBodyTail& bt = fold->BodyTailArr[0];
+    const auto sampleWeights = MakeArrayRef(fold->SampleWeights);
+    for (auto dim : xrange(bt.WeightedDerivatives.size())) {
+        const auto weightedDerivatives = MakeConstArrayRef(bt.WeightedDerivatives[dim]);
+        const auto sampleWeightedDerivatives = MakeArrayRef(bt.SampleWeightedDerivatives[dim]);
+        for (auto idx : xrange(begin, end)) {
+            sampleWeightedDerivatives[idx] = weightedDerivatives[idx] * sampleWeights[idx];
+        }
+    }
+    const auto& learnWeights = fold->GetLearnWeights();
+    if (!learnWeights.empty()) {
+        for (auto idx : xrange(begin, end)) {
+            sampleWeights[idx] *= learnWeights[idx];
         }
     }
 }
@@ -124,8 +149,44 @@ void TMvsSampler::GenSampleWeights(
     NPar::TLocalExecutor* localExecutor,
     TFold* fold) const {
 
+    GenSampleWeightsImpl(boostingType, leafValues, /*calcWeightedData*/ false, rand, localExecutor, fold);
+}
+
+void TMvsSampler::GenSampleWeightsWithWeightedData(
+    const TVector<TVector<TVector<double>>>& leafValues,
+    TRestorableFastRng64* rand,
+    NPar::TLocalExecutor* localExecutor,
+    TFold* fold) const {
+
+    CB_ENSURE_INTERNAL(
+        fold->BodyTailArr.size() == 1 && fold->BodyTailArr[0].TailFinish == SafeIntegerCast<int>(SampleCount),
+        "Weighted data can be calculated with MVS weights only for plain fold");
+    GenSampleWeightsImpl(EBoostingType::Plain, leafValues, /*calcWeightedData*/ true, rand, localExecutor, fold);
+}
+
+void TMvsSampler::GenSampleWeightsImpl(
+    EBoostingType boostingType,
+    const TVector<TVector<TVector<double>>>& leafValues,
+    bool calcWeightedData,
+    TRestorableFastRng64* rand,
+    NPar::TLocalExecutor* localExecutor,
+    TFold* fold) const {
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SampleCount);
+    blockParams.SetBlockSize(BlockSize);
     if (SampleRate == 1.0f) {
         Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1.0f);
+        if (calcWeightedData) {
+            localExecutor->ExecRange(
+                [&](ui32 blockId) {
+                    const ui32 blockOffset = blockId * blockParams.GetBlockSize();
+                    CalcWeightedDataInRange(blockOffset, Min<ui32>(blockOffset + blockParams.GetBlockSize(), SampleCount), fold);
+                },
+                0,
+                blockParams.GetBlockCount(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+        }
     } else {
         const auto approxDimension = fold->GetApproxDimension();
         TVector<TVector<double>> tailDerivatives;
@@ -169,8 +230,10 @@ void TMvsSampler::GenSampleWeights(
 
         double lambda = GetLambda(derivatives, leafValues, localExecutor);
 
-        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SampleCount);
-        blockParams.SetBlockSize(BlockSize);
+        // per thread buffers: norms of derivatives in block order and their copy reordered by threshold selection
+        const int threadCount = localExecutor->GetThreadCount() + 1;
+        TVector<TVector<double>> derivativeNorms(threadCount);
+        TVector<TVector<double>> thresholdCandidates(threadCount);
         const ui64 randSeed = rand->GenRand();
         localExecutor->ExecRange(
             [&](ui32 blockId) {
@@ -183,30 +246,24 @@ void TMvsSampler::GenSampleWeights(
                 );
                 const ui32 blockFinish = blockOffset + blockSize;
 
-                TVector<double> thresholdCandidates(blockSize, lambda);
+                const int threadId = localExecutor->GetWorkerThreadId();
+                auto& norms = derivativeNorms[threadId];
+                norms.assign(blockSize, lambda);
                 for (auto dim : xrange(approxDimension)) {
                     TConstArrayRef<double> derivativesRef(derivatives[dim].begin() + blockOffset, blockSize);
                     for (auto idx : xrange(blockSize)) {
                         const double der = derivativesRef[idx];
-                        thresholdCandidates[idx] += der * der;
+                        norms[idx] += der * der;
                     }
                 }
-                for (auto& value : thresholdCandidates) {
+                for (auto& value : norms) {
                     value = sqrt(value);
                 }
-                double threshold = CalculateThreshold(
-                    thresholdCandidates.begin(),
-                    thresholdCandidates.end(),
-                    0,
-                    0,
-                    SampleRate * blockSize);
+                auto& candidates = thresholdCandidates[threadId];
+                candidates.assign(norms.begin(), norms.end());
+                double threshold = CalculateThreshold(candidates, SampleRate * blockSize);
                 for (ui32 i = blockOffset; i < blockFinish; ++i) {
-                    double grad2 = 0;
-                    for (auto dim : xrange(approxDimension)) {
-                        const double der = derivatives[dim][i];
-                        grad2 += der * der;
-                    }
-                    const double probability = GetSingleProbability(sqrt(grad2 + lambda), threshold);
+                    const double probability = GetSingleProbability(norms[i - blockOffset], threshold);
                     if (probability > std::numeric_limits<double>::epsilon()) {
                         const double weight = 1 / probability;
                         double r = prng.GenRandReal1();
@@ -215,6 +272,9 @@ void TMvsSampler::GenSampleWeights(
                         fold->SampleWeights[i] = 0;
                     }
                 }
+                if (calcWeightedData) {
+                    CalcWeightedDataInRange(blockOffset, blockFinish, fold);
+                }
             },
             0,
             blockParams.GetBlockCount(),
@@ -30,17 +30,27 @@ public:
         NPar::TLocalExecutor* localExecutor,
         TFold* fold) const;
 
+    // Same as GenSampleWeights, but also fills SampleWeightedDerivatives and multiplies SampleWeights
+    // by learn weights in the same pass over data. Only for plain folds with a single body tail.
+    void GenSampleWeightsWithWeightedData(
+        const TVector<TVector<TVector<double>>>& leafValues,
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor,
+        TFold* fold) const;
+
 private:
+    void GenSampleWeightsImpl(
+        EBoostingType boostingType,
+        const TVector<TVector<TVector<double>>>& leafValues,
+        bool calcWeightedData,
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor,
+        TFold* fold) const;
     double GetLambda(
         const TVector<TConstArrayRef<double>>& derivatives,
         const TVector<TVector<TVector<double>>>& leafValues,
         NPar::TLocalExecutor* localExecutor) const;
-    double CalculateThreshold(
-        TVector<double>::iterator candidatesBegin,
-        TVector<double>::iterator candidatesEnd,
-        double sumSmall,
-        ui32 nLarge,
-        double sampleSize) const;
+    double CalculateThreshold(TArrayRef<double> candidates, double sampleSize) const;
 
 private:
     ui32 SampleCount;
@@ -38,6 +38,14 @@ void TPairwiseStats::Add(const TPairwiseStats& rhs) {
             auto& dst2 = dst1[leafIdx2];
             const auto& add2 = add1[leafIdx2];
 
+            if (add2.empty()) {
+                continue;
+            }
+            if (dst2.empty()) {
+                dst2 = add2;
+                continue;
+            }
+
             Y_ASSERT(dst2.size() == add2.size());
 
             for (auto bucketIdx : xrange(dst2.size())) {
@@ -120,6 +128,116 @@ inline static void UpdateWeightSumFromNonDiagStats(
 }
 
 
+static const TBucketPairWeightStatistics ZeroBucketPairWeightStatistics;
+
+
+inline static const TBucketPairWeightStatistics& GetBucketPairWeightStatistics(
+    const TVector<TBucketPairWeightStatistics>& leafPairStatistics,
+    size_t bucketIdx
+) {
+    return leafPairStatistics.empty() ? ZeroBucketPairWeightStatistics : leafPairStatistics[bucketIdx];
+}
+
+
+inline static double CalcSmallerBorderWeightSum(
+    const TVector<TBucketPairWeightStatistics>& leafPairStatistics,
+    size_t bucketBegin,
+    size_t bucketEnd
+) {
+    if (leafPairStatistics.empty()) {
+        return 0.0;
+    }
+    const TBucketPairWeightStatistics* data = leafPairStatistics.data();
+    auto total0 = NSimdOps::MakeZeros();
+    auto total2 = NSimdOps::MakeZeros();
+    auto bucketId = bucketBegin;
+    for (; bucketId + 2 * NSimdOps::Size <= bucketEnd; bucketId += 2 * NSimdOps::Size) {
+        total0 = NSimdOps::ElementwiseAdd(
+            total0,
+            NSimdOps::Gather(&data[bucketId + 0].SmallerBorderWeightSum, &data[bucketId + 1].SmallerBorderWeightSum));
+        total2 = NSimdOps::ElementwiseAdd(
+            total2,
+            NSimdOps::Gather(&data[bucketId + 2].SmallerBorderWeightSum, &data[bucketId + 3].SmallerBorderWeightSum));
+    }
+    double total = NSimdOps::HorizontalAdd(total0) + NSimdOps::HorizontalAdd(total2);
+    for (; bucketId < bucketEnd; ++bucketId) {
+        total += data[bucketId].SmallerBorderWeightSum;
+    }
+    return total;
+}
+
+
+namespace {
+    /* Leaf pairs with statistics. Pairs in a fold usually touch a small part of leafCount^2 leaf pairs,
+     * so the score calculation walks these lists instead of the full leaf x leaf matrix for every split.
+     */
+    struct TTouchedLeafPairs {
+        TVector<bool> HasDiagStatistics; // [leafIdx]
+        TVector<TVector<int>> NonDiagNeighbours; // [y] -> sorted x > y with statistics in [x][y] or [y][x]
+
+    public:
+        explicit TTouchedLeafPairs(const TArray2D<TVector<TBucketPairWeightStatistics>>& pairWeightStatistics) {
+            const int leafCount = pairWeightStatistics.GetYSize();
+            HasDiagStatistics.resize(leafCount);
+            NonDiagNeighbours.resize(leafCount);
+            for (int y = 0; y < leafCount; ++y) {
+                HasDiagStatistics[y] = !pairWeightStatistics[y][y].empty();
+                for (int x = y + 1; x < leafCount; ++x) {
+                    if (!pairWeightStatistics[x][y].empty() || !pairWeightStatistics[y][x].empty()) {
+                        NonDiagNeighbours[y].push_back(x);
+                    }
+                }
+            }
+        }
+    };
+}
+
+
+static void UpdateWeightSumFromTotals(
+    const TArray2D<TVector<TBucketPairWeightStatistics>>& pairWeightStatistics,
+    const TTouchedLeafPairs& touchedLeafPairs,
+    size_t bucketBegin,
+    size_t bucketEnd,
+    TArray2D<double>* weightSum
+) {
+    for (auto y : xrange(touchedLeafPairs.NonDiagNeighbours.ysize())) {
+        for (int x : touchedLeafPairs.NonDiagNeighbours[y]) {
+            const double total = CalcSmallerBorderWeightSum(pairWeightStatistics[x][y], bucketBegin, bucketEnd)
+                + CalcSmallerBorderWeightSum(pairWeightStatistics[y][x], bucketBegin, bucketEnd);
+            UpdateWeightSumFromTotal(y, x, total, weightSum);
+        }
+    }
+}
+
+
+static void UpdateWeightSumFromBucketStats(
+    const TArray2D<TVector<TBucketPairWeightStatistics>>& pairWeightStatistics,
+    const TTouchedLeafPairs& touchedLeafPairs,
+    size_t bucketIdx,
+    TArray2D<double>* weightSum
+) {
+    auto& weightSumRef = *weightSum;
+    for (auto y : xrange(touchedLeafPairs.NonDiagNeighbours.ysize())) {
+        if (touchedLeafPairs.HasDiagStatistics[y]) {
+            const auto& yy = pairWeightStatistics[y][y][bucketIdx];
+            const double weightDelta = yy.SmallerBorderWeightSum - yy.GreaterBorderRightWeightSum;
+            weightSumRef[2 * y][2 * y + 1] += weightDelta;
+            weightSumRef[2 * y + 1][2 * y] += weightDelta;
+            weightSumRef[2 * y][2 * y] -= weightDelta;
+            weightSumRef[2 * y + 1][2 * y + 1] -= weightDelta;
+        }
+        for (int x : touchedLeafPairs.NonDiagNeighbours[y]) {
+            UpdateWeightSumFromNonDiagStats(
+                y,
+                x,
+                GetBucketPairWeightStatistics(pairWeightStatistics[x][y], bucketIdx),
+                GetBucketPairWeightStatistics(pairWeightStatistics[y][x], bucketIdx),
+                weightSum);
+        }
+    }
+}
+
+
 void CalculatePairwiseScore(
     const TPairwiseStats& pairwiseStats,
     int bucketCount,
@@ -133,9 +251,10 @@ void CalculatePairwiseScore(
 
     const int leafCount = derSums.ysize();
 
+    const TTouchedLeafPairs touchedLeafPairs(pairWeightStatistics);
+
     TArray2D<double> weightSum(2 * leafCount, 2 * leafCount);
 
-    // TODO(ilyzhin): refactor this (extract common code to functions)
     switch (pairwiseStats.SplitEnsembleSpec.Type) {
         case ESplitEnsembleType::OneFeature:
             {
@@ -150,52 +269,7 @@ void CalculatePairwiseScore(
                     }
                 }
 
-                for (int y = 0; y < leafCount; ++y) {
-                    for (int x = y + 1; x < leafCount; ++x) {
-                        const TBucketPairWeightStatistics* xyData = pairWeightStatistics[x][y].data();
-                        const TBucketPairWeightStatistics* yxData = pairWeightStatistics[y][x].data();
-                        auto totalXY0 = NSimdOps::MakeZeros();
-                        auto totalXY2 = NSimdOps::MakeZeros();
-                        auto totalYX0 = NSimdOps::MakeZeros();
-                        auto totalYX2 = NSimdOps::MakeZeros();
-                        for (int bucketId = 0;
-                             bucketId + 2 * static_cast<int>(NSimdOps::Size) <= bucketCount;
-                             bucketId += 2 * NSimdOps::Size)
-                        {
-                            totalXY0 = NSimdOps::ElementwiseAdd(
-                                totalXY0,
-                                NSimdOps::Gather(
-                                    &xyData[bucketId + 0].SmallerBorderWeightSum,
-                                    &xyData[bucketId + 1].SmallerBorderWeightSum));
-                            totalXY2 = NSimdOps::ElementwiseAdd(
-                                totalXY2,
-                                NSimdOps::Gather(
-                                    &xyData[bucketId + 2].SmallerBorderWeightSum,
-                                    &xyData[bucketId + 3].SmallerBorderWeightSum));
-                            totalYX0 = NSimdOps::ElementwiseAdd(
-                                totalYX0,
-                                NSimdOps::Gather(
-                                    &yxData[bucketId + 0].SmallerBorderWeightSum,
-                                    &yxData[bucketId + 1].SmallerBorderWeightSum));
-                            totalYX2 = NSimdOps::ElementwiseAdd(
-                                totalYX2,
-                                NSimdOps::Gather(
-                                    &yxData[bucketId + 2].SmallerBorderWeightSum,
-                                    &yxData[bucketId + 3].SmallerBorderWeightSum));
-                        }
-                        double total = NSimdOps::HorizontalAdd(totalXY0) + NSimdOps::HorizontalAdd(totalXY2)
-                            + NSimdOps::HorizontalAdd(totalYX0) + NSimdOps::HorizontalAdd(totalYX2);
-                        for (int bucketId = bucketCount - bucketCount % (2 * NSimdOps::Size);
-                             bucketId < bucketCount;
-                             ++bucketId)
-                        {
-                            total += xyData[bucketId].SmallerBorderWeightSum
-                                + yxData[bucketId].SmallerBorderWeightSum;
-                        }
-
-                        UpdateWeightSumFromTotal(y, x, total, &weightSum);
-                    }
-                }
+                UpdateWeightSumFromTotals(pairWeightStatistics, touchedLeafPairs, 0, bucketCount, &weightSum);
 
                 Y_ASSERT(
                     pairwiseStats.SplitEnsembleSpec.OneSplitType == ESplitType::OnlineCtr ||
@@ -206,21 +280,8 @@ void CalculatePairwiseScore(
                         const double derDelta = derSums[y][splitId];
                         derSum[2 * y] += derDelta;
                         derSum[2 * y + 1] -= derDelta;
-
-                        const double weightDelta = (pairWeightStatistics[y][y][splitId].SmallerBorderWeightSum
-                            - pairWeightStatistics[y][y][splitId].GreaterBorderRightWeightSum);
-                        weightSum[2 * y][2 * y + 1] += weightDelta;
-                        weightSum[2 * y + 1][2 * y] += weightDelta;
-                        weightSum[2 * y][2 * y] -= weightDelta;
-                        weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-
-                        for (int x = y + 1; x < leafCount; ++x) {
-                            const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][splitId];
-                            const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][splitId];
-
-                            UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                        }
                     }
+                    UpdateWeightSumFromBucketStats(pairWeightStatistics, touchedLeafPairs, splitId, &weightSum);
 
                     const TVector<double> leafValues = CalculatePairwiseLeafValues(
                         weightSum,
@@ -251,33 +312,17 @@ void CalculatePairwiseScore(
 
                     weightSum.FillZero();
 
-                    for (int y = 0; y < leafCount; ++y) {
-                        const double weightDelta =
-                            (pairWeightStatistics[y][y][2 * binFeatureIdx].SmallerBorderWeightSum
-                             - pairWeightStatistics[y][y][2 * binFeatureIdx].GreaterBorderRightWeightSum);
-                        weightSum[2 * y][2 * y + 1] += weightDelta;
-                        weightSum[2 * y + 1][2 * y] += weightDelta;
-                        weightSum[2 * y][2 * y] -= weightDelta;
-                        weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-
-                        for (int x = y + 1; x < leafCount; ++x) {
-                            const TBucketPairWeightStatistics* xyData = pairWeightStatistics[x][y].data();
-                            const TBucketPairWeightStatistics* yxData = pairWeightStatistics[y][x].data();
-
-                            double total =
-                                xyData[2 * binFeatureIdx].SmallerBorderWeightSum
-                                + yxData[2 * binFeatureIdx].SmallerBorderWeightSum
-                                + xyData[2 * binFeatureIdx + 1].SmallerBorderWeightSum
-                                + yxData[2 * binFeatureIdx + 1].SmallerBorderWeightSum;
-
-                            UpdateWeightSumFromTotal(y, x, total, &weightSum);
-
-                            const TBucketPairWeightStatistics& xy = xyData[2 * binFeatureIdx];
-                            const TBucketPairWeightStatistics& yx = yxData[2 * binFeatureIdx];
-
-                            UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                        }
-                    }
+                    UpdateWeightSumFromTotals(
+                        pairWeightStatistics,
+                        touchedLeafPairs,
+                        2 * binFeatureIdx,
+                        2 * binFeatureIdx + 2,
+                        &weightSum);
+                    UpdateWeightSumFromBucketStats(
+                        pairWeightStatistics,
+                        touchedLeafPairs,
+                        2 * binFeatureIdx,
+                        &weightSum);
 
                     const TVector<double> leafValues = CalculatePairwiseLeafValues(
                         weightSum,
@@ -339,78 +384,23 @@ void CalculatePairwiseScore(
                     auto bucketBegin = srcBucketOffset;
                     auto bucketEnd = srcBucketOffset + boundsInBundle.GetSize() + 1;
 
-                    for (int y = 0; y < leafCount; ++y) {
-                        for (int x = y + 1; x < leafCount; ++x) {
-                            const TBucketPairWeightStatistics* xyData = pairWeightStatistics[x][y].data();
-                            const TBucketPairWeightStatistics* yxData = pairWeightStatistics[y][x].data();
-                            auto totalXY0 = NSimdOps::MakeZeros();
-                            auto totalXY2 = NSimdOps::MakeZeros();
-                            auto totalYX0 = NSimdOps::MakeZeros();
-                            auto totalYX2 = NSimdOps::MakeZeros();
-
-                            auto bucketId = bucketBegin;
-                            for (;
-                                 bucketId + 2 * NSimdOps::Size <= bucketEnd;
-                                 bucketId += 2 * NSimdOps::Size)
-                            {
-                                totalXY0 = NSimdOps::ElementwiseAdd(
-                                    totalXY0,
-                                    NSimdOps::Gather(
-                                        &xyData[bucketId + 0].SmallerBorderWeightSum,
-                                        &xyData[bucketId + 1].SmallerBorderWeightSum));
-                                totalXY2 = NSimdOps::ElementwiseAdd(
-                                    totalXY2,
-                                    NSimdOps::Gather(
-                                        &xyData[bucketId + 2].SmallerBorderWeightSum,
-                                        &xyData[bucketId + 3].SmallerBorderWeightSum));
-                                totalYX0 = NSimdOps::ElementwiseAdd(
-                                    totalYX0,
-                                    NSimdOps::Gather(
-                                        &yxData[bucketId + 0].SmallerBorderWeightSum,
-                                        &yxData[bucketId + 1].SmallerBorderWeightSum));
-                                totalYX2 = NSimdOps::ElementwiseAdd(
-                                    totalYX2,
-                                    NSimdOps::Gather(
-                                        &yxData[bucketId + 2].SmallerBorderWeightSum,
-                                        &yxData[bucketId + 3].SmallerBorderWeightSum));
-                            }
-                            double total = NSimdOps::HorizontalAdd(totalXY0)
-                                + NSimdOps::HorizontalAdd(totalXY2)
-                                + NSimdOps::HorizontalAdd(totalYX0)
-                                + NSimdOps::HorizontalAdd(totalYX2);
-                            for (; bucketId < bucketEnd; ++bucketId) {
-                                total += xyData[bucketId].SmallerBorderWeightSum
-                                    + yxData[bucketId].SmallerBorderWeightSum;
-                            }
-
-                            UpdateWeightSumFromTotal(y, x, total, &weightSum);
-                        }
-                    }
+                    UpdateWeightSumFromTotals(
+                        pairWeightStatistics,
+                        touchedLeafPairs,
+                        bucketBegin,
+                        bucketEnd,
+                        &weightSum);
 
                     for (ui32 splitId = 0; splitId < boundsInBundle.GetSize(); ++splitId) {
                         auto bucketId = srcBucketOffset + splitId;
-                        for (int y = 0; y < leafCount; ++y) {
-                            if (splitId > 0) {
+                        if (splitId > 0) {
+                            for (int y = 0; y < leafCount; ++y) {
                                 const double derDelta = derSums[y][bundlePart.Bounds.Begin + splitId - 1];
                                 derSum[2 * y] += derDelta;
                                 derSum[2 * y + 1] -= derDelta;
                             }
-
-                            const double weightDelta =
-                                (pairWeightStatistics[y][y][bucketId].SmallerBorderWeightSum
-                                 - pairWeightStatistics[y][y][bucketId].GreaterBorderRightWeightSum);
-                            weightSum[2 * y][2 * y + 1] += weightDelta;
-                            weightSum[2 * y + 1][2 * y] += weightDelta;
-                            weightSum[2 * y][2 * y] -= weightDelta;
-                            weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-
-                            for (int x = y + 1; x < leafCount; ++x) {
-                                const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][bucketId];
-                                const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][bucketId];
-
-                                UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                            }
                         }
+                        UpdateWeightSumFromBucketStats(pairWeightStatistics, touchedLeafPairs, bucketId, &weightSum);
 
                         const TVector<double> leafValues = CalculatePairwiseLeafValues(
                             weightSum,
@@ -446,68 +436,19 @@ void CalculatePairwiseScore(
                             derSum[2 * leafId + 1] += derSums[leafId][bucketIdx];
                         }
                     }
-                    for (int y = 0; y < leafCount; ++y) {
-                        for (int x = y + 1; x < leafCount; ++x) {
-                            const TBucketPairWeightStatistics* xyData = pairWeightStatistics[x][y].data();
-                            const TBucketPairWeightStatistics* yxData = pairWeightStatistics[y][x].data();
-                            auto totalXY0 = NSimdOps::MakeZeros();
-                            auto totalXY2 = NSimdOps::MakeZeros();
-                            auto totalYX0 = NSimdOps::MakeZeros();
-                            auto totalYX2 = NSimdOps::MakeZeros();
-                            for (int bucketId = bucketIdxOffset;
-                                 bucketId + 2 * static_cast<int>(NSimdOps::Size) <= bucketIdxOffset + static_cast<int>(part.BucketCount);
-                                 bucketId += 2 * NSimdOps::Size) {
-                                totalXY0 = NSimdOps::ElementwiseAdd(
-                                    totalXY0,
-                                    NSimdOps::Gather(
-                                        &xyData[bucketId + 0].SmallerBorderWeightSum,
-                                        &xyData[bucketId + 1].SmallerBorderWeightSum));
-                                totalXY2 = NSimdOps::ElementwiseAdd(
-                                    totalXY2,
-                                    NSimdOps::Gather(
-                                        &xyData[bucketId + 2].SmallerBorderWeightSum,
-                                        &xyData[bucketId + 3].SmallerBorderWeightSum));
-                                totalYX0 = NSimdOps::ElementwiseAdd(
-                                    totalYX0,
-                                    NSimdOps::Gather(
-                                        &yxData[bucketId + 0].SmallerBorderWeightSum,
-                                        &yxData[bucketId + 1].SmallerBorderWeightSum));
-                                totalYX2 = NSimdOps::ElementwiseAdd(
-                                    totalYX2,
-                                    NSimdOps::Gather(
-                                        &yxData[bucketId + 2].SmallerBorderWeightSum,
-                                        &yxData[bucketId + 3].SmallerBorderWeightSum));
-                            }
-                            double total =
-                                NSimdOps::HorizontalAdd(totalXY0) + NSimdOps::HorizontalAdd(totalXY2)
-                                + NSimdOps::HorizontalAdd(totalYX0) + NSimdOps::HorizontalAdd(totalYX2);
-                            for (int bucketId = bucketIdxOffset + part.BucketCount - part.BucketCount % (2 * NSimdOps::Size);
-                                 bucketId < bucketIdxOffset + bucketCount;
-                                 ++bucketId) {
-                                total += xyData[bucketId].SmallerBorderWeightSum
-                                         + yxData[bucketId].SmallerBorderWeightSum;
-                            }
-                            UpdateWeightSumFromTotal(y, x, total, &weightSum);
-                        }
-                    }
+                    UpdateWeightSumFromTotals(
+                        pairWeightStatistics,
+                        touchedLeafPairs,
+                        bucketIdxOffset,
+                        bucketIdxOffset + part.BucketCount,
+                        &weightSum);
                     for (int splitId = splitIdxOffset, bucketId = bucketIdxOffset; splitId < splitIdxOffset + static_cast<int>(part.BucketCount) - 1; ++splitId, ++bucketId) {
                         for (int y = 0; y < leafCount; ++y) {
                             const double derDelta = derSums[y][bucketId];
                             derSum[2 * y] += derDelta;
                             derSum[2 * y + 1] -= derDelta;
-                            const double weightDelta = (
-                                pairWeightStatistics[y][y][bucketId].SmallerBorderWeightSum
-                                - pairWeightStatistics[y][y][bucketId].GreaterBorderRightWeightSum);
-                            weightSum[2 * y][2 * y + 1] += weightDelta;
-                            weightSum[2 * y + 1][2 * y] += weightDelta;
-                            weightSum[2 * y][2 * y] -= weightDelta;
-                            weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-                            for (int x = y + 1; x < leafCount; ++x) {
-                                const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][bucketId];
-                                const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][bucketId];
-                                UpdateWeightSumFromNonDiagStats(y, x, xy, yx, &weightSum);
-                            }
                         }
+                        UpdateWeightSumFromBucketStats(pairWeightStatistics, touchedLeafPairs, bucketId, &weightSum);
                         const TVector<double> leafValues = CalculatePairwiseLeafValues(
                             weightSum,
                             derSum,
@@ -522,4 +463,3 @@ void CalculatePairwiseScore(
             break;
     }
 }
-
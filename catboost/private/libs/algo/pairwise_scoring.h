@@ -35,6 +35,9 @@ struct TPairwiseStats {
      *  For ExclusiveFeaturesBundle: bucketCount for all used features
      *  For FeaturesGroup:           bucketCount for all grouped features
      */
+    /* Only leaf pairs that are touched by pairs have statistics,
+     * the vectors for the other leaf pairs are empty and mean all zeros.
+     */
     TArray2D<TVector<TBucketPairWeightStatistics>> PairWeightStatistics; // [leafCount][leafCount][statsCount]
 
     TSplitEnsembleSpec SplitEnsembleSpec;
@@ -66,6 +69,19 @@ inline TVector<TVector<double>> ComputeDerSums(
     return derSums;
 }
 
+inline TBucketPairWeightStatistics* GetOrCreatePairWeightStatistics(
+    ui32 leafId1,
+    ui32 leafId2,
+    size_t statsCount,
+    TArray2D<TVector<TBucketPairWeightStatistics>>* weightSums
+) {
+    auto& leafPairStatistics = (*weightSums)[leafId1][leafId2];
+    if (leafPairStatistics.empty()) {
+        leafPairStatistics.resize(statsCount);
+    }
+    return leafPairStatistics.data();
+}
+
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
 inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistics(
@@ -77,7 +93,6 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     NCB::TIndexRange<int> pairIndexRange
 ) {
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
-    weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(bucketCount));
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -90,11 +105,21 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
         if (winnerBucketId > loserBucketId) {
-            weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[loserLeafId][winnerLeafId][winnerBucketId].GreaterBorderRightWeightSum -= weight;
+            auto* leafPairWeightSums = GetOrCreatePairWeightStatistics(
+                loserLeafId,
+                winnerLeafId,
+                bucketCount,
+                &weightSums);
+            leafPairWeightSums[loserBucketId].SmallerBorderWeightSum -= weight;
+            leafPairWeightSums[winnerBucketId].GreaterBorderRightWeightSum -= weight;
         } else {
-            weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+            auto* leafPairWeightSums = GetOrCreatePairWeightStatistics(
+                winnerLeafId,
+                loserLeafId,
+                bucketCount,
+                &weightSums);
+            leafPairWeightSums[winnerBucketId].SmallerBorderWeightSum -= weight;
+            leafPairWeightSums[loserBucketId].GreaterBorderRightWeightSum -= weight;
         }
     }
 
@@ -114,7 +139,6 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     const int binaryFeaturesCount = (int)GetValueBitCount(bucketCount - 1);
 
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
-    weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(2 * binaryFeaturesCount));
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -127,18 +151,29 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
 
+        auto* loserWinnerWeightSums = GetOrCreatePairWeightStatistics(
+            loserLeafId,
+            winnerLeafId,
+            2 * binaryFeaturesCount,
+            &weightSums);
+        auto* winnerLoserWeightSums = GetOrCreatePairWeightStatistics(
+            winnerLeafId,
+            loserLeafId,
+            2 * binaryFeaturesCount,
+            &weightSums);
+
         for (auto bitIndex : xrange<NCB::TBinaryFeaturesPack>(binaryFeaturesCount)) {
             auto winnerBit = (winnerFeaturesPack >> bitIndex) & 1;
             auto loserBit = (loserFeaturesPack >> bitIndex) & 1;
 
             if (winnerBit > loserBit) {
-                weightSums[loserLeafId][winnerLeafId][2 * bitIndex].SmallerBorderWeightSum -= weight;
-                weightSums[loserLeafId][winnerLeafId][2 * bitIndex + 1].GreaterBorderRightWeightSum -= weight;
+                loserWinnerWeightSums[2 * bitIndex].SmallerBorderWeightSum -= weight;
+                loserWinnerWeightSums[2 * bitIndex + 1].GreaterBorderRightWeightSum -= weight;
             } else {
                 auto winnerBucketId = 2 * bitIndex + winnerBit;
-                weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
+                winnerLoserWeightSums[winnerBucketId].SmallerBorderWeightSum -= weight;
                 auto loserBucketId = 2 * bitIndex + loserBit;
-                weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+                winnerLoserWeightSums[loserBucketId].GreaterBorderRightWeightSum -= weight;
             }
         }
     }
@@ -173,7 +208,6 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     }
 
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
-    weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(totalBucketCount));
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -186,6 +220,17 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
 
+        auto* loserWinnerWeightSums = GetOrCreatePairWeightStatistics(
+            loserLeafId,
+            winnerLeafId,
+            totalBucketCount,
+            &weightSums);
+        auto* winnerLoserWeightSums = GetOrCreatePairWeightStatistics(
+            winnerLeafId,
+            loserLeafId,
+            totalBucketCount,
+            &weightSums);
+
         ui32 bucketOffset = 0;
         for (auto bundlePartIdx : xrange(exclusiveFeaturesBundle.Parts.size())) {
             if (!calcStatsForBundlePart[bundlePartIdx]) {
@@ -198,15 +243,11 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             auto loserBucketId = NCB::GetBinFromBundle<ui32>(loserBundleValue, boundsInBundle);
 
             if (winnerBucketId > loserBucketId) {
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + loserBucketId].SmallerBorderWeightSum
-                    -= weight;
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
-                    -= weight;
+                loserWinnerWeightSums[bucketOffset + loserBucketId].SmallerBorderWeightSum -= weight;
+                loserWinnerWeightSums[bucketOffset + winnerBucketId].GreaterBorderRightWeightSum -= weight;
             } else {
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + winnerBucketId].SmallerBorderWeightSum
-                    -= weight;
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + loserBucketId].GreaterBorderRightWeightSum
-                    -= weight;
+                winnerLoserWeightSums[bucketOffset + winnerBucketId].SmallerBorderWeightSum -= weight;
+                winnerLoserWeightSums[bucketOffset + loserBucketId].GreaterBorderRightWeightSum -= weight;
             }
 
             bucketOffset += boundsInBundle.GetSize() + 1;
@@ -228,7 +269,6 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     NCB::TIndexRange<int> pairIndexRange
 ) {
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
-    weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(featuresGroup.TotalBucketCount));
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -241,21 +281,28 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
 
+        auto* loserWinnerWeightSums = GetOrCreatePairWeightStatistics(
+            loserLeafId,
+            winnerLeafId,
+            featuresGroup.TotalBucketCount,
+            &weightSums);
+        auto* winnerLoserWeightSums = GetOrCreatePairWeightStatistics(
+            winnerLeafId,
+            loserLeafId,
+            featuresGroup.TotalBucketCount,
+            &weightSums);
+
         ui32 bucketOffset = 0;
         for (auto partIdx : xrange(featuresGroup.Parts.size())) {
             auto winnerBucketId = NCB::GetPartValueFromGroup(winnerGroupValue, partIdx);
             auto loserBucketId = NCB::GetPartValueFromGroup(loserGroupValue, partIdx);
 
             if (winnerBucketId > loserBucketId) {
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + loserBucketId].SmallerBorderWeightSum
-                    -= weight;
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
-                    -= weight;
+                loserWinnerWeightSums[bucketOffset + loserBucketId].SmallerBorderWeightSum -= weight;
+                loserWinnerWeightSums[bucketOffset + winnerBucketId].GreaterBorderRightWeightSum -= weight;
             } else {
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + winnerBucketId].SmallerBorderWeightSum
-                    -= weight;
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + loserBucketId].GreaterBorderRightWeightSum
-                    -= weight;
+                winnerLoserWeightSums[bucketOffset + winnerBucketId].SmallerBorderWeightSum -= weight;
+                winnerLoserWeightSums[bucketOffset + loserBucketId].GreaterBorderRightWeightSum -= weight;
             }
 
             bucketOffset += featuresGroup.Parts[partIdx].BucketCount;
@@ -448,6 +448,7 @@ void Bootstrap(
     const bool isPairwiseScoring = IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction());
     const TMaybe<float> mvsReg = params.ObliviousTreeOptions->BootstrapConfig->GetMvsReg();
     bool performRandomChoice = true;
+    bool isWeightedDataCalculated = false;
     if (bootstrapType != EBootstrapType::No && samplingUnit == ESamplingUnit::Group) {
         CB_ENSURE(!fold->LearnQueriesInfo.empty(), "No groups in dataset. Please disable sampling or use per object sampling");
     }
@@ -480,7 +481,12 @@ void Bootstrap(
             if (!isPairwiseScoring) {
                 performRandomChoice = false;
                 TMvsSampler sampler(learnSampleCount, takenFraction, mvsReg);
-                sampler.GenSampleWeights(boostingType, leafValues, rand, localExecutor, fold);
+                if (IsPlainMode(boostingType) && fold->BodyTailArr.size() == 1 && fold->BodyTailArr[0].PairwiseWeights.empty()) {
+                    sampler.GenSampleWeightsWithWeightedData(leafValues, rand, localExecutor, fold);
+                    isWeightedDataCalculated = true;
+                } else {
+                    sampler.GenSampleWeights(boostingType, leafValues, rand, localExecutor, fold);
+                }
             }
             break;
         case EBootstrapType::No:
@@ -491,7 +497,7 @@ void Bootstrap(
         default:
             CB_ENSURE(false, "Not supported bootstrap type on CPU: " << bootstrapType);
     }
-    if (!isPairwiseScoring) {
+    if (!isPairwiseScoring && !isWeightedDataCalculated) {
         CalcWeightedData(learnSampleCount, params.BoostingOptions->BoostingType.Get(), localExecutor, fold);
     }
     sampledDocs->Sample(
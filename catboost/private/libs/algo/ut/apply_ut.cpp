@@ -14,50 +14,51 @@
 using namespace NCB;
 
 
-Y_UNIT_TEST_SUITE(TLeafIndexCalcerOnPool) {
-    const TVector<TVector<float>> DEFAULT_FEATURES = {
-        {0.f, 0.f, 0.f},
-        {3.f, 0.f, 0.f},
-        {0.f, 1.f, 0.f},
-        {3.f, 1.f, 0.f},
-        {0.f, 0.f, 1.f},
-        {3.f, 0.f, 1.f},
-        {0.f, 1.f, 1.f},
-        {3.f, 1.f, 1.f},
-    };
-
-    TObjectsDataProviderPtr CreateObjectsDataProviderWithFeatures(
-        const TVector<TVector<float>>& featuresData) {
-
-        auto dataProvider = CreateDataProvider<IRawObjectsOrderDataVisitor>(
-            [&] (IRawObjectsOrderDataVisitor* visitor) {
-                TDataMetaInfo metaInfo;
-                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
-                    (ui32)featuresData[0].size(),
-                    TVector<ui32>{},
-                    TVector<ui32>{},
-                    TVector<ui32>{},
-                    TVector<TString>{});
-
-                visitor->Start(
-                    /*inBlock*/false,
-                    metaInfo,
-                    /*haveUnknownNumberOfSparseFeatures*/ false,
-                    (ui32)featuresData.size(),
-                    EObjectsOrder::Undefined,
-                    /*resourceHolders*/ {});
-                visitor->StartNextBlock((ui32)featuresData.size());
-
-                for (auto objectIdx : xrange(featuresData.size())) {
-                    visitor->AddAllFloatFeatures(objectIdx, featuresData[objectIdx]);
-                }
+static const TVector<TVector<float>> DEFAULT_FEATURES = {
+    {0.f, 0.f, 0.f},
+    {3.f, 0.f, 0.f},
+    {0.f, 1.f, 0.f},
+    {3.f, 1.f, 0.f},
+    {0.f, 0.f, 1.f},
+    {3.f, 0.f, 1.f},
+    {0.f, 1.f, 1.f},
+    {3.f, 1.f, 1.f},
+};
+
+static TObjectsDataProviderPtr CreateObjectsDataProviderWithFeatures(
+    const TVector<TVector<float>>& featuresData) {
+
+    auto dataProvider = CreateDataProvider<IRawObjectsOrderDataVisitor>(
+        [&] (IRawObjectsOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)featuresData[0].size(),
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{});
+
+            visitor->Start(
+                /*inBlock*/false,
+                metaInfo,
+                /*haveUnknownNumberOfSparseFeatures*/ false,
+                (ui32)featuresData.size(),
+                EObjectsOrder::Undefined,
+                /*resourceHolders*/ {});
+            visitor->StartNextBlock((ui32)featuresData.size());
+
+            for (auto objectIdx : xrange(featuresData.size())) {
+                visitor->AddAllFloatFeatures(objectIdx, featuresData[objectIdx]);
+            }
 
-                visitor->Finish();
-            });
+            visitor->Finish();
+        });
+
+    return dataProvider->ObjectsData;
+}
 
-        return dataProvider->ObjectsData;
-    };
 
+Y_UNIT_TEST_SUITE(TLeafIndexCalcerOnPool) {
     void CheckLeafIndexCalcer(
         const TFullModel& model,
         const TVector<TVector<float>>& features,
@@ -147,3 +148,53 @@ Y_UNIT_TEST_SUITE(TLeafIndexCalcerOnPool) {
         CheckLeafIndexCalcer(model, DEFAULT_FEATURES, expectedLeafIndexes);
     }
 }
+
+
+Y_UNIT_TEST_SUITE(TStagedModelCalcerOnPool) {
+    void CheckStagedCalcer(const TFullModel& model, int treeBegin, int evalPeriod) {
+        TObjectsDataProviderPtr objectsData = CreateObjectsDataProviderWithFeatures(DEFAULT_FEATURES);
+        const int treeCount = (int)model.GetTreeCount();
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(1);
+        TStagedModelCalcerOnPool stagedCalcer(model, objectsData, &executor, treeBegin, treeCount, evalPeriod);
+
+        int expectedTreeEnd = treeBegin;
+        while (stagedCalcer.Next()) {
+            expectedTreeEnd = Min(expectedTreeEnd + evalPeriod, treeCount);
+            UNIT_ASSERT_VALUES_EQUAL(stagedCalcer.GetCurrentTreeEnd(), expectedTreeEnd);
+
+            TVector<TVector<double>> stagedApprox;
+            stagedCalcer.GetApprox(EPredictionType::InternalRawFormulaVal, &stagedApprox);
+            const auto expectedApprox = ApplyModelMulti(
+                model,
+                *objectsData,
+                EPredictionType::InternalRawFormulaVal,
+                treeBegin,
+                expectedTreeEnd,
+                &executor);
+
+            UNIT_ASSERT_VALUES_EQUAL(stagedApprox.size(), expectedApprox.size());
+            for (auto dim : xrange(expectedApprox.size())) {
+                UNIT_ASSERT_VALUES_EQUAL(stagedApprox[dim].size(), expectedApprox[dim].size());
+                for (auto objectIdx : xrange(expectedApprox[dim].size())) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(stagedApprox[dim][objectIdx], expectedApprox[dim][objectIdx], 1e-9);
+                }
+            }
+        }
+        UNIT_ASSERT_VALUES_EQUAL(expectedTreeEnd, treeCount);
+        UNIT_ASSERT(!stagedCalcer.Next());
+    }
+
+    Y_UNIT_TEST(TestSingleTreeStages) {
+        CheckStagedCalcer(SimpleFloatModel(3), /*treeBegin*/ 0, /*evalPeriod*/ 1);
+    }
+
+    Y_UNIT_TEST(TestUnevenStages) {
+        CheckStagedCalcer(SimpleFloatModel(5), /*treeBegin*/ 1, /*evalPeriod*/ 3);
+    }
+
+    Y_UNIT_TEST(TestMultiVal) {
+        CheckStagedCalcer(MultiValueFloatModel(), /*treeBegin*/ 0, /*evalPeriod*/ 1);
+    }
+}
@@ -126,4 +126,47 @@ Y_UNIT_TEST_SUITE(mvs) {
             }
         }
     }
+
+    Y_UNIT_TEST(mvs_GenWeights_with_weighted_data) {
+        const ui32 SampleCount = 20000;
+        const int SampleCountAsInt = SafeIntegerCast<int>(SampleCount);
+        TRestorableFastRng64 derivativesRand(0);
+
+        const auto makeFold = [&] () {
+            TFold ff;
+            ff.SampleWeights.resize(SampleCount, 1);
+            TFold::TBodyTail bt(0, 0, SampleCountAsInt, SampleCountAsInt, (double)SampleCountAsInt);
+            bt.WeightedDerivatives.resize(2, TVector<double>(SampleCount));
+            bt.SampleWeightedDerivatives.resize(2, TVector<double>(SampleCount));
+            bt.Approx.resize(2, TVector<double>(SampleCount));
+            ff.BodyTailArr.emplace_back(std::move(bt));
+            return ff;
+        };
+        TFold ff = makeFold();
+        for (auto& derivatives : ff.BodyTailArr[0].WeightedDerivatives) {
+            for (auto& der : derivatives) {
+                der = derivativesRand.GenRandReal1() - 0.5;
+            }
+        }
+        TFold fusedFold = makeFold();
+        fusedFold.BodyTailArr[0].WeightedDerivatives = ff.BodyTailArr[0].WeightedDerivatives;
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TMvsSampler sampler(SampleCount, 0.3, Nothing());
+
+        TRestorableFastRng64 rand(0);
+        sampler.GenSampleWeights(Plain, {}, &rand, &executor, &ff);
+        TRestorableFastRng64 fusedRand(0);
+        sampler.GenSampleWeightsWithWeightedData({}, &fusedRand, &executor, &fusedFold);
+
+        for (ui32 i = 0; i < SampleCount; ++i) {
+            UNIT_ASSERT_VALUES_EQUAL(fusedFold.SampleWeights[i], ff.SampleWeights[i]);
+            for (auto dim : xrange(2)) {
+                UNIT_ASSERT_VALUES_EQUAL(
+                    fusedFold.BodyTailArr[0].SampleWeightedDerivatives[dim][i],
+                    ff.BodyTailArr[0].WeightedDerivatives[dim][i] * ff.SampleWeights[i]);
+            }
+        }
+    }
 }
@@ -19,7 +19,8 @@ static TPairwiseStats CalcPairwiseStats(
     TConstArrayRef<double> weightedDerivativesData,
     const TVector<TQueryInfo>& queriesInfo,
     int leafCount,
-    int bucketCount)
+    int bucketCount,
+    int pairBlockCount = 1)
 {
     const int docCount = singleIdx.ysize();
     TVector<TIndexType> leafIndices(docCount);
@@ -39,14 +40,22 @@ static TPairwiseStats CalcPairwiseStats(
         NCB::TIndexRange<int>(docCount));
     const auto flatPairs = UnpackPairsFromQueries(queriesInfo);
     const int pairCount = flatPairs.ysize();
-    pairwiseStats.PairWeightStatistics = ComputePairWeightStatistics(
-        flatPairs,
-        leafCount,
-        bucketCount,
-        leafIndices,
-        [&](ui32 docId) { return bucketIndices[docId]; },
-        NCB::TIndexRange<int>(pairCount));
+    const int pairPart = CeilDiv(pairCount, pairBlockCount);
+    pairwiseStats.PairWeightStatistics = TArray2D<TVector<TBucketPairWeightStatistics>>(leafCount, leafCount);
     pairwiseStats.SplitEnsembleSpec = TSplitEnsembleSpec::OneSplit(ESplitType::FloatFeature);
+    for (int blockIdx = 0; blockIdx < pairBlockCount; ++blockIdx) {
+        TPairwiseStats blockStats;
+        blockStats.DerSums.assign(leafCount, TVector<double>(bucketCount, 0.0));
+        blockStats.PairWeightStatistics = ComputePairWeightStatistics(
+            flatPairs,
+            leafCount,
+            bucketCount,
+            leafIndices,
+            [&](ui32 docId) { return bucketIndices[docId]; },
+            NCB::TIndexRange<int>(Min(pairCount, blockIdx * pairPart), Min(pairCount, (blockIdx + 1) * pairPart)));
+        blockStats.SplitEnsembleSpec = pairwiseStats.SplitEnsembleSpec;
+        pairwiseStats.Add(blockStats);
+    }
 
     return pairwiseStats;
 }
@@ -192,4 +201,53 @@ Y_UNIT_TEST_SUITE(PairwiseScoringTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[1], scores2[1], 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[2], scores2[2], 1e-6);
     }
+
+    Y_UNIT_TEST(PairwiseScoringTestSparseLeafPairs) {
+        TVector<TIndexType> singleIdx = {1, 2, 0, 1, 3, 2, 1, 0, 2, 3, 1, 2};
+        singleIdx[0] += 3 * 4;
+        singleIdx[1] += 3 * 4;
+        singleIdx[3] += 3 * 4;
+        singleIdx[5] += 1 * 4;
+        singleIdx[6] += 2 * 4;
+        singleIdx[9] += 2 * 4;
+        singleIdx[11] += 5 * 4;
+        const TVector<double> ders = {0.5, -0.5, 1.2, -3.2, 0.1, 0.3, -0.6, 2.5, -1.9, 0.5, 0.7, -1.1};
+        TVector<TQueryInfo> queriesInfo = {{0, (ui32)singleIdx.size()}};
+        TVector<TVector<TCompetitor>>& comps = queriesInfo[0].Competitors;
+        comps.resize(ders.size());
+        comps[0].push_back({1, 1});
+        comps[0].push_back({3, 2});
+        comps[2].push_back({7, 1});
+        comps[5].push_back({8, 1});
+        comps[6].push_back({9, 0.5});
+        comps[9].push_back({6, 1});
+        comps[10].push_back({4, 1});
+        const int leafCount = 8;
+        const int bucketCount = 4;
+        const ESplitType splitType = ESplitType::FloatFeature;
+        const float l2DiagReg = 0.3;
+        const float pairwiseNonDiagReg = 0.1;
+        const ui32 oneHotMaxSize = 2;
+
+        TVector<double> scores1, scores2;
+        {
+            TPairwiseStats pairwiseStats = CalcPairwiseStats(
+                singleIdx,
+                MakeArrayRef(ders.data(), ders.size()),
+                queriesInfo,
+                leafCount,
+                bucketCount,
+                /*pairBlockCount*/ 3);
+            UNIT_ASSERT(pairwiseStats.PairWeightStatistics[0][5].empty());
+            UNIT_ASSERT(pairwiseStats.PairWeightStatistics[4][4].empty());
+            TPairwiseScoreCalcer scoreCalcer;
+            CalculatePairwiseScore(pairwiseStats, bucketCount, l2DiagReg, pairwiseNonDiagReg, oneHotMaxSize, &scoreCalcer);
+            scores1 = scoreCalcer.GetScores();
+        }
+        CalculatePairwiseScoreSimple(singleIdx, MakeArrayRef(ders.data(), ders.size()), queriesInfo, leafCount, bucketCount, splitType, l2DiagReg, pairwiseNonDiagReg, &scores2);
+
+        UNIT_ASSERT_DOUBLES_EQUAL(scores1[0], scores2[0], 1e-6);
+        UNIT_ASSERT_DOUBLES_EQUAL(scores1[1], scores2[1], 1e-6);
+        UNIT_ASSERT_DOUBLES_EQUAL(scores1[2], scores2[2], 1e-6);
+    }
 }
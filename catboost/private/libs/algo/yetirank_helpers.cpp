@@ -8,8 +8,26 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
 
+#include <tuple>
+
+
+namespace {
+    struct TYetiRankPair {
+        ui32 Winner;
+        ui32 Loser;
+        float Weight;
+    };
+
+    // reused across queries processed by one thread
+    struct TYetiRankQueryBuffers {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<TYetiRankPair> Pairs;
+    };
+}
 
 static void GenerateYetiRankPairsForQuery(
     const float* relevs,
@@ -19,6 +37,7 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     double decaySpeed,
     ui64 randomSeed,
+    TYetiRankQueryBuffers* buffers,
     TVector<TVector<TCompetitor>>* competitors
 ) {
     TFastRng64 rand(randomSeed);
@@ -26,11 +45,15 @@ static void GenerateYetiRankPairsForQuery(
     competitorsRef.clear();
     competitorsRef.resize(querySize);
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    // each permutation yields at most querySize - 1 adjacent pairs, so only they are stored
+    TVector<int>& indices = buffers->Indices;
+    TVector<double>& bootstrappedApprox = buffers->BootstrappedApprox;
+    TVector<TYetiRankPair>& pairs = buffers->Pairs;
+    indices.yresize(querySize);
+    pairs.clear();
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        bootstrappedApprox.assign(expApproxes, expApproxes + querySize);
         for (ui32 docId = 0; docId < querySize; ++docId) {
             const float uniformValue = rand.GenRandReal1();
             // TODO(nikitxskv): try to experiment with different bootstraps.
@@ -53,22 +76,31 @@ static void GenerateYetiRankPairsForQuery(
             const float pairWeight = magicConst * decayCoefficient
                 * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                pairs.push_back({(ui32)firstCandidate, (ui32)secondCandidate, pairWeight});
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                pairs.push_back({(ui32)secondCandidate, (ui32)firstCandidate, pairWeight});
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
-    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
-        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight
-                = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
-            if (competitorsWeight != 0) {
-                competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
-            }
+    // stable sort keeps permutation order of equal pairs, so weights are summed in the same order as before
+    StableSort(
+        pairs,
+        [](const TYetiRankPair& lhs, const TYetiRankPair& rhs) {
+            return std::tie(lhs.Winner, lhs.Loser) < std::tie(rhs.Winner, rhs.Loser);
+        }
+    );
+    for (size_t pairIdx = 0; pairIdx < pairs.size();) {
+        const ui32 winnerIndex = pairs[pairIdx].Winner;
+        const ui32 loserIndex = pairs[pairIdx].Loser;
+        float pairsWeight = 0;
+        for (; pairIdx < pairs.size() && pairs[pairIdx].Winner == winnerIndex && pairs[pairIdx].Loser == loserIndex; ++pairIdx) {
+            pairsWeight += pairs[pairIdx].Weight;
+        }
+        const float competitorsWeight = queryWeight * pairsWeight / permutationCount;
+        if (competitorsWeight != 0) {
+            competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
         }
     }
 }
@@ -97,6 +129,7 @@ void UpdatePairsForYetiRank(
         blockCount,
         [&](int blockId) {
             TFastRng64 rand(randomSeeds[blockId]);
+            TYetiRankQueryBuffers buffers;
             const int from = queryBegin + blockId * blockSize;
             const int to = Min<int>(queryBegin + (blockId + 1) * blockSize, queryEnd);
             for (int queryIndex = from; queryIndex < to; ++queryIndex) {
@@ -109,6 +142,7 @@ void UpdatePairsForYetiRank(
                     permutationCount,
                     decaySpeed,
                     rand.GenRand(),
+                    &buffers,
                     &queryInfoRef.Competitors
                 );
             }
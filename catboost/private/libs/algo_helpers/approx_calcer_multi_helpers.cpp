@@ -2,7 +2,10 @@
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
 
-inline void AddDersRangeMulti(
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+
+static void AddDersRangeMulti(
     TConstArrayRef<TIndexType> leafIndices,
     TConstArrayRef<TConstArrayRef<float>> target,
     TConstArrayRef<float> weight,
@@ -12,6 +15,7 @@ inline void AddDersRangeMulti(
     int rowBegin,
     int rowEnd,
     bool isUpdateWeight,
+    TDersRangeMultiBuffers* buffers,
     TArrayRef<TSumMulti> leafDers // [dimensionIdx]
 ) {
     const auto* multiError = dynamic_cast<const TMultiDerCalcer*>(&error);
@@ -19,13 +23,24 @@ inline void AddDersRangeMulti(
 
     const int approxDimension = approx.size();
     const bool useHessian = !leafDers[0].SumDer2.Data.empty();
-    THessianInfo curDer2(useHessian * approxDimension, error.GetHessianType());
-    TVector<double> curDer(approxDimension);
+    THessianInfo& curDer2 = buffers->Der2;
+    if (curDer2.Data.ysize() != CalcInternalDer2DataSize(error.GetHessianType(), useHessian * approxDimension)) {
+        curDer2 = THessianInfo(useHessian * approxDimension, error.GetHessianType());
+    }
+    TVector<double>& curDer = buffers->Der;
+    curDer.yresize(approxDimension);
     constexpr int UnrollMaxCount = 16;
-    TVector<TVector<double>> curApprox(UnrollMaxCount, TVector<double>(approxDimension));
-    TVector<TVector<float>> curTarget;
+    TVector<TVector<double>>& curApprox = buffers->Approx;
+    curApprox.resize(UnrollMaxCount);
+    for (auto& unrolledApprox : curApprox) {
+        unrolledApprox.yresize(approxDimension);
+    }
+    TVector<TVector<float>>& curTarget = buffers->Target;
     if (isMultiRegression) {
-        curTarget = TVector<TVector<float>>(UnrollMaxCount, TVector<float>(target.size()));
+        curTarget.resize(UnrollMaxCount);
+        for (auto& unrolledTarget : curTarget) {
+            unrolledTarget.yresize(target.size());
+        }
     }
 
     const auto addDersRangeMultiImpl = [&](auto useWeights, auto useLeafIndices, auto useHessian, auto isMultiRegression) {
@@ -57,6 +72,59 @@ inline void AddDersRangeMulti(
     DispatchGenericLambda(addDersRangeMultiImpl, !weight.empty(), !leafIndices.empty(), useHessian, isMultiRegression);
 }
 
+static void ResetLeafDersMulti(
+    int leafCount,
+    int approxDimension,
+    ELeavesEstimation estimationMethod,
+    EHessianType hessianType,
+    TVector<TSumMulti>* leafDers
+) {
+    const int hessianSize = estimationMethod == ELeavesEstimation::Newton
+        ? CalcInternalDer2DataSize(hessianType, approxDimension)
+        : 0;
+    const bool isSameShape = leafDers->ysize() == leafCount && AllOf(*leafDers, [=](const TSumMulti& ders) {
+        return ders.SumDer.ysize() == approxDimension && ders.SumDer2.Data.ysize() == hessianSize;
+    });
+    if (!isSameShape) {
+        leafDers->assign(leafCount, MakeZeroDers(approxDimension, estimationMethod, hessianType));
+        return;
+    }
+    for (auto& ders : *leafDers) {
+        ders.SetZeroDers();
+        ders.SumWeights = 0;
+    }
+}
+
+void CalcLeafDersMulti(
+    const TVector<TIndexType>& indices,
+    TConstArrayRef<TConstArrayRef<float>> target,
+    TConstArrayRef<float> weight,
+    const TVector<TVector<double>>& approx,
+    const TVector<TVector<double>>& approxDeltas,
+    const IDerCalcer& error,
+    int sampleCount,
+    bool isUpdateWeight,
+    ELeavesEstimation estimationMethod,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TSumMulti>* leafDers
+) {
+    TLeafDersMultiBuffers buffers;
+    CalcLeafDersMulti(
+        indices,
+        target,
+        weight,
+        approx,
+        approxDeltas,
+        error,
+        sampleCount,
+        isUpdateWeight,
+        estimationMethod,
+        localExecutor,
+        &buffers,
+        leafDers
+    );
+}
+
 void CalcLeafDersMulti(
     const TVector<TIndexType>& indices,
     TConstArrayRef<TConstArrayRef<float>> target,
@@ -68,22 +136,32 @@ void CalcLeafDersMulti(
     bool isUpdateWeight,
     ELeavesEstimation estimationMethod,
     NPar::TLocalExecutor* localExecutor,
+    TLeafDersMultiBuffers* buffers,
     TVector<TSumMulti>* leafDers
 ) {
     const int approxDimension = approx.ysize();
     Y_ASSERT(approxDimension > 0);
-    const auto leafCount = leafDers->size();
-    for (auto& curLeafDers : *leafDers) {
-        curLeafDers.SetZeroDers();
+    const int leafCount = leafDers->ysize();
+
+    // parts are contiguous and depend only on sample count and leaf ders size, not on thread count,
+    //  so sums do not depend on thread_count
+    constexpr int MinPartSize = 1000;
+    constexpr size_t MaxPartLeafDersSize = 256 << 20;
+    const size_t leafHessianSize = leafCount > 0 ? (*leafDers)[0].SumDer2.Data.size() : 0;
+    const size_t partLeafDersSize = Max<size_t>(1, leafCount * (approxDimension + leafHessianSize) * sizeof(double));
+    const int maxPartCount = Max<int>(1, Min<size_t>(CB_THREAD_LIMIT, MaxPartLeafDersSize / partLeafDersSize));
+    const int partCount = Max(1, Min(maxPartCount, CeilDiv(sampleCount, MinPartSize)));
+    const int partSize = Max(1, CeilDiv(sampleCount, partCount));
+    if (buffers->PartLeafDers.ysize() < partCount) {
+        buffers->PartLeafDers.resize(partCount);
+        buffers->PartDersBuffers.resize(partCount);
     }
-    const auto& zeroDers = MakeZeroDers(approxDimension, estimationMethod, error.GetHessianType());
-    const auto hessianSize = zeroDers.SumDer2.Data.size();
-    NCB::MapMerge(
-        localExecutor,
-        NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>(sampleCount), /*blockSize*/Max<ui32>(1000, hessianSize / CB_THREAD_LIMIT)),
-        /*mapFunc*/[&](NCB::TIndexRange<int> partIndexRange, TVector<TSumMulti>* leafDers) {
-            Y_ASSERT(!partIndexRange.Empty());
-            leafDers->resize(leafCount, zeroDers);
+    localExecutor->ExecRangeWithThrow(
+        [&](int partIdx) {
+            auto& partLeafDers = buffers->PartLeafDers[partIdx];
+            ResetLeafDersMulti(leafCount, approxDimension, estimationMethod, error.GetHessianType(), &partLeafDers);
+            const int rowBegin = Min(sampleCount, partIdx * partSize);
+            const int rowEnd = Min(sampleCount, rowBegin + partSize);
             AddDersRangeMulti(
                 indices,
                 target,
@@ -91,28 +169,57 @@ void CalcLeafDersMulti(
                 approx, // [dimensionIdx][rowIdx]
                 approxDeltas, // [dimensionIdx][rowIdx]
                 error,
-                partIndexRange.Begin,
-                partIndexRange.End,
+                rowBegin,
+                rowEnd,
                 isUpdateWeight,
-                *leafDers // [dimensionIdx]
+                &buffers->PartDersBuffers[partIdx],
+                partLeafDers // [dimensionIdx]
             );
         },
-        /*mergeFunc*/[=](TVector<TSumMulti>* leafDers, TVector<TVector<TSumMulti>>&& addVector) {
-            if (estimationMethod == ELeavesEstimation::Newton) {
-                for (auto leafIdx : xrange(leafCount)) {
-                    for (const auto& addItem : addVector) {
-                        (*leafDers)[leafIdx].AddDerDer2(addItem[leafIdx].SumDer, addItem[leafIdx].SumDer2);
+        0,
+        partCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    if (leafCount == 0) {
+        return;
+    }
+    // reduce in parallel over leaves and blocks of hessian, parts are summed in fixed order
+    constexpr int HessianBlockSize = 4096;
+    const int hessianSize = (*leafDers)[0].SumDer2.Data.ysize();
+    const int hessianBlockCount = Max(1, CeilDiv(hessianSize, HessianBlockSize));
+    const auto& partLeafDers = buffers->PartLeafDers;
+    localExecutor->ExecRangeWithThrow(
+        [&](int taskIdx) {
+            const int leafIdx = taskIdx / hessianBlockCount;
+            const int hessianBlockIdx = taskIdx % hessianBlockCount;
+            TSumMulti& dstDers = (*leafDers)[leafIdx];
+            if (hessianBlockIdx == 0) {
+                Fill(dstDers.SumDer.begin(), dstDers.SumDer.end(), 0.0);
+                for (auto partIdx : xrange(partCount)) {
+                    const TSumMulti& partDers = partLeafDers[partIdx][leafIdx];
+                    for (auto dim : xrange(approxDimension)) {
+                        dstDers.SumDer[dim] += partDers.SumDer[dim];
                     }
-                }
-            } else {
-                for (auto leafIdx : xrange(leafCount)) {
-                    for (const auto& addItem : addVector) {
-                        (*leafDers)[leafIdx].AddDerWeight(addItem[leafIdx].SumDer, addItem[leafIdx].SumWeights, isUpdateWeight);
+                    if (isUpdateWeight) {
+                        dstDers.SumWeights += partDers.SumWeights;
                     }
                 }
             }
+            const int hessianBegin = hessianBlockIdx * HessianBlockSize;
+            const int hessianEnd = Min(hessianSize, hessianBegin + HessianBlockSize);
+            const auto dstDer2 = MakeArrayRef(dstDers.SumDer2.Data).Slice(hessianBegin, hessianEnd - hessianBegin);
+            Fill(dstDer2.begin(), dstDer2.end(), 0.0);
+            for (auto partIdx : xrange(partCount)) {
+                const auto partDer2 = MakeConstArrayRef(partLeafDers[partIdx][leafIdx].SumDer2.Data);
+                for (auto idx : xrange(dstDer2.size())) {
+                    dstDer2[idx] += partDer2[hessianBegin + idx];
+                }
+            }
         },
-        leafDers
+        0,
+        leafCount * hessianBlockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
     );
 }
 
@@ -168,6 +275,65 @@ void CalcLeafDeltasMulti(
     }
 }
 
+void CalcLeafDeltasMulti(
+    const TVector<TSumMulti>& leafDers,
+    ELeavesEstimation estimationMethod,
+    float l2Regularizer,
+    double sumAllWeights,
+    int docCount,
+    NPar::TLocalExecutor* localExecutor,
+    TLeafDersMultiBuffers* buffers,
+    TVector<TVector<double>>* curLeafValues
+) {
+    const int leafCount = leafDers.ysize();
+    const int threadCount = localExecutor->GetThreadCount() + 1;
+    buffers->NewtonBuffers.resize(threadCount);
+    buffers->LeafDeltas.resize(threadCount);
+    localExecutor->ExecRangeWithThrow(
+        [&](int leaf) {
+            const int threadId = localExecutor->GetWorkerThreadId();
+            TVector<double>& curDelta = buffers->LeafDeltas[threadId];
+            if (estimationMethod == ELeavesEstimation::Newton) {
+                CalcDeltaNewtonMulti(leafDers[leaf], l2Regularizer, sumAllWeights, docCount, &buffers->NewtonBuffers[threadId], &curDelta);
+            } else {
+                Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
+                CalcDeltaGradientMulti(leafDers[leaf], l2Regularizer, sumAllWeights, docCount, &curDelta);
+            }
+            for (int dim = 0; dim < curDelta.ysize(); ++dim) {
+                (*curLeafValues)[dim][leaf] = curDelta[dim];
+            }
+        },
+        0,
+        leafCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
+
+void CalcLeafDeltasMulti(
+    const TVector<TSumMulti>& leafDer,
+    ELeavesEstimation estimationMethod,
+    float l2Regularizer,
+    double sumAllWeights,
+    int docCount,
+    NPar::TLocalExecutor* /*localExecutor*/,
+    TLeafDersMultiBuffers* buffers,
+    TVector<double>* curLeafValues
+) {
+    Y_ASSERT(leafDer.ysize() == 1);
+    buffers->NewtonBuffers.resize(Max<size_t>(1, buffers->NewtonBuffers.size()));
+    buffers->LeafDeltas.resize(Max<size_t>(1, buffers->LeafDeltas.size()));
+    TVector<double>& curDelta = buffers->LeafDeltas[0];
+    if (estimationMethod == ELeavesEstimation::Newton) {
+        CalcDeltaNewtonMulti(leafDer[0], l2Regularizer, sumAllWeights, docCount, &buffers->NewtonBuffers[0], &curDelta);
+    } else {
+        Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
+        CalcDeltaGradientMulti(leafDer[0], l2Regularizer, sumAllWeights, docCount, &curDelta);
+    }
+    for (int dim = 0; dim < curDelta.ysize(); ++dim) {
+        (*curLeafValues)[dim] = curDelta[dim];
+    }
+}
+
 void UpdateApproxDeltasMulti(
     const TVector<TIndexType>& indices,
     int docCount,
@@ -35,6 +35,37 @@ inline void AddDersRangeMulti(
     TArrayRef<TSumMulti> leafDers // [dimensionIdx]
 );
 
+// Scratch space of AddDersRangeMulti for one part of samples
+struct TDersRangeMultiBuffers {
+    TVector<double> Der; // [dimensionIdx]
+    THessianInfo Der2;
+    TVector<TVector<double>> Approx; // [unrollIdx][dimensionIdx]
+    TVector<TVector<float>> Target; // [unrollIdx][targetIdx]
+};
+
+// Scratch space of multi-dimensional leaf estimation, kept by caller between iterations
+struct TLeafDersMultiBuffers {
+    TVector<TVector<TSumMulti>> PartLeafDers; // [partIdx][leafIdx]
+    TVector<TDersRangeMultiBuffers> PartDersBuffers; // [partIdx]
+    TVector<TNewtonMultiBuffers> NewtonBuffers; // [threadId]
+    TVector<TVector<double>> LeafDeltas; // [threadId][dimensionIdx]
+};
+
+void CalcLeafDersMulti(
+    const TVector<TIndexType>& indices,
+    TConstArrayRef<TConstArrayRef<float>> target,
+    TConstArrayRef<float> weight,
+    const TVector<TVector<double>>& approx,
+    const TVector<TVector<double>>& approxDeltas,
+    const IDerCalcer& error,
+    int sampleCount,
+    bool isUpdateWeight,
+    ELeavesEstimation estimationMethod,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TSumMulti>* leafDers
+);
+
+// Accumulates ders of contiguous sample parts in parallel and reduces them into leafDers
 void CalcLeafDersMulti(
     const TVector<TIndexType>& indices,
     TConstArrayRef<TConstArrayRef<float>> target,
@@ -46,6 +77,7 @@ void CalcLeafDersMulti(
     bool isUpdateWeight,
     ELeavesEstimation estimationMethod,
     NPar::TLocalExecutor* localExecutor,
+    TLeafDersMultiBuffers* buffers,
     TVector<TSumMulti>* leafDers
 );
 
@@ -66,3 +98,26 @@ void CalcLeafDeltasMulti(
     int docCount,
     TVector<double>* curLeafValues
 );
+
+// Solves per-leaf systems in parallel
+void CalcLeafDeltasMulti(
+    const TVector<TSumMulti>& leafDers,
+    ELeavesEstimation estimationMethod,
+    float l2Regularizer,
+    double sumAllWeights,
+    int docCount,
+    NPar::TLocalExecutor* localExecutor,
+    TLeafDersMultiBuffers* buffers,
+    TVector<TVector<double>>* curLeafValues
+);
+
+void CalcLeafDeltasMulti(
+    const TVector<TSumMulti>& leafDer,
+    ELeavesEstimation estimationMethod,
+    float l2Regularizer,
+    double sumAllWeights,
+    int docCount,
+    NPar::TLocalExecutor* localExecutor,
+    TLeafDersMultiBuffers* buffers,
+    TVector<double>* curLeafValues
+);
@@ -10,9 +10,20 @@ void SolveNewtonEquation(
     const TVector<double>& negativeDer,
     const float l2Regularizer,
     TVector<double>* res)
+{
+    TVector<double> hessianBuffer;
+    SolveNewtonEquation(hessian, negativeDer, l2Regularizer, &hessianBuffer, res);
+}
+
+void SolveNewtonEquation(
+    const THessianInfo& hessian,
+    const TVector<double>& negativeDer,
+    const float l2Regularizer,
+    TVector<double>* hessianBuffer,
+    TVector<double>* res)
 {
     if (hessian.HessianType == EHessianType::Symmetric) {
-        TSymmetricHessian::SolveNewtonEquation(hessian, negativeDer, l2Regularizer, res);
+        TSymmetricHessian::SolveNewtonEquation(hessian, negativeDer, l2Regularizer, hessianBuffer, res);
     } else {
         Y_ASSERT(hessian.HessianType == EHessianType::Diagonal);
         TDiagonalHessian::SolveNewtonEquation(hessian, negativeDer, l2Regularizer, res);
@@ -24,12 +35,24 @@ void TSymmetricHessian::SolveNewtonEquation(
     const TVector<double>& negativeDer,
     const float l2Regularizer,
     TVector<double>* res)
+{
+    TVector<double> hessianBuffer;
+    SolveNewtonEquation(hessian, negativeDer, l2Regularizer, &hessianBuffer, res);
+}
+
+void TSymmetricHessian::SolveNewtonEquation(
+    const THessianInfo& hessian,
+    const TVector<double>& negativeDer,
+    const float l2Regularizer,
+    TVector<double>* hessianBuffer,
+    TVector<double>* res)
 {
     Y_ASSERT(hessian.ApproxDimension == negativeDer.ysize());
     const int approxDimension = hessian.ApproxDimension;
 
     *res = negativeDer;
-    auto localHessian = hessian.Data;
+    auto& localHessian = *hessianBuffer;
+    localHessian.assign(hessian.Data.begin(), hessian.Data.end());
     const auto hessianSize = (approxDimension + 1) * approxDimension / 2;
 
     float maxTraceElement = l2Regularizer;
@@ -38,6 +38,14 @@ public:
         const float /*l2Regularizer*/,
         TVector<double>* /*res*/);
 
+    /// Same as above, regularized hessian is built in hessianBuffer reused between calls
+    static void SolveNewtonEquation(
+        const THessianInfo& /*hessian*/,
+        const TVector<double>& /*negativeDer*/,
+        const float /*l2Regularizer*/,
+        TVector<double>* /*hessianBuffer*/,
+        TVector<double>* /*res*/);
+
     static int CalcInternalDer2DataSize(int /*approxDimension*/);
 };
 
@@ -69,6 +77,13 @@ void SolveNewtonEquation(
     const float /*l2Regularizer*/,
     TVector<double>* /*res*/);
 
+void SolveNewtonEquation(
+    const THessianInfo& /*hessian*/,
+    const TVector<double>& /*negativeDer*/,
+    const float /*l2Regularizer*/,
+    TVector<double>* /*hessianBuffer*/,
+    TVector<double>* /*res*/);
+
 
 class THessianInfo {
 public:
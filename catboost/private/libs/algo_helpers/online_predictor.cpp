@@ -2,19 +2,34 @@
 
 #include <catboost/libs/helpers/matrix.h>
 
+#include <util/generic/xrange.h>
+
+
+void CalcDeltaNewtonMulti(
+    const TSumMulti& ss,
+    float l2Regularizer,
+    double sumAllWeights,
+    int allDocCount,
+    TVector<double>* res) {
+
+    TNewtonMultiBuffers buffers;
+    CalcDeltaNewtonMulti(ss, l2Regularizer, sumAllWeights, allDocCount, &buffers, res);
+}
 
 void CalcDeltaNewtonMulti(
     const TSumMulti& ss,
     float l2Regularizer,
     double sumAllWeights,
     int allDocCount,
+    TNewtonMultiBuffers* buffers,
     TVector<double>* res) {
 
-    TVector<double> total1st = ss.SumDer;
-    for (auto& elem : total1st) {
-        elem = -elem;
+    auto& total1st = buffers->NegativeDer;
+    total1st.yresize(ss.SumDer.size());
+    for (auto dim : xrange(ss.SumDer.size())) {
+        total1st[dim] = -ss.SumDer[dim];
     }
 
     l2Regularizer *= sumAllWeights / allDocCount;
-    SolveNewtonEquation(ss.SumDer2, total1st, l2Regularizer, res);
+    SolveNewtonEquation(ss.SumDer2, total1st, l2Regularizer, &buffers->Hessian, res);
 }
@@ -185,3 +185,17 @@ void CalcDeltaNewtonMulti(
     double sumAllWeights,
     int allDocCount,
     TVector<double>* res);
+
+// Scratch space of CalcDeltaNewtonMulti, reused between calls to avoid allocations
+struct TNewtonMultiBuffers {
+    TVector<double> NegativeDer;
+    TVector<double> Hessian;
+};
+
+void CalcDeltaNewtonMulti(
+    const TSumMulti& ss,
+    float l2Regularizer,
+    double sumAllWeights,
+    int allDocCount,
+    TNewtonMultiBuffers* buffers,
+    TVector<double>* res);
@@ -0,0 +1,140 @@
+#include <library/cpp/testing/unittest/registar.h>
+#include <catboost/private/libs/algo_helpers/approx_calcer_multi_helpers.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(ApproxCalcerMultiHelpersTest) {
+    Y_UNIT_TEST(ParallelLeafDersMatchSequential) {
+        const int sampleCount = 5000;
+        const int approxDimension = 4;
+        const int leafCount = 8;
+        TFastRng<ui64> rng(0);
+
+        TVector<TVector<double>> approx(approxDimension, TVector<double>(sampleCount));
+        for (auto& dimensionApprox : approx) {
+            for (auto& value : dimensionApprox) {
+                value = rng.GenRandReal1() - 0.5;
+            }
+        }
+        TVector<float> target(sampleCount);
+        TVector<float> weight(sampleCount);
+        TVector<TIndexType> indices(sampleCount);
+        for (auto sampleIdx : xrange(sampleCount)) {
+            target[sampleIdx] = rng.Uniform(approxDimension);
+            weight[sampleIdx] = 0.5 + rng.GenRandReal1();
+            indices[sampleIdx] = rng.Uniform(leafCount);
+        }
+        const TVector<TConstArrayRef<float>> targetRef = {target};
+
+        const TMultiClassError error(/*isExpApprox*/ false);
+        TVector<TSumMulti> expectedLeafDers(leafCount, MakeZeroDers(approxDimension, ELeavesEstimation::Newton, error.GetHessianType()));
+        TVector<double> curApprox(approxDimension);
+        TVector<double> curDer(approxDimension);
+        THessianInfo curDer2(approxDimension, error.GetHessianType());
+        for (auto sampleIdx : xrange(sampleCount)) {
+            for (auto dim : xrange(approxDimension)) {
+                curApprox[dim] = approx[dim][sampleIdx];
+            }
+            error.CalcDersMulti(curApprox, target[sampleIdx], weight[sampleIdx], &curDer, &curDer2);
+            expectedLeafDers[indices[sampleIdx]].AddDerDer2(curDer, curDer2);
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TLeafDersMultiBuffers buffers;
+        TVector<TSumMulti> leafDers(leafCount, MakeZeroDers(approxDimension, ELeavesEstimation::Newton, error.GetHessianType()));
+        for (auto iteration : xrange(2)) {
+            Y_UNUSED(iteration);
+            CalcLeafDersMulti(
+                indices,
+                targetRef,
+                weight,
+                approx,
+                /*approxDeltas*/ {},
+                error,
+                sampleCount,
+                /*isUpdateWeight*/ true,
+                ELeavesEstimation::Newton,
+                &localExecutor,
+                &buffers,
+                &leafDers);
+            for (auto leaf : xrange(leafCount)) {
+                for (auto dim : xrange(approxDimension)) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(leafDers[leaf].SumDer[dim], expectedLeafDers[leaf].SumDer[dim], 1e-9);
+                }
+                for (auto idx : xrange(leafDers[leaf].SumDer2.Data.size())) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(leafDers[leaf].SumDer2.Data[idx], expectedLeafDers[leaf].SumDer2.Data[idx], 1e-9);
+                }
+            }
+        }
+
+        TVector<TVector<double>> expectedLeafDeltas(approxDimension, TVector<double>(leafCount));
+        CalcLeafDeltasMulti(expectedLeafDers, ELeavesEstimation::Newton, /*l2Regularizer*/ 3.0f, sampleCount, sampleCount, &expectedLeafDeltas);
+        TVector<TVector<double>> leafDeltas(approxDimension, TVector<double>(leafCount));
+        CalcLeafDeltasMulti(leafDers, ELeavesEstimation::Newton, /*l2Regularizer*/ 3.0f, sampleCount, sampleCount, &localExecutor, &buffers, &leafDeltas);
+        for (auto dim : xrange(approxDimension)) {
+            for (auto leaf : xrange(leafCount)) {
+                UNIT_ASSERT_DOUBLES_EQUAL(leafDeltas[dim][leaf], expectedLeafDeltas[dim][leaf], 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(LeafDersDoNotDependOnThreadCount) {
+        const int sampleCount = 10000;
+        const int approxDimension = 3;
+        const int leafCount = 16;
+        TFastRng<ui64> rng(1);
+
+        TVector<TVector<double>> approx(approxDimension, TVector<double>(sampleCount));
+        for (auto& dimensionApprox : approx) {
+            for (auto& value : dimensionApprox) {
+                value = rng.GenRandReal1() - 0.5;
+            }
+        }
+        TVector<float> target(sampleCount);
+        TVector<float> weight(sampleCount);
+        TVector<TIndexType> indices(sampleCount);
+        for (auto sampleIdx : xrange(sampleCount)) {
+            target[sampleIdx] = rng.Uniform(approxDimension);
+            weight[sampleIdx] = 0.5 + rng.GenRandReal1();
+            indices[sampleIdx] = rng.Uniform(leafCount);
+        }
+        const TVector<TConstArrayRef<float>> targetRef = {target};
+        const TMultiClassError error(/*isExpApprox*/ false);
+
+        TVector<TVector<TSumMulti>> threadCountLeafDers;
+        for (int threadCount : {1, 3, 8}) {
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount - 1);
+            TLeafDersMultiBuffers buffers;
+            auto& leafDers = threadCountLeafDers.emplace_back(
+                leafCount,
+                MakeZeroDers(approxDimension, ELeavesEstimation::Newton, error.GetHessianType())
+            );
+            CalcLeafDersMulti(
+                indices,
+                targetRef,
+                weight,
+                approx,
+                /*approxDeltas*/ {},
+                error,
+                sampleCount,
+                /*isUpdateWeight*/ true,
+                ELeavesEstimation::Newton,
+                &localExecutor,
+                &buffers,
+                &leafDers);
+        }
+        for (const auto& leafDers : threadCountLeafDers) {
+            for (auto leaf : xrange(leafCount)) {
+                // sums must be bitwise equal
+                UNIT_ASSERT_EQUAL(leafDers[leaf].SumDer, threadCountLeafDers[0][leaf].SumDer);
+                UNIT_ASSERT_EQUAL(leafDers[leaf].SumDer2.Data, threadCountLeafDers[0][leaf].SumDer2.Data);
+                UNIT_ASSERT_EQUAL(leafDers[leaf].SumWeights, threadCountLeafDers[0][leaf].SumWeights);
+            }
+        }
+    }
+}
@@ -13,6 +13,7 @@
 #include <util/string/cast.h>
 #include <util/string/split.h>
 
+#include <util/generic/cast.h>
 #include <util/generic/utility.h>
 #include <util/generic/xrange.h>
 
@@ -105,33 +106,31 @@ static NCB::TEvalResult Apply(
 
     NCB::TEvalResult resultApprox;
     TVector<TVector<TVector<double>>>& rawValues = resultApprox.GetRawValuesRef();
-    rawValues.resize(1);
+    rawValues.clear();
 
+    const size_t approxDimension = model.GetDimensionsCount();
+    const size_t docCount = dataset.ObjectsGrouping->GetObjectCount();
     auto maybeBaseline = dataset.RawTargetData.GetBaseline();
-    if (maybeBaseline) {
-        AssignRank2(*maybeBaseline, &rawValues[0]);
-    } else {
-        rawValues[0].resize(model.GetDimensionsCount(),
-                            TVector<double>(dataset.ObjectsGrouping->GetObjectCount(), 0.0));
-    }
-    TModelCalcerOnPool modelCalcerOnPool(model, dataset.ObjectsData, executor);
-    TVector<double> flatApprox;
-    TVector<TVector<double>> approx;
-    for (; begin < end; begin += evalPeriod) {
-        modelCalcerOnPool.ApplyModelMulti(EPredictionType::InternalRawFormulaVal,
-                                          begin,
-                                          Min(begin + evalPeriod, end),
-                                          &flatApprox,
-                                          &approx);
-
-        for (size_t i = 0; i < approx.size(); ++i) {
-            for (size_t j = 0; j < approx[0].size(); ++j) {
-                rawValues.back()[i][j] += approx[i][j];
+
+    // features are quantized once, each stage evaluates only its own trees
+    TStagedModelCalcerOnPool stagedModelCalcer(
+        model,
+        dataset.ObjectsData,
+        executor,
+        SafeIntegerCast<int>(begin),
+        SafeIntegerCast<int>(end),
+        SafeIntegerCast<int>(evalPeriod));
+    while (stagedModelCalcer.Next()) {
+        const auto flatApprox = stagedModelCalcer.GetFlatApprox();
+        auto& stageApprox = rawValues.emplace_back();
+        stageApprox.resize(approxDimension);
+        for (auto dim : xrange(approxDimension)) {
+            stageApprox[dim].yresize(docCount);
+            for (auto doc : xrange(docCount)) {
+                stageApprox[dim][doc] = flatApprox[approxDimension * doc + dim]
+                    + (maybeBaseline ? (*maybeBaseline)[dim][doc] : 0.0);
             }
         }
-        if (begin + evalPeriod < end) {
-            rawValues.push_back(rawValues.back());
-        }
     }
     return resultApprox;
 }
@@ -99,6 +99,15 @@ namespace NCatboostDistributed {
             RandomSeed);
     };
 
+    using TQuantileSketch = TVector<std::pair<double, double>>; // (diff, sum weight of local diffs <= diff), ascending
+
+    struct TQuantileIntervalPoints {
+        double LeftSumWeight = 0; // sum weight of diffs <= interval begin
+        TVector<std::pair<double, double>> Diffs; // (diff, weight) for diffs inside interval
+
+        SAVELOAD(LeftSumWeight, Diffs);
+    };
+
     struct TLocalTensorSearchData {
         // part of TLearnContext used by GreedyTensorSearch
         TCalcScoreFold SampledDocs;
@@ -123,12 +132,7 @@ namespace NCatboostDistributed {
         TVector<TVector<double>> BacktrackingStart;
 
         // data used by Exact approx calcer
-        TVector<TVector<TVector<std::pair<double, double>>>> ExactDiff; // [dim][leaf][]
-        TVector<TVector<TMinMax<int>>> SplitBounds; // [dim][leaf]
-        TVector<TVector<double>> LastPivot; // [dim][leaf]
-        TVector<TVector<int>> LastPartitionPoint; // [dim][leaf]
-        TVector<TVector<double>> CollectedLeftSumWeight; // [dim][leaf]
-        TVector<TVector<double>> LastSplitLeftSumWeight; // [dim][leaf]
+        TVector<TVector<TVector<std::pair<double, double>>>> ExactDiff; // [dim][leaf][], (diff, weight) sorted by diff
 
         ui32 AllDocCount;
         double SumAllWeights;
@@ -841,15 +841,42 @@ namespace NCatboostDistributed {
         *outTotalLeafWeights = std::move(totalLeafWeights);
     }
 
+    static constexpr size_t QuantileSketchSize = 256;
+
+    /*
+     * Takes about QuantileSketchSize points of sorted diffs at equal rank steps.
+     * Every point is moved to the end of its run of equal diffs, so the attached weight
+     * is exactly the local sum weight of diffs less or equal than the point.
+     * The last point always holds the total local weight.
+     */
+    static TQuantileSketch BuildQuantileSketch(TConstArrayRef<std::pair<double, double>> sortedDiffs) {
+        const size_t objectCount = sortedDiffs.size();
+        const size_t rankStep = Max<size_t>(1, CeilDiv(objectCount, QuantileSketchSize));
+        TQuantileSketch sketch;
+        sketch.reserve(Min(objectCount, QuantileSketchSize + 1));
+        double leftSumWeight = 0;
+        size_t nextRank = rankStep;
+        for (auto idx : xrange(objectCount)) {
+            leftSumWeight += sortedDiffs[idx].second;
+            const bool isLast = idx + 1 == objectCount;
+            const bool isRunEnd = isLast || sortedDiffs[idx + 1].first != sortedDiffs[idx].first;
+            if (isLast || (isRunEnd && idx + 1 >= nextRank)) {
+                sketch.emplace_back(sortedDiffs[idx].first, leftSumWeight);
+                nextRank = idx + 1 + rankStep;
+            }
+        }
+        return sketch;
+    }
+
     /*
      * Prepares data structures for exact quantile approx calculation.
-     * Returns Min and Max values of target for binary search of quantile.
+     * Returns per leaf sketches of local diffs distribution for locating quantile on master.
      */
-    void TQuantileExactApproxStarter::DoMap(
+    void TQuantileSketchBuilder::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
-        TInput* /*input*/,
-        TOutput* outMinMaxDiffs
+        TInput* /*unused*/,
+        TOutput* outSketches
     ) const {
         auto& localData = TLocalTensorSearchData::GetRef();
         const int leafCount = localData.Buckets.size();
@@ -859,168 +886,83 @@ namespace NCatboostDistributed {
         const auto& avrgFoldIndexing = localData.Progress->AveragingFold.LearnPermutation.Get()->GetObjectsIndexing();
 
         localData.ExactDiff.yresize(approxDimension);
-        localData.SplitBounds.yresize(approxDimension);
-        localData.LastPivot.yresize(approxDimension);
-        localData.LastPartitionPoint.yresize(approxDimension);
-        localData.CollectedLeftSumWeight.yresize(approxDimension);
-        localData.LastSplitLeftSumWeight.yresize(approxDimension);
 
-        TOutput minMaxDiffs(approxDimension);
+        TOutput sketches(approxDimension, TVector<TQuantileSketch>(leafCount));
         for (auto dimension : xrange(approxDimension)) {
             localData.ExactDiff[dimension].yresize(leafCount);
             for (auto leaf : xrange(leafCount)) {
                 localData.ExactDiff[dimension][leaf].clear();
             }
-            minMaxDiffs[dimension].assign(leafCount, {std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()});
             avrgFoldIndexing.ForEach([&](int idx, int srcIdx) {
                 const double diff = target[dimension][srcIdx] - localData.Progress->AvrgApprox[dimension][srcIdx];
                 const double weight = weights.empty() ? 1.0 : weights[srcIdx];
                 const TIndexType leaf = localData.Indices[idx];
                 localData.ExactDiff[dimension][leaf].emplace_back(diff, weight);
-                minMaxDiffs[dimension][leaf].Min = Min(minMaxDiffs[dimension][leaf].Min, diff);
-                minMaxDiffs[dimension][leaf].Max = Max(minMaxDiffs[dimension][leaf].Max, diff);
             });
-
-            localData.SplitBounds[dimension].yresize(leafCount);
-            localData.LastPartitionPoint[dimension].yresize(leafCount);
-            localData.LastPivot[dimension].yresize(leafCount);
-            localData.CollectedLeftSumWeight[dimension].yresize(leafCount);
-            localData.LastSplitLeftSumWeight[dimension].yresize(leafCount);
             for (auto leaf : xrange(leafCount)) {
-                const int objectCount = localData.ExactDiff[dimension][leaf].size();
-                localData.SplitBounds[dimension][leaf] = {0, objectCount};
-                localData.LastPivot[dimension][leaf] = std::numeric_limits<double>::max();
-                localData.LastPartitionPoint[dimension][leaf] = objectCount;
-                localData.CollectedLeftSumWeight[dimension][leaf]= 0;
-                localData.LastSplitLeftSumWeight[dimension][leaf] = 0;
+                auto& exactDiff = localData.ExactDiff[dimension][leaf];
+                Sort(exactDiff, [](const std::pair<double, double>& lhs, const std::pair<double, double>& rhs) {
+                    return lhs.first < rhs.first;
+                });
+                sketches[dimension][leaf] = BuildQuantileSketch(exactDiff);
             }
         }
 
-        *outMinMaxDiffs = std::move(minMaxDiffs);
-    }
-
-    void TQuantileExactApproxStarter::DoReduce(TVector<TOutput>* inMinMaxDiffsFromWorkers,
-                                               TOutput* reducedMinMaxDiffs) const {
-        const auto& minMaxDiffsFromWorkers = *inMinMaxDiffsFromWorkers;
-        TOutput result = minMaxDiffsFromWorkers[0];
-        for (auto worker : xrange(1, SafeIntegerCast<int>(minMaxDiffsFromWorkers.size()))) {
-            const auto& resultFromWorker = minMaxDiffsFromWorkers[worker];
-            for (auto dimension : xrange(result.size())) {
-                for (auto leaf : xrange(result[dimension].size())) {
-                    result[dimension][leaf].Min = Min(result[dimension][leaf].Min, resultFromWorker[dimension][leaf].Min);
-                    result[dimension][leaf].Max = Max(result[dimension][leaf].Max, resultFromWorker[dimension][leaf].Max);
-                }
-            }
-        }
-        *reducedMinMaxDiffs = std::move(result);
+        *outSketches = std::move(sketches);
     }
 
     /*
-     * Split exact diff arrays by pivots
-     * Returns weights of left parts after splitting
+     * Returns sum weight of diffs up to the beginning of search interval
+     * and all diffs inside interval (Min, Max]
      */
-    void TQuantileArraySplitter::DoMap(
+    void TQuantileIntervalCollector::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
-        TInput* pivots,
-        TOutput* outLeftRightWeights
+        TInput* inIntervals,
+        TOutput* outIntervalPoints
     ) const {
-        auto& localData = TLocalTensorSearchData::GetRef();
-        const auto leafCount = localData.Buckets.size();
-        const auto& pivotsRef = *pivots;
-        const auto approxDimension = pivotsRef.size();
-        TOutput leftWeights(approxDimension);
+        const auto& localData = TLocalTensorSearchData::GetRef();
+        const auto& intervals = *inIntervals;
+        const auto approxDimension = intervals.size();
+        const auto isLessThanDiff = [](double value, const std::pair<double, double>& diff) {
+            return value < diff.first;
+        };
+        TOutput intervalPoints(approxDimension);
         for (auto dimension : xrange(approxDimension)) {
-            leftWeights[dimension].assign(leafCount, 0);
+            const auto leafCount = intervals[dimension].size();
+            intervalPoints[dimension].resize(leafCount);
             for (auto leaf : xrange(leafCount)) {
-                auto& lastPivot = localData.LastPivot[dimension][leaf];
-                auto& lastPartitionPoint = localData.LastPartitionPoint[dimension][leaf];
-                auto& splitBounds = localData.SplitBounds[dimension][leaf];
-                auto& exactDiff = localData.ExactDiff[dimension][leaf];
-                auto& collectedLeftSumWeight = localData.CollectedLeftSumWeight[dimension][leaf];
-                auto& lastLeftSumWeight = localData.LastSplitLeftSumWeight[dimension][leaf];
-
-                const double curPivot = pivotsRef[dimension][leaf];
-                if (curPivot < lastPivot) {
-                    splitBounds.Max = lastPartitionPoint;
-                } else {
-                    splitBounds.Min = lastPartitionPoint;
-                    collectedLeftSumWeight += lastLeftSumWeight;
-                }
-                lastPivot = curPivot;
-                const auto partitionBegin = exactDiff.begin() + splitBounds.Min;
-                const auto partitionEnd = exactDiff.begin() + splitBounds.Max;
-                const auto partitionIt = std::partition(
-                    partitionBegin,
-                    partitionEnd,
-                    [curPivot](const std::pair<double, double>& diff) {
-                        return diff.first <= curPivot;
-                    });
-                int curPartitionPoint = partitionIt - exactDiff.begin();
-                lastLeftSumWeight = Accumulate(partitionBegin, partitionIt, 0.0, [](double totalWeight, const std::pair<double, double>& diff) {
+                const auto& exactDiff = localData.ExactDiff[dimension][leaf];
+                const auto& interval = intervals[dimension][leaf];
+                const auto intervalBegin = std::upper_bound(exactDiff.begin(), exactDiff.end(), interval.Min, isLessThanDiff);
+                const auto intervalEnd = std::upper_bound(intervalBegin, exactDiff.end(), interval.Max, isLessThanDiff);
+                auto& points = intervalPoints[dimension][leaf];
+                points.LeftSumWeight = Accumulate(exactDiff.begin(), intervalBegin, 0.0, [](double totalWeight, const std::pair<double, double>& diff) {
                     return totalWeight + diff.second;
                 });
-                leftWeights[dimension][leaf] = collectedLeftSumWeight + lastLeftSumWeight;
-                lastPartitionPoint = curPartitionPoint;
-            }
-        }
-        *outLeftRightWeights = std::move(leftWeights);
-    }
-
-    void TQuantileArraySplitter::DoReduce(
-        TVector<TOutput>* inLeftWeightsFromWorkers,
-        TOutput* outTotalLeftWeights
-    ) const {
-        const auto& leftWeightsFromWorkers = *inLeftWeightsFromWorkers;
-        TOutput totalLeftWeights = leftWeightsFromWorkers[0];
-        for (auto worker : xrange(1, SafeIntegerCast<int>(leftWeightsFromWorkers.size()))) {
-            for (auto dimension : xrange(totalLeftWeights.size())) {
-                AddElementwise(leftWeightsFromWorkers[worker][dimension], &totalLeftWeights[dimension]);
+                points.Diffs.assign(intervalBegin, intervalEnd);
             }
         }
-        *outTotalLeftWeights = std::move(totalLeftWeights);
+        *outIntervalPoints = std::move(intervalPoints);
     }
 
-    /*
-     * Calculates weight of elements equal to pivots
-     * Needed to adjusting quantile value according to 'delta' parameter of Quantile metric
-     */
-    void TQuantileEqualWeightsCalcer::DoMap(
-        NPar::IUserContext* /*ctx*/,
-        int /*hostId*/,
-        TInput* inPivots,
-        TOutput* outEqualSumWeights
+    void TQuantileIntervalCollector::DoReduce(
+        TVector<TOutput>* inIntervalPointsFromWorkers,
+        TOutput* outTotalIntervalPoints
     ) const {
-        auto& localData = TLocalTensorSearchData::GetRef();
-        const auto& pivots = *inPivots;
-        const auto approxDimension = pivots.size();
-        const auto leafCount = pivots[0].size();
-        TOutput equalSumWeights(approxDimension, TVector<double>(leafCount, 0.0));
-        for (auto dimension : xrange(approxDimension)) {
-            for (auto leaf : xrange(leafCount)) {
-                const auto pivot = pivots[dimension][leaf];
-                const auto& exactDiff = localData.ExactDiff[dimension][leaf];
-                double sumWeights = 0;
-                for (const auto [diff, weight] : exactDiff) {
-                    if (diff == pivot) {
-                        sumWeights += weight;
-                    }
+        auto& intervalPointsFromWorkers = *inIntervalPointsFromWorkers;
+        TOutput totalIntervalPoints = std::move(intervalPointsFromWorkers[0]);
+        for (auto worker : xrange(1, SafeIntegerCast<int>(intervalPointsFromWorkers.size()))) {
+            for (auto dimension : xrange(totalIntervalPoints.size())) {
+                for (auto leaf : xrange(totalIntervalPoints[dimension].size())) {
+                    const auto& workerPoints = intervalPointsFromWorkers[worker][dimension][leaf];
+                    auto& points = totalIntervalPoints[dimension][leaf];
+                    points.LeftSumWeight += workerPoints.LeftSumWeight;
+                    points.Diffs.insert(points.Diffs.end(), workerPoints.Diffs.begin(), workerPoints.Diffs.end());
                 }
-                equalSumWeights[dimension][leaf] = sumWeights;
-            }
-        }
-        *outEqualSumWeights = std::move(equalSumWeights);
-    }
-
-    void TQuantileEqualWeightsCalcer::DoReduce(TVector<TOutput>* inEqualSumWeightsFromWorkers, TOutput* outTotalEqualSumWeights) const {
-        const auto& equalSumWeightsFromWorkers = *inEqualSumWeightsFromWorkers;
-        TOutput totalEqualSumWeights = equalSumWeightsFromWorkers[0];
-        for (auto worker : xrange(1, SafeIntegerCast<int>(equalSumWeightsFromWorkers.size()))) {
-            for (auto dimension : xrange(totalEqualSumWeights.size())) {
-                AddElementwise(equalSumWeightsFromWorkers[worker][dimension], &totalEqualSumWeights[dimension]);
             }
         }
-        *outTotalEqualSumWeights = std::move(totalEqualSumWeights);
+        *outTotalIntervalPoints = std::move(totalIntervalPoints);
     }
 
     void TArmijoStartPointBackupper::DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TInput* isRestore, TOutput* /*unused*/) const {
@@ -1064,8 +1006,7 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d4d6, NCatboostDistributed, TApproxReconstructor
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e0, NCatboostDistributed, TLeafWeightsGetter);
 
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e1, NCatboostDistributed, TDatasetLoader);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d4e3, NCatboostDistributed, TQuantileExactApproxStarter);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d4e4, NCatboostDistributed, TQuantileArraySplitter);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d4e5, NCatboostDistributed, TQuantileEqualWeightsCalcer);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e3, NCatboostDistributed, TQuantileSketchBuilder);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e4, NCatboostDistributed, TQuantileIntervalCollector);
 
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e6, NCatboostDistributed, TArmijoStartPointBackupper);
@@ -164,20 +164,14 @@ namespace NCatboostDistributed {
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* leafWeights) const final;
         void DoReduce(TVector<TOutput>* leafWeightsFromWorkers, TOutput* totalLeafWeights) const final;
     };
-    class TQuantileExactApproxStarter: public NPar::TMapReduceCmd<TUnusedInitializedParam, TVector<TVector<TMinMax<double>>>> {
-        OBJECT_NOCOPY_METHODS(TQuantileExactApproxStarter);
-        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* leafCount, TOutput* minMaxDiffs) const final;
-        void DoReduce(TVector<TOutput>* minMaxDiffsFromWorkers, TOutput* reducedMinMaxDiffs) const final;
-    };
-    class TQuantileArraySplitter: public NPar::TMapReduceCmd<TVector<TVector<double>>, TVector<TVector<double>>> {
-        OBJECT_NOCOPY_METHODS(TQuantileArraySplitter);
-        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* pivots, TOutput* leftSumWeights) const final;
-        void DoReduce(TVector<TOutput>* leftRightWeightsFromWorkers, TOutput* totalLeftSumWeights) const final;
-    };
-    class TQuantileEqualWeightsCalcer: public NPar::TMapReduceCmd<TVector<TVector<double>>, TVector<TVector<double>>> {
-        OBJECT_NOCOPY_METHODS(TQuantileEqualWeightsCalcer);
-        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* pivots, TOutput* equalSumWeights) const final;
-        void DoReduce(TVector<TOutput>* equalSumWeightsFromWorkers, TOutput* totalEqualSumWeights) const final;
+    class TQuantileSketchBuilder: public NPar::TMapReduceCmd<TUnusedInitializedParam, TVector<TVector<TQuantileSketch>>> {
+        OBJECT_NOCOPY_METHODS(TQuantileSketchBuilder);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* sketches) const final;
+    };
+    class TQuantileIntervalCollector: public NPar::TMapReduceCmd<TVector<TVector<TMinMax<double>>>, TVector<TVector<TQuantileIntervalPoints>>> {
+        OBJECT_NOCOPY_METHODS(TQuantileIntervalCollector);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* intervals, TOutput* intervalPoints) const final;
+        void DoReduce(TVector<TOutput>* intervalPointsFromWorkers, TOutput* totalIntervalPoints) const final;
     };
 
 } // NCatboostDistributed
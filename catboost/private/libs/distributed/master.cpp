@@ -384,6 +384,57 @@ void MapCalcErrors(TLearnContext* ctx) {
     }
 }
 
+/*
+ * Locates interval (Min, Max] between two adjacent sketch points which contains the weighted quantile.
+ * For each candidate point, sketch of every worker gives lower and upper bounds of the local sum weight
+ * of diffs less or equal than the candidate.
+ */
+static TMinMax<double> GetQuantileSearchInterval(
+    TConstArrayRef<TConstArrayRef<std::pair<double, double>>> workerSketches,
+    double neededLeftWeight
+) {
+    TVector<double> candidates;
+    for (const auto& sketch : workerSketches) {
+        for (const auto& [diff, leftSumWeight] : sketch) {
+            candidates.push_back(diff);
+        }
+    }
+    SortUnique(candidates);
+    Y_ASSERT(!candidates.empty());
+
+    TMinMax<double> interval{-std::numeric_limits<double>::infinity(), candidates.back()};
+    TVector<size_t> sketchPositions(workerSketches.size(), 0); // count of sketch points <= candidate
+    for (auto candidate : candidates) {
+        double minLeftSumWeight = 0;
+        double maxLeftSumWeight = 0;
+        for (auto worker : xrange(workerSketches.size())) {
+            const auto& sketch = workerSketches[worker];
+            auto& position = sketchPositions[worker];
+            while (position < sketch.size() && sketch[position].first <= candidate) {
+                ++position;
+            }
+            if (position > 0) {
+                minLeftSumWeight += sketch[position - 1].second;
+            }
+            if (position > 0 && sketch[position - 1].first == candidate) {
+                maxLeftSumWeight += sketch[position - 1].second;
+            } else if (position < sketch.size()) {
+                maxLeftSumWeight += sketch[position].second;
+            } else if (!sketch.empty()) {
+                maxLeftSumWeight += sketch.back().second;
+            }
+        }
+        if (maxLeftSumWeight < neededLeftWeight) {
+            interval.Min = candidate;
+        }
+        if (minLeftSumWeight >= neededLeftWeight) {
+            interval.Max = candidate;
+            break;
+        }
+    }
+    return interval;
+}
+
 template <typename TDeltaUpdater>
 static void UpdateLeavesExact(
     const IDerCalcer& error,
@@ -403,74 +454,81 @@ static void UpdateLeavesExact(
         delta = quantileError->Delta;
     }
 
-    TVector<TUnusedInitializedParam> emptyInput(1);
-
-    TVector<TVector<TMinMax<double>>> searchIntervals;
-    NPar::RunMapReduce(TMasterEnvironment::GetRef().SharedTrainData.Get(), new TQuantileExactApproxStarter(), &emptyInput, &searchIntervals);
+    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
+    const auto sketchesFromWorkers = ApplyMapper<TQuantileSketchBuilder>(workerCount, TMasterEnvironment::GetRef().SharedTrainData);
 
-    TVector<double> totalLeafWeights;
-    NPar::RunMapReduce(TMasterEnvironment::GetRef().SharedTrainData.Get(), new TLeafWeightsGetter(), &emptyInput, &totalLeafWeights);
+    TVector<double> totalLeafWeights(leafCount, 0.0);
+    for (const auto& workerSketches : sketchesFromWorkers) {
+        for (auto leaf : xrange(leafCount)) {
+            if (!workerSketches[0][leaf].empty()) {
+                totalLeafWeights[leaf] += workerSketches[0][leaf].back().second;
+            }
+        }
+    }
 
     TVector<double> neededLeftWeigths(leafCount);
     for (auto leaf : xrange(leafCount)) {
         neededLeftWeigths[leaf] = alpha * totalLeafWeights[leaf];
     }
 
-    constexpr int BINARY_SEARCH_ITERATIONS = 100;
-    TVector<TVector<double>> pivots(approxDimension, TVector<double>(leafCount));
-    TVector<TVector<double>> leftWeights(approxDimension, TVector<double>(leafCount));
-    for (auto iter : xrange(BINARY_SEARCH_ITERATIONS)) {
-        Y_UNUSED(iter);
-        // calc new pivots
-        for (auto dimension : xrange(approxDimension)) {
-            for (auto leaf : xrange(leafCount)) {
-                const double leftValue = searchIntervals[dimension][leaf].Min;
-                const double rightValue = searchIntervals[dimension][leaf].Max;
-                pivots[dimension][leaf] = (leftValue + rightValue) / 2;
-            }
-        }
-        TVector<TVector<TVector<double>>> splitCmdInput(1, pivots);
-        NPar::RunMapReduce(TMasterEnvironment::GetRef().SharedTrainData.Get(), new TQuantileArraySplitter(), &splitCmdInput, &leftWeights);
-        for (auto dimension : xrange(approxDimension)) {
-            for (auto leaf : xrange(leafCount)) {
-                if (leftWeights[dimension][leaf] < neededLeftWeigths[leaf]) {
-                    searchIntervals[dimension][leaf].Min = pivots[dimension][leaf];
-                } else {
-                    searchIntervals[dimension][leaf].Max = pivots[dimension][leaf];
+    TVector<TVector<TMinMax<double>>> searchIntervals(approxDimension, TVector<TMinMax<double>>(leafCount, {0.0, 0.0}));
+    TVector<TConstArrayRef<std::pair<double, double>>> leafSketches(sketchesFromWorkers.size());
+    for (auto dimension : xrange(approxDimension)) {
+        for (auto leaf : xrange(leafCount)) {
+            if (totalLeafWeights[leaf] > 0) {
+                for (auto worker : xrange(sketchesFromWorkers.size())) {
+                    leafSketches[worker] = sketchesFromWorkers[worker][dimension][leaf];
                 }
+                searchIntervals[dimension][leaf] = GetQuantileSearchInterval(leafSketches, neededLeftWeigths[leaf]);
             }
         }
     }
 
+    TVector<TVector<TVector<TMinMax<double>>>> collectCmdInput(1, searchIntervals);
+    TVector<TVector<TQuantileIntervalPoints>> intervalPoints;
+    NPar::RunMapReduce(TMasterEnvironment::GetRef().SharedTrainData.Get(), new TQuantileIntervalCollector(), &collectCmdInput, &intervalPoints);
+
     TVector<TVector<double>> leafValues(approxDimension, TVector<double>(leafCount));
     for (auto dimension : xrange(approxDimension)) {
         for (auto leaf : xrange(leafCount)) {
-            if (totalLeafWeights[leaf] > 0) {
-                leafValues[dimension][leaf] = searchIntervals[dimension][leaf].Max;
+            if (totalLeafWeights[leaf] <= 0) {
+                continue;
             }
-        }
-    }
+            auto& diffs = intervalPoints[dimension][leaf].Diffs;
+            Sort(diffs, [](const std::pair<double, double>& lhs, const std::pair<double, double>& rhs) {
+                return lhs.first < rhs.first;
+            });
+            double quantile = searchIntervals[dimension][leaf].Max;
+            double lessSumWeight = intervalPoints[dimension][leaf].LeftSumWeight;
+            double equalSumWeight = 0;
+            for (size_t runBegin = 0; runBegin < diffs.size();) {
+                size_t runEnd = runBegin;
+                double runSumWeight = 0;
+                for (; runEnd < diffs.size() && diffs[runEnd].first == diffs[runBegin].first; ++runEnd) {
+                    runSumWeight += diffs[runEnd].second;
+                }
+                if (lessSumWeight + runSumWeight >= neededLeftWeigths[leaf] || runEnd == diffs.size()) {
+                    quantile = diffs[runBegin].first;
+                    equalSumWeight = runSumWeight;
+                    break;
+                }
+                lessSumWeight += runSumWeight;
+                runBegin = runEnd;
+            }
+            leafValues[dimension][leaf] = quantile;
 
-    // specific adjust according to delta parameter of Quantile loss
-    if (delta > 0) {
-        TVector<TVector<TVector<double>>> cmdInput(1, leafValues);
-        TVector<TVector<double>> equalSumWeights;
-        NPar::RunMapReduce(TMasterEnvironment::GetRef().SharedTrainData.Get(), new TQuantileEqualWeightsCalcer(), &cmdInput, &equalSumWeights);
-        for (auto dimension : xrange(approxDimension)) {
-            for (auto leaf : xrange(leafCount)) {
-                if (totalLeafWeights[leaf] > 0) {
-                    if (leftWeights[dimension][leaf] + alpha * equalSumWeights[dimension][leaf] >= neededLeftWeigths[leaf] - DBL_EPSILON) {
-                        leafValues[dimension][leaf] -= delta;
-                    } else {
-                        leafValues[dimension][leaf] += delta;
-                    }
+            // specific adjust according to delta parameter of Quantile loss
+            if (delta > 0) {
+                if (lessSumWeight + alpha * equalSumWeight >= neededLeftWeigths[leaf] - DBL_EPSILON) {
+                    leafValues[dimension][leaf] -= delta;
+                } else {
+                    leafValues[dimension][leaf] += delta;
                 }
             }
         }
     }
 
     AddElementwise(leafValues, averageLeafValues);
-    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
     ApplyMapper<TDeltaUpdater>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, leafValues);
 }
 
@@ -27,19 +27,32 @@ using namespace NCB;
 
 static TUpdateMethod ParseUpdateMethod(const TString& updateMethod) {
     TString errorMessage = "Incorrect update-method param value. Should be one of: SinglePoint, \
-        TopKLeaves, AllPoints or TopKLeaves:top=2 to set the top size in TopKLeaves method.";
+        TopKLeaves, AllPoints or TopKLeaves:top=2 to set the top size in TopKLeaves method. \
+        Add top_trees=N (e.g. SinglePoint:top_trees=50 or TopKLeaves:top=2;top_trees=50) \
+        to make each document affect only N trees.";
     TVector<TString> tokens = StringSplitter(updateMethod).Split(':').Limit(2);
     CB_ENSURE(tokens.size() <= 2, errorMessage);
     EUpdateType updateType;
     CB_ENSURE(TryFromString<EUpdateType>(tokens[0], updateType), tokens[0] + " update method is not supported");
-    CB_ENSURE(tokens.size() == 1 || (tokens.size() == 2 && updateType == EUpdateType::TopKLeaves), errorMessage);
     int topSize = 0;
+    int topTreesCount = -1;
     if (tokens.size() == 2) {
-        TVector<TString> keyValue = StringSplitter(tokens[1]).Split('=').Limit(2);
-        CB_ENSURE(keyValue[0] == "top", errorMessage);
-        CB_ENSURE(TryFromString<int>(keyValue[1], topSize), "Top size should be nonnegative integer, got: " + keyValue[1]);
+        for (const auto& param : StringSplitter(tokens[1]).Split(';')) {
+            TVector<TString> keyValue = StringSplitter(param.Token()).Split('=').Limit(2);
+            CB_ENSURE(keyValue.size() == 2, errorMessage);
+            if (keyValue[0] == "top") {
+                CB_ENSURE(updateType == EUpdateType::TopKLeaves, errorMessage);
+                CB_ENSURE(TryFromString<int>(keyValue[1], topSize), "Top size should be nonnegative integer, got: " + keyValue[1]);
+            } else {
+                CB_ENSURE(keyValue[0] == "top_trees", errorMessage);
+                CB_ENSURE(
+                    TryFromString<int>(keyValue[1], topTreesCount) && topTreesCount > 0,
+                    "Top trees count should be positive integer, got: " + keyValue[1]
+                );
+            }
+        }
     }
-    return TUpdateMethod(updateType, topSize);
+    return TUpdateMethod(updateType, topSize, topTreesCount);
 }
 
 static TDStrResult GetFinalDocumentImportances(
@@ -1,7 +1,9 @@
 #include "docs_importance_helpers.h"
 #include "ders_helpers.h"
 
+#include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/loggers/logger.h>
+#include <catboost/libs/logging/logging.h>
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/private/libs/algo/index_calcer.h>
 
@@ -11,6 +13,8 @@
 #include <util/generic/cast.h>
 #include <util/generic/utility.h>
 #include <util/generic/ymath.h>
+#include <util/generic/xrange.h>
+#include <util/stream/format.h>
 
 #include <numeric>
 
@@ -18,18 +22,53 @@
 using namespace NCB;
 
 
+// Train documents are processed in batches of up to this size by each worker.
+static constexpr ui32 MaxDocBatchSize = 16;
+
+
 TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
     const TProcessedDataProvider& processedData, int logPeriod
 ) {
+    const ui32 testDocCount = processedData.GetObjectCount();
+    const ui64 cpuRamLimit = GetMonopolisticFreeCpuRam();
     TVector<TVector<ui32>> leafIndices(TreeCount);
+    TVector<TVector<TVector<ui32>>> leavesTestDocId(TreeCount); // [treeCount][leafCount]
     auto binarizedFeatures = MakeQuantizedFeaturesForEvaluator(Model, *processedData.ObjectsData.Get());
     LocalExecutor->ExecRange([&] (int treeId) {
         leafIndices[treeId] = BuildIndicesForBinTree(Model, binarizedFeatures.Get(), treeId);
+        leavesTestDocId[treeId].resize(TreesStatistics[treeId].LeafCount);
+        for (ui32 docId = 0; docId < testDocCount; ++docId) {
+            leavesTestDocId[treeId][leafIndices[treeId][docId]].push_back(docId);
+        }
     }, NPar::TLocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
 
     UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetOneDimensionalTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
-    const size_t docBlockSize = 1000;
+    // leaf indices are not needed anymore, test documents of the leaves are kept in leavesTestDocId
+    TVector<TVector<ui32>>().swap(leafIndices);
+    const ui64 leavesTestDocIdSize = (ui64)TreeCount * testDocCount * sizeof(ui32);
+    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(testDocCount));
+
+    const ui32 workerCount = LocalExecutor->GetThreadCount() + 1;
+    ui32 docBatchSize = Max<ui32>(Min<ui32>(MaxDocBatchSize, CeilDiv<ui32>(DocCount, workerCount)), 1);
+    while (docBatchSize > 1
+        && GetDocBatchBuffersSize(docBatchSize, testDocCount) * workerCount + leavesTestDocIdSize > cpuRamLimit / 2)
+    {
+        docBatchSize /= 2;
+    }
+    const ui64 buffersSize = GetDocBatchBuffersSize(docBatchSize, testDocCount) * workerCount;
+    OutputWarningIfCpuRamUsageOverLimit(buffersSize + leavesTestDocIdSize, cpuRamLimit);
+    if (logPeriod) {
+        CATBOOST_INFO_LOG << "Documents are processed in batches of " << docBatchSize
+            << ", batch buffers use " << HumanReadableSize(buffersSize, SF_BYTES)
+            << ", test documents of leaves use " << HumanReadableSize(leavesTestDocIdSize, SF_BYTES) << Endl;
+        if (UsesTopTrees()) {
+            CATBOOST_INFO_LOG << "Each document affects only " << UpdateMethod.TopTreesCount
+                << " of " << TreeCount << " trees" << Endl;
+        }
+    }
+
+    TVector<TDocBatchBuffers> buffers(workerCount);
+    const size_t docBlockSize = docBatchSize * workerCount;
     TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
     TProfileInfo processDocumentsProfile(DocCount);
 
@@ -37,17 +76,21 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
         const size_t end = Min<size_t>(start + docBlockSize, DocCount);
         processDocumentsProfile.StartIterationBlock();
 
-        LocalExecutor->ExecRange([&] (int docId) {
-            // The derivative of leaf values with respect to train doc weight.
-            TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
-            UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
-        }, NPar::TLocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        // each batch of the block uses its own buffers
+        LocalExecutor->ExecRange([&] (int batchIdx) {
+            const ui32 batchStart = start + batchIdx * docBatchSize;
+            const ui32 batchEnd = Min<ui32>(batchStart + docBatchSize, end);
+            TVector<ui32> removedDocIds(batchEnd - batchStart);
+            std::iota(removedDocIds.begin(), removedDocIds.end(), batchStart);
+            UpdateLeavesDerivatives(removedDocIds, &buffers[batchIdx]);
+            GetDocumentImportancesForTrainDocBatch(removedDocIds, leavesTestDocId, &buffers[batchIdx], &documentImportances);
+        }, NPar::TLocalExecutor::TExecRangeParams(0, CeilDiv<size_t>(end - start, docBatchSize)), NPar::TLocalExecutor::WAIT_COMPLETE);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
-        }
+    }
+    DumpMemUsage("After documents importances evaluation");
     return documentImportances;
 }
 
@@ -69,123 +112,298 @@ void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TV
     EvaluateDerivatives(LossFunction, LeafEstimationMethod, finalApproxes, target, &FinalFirstDerivatives, nullptr, nullptr);
 }
 
-TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian) {
-    TVector<ui32> leafIdToUpdate;
-    const ui32 leafCount = 1 << Model.ModelTrees->GetTreeSizes()[treeId];
+bool TDocumentImportancesEvaluator::UpdatesLeavesByAllDocuments() const {
+    return UpdateMethod.UpdateType == EUpdateType::AllPoints
+        || (UpdateMethod.UpdateType == EUpdateType::TopKLeaves && UpdateMethod.TopSize > 0);
+}
+
+bool TDocumentImportancesEvaluator::UsesTopTrees() const {
+    return UpdateMethod.TopTreesCount != -1 && (ui32)UpdateMethod.TopTreesCount < TreeCount;
+}
+
+ui64 TDocumentImportancesEvaluator::GetDocBatchBuffersSize(ui32 batchSize, ui32 testDocCount) const {
+    ui64 maxLeafCount = 0;
+    for (const auto& treeStatistics : TreesStatistics) {
+        maxLeafCount = Max<ui64>(maxLeafCount, treeStatistics.LeafCount);
+    }
+    const ui64 jacobiansSize = UpdatesLeavesByAllDocuments() ? DocCount : 0;
+    const ui64 treeScoresSize = UsesTopTrees() ? TreeCount : 0;
+    const ui64 doublesPerBatchElement
+        = jacobiansSize + 1 + LeafDerivativesOffsets.back() + maxLeafCount + testDocCount + treeScoresSize;
+    const ui64 bytesPerBatchElement = doublesPerBatchElement * sizeof(double) + (maxLeafCount + treeScoresSize) * sizeof(ui8);
+    return batchSize * bytesPerBatchElement + (maxLeafCount + treeScoresSize) * sizeof(ui32);
+}
+
+void TDocumentImportancesEvaluator::SetTreesToUse(TConstArrayRef<ui32> removedDocIds, TDocBatchBuffers* buffers) {
+    const ui32 batchSize = removedDocIds.size();
+    // the direct change of the removed document leaf value, the term which does not depend on jacobians
+    auto& treeScores = buffers->TreeScores;
+    treeScores.assign((size_t)TreeCount * batchSize, 0.0);
+    for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+        const auto& treeStatistics = TreesStatistics[treeId];
+        const TVector<ui32>& leafIndices = treeStatistics.LeafIndices;
+        for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
+            const TVector<double>& formulaNumeratorAdding = treeStatistics.FormulaNumeratorAdding[it];
+            const TVector<double>& formulaDenominators = treeStatistics.FormulaDenominators[it];
+            for (auto idx : xrange(batchSize)) {
+                const ui32 removedDocId = removedDocIds[idx];
+                treeScores[(size_t)treeId * batchSize + idx]
+                    += Abs(formulaNumeratorAdding[removedDocId] / formulaDenominators[leafIndices[removedDocId]]);
+            }
+        }
+    }
+
+    // trees are selected for each document separately, so results do not depend on the batch composition
+    auto& isTreeUsed = buffers->IsTreeUsed;
+    isTreeUsed.assign((size_t)TreeCount * batchSize, 0);
+    auto& orderedTreeIndices = buffers->OrderedTreeIndices;
+    orderedTreeIndices.yresize(TreeCount);
+    const ui32 topTreesCount = UpdateMethod.TopTreesCount;
+    for (auto idx : xrange(batchSize)) {
+        std::iota(orderedTreeIndices.begin(), orderedTreeIndices.end(), 0);
+        PartialSort(
+            orderedTreeIndices.begin(),
+            orderedTreeIndices.begin() + topTreesCount,
+            orderedTreeIndices.end(),
+            [&](ui32 firstTreeId, ui32 secondTreeId) {
+                const double firstScore = treeScores[(size_t)firstTreeId * batchSize + idx];
+                const double secondScore = treeScores[(size_t)secondTreeId * batchSize + idx];
+                return firstScore > secondScore || (firstScore == secondScore && firstTreeId < secondTreeId);
+            }
+        );
+        for (ui32 i = 0; i < topTreesCount; ++i) {
+            isTreeUsed[(size_t)orderedTreeIndices[i] * batchSize + idx] = 1;
+        }
+    }
+}
+
+void TDocumentImportancesEvaluator::SetLeafIdToUpdate(ui32 treeId, ui32 batchSize, TDocBatchBuffers* buffers) {
+    const ui32 leafCount = TreesStatistics[treeId].LeafCount;
+    auto& isLeafUpdated = buffers->IsLeafUpdated;
 
     if (UpdateMethod.UpdateType == EUpdateType::AllPoints) {
-        leafIdToUpdate.resize(leafCount);
-        std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
-    } else if (UpdateMethod.UpdateType == EUpdateType::TopKLeaves) {
-        const TVector<ui32>& leafIndices = TreesStatistics[treeId].LeafIndices;
-        TVector<double> leafJacobians(leafCount);
-        for (ui32 docId = 0; docId < DocCount; ++docId) {
-            leafJacobians[leafIndices[docId]] += Abs(jacobian[docId]);
+        isLeafUpdated.assign((size_t)leafCount * batchSize, 1);
+        return;
+    }
+    Y_ASSERT(UpdateMethod.UpdateType == EUpdateType::TopKLeaves);
+
+    const TVector<ui32>& leafIndices = TreesStatistics[treeId].LeafIndices;
+    const double* jacobians = buffers->Jacobians.data();
+    auto& leafJacobians = buffers->LeafJacobians;
+    leafJacobians.assign((size_t)leafCount * batchSize, 0.0);
+    for (ui32 docId = 0; docId < DocCount; ++docId) {
+        const double* docJacobians = jacobians + (size_t)docId * batchSize;
+        double* docLeafJacobians = leafJacobians.data() + (size_t)leafIndices[docId] * batchSize;
+        for (ui32 idx = 0; idx < batchSize; ++idx) {
+            docLeafJacobians[idx] += Abs(docJacobians[idx]);
         }
+    }
 
-        TVector<ui32> orderedLeafIndices(leafCount);
+    isLeafUpdated.assign((size_t)leafCount * batchSize, 0);
+    auto& orderedLeafIndices = buffers->OrderedLeafIndices;
+    orderedLeafIndices.yresize(leafCount);
+    const ui32 topSize = Min<ui32>(UpdateMethod.TopSize, leafCount);
+    for (ui32 idx = 0; idx < batchSize; ++idx) {
         std::iota(orderedLeafIndices.begin(), orderedLeafIndices.end(), 0);
-        Sort(orderedLeafIndices.begin(), orderedLeafIndices.end(), [&](ui32 firstDocId, ui32 secondDocId) {
-            return leafJacobians[firstDocId] > leafJacobians[secondDocId];
+        Sort(orderedLeafIndices.begin(), orderedLeafIndices.end(), [&](ui32 firstLeafId, ui32 secondLeafId) {
+            return leafJacobians[firstLeafId * batchSize + idx] > leafJacobians[secondLeafId * batchSize + idx];
         });
-
-        leafIdToUpdate = TVector<ui32>(
-            orderedLeafIndices.begin(),
-            orderedLeafIndices.begin() + Min<ui32>(UpdateMethod.TopSize, leafCount)
-        );
+        for (ui32 i = 0; i < topSize; ++i) {
+            isLeafUpdated[orderedLeafIndices[i] * batchSize + idx] = 1;
+        }
     }
-
-    return leafIdToUpdate;
 }
 
-void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives) {
-    TVector<double> jacobian(DocCount);
+void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(TConstArrayRef<ui32> removedDocIds, TDocBatchBuffers* buffers) {
+    const ui32 batchSize = removedDocIds.size();
+    const bool updatesByAllDocuments = UpdatesLeavesByAllDocuments();
+    if (updatesByAllDocuments) {
+        buffers->Jacobians.assign((size_t)DocCount * batchSize, 0.0);
+    }
+    buffers->RemovedDocJacobians.assign(batchSize, 0.0);
+    buffers->LeafDerivatives.yresize(LeafDerivativesOffsets.back() * batchSize);
+    const bool usesTopTrees = UsesTopTrees();
+    if (usesTopTrees) {
+        SetTreesToUse(removedDocIds, buffers);
+    }
+
+    double* jacobians = buffers->Jacobians.data();
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        auto& treeStatistics = TreesStatistics[treeId];
+        const auto& treeStatistics = TreesStatistics[treeId];
+        const TVector<ui32>& leafIndices = treeStatistics.LeafIndices;
+        const ui8* isTreeUsed = usesTopTrees ? buffers->IsTreeUsed.data() + (size_t)treeId * batchSize : nullptr;
+        // trees not used by any document of the batch do not change
+        if (isTreeUsed && AllOf(isTreeUsed, isTreeUsed + batchSize, [] (ui8 value) { return value == 0; })) {
+            const size_t treeBegin = LeafDerivativesOffsets[treeId * LeavesEstimationIterations];
+            const size_t treeEnd = LeafDerivativesOffsets[(treeId + 1) * LeavesEstimationIterations];
+            Fill(
+                buffers->LeafDerivatives.begin() + treeBegin * batchSize,
+                buffers->LeafDerivatives.begin() + treeEnd * batchSize,
+                0.0
+            );
+            continue;
+        }
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<ui32> leafIdToUpdate = GetLeafIdToUpdate(treeId, jacobian);
-            TVector<double>& leafDerivativesRef = (*leafDerivatives)[treeId][it];
+            const size_t leafDerivativesOffset = LeafDerivativesOffsets[treeId * LeavesEstimationIterations + it];
+            TArrayRef<double> leafDerivatives(
+                buffers->LeafDerivatives.data() + leafDerivativesOffset * batchSize,
+                (size_t)treeStatistics.LeafCount * batchSize
+            );
 
             // Updating Leaves Derivatives
-            UpdateLeavesDerivativesForTree(
-                leafIdToUpdate,
-                removedDocId,
-                jacobian,
-                treeId,
-                it,
-                &leafDerivativesRef
-            );
+            UpdateLeavesDerivativesForTree(removedDocIds, treeId, it, buffers, leafDerivatives);
+            if (isTreeUsed) {
+                for (ui32 leafId = 0; leafId < treeStatistics.LeafCount; ++leafId) {
+                    double* leafDerivativesRef = leafDerivatives.data() + (size_t)leafId * batchSize;
+                    for (ui32 idx = 0; idx < batchSize; ++idx) {
+                        leafDerivativesRef[idx] = isTreeUsed[idx] ? leafDerivativesRef[idx] : 0.0;
+                    }
+                }
+            }
 
             // Updating Jacobian
-            bool isRemovedDocUpdated = false;
-            for (ui32 leafId : leafIdToUpdate) {
-                for (ui32 docId : treeStatistics.LeavesDocId[leafId]) {
-                    jacobian[docId] += leafDerivativesRef[leafId];
+            if (!updatesByAllDocuments) {
+                for (auto idx : xrange(batchSize)) {
+                    const ui32 removedDocLeafId = leafIndices[removedDocIds[idx]];
+                    buffers->RemovedDocJacobians[idx] += leafDerivatives[removedDocLeafId * batchSize + idx];
                 }
-                isRemovedDocUpdated |= (treeStatistics.LeafIndices[removedDocId] == leafId);
+                continue;
             }
-            if (!isRemovedDocUpdated) {
-                ui32 removedDocLeafId = treeStatistics.LeafIndices[removedDocId];
-                jacobian[removedDocId] += leafDerivativesRef[removedDocLeafId];
+            const ui8* isLeafUpdated = buffers->IsLeafUpdated.data();
+            const bool updateAllLeaves = UpdateMethod.UpdateType == EUpdateType::AllPoints;
+            for (ui32 docId = 0; docId < DocCount; ++docId) {
+                double* docJacobians = jacobians + (size_t)docId * batchSize;
+                const size_t leafOffset = (size_t)leafIndices[docId] * batchSize;
+                const double* docLeafDerivatives = leafDerivatives.data() + leafOffset;
+                if (updateAllLeaves) {
+                    for (ui32 idx = 0; idx < batchSize; ++idx) {
+                        docJacobians[idx] += docLeafDerivatives[idx];
+                    }
+                } else {
+                    const ui8* isDocLeafUpdated = isLeafUpdated + leafOffset;
+                    for (ui32 idx = 0; idx < batchSize; ++idx) {
+                        docJacobians[idx] += isDocLeafUpdated[idx] ? docLeafDerivatives[idx] : 0.0;
+                    }
+                }
+            }
+            for (auto idx : xrange(batchSize)) {
+                const ui32 removedDocId = removedDocIds[idx];
+                const size_t removedDocLeafOffset = (size_t)leafIndices[removedDocId] * batchSize + idx;
+                if (!isLeafUpdated[removedDocLeafOffset]) {
+                    jacobians[(size_t)removedDocId * batchSize + idx] += leafDerivatives[removedDocLeafOffset];
+                }
             }
         }
     }
 }
 
-void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
-    const TVector<TVector<TVector<double>>>& leafDerivatives,
-    const TVector<TVector<ui32>>& leafIndices,
-    TVector<double>* documentImportance
+void TDocumentImportancesEvaluator::GetDocumentImportancesForTrainDocBatch(
+    TConstArrayRef<ui32> removedDocIds,
+    const TVector<TVector<TVector<ui32>>>& leavesTestDocId,
+    TDocBatchBuffers* buffers,
+    TVector<TVector<double>>* documentImportances
 ) {
-    const ui32 docCount = documentImportance->size();
-    TVector<double> predictedDerivatives(docCount);
+    const ui32 batchSize = removedDocIds.size();
+    const ui32 docCount = FinalFirstDerivatives.size();
+    auto& predictedDerivatives = buffers->PredictedDerivatives;
+    predictedDerivatives.assign((size_t)docCount * batchSize, 0.0);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
+        const ui32 leafCount = TreesStatistics[treeId].LeafCount;
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
-            for (ui32 docId = 0; docId < docCount; ++docId) {
-                predictedDerivatives[docId] += leafDerivativesRef[leafIndicesRef[docId]];
+            const double* leafDerivatives = buffers->LeafDerivatives.data()
+                + LeafDerivativesOffsets[treeId * LeavesEstimationIterations + it] * batchSize;
+            for (ui32 leafId = 0; leafId < leafCount; ++leafId) {
+                const double* leafDerivativesRef = leafDerivatives + (size_t)leafId * batchSize;
+                // leaves that do not change for any removed document are skipped
+                // (most of them for SinglePoint and TopKLeaves update methods)
+                if (AllOf(leafDerivativesRef, leafDerivativesRef + batchSize, [] (double value) { return value == 0.0; })) {
+                    continue;
+                }
+                for (ui32 docId : leavesTestDocId[treeId][leafId]) {
+                    double* docPredictedDerivatives = predictedDerivatives.data() + (size_t)docId * batchSize;
+                    for (ui32 idx = 0; idx < batchSize; ++idx) {
+                        docPredictedDerivatives[idx] += leafDerivativesRef[idx];
+                    }
+                }
             }
         }
     }
 
-    for (ui32 docId = 0; docId < docCount; ++docId) {
-        (*documentImportance)[docId] = FinalFirstDerivatives[docId] * predictedDerivatives[docId];
+    for (auto idx : xrange(batchSize)) {
+        TVector<double>& documentImportance = (*documentImportances)[removedDocIds[idx]];
+        for (ui32 docId = 0; docId < docCount; ++docId) {
+            documentImportance[docId] = FinalFirstDerivatives[docId] * predictedDerivatives[(size_t)docId * batchSize + idx];
+        }
     }
 }
 
 void TDocumentImportancesEvaluator::UpdateLeavesDerivativesForTree(
-    const TVector<ui32>& leafIdToUpdate,
-    ui32 removedDocId,
-    const TVector<double>& jacobian,
+    TConstArrayRef<ui32> removedDocIds,
     ui32 treeId,
     ui32 leavesEstimationIteration,
-    TVector<double>* leafDerivatives
+    TDocBatchBuffers* buffers,
+    TArrayRef<double> leafDerivatives
 ) {
-    auto& leafDerivativesRef = *leafDerivatives;
     const auto& treeStatistics = TreesStatistics[treeId];
     const TVector<double>& formulaNumeratorMultiplier = treeStatistics.FormulaNumeratorMultiplier[leavesEstimationIteration];
     const TVector<double>& formulaNumeratorAdding = treeStatistics.FormulaNumeratorAdding[leavesEstimationIteration];
     const TVector<double>& formulaDenominators = treeStatistics.FormulaDenominators[leavesEstimationIteration];
-    const ui32 removedDocLeafId = treeStatistics.LeafIndices[removedDocId];
+    const TVector<ui32>& leafIndices = treeStatistics.LeafIndices;
+    const ui32 leafCount = treeStatistics.LeafCount;
+    const ui32 batchSize = removedDocIds.size();
 
-    leafDerivativesRef.resize(treeStatistics.LeafCount);
-    Fill(leafDerivativesRef.begin(), leafDerivativesRef.end(), 0);
-    bool isRemovedDocUpdated = false;
-    for (ui32 leafId : leafIdToUpdate) {
-        for (ui32 docId : treeStatistics.LeavesDocId[leafId]) {
-            leafDerivativesRef[leafId] += formulaNumeratorMultiplier[docId] * jacobian[docId];
+    Fill(leafDerivatives.begin(), leafDerivatives.end(), 0.0);
+
+    if (!UpdatesLeavesByAllDocuments()) {
+        for (auto idx : xrange(batchSize)) {
+            const ui32 removedDocId = removedDocIds[idx];
+            const ui32 removedDocLeafId = leafIndices[removedDocId];
+            double& leafDerivative = leafDerivatives[removedDocLeafId * batchSize + idx];
+            leafDerivative += buffers->RemovedDocJacobians[idx] * formulaNumeratorMultiplier[removedDocId];
+            leafDerivative += formulaNumeratorAdding[removedDocId];
+            leafDerivative *= -LearningRate / formulaDenominators[removedDocLeafId];
         }
-        if (leafId == removedDocLeafId) {
-            leafDerivativesRef[leafId] += formulaNumeratorAdding[removedDocId];
+        return;
+    }
+
+    SetLeafIdToUpdate(treeId, batchSize, buffers);
+    const double* jacobians = buffers->Jacobians.data();
+    const ui8* isLeafUpdated = buffers->IsLeafUpdated.data();
+
+    for (ui32 docId = 0; docId < DocCount; ++docId) {
+        const double multiplier = formulaNumeratorMultiplier[docId];
+        const double* docJacobians = jacobians + (size_t)docId * batchSize;
+        double* docLeafDerivatives = leafDerivatives.data() + (size_t)leafIndices[docId] * batchSize;
+        for (ui32 idx = 0; idx < batchSize; ++idx) {
+            docLeafDerivatives[idx] += multiplier * docJacobians[idx];
+        }
+    }
+    for (auto idx : xrange(batchSize)) {
+        const ui32 removedDocId = removedDocIds[idx];
+        const size_t removedDocLeafOffset = (size_t)leafIndices[removedDocId] * batchSize + idx;
+        if (isLeafUpdated[removedDocLeafOffset]) {
+            leafDerivatives[removedDocLeafOffset] += formulaNumeratorAdding[removedDocId];
         }
-        leafDerivativesRef[leafId] *= -LearningRate / formulaDenominators[leafId];
-        isRemovedDocUpdated |= (leafId == removedDocLeafId);
     }
-    if (!isRemovedDocUpdated) {
-        leafDerivativesRef[removedDocLeafId] += jacobian[removedDocId] * formulaNumeratorMultiplier[removedDocId];
-        leafDerivativesRef[removedDocLeafId] += formulaNumeratorAdding[removedDocId];
-        leafDerivativesRef[removedDocLeafId] *= -LearningRate / formulaDenominators[removedDocLeafId];
+    for (ui32 leafId = 0; leafId < leafCount; ++leafId) {
+        const double leafMultiplier = -LearningRate / formulaDenominators[leafId];
+        double* leafDerivativesRef = leafDerivatives.data() + (size_t)leafId * batchSize;
+        const ui8* isLeafUpdatedRef = isLeafUpdated + (size_t)leafId * batchSize;
+        for (ui32 idx = 0; idx < batchSize; ++idx) {
+            leafDerivativesRef[idx] = isLeafUpdatedRef[idx] ? leafDerivativesRef[idx] * leafMultiplier : 0.0;
+        }
+    }
+    // leaf of the removed document is always updated by the removed document itself
+    for (auto idx : xrange(batchSize)) {
+        const ui32 removedDocId = removedDocIds[idx];
+        const ui32 removedDocLeafId = leafIndices[removedDocId];
+        const size_t removedDocLeafOffset = (size_t)removedDocLeafId * batchSize + idx;
+        if (!isLeafUpdated[removedDocLeafOffset]) {
+            double& leafDerivative = leafDerivatives[removedDocLeafOffset];
+            leafDerivative += jacobians[(size_t)removedDocId * batchSize + idx] * formulaNumeratorMultiplier[removedDocId];
+            leafDerivative += formulaNumeratorAdding[removedDocId];
+            leafDerivative *= -LearningRate / formulaDenominators[removedDocLeafId];
+        }
     }
 }
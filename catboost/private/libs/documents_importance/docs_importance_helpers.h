@@ -12,6 +12,7 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/system/types.h>
@@ -24,18 +25,23 @@
  */
 
 // This class describes the update set method (section 3.1.3 from the paper).
+// TopTreesCount (if set) makes each removed document affect only the trees on which its own leaves depend most.
 struct TUpdateMethod {
     TUpdateMethod() = default;
-    explicit TUpdateMethod(EUpdateType updateType, int topSize = -1)
+    explicit TUpdateMethod(EUpdateType updateType, int topSize = -1, int topTreesCount = -1)
         : UpdateType(updateType)
         , TopSize(topSize)
+        , TopTreesCount(topTreesCount)
     {
         CB_ENSURE(UpdateType != EUpdateType::TopKLeaves || TopSize >= 0,
             "You should provide top size for TopKLeaves method. It should be nonnegative integer.");
+        CB_ENSURE(TopTreesCount == -1 || TopTreesCount > 0,
+            "Top trees count should be positive integer or -1 (for all trees).");
     }
 
     EUpdateType UpdateType;
     int TopSize;
+    int TopTreesCount = -1; // -1 means that all trees are used
 };
 
 // The class for document importances evaluation.
@@ -77,32 +83,68 @@ public:
             treeStatisticsEvaluator = MakeHolder<TNewtonTreeStatisticsEvaluator>(DocCount);
         }
         TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, startingApprox, logPeriod);
+
+        LeafDerivativesOffsets.reserve(TreeCount * LeavesEstimationIterations + 1);
+        LeafDerivativesOffsets.push_back(0);
+        for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+            for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
+                LeafDerivativesOffsets.push_back(LeafDerivativesOffsets.back() + TreesStatistics[treeId].LeafCount);
+            }
+        }
     }
 
     // Getting the importance of all train objects for all objects from pool.
     TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
 
+private:
+    /*
+     * Buffers for a batch of removed train documents, reused by a worker between batches.
+     * Values for the documents of the batch are interleaved: the value for docId (leafId) and the
+     * batch element idx is stored at [docId * batchSize + idx] ([leafId * batchSize + idx]),
+     * so that updates of all the batch elements are done by one contiguous (vectorizable) loop.
+     */
+    struct TDocBatchBuffers {
+        TVector<double> Jacobians; // [DocCount * batchSize], empty if leaves are not updated by other documents
+        TVector<double> RemovedDocJacobians; // [batchSize]
+        TVector<double> LeafDerivatives; // [LeafDerivativesOffsets.back() * batchSize]
+        TVector<double> LeafJacobians; // [maxLeafCount * batchSize]
+        TVector<ui8> IsLeafUpdated; // [maxLeafCount * batchSize]
+        TVector<ui32> OrderedLeafIndices; // [maxLeafCount]
+        TVector<double> PredictedDerivatives; // [testDocCount * batchSize]
+        TVector<double> TreeScores; // [TreeCount * batchSize], empty if all trees are used
+        TVector<ui8> IsTreeUsed; // [TreeCount * batchSize], empty if all trees are used
+        TVector<ui32> OrderedTreeIndices; // [TreeCount], empty if all trees are used
+    };
+
 private:
     // Evaluate first derivatives at the final approxes
     void UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target);
-    // Leaves derivatives will be updated based on objects from these leaves.
-    TVector<ui32> GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian);
-    // Algorithm 4 from paper.
-    void UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives);
-    // Getting the importance of one train object for all objects from pool.
-    void GetDocumentImportancesForOneTrainDoc(
-        const TVector<TVector<TVector<double>>>& leafDerivatives,
-        const TVector<TVector<ui32>>& leafIndices,
-        TVector<double>* documentImportance
-    );
-    // Evaluate leaf derivatives at a given removedDocId weight (Equation (6) from paper).
+    // Whether leaf derivatives depend on the jacobian of documents other than the removed one.
+    bool UpdatesLeavesByAllDocuments() const;
+    // Whether removed documents affect only a part of the trees.
+    bool UsesTopTrees() const;
+    // Memory used by the buffers of one worker.
+    ui64 GetDocBatchBuffersSize(ui32 batchSize, ui32 testDocCount) const;
+    // Mark trees on which the leaves of each removed document depend most (TopTreesCount per document).
+    void SetTreesToUse(TConstArrayRef<ui32> removedDocIds, TDocBatchBuffers* buffers);
+    // Mark leaves which derivatives will be updated based on objects from these leaves.
+    void SetLeafIdToUpdate(ui32 treeId, ui32 batchSize, TDocBatchBuffers* buffers);
+    // Algorithm 4 from paper for a batch of removed documents.
+    void UpdateLeavesDerivatives(TConstArrayRef<ui32> removedDocIds, TDocBatchBuffers* buffers);
+    // Evaluate leaf derivatives at given removedDocIds weights (Equation (6) from paper).
     void UpdateLeavesDerivativesForTree(
-        const TVector<ui32>& leafIdToUpdate,
-        ui32 removedDocId,
-        const TVector<double>& jacobian,
+        TConstArrayRef<ui32> removedDocIds,
         ui32 treeId,
         ui32 leavesEstimationIteration,
-        TVector<double>* leafDerivatives
+        TDocBatchBuffers* buffers,
+        TArrayRef<double> leafDerivatives // [leafCount * batchSize]
+    );
+    // Getting the importance of a batch of train objects for all objects from pool.
+    void GetDocumentImportancesForTrainDocBatch(
+        TConstArrayRef<ui32> removedDocIds,
+        const TVector<TVector<TVector<ui32>>>& leavesTestDocId, // [treeCount][leafCount]
+        TDocBatchBuffers* buffers,
+        TVector<TVector<double>>* documentImportances // [DocCount][testDocCount]
     );
 
 private:
@@ -116,5 +158,6 @@ private:
     float LearningRate;
     ui32 TreeCount;
     ui32 DocCount;
+    TVector<size_t> LeafDerivativesOffsets; // [treeCount * LeavesEstimationIterations + 1]
     TAtomicSharedPtr<NPar::TLocalExecutor> LocalExecutor;
 };
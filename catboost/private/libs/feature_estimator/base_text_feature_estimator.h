@@ -104,9 +104,7 @@ namespace NCB {
                 const ui64 samplesCount = ds.SamplesCount();
                 TVector<float> features(featuresCount * samplesCount);
 
-                for (ui64 line = 0; line < samplesCount; ++line) {
-                    Compute(featureCalcer, ds.GetText(line), line, samplesCount, features);
-                }
+                featureCalcer.ComputeBlock(ds.GetTexts(), features);
 
                 for (ui32 f = 0; f < featuresCount; ++f) {
                     visitors[id](
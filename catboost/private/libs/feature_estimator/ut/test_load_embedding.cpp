@@ -114,4 +114,40 @@ Y_UNIT_TEST_SUITE(EmbeddingTest) {
         }
     }
 
+    Y_UNIT_TEST(TestMappedEmbeddingLoad) {
+        TFastRng64 rng(0);
+        auto dictionaryBuilderOptions = NCatboostOptions::TDictionaryBuilderOptions{1, -1};
+        NTextProcessing::NDictionary::TDictionaryOptions dictionaryOptions;
+
+        TDictionaryBuilder builder{dictionaryBuilderOptions, dictionaryOptions};
+        auto embedding = GenerateEmbedding(1000, 100, &rng, &builder);
+        DumpEmbedding(embedding, "embedding.txt");
+        {
+            TOFStream tokens("embedding.tokens");
+            TOFStream rows("embedding.rows");
+            for (const auto& [key, vec] : embedding) {
+                tokens << key << Endl;
+                rows.Write(vec.data(), vec.size() * sizeof(float));
+            }
+            // token unknown to the dictionary
+            tokens << "unknown_word" << Endl;
+            const auto unknownVec = RandomVec(100, &rng);
+            rows.Write(unknownVec.data(), unknownVec.size() * sizeof(float));
+        }
+
+        auto dict = TDictionaryProxy(builder.FinishBuilding());
+        auto parsedEmbedding = LoadEmbedding("embedding.txt", dict);
+        auto mappedEmbedding = LoadMappedEmbedding("embedding.tokens", "embedding.rows", dict);
+        UNIT_ASSERT_VALUES_EQUAL(mappedEmbedding->Dim(), parsedEmbedding->Dim());
+
+        TVector<float> parsedVec;
+        TVector<float> mappedVec;
+        for (const auto& [word, vec] : embedding) {
+            TText text;
+            dict.Apply({word, "unknown_word"}, &text);
+            parsedEmbedding->Apply(text, &parsedVec);
+            mappedEmbedding->Apply(text, &mappedVec);
+            EnsureVecEqual(parsedVec, mappedVec);
+        }
+    }
 }
@@ -14,12 +14,17 @@
 #include <catboost/libs/train_lib/dir_helper.h>
 #include <catboost/private/libs/options/plain_options_helper.h>
 
+#include <library/cpp/json/json_writer.h>
+
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/deque.h>
 #include <util/generic/set.h>
 #include <util/generic/xrange.h>
 #include <util/random/shuffle.h>
 
+#include <atomic>
+#include <cmath>
 #include <numeric>
 
 namespace {
@@ -1127,9 +1132,388 @@ namespace {
         }
         return bestParamsSetMetricValue;
     }
+
+    bool IsSameQuantization(const TQuantizationParamsInfo& lhs, const TQuantizationParamsInfo& rhs) {
+        return lhs.BinsCount == rhs.BinsCount &&
+            lhs.BorderType == rhs.BorderType &&
+            lhs.NanMode == rhs.NanMode;
+    }
+
+    // Quantized (and for train-test search also split) dataset shared by all candidates with the same
+    // quantization params
+    struct TSharedQuantizedData {
+        TQuantizationParamsInfo QuantizationParamsSet;
+        TLabelConverter LabelConverter;
+        NCB::TTrainingDataProviderPtr QuantizedData;
+        NCB::TTrainingDataProviders TrainTestData;
+    };
+
+    struct THalvingCandidate {
+        NJson::TJsonValue ModelParams;
+        TQuantizationParamsInfo QuantizationParamsSet;
+        size_t SharedDataIdx = 0;
+        ui32 IterationCount = 0;
+
+        double MetricValue = 0; // best value of the first metric on the last round
+        int MetricSign = 1;
+        TMetricsAndTimeLeftHistory TrainTestResult;
+        TVector<TCVResult> CvResult;
+    };
+
+    // Searched params of the candidate in the same form as in the search result
+    TString GetSearchedParamsJson(
+        const THalvingCandidate& candidate,
+        const TVector<TString>& paramNames,
+        const TGeneralQuatizationParamsInfo& generalQuantizeParamsInfo) {
+
+        NJson::TJsonValue searchedParams(NJson::JSON_MAP);
+        for (const auto& paramName : paramNames) {
+            searchedParams[paramName] = candidate.ModelParams[paramName];
+        }
+        if (generalQuantizeParamsInfo.IsBordersCountInGrid) {
+            searchedParams[generalQuantizeParamsInfo.BordersCountParamName] = candidate.QuantizationParamsSet.BinsCount;
+        }
+        if (generalQuantizeParamsInfo.IsBorderTypeInGrid) {
+            searchedParams[generalQuantizeParamsInfo.BorderTypeParamName] = ToString(candidate.QuantizationParamsSet.BorderType);
+        }
+        if (generalQuantizeParamsInfo.IsNanModeInGrid) {
+            searchedParams[generalQuantizeParamsInfo.NanModeParamName] = ToString(candidate.QuantizationParamsSet.NanMode);
+        }
+        return NJson::WriteJson(&searchedParams, /*formatOutput*/ false, /*sortkeys*/ true);
+    }
+
+    void TrainHalvingCandidate(
+        ui32 iterationCount,
+        bool isSearchUsingTrainTestSplit,
+        const TMaybe<TCustomObjectiveDescriptor>& objectiveDescriptor,
+        const TMaybe<TCustomMetricDescriptor>& evalMetricDescriptor,
+        const TCrossValidationParams& cvParams,
+        const NCB::TDataMetaInfo& metaInfo,
+        ui32 targetDimension,
+        TSharedQuantizedData* sharedData,
+        NPar::TLocalExecutor* localExecutor,
+        THalvingCandidate* candidate) {
+
+        NJson::TJsonValue modelParams = candidate->ModelParams;
+        modelParams["iterations"] = iterationCount;
+        // Candidates are trained concurrently: logging level is a process-wide setting and written files
+        // (and cat features perfect hash unloaded to them) would be shared, so both are disabled
+        modelParams["logging_level"] = ToString(ELoggingLevel::Silent);
+        modelParams.EraseValue("verbose");
+        modelParams["allow_writing_files"] = false;
+
+        NCatboostOptions::TCatBoostOptions catBoostOptions(ETaskType::CPU);
+        NCatboostOptions::TOutputFilesOptions outputFileOptions;
+        CB_ENSURE(
+            ParseJsonParams(metaInfo, modelParams, &catBoostOptions, &outputFileOptions),
+            "Error: failed to parse parameters of successive halving candidate"
+        );
+        InitializeEvalMetricIfNotSet(catBoostOptions.MetricOptions->ObjectiveMetric, &catBoostOptions.MetricOptions->EvalMetric);
+
+        const ui32 approxDimension = NCB::GetApproxDimension(catBoostOptions, sharedData->LabelConverter, targetDimension);
+        const TVector<THolder<IMetric>> metrics = CreateMetrics(
+            catBoostOptions.MetricOptions,
+            evalMetricDescriptor,
+            approxDimension,
+            metaInfo.HasWeights
+        );
+        candidate->MetricSign = GetSignForMetricMinimization(metrics[0]);
+
+        if (isSearchUsingTrainTestSplit) {
+            UpdateSampleRateOption(metaInfo.ObjectCount, &catBoostOptions);
+            THolder<IModelTrainer> modelTrainerHolder = THolder<IModelTrainer>(TTrainerFactory::Construct(catBoostOptions.GetTaskType()));
+
+            TEvalResult evalRes;
+
+            TTrainModelInternalOptions internalOptions;
+            internalOptions.CalcMetricsOnly = true;
+            internalOptions.ForceCalcEvalMetricOnEveryIteration = false;
+            internalOptions.OffsetMetricPeriodByInitModelSize = true;
+            outputFileOptions.SetAllowWriteFiles(false);
+            const auto defaultTrainingCallbacks = MakeHolder<ITrainingCallbacks>();
+            TRestorableFastRng64 rand(catBoostOptions.RandomSeed);
+            TMetricsAndTimeLeftHistory metricsAndTimeHistory;
+            modelTrainerHolder->TrainModel(
+                internalOptions,
+                catBoostOptions,
+                outputFileOptions,
+                objectiveDescriptor,
+                evalMetricDescriptor,
+                sharedData->TrainTestData,
+                sharedData->LabelConverter,
+                defaultTrainingCallbacks.Get(),
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                /*initModelApplyCompatiblePools*/ NCB::TDataProviders(),
+                localExecutor,
+                &rand,
+                /*dstModel*/ nullptr,
+                /*evalResultPtrs*/ {&evalRes},
+                &metricsAndTimeHistory,
+                /*dstLearnProgress*/nullptr
+            );
+            CB_ENSURE(!metricsAndTimeHistory.TestBestError.empty(), "Error: no test metrics for successive halving candidate");
+            candidate->MetricValue = metricsAndTimeHistory.TestBestError[0].at(metrics[0]->GetDescription());
+            candidate->TrainTestResult = std::move(metricsAndTimeHistory);
+        } else {
+            TVector<TCVResult> cvResult;
+            CrossValidate(
+                modelParams,
+                objectiveDescriptor,
+                evalMetricDescriptor,
+                sharedData->LabelConverter,
+                sharedData->QuantizedData,
+                cvParams,
+                localExecutor,
+                &cvResult,
+                /*isAlreadyShuffled*/ true);
+            const auto& averageTest = cvResult[0].AverageTest;
+            CB_ENSURE(!averageTest.empty(), "Error: cross-validation returned empty metric history");
+            candidate->MetricValue = candidate->MetricSign == 1
+                ? *MinElement(averageTest.begin(), averageTest.end())
+                : *MaxElement(averageTest.begin(), averageTest.end());
+            candidate->CvResult = std::move(cvResult);
+        }
+    }
+
+    // Successive halving search over all candidates produced by gridIterator.
+    // Data is quantized (and split) once per distinct set of quantization params, candidates of one round
+    // are trained concurrently on disjoint thread pools, and only the best 1 / ReductionFactor of them
+    // proceed to the next round with a bigger iteration budget.
+    double TuneHyperparamsSuccessiveHalving(
+        const NCB::TSuccessiveHalvingParams& halvingParams,
+        bool isSearchUsingTrainTestSplit,
+        const TVector<TString>& paramNames,
+        const TMaybe<TCustomObjectiveDescriptor>& objectiveDescriptor,
+        const TMaybe<TCustomMetricDescriptor>& evalMetricDescriptor,
+        const TTrainTestSplitParams& trainTestSplitParams,
+        const TCrossValidationParams& cvParams,
+        const TGeneralQuatizationParamsInfo& generalQuantizeParamsInfo,
+        ui64 cpuUsedRamLimit,
+        NCB::TDataProviderPtr data,
+        TProductIteratorBase<TDeque<NJson::TJsonValue>, NJson::TJsonValue>* gridIterator,
+        NJson::TJsonValue* modelParamsToBeTried,
+        TGridParamsInfo* bestGridParams,
+        TMetricsAndTimeLeftHistory* trainTestResult,
+        TVector<TCVResult>* bestCvResult,
+        TVector<NCB::TSuccessiveHalvingRoundResult>* roundResults,
+        NPar::TLocalExecutor* localExecutor,
+        int verbose,
+        const THashMap<TString, NCB::TCustomRandomDistributionGenerator>& randDistGenerators = {}) {
+
+        CB_ENSURE(halvingParams.ReductionFactor > 1.0, "Error: successive halving reduction factor should be greater than 1");
+        CB_ENSURE(halvingParams.ParallelCandidates > 0, "Error: successive halving needs at least one parallel candidate");
+        CB_ENSURE(
+            !FindPtr(paramNames, TString("iterations")),
+            "Error: iterations can't be searched over in successive halving mode"
+        );
+
+        TRestorableFastRng64 rand(
+            isSearchUsingTrainTestSplit ? trainTestSplitParams.PartitionRandSeed : cvParams.PartitionRandSeed
+        );
+        const bool shuffle = isSearchUsingTrainTestSplit ? trainTestSplitParams.Shuffle : cvParams.Shuffle;
+        if (shuffle) {
+            auto objectsGroupingSubset = NCB::Shuffle(data->ObjectsGrouping, 1, &rand);
+            data = data->GetSubset(objectsGroupingSubset, cpuUsedRamLimit, localExecutor);
+        }
+
+        // Collect valid candidates and prepare shared quantized data
+        TVector<THalvingCandidate> candidates;
+        TVector<TSharedQuantizedData> sharedData;
+        TConstArrayRef<NJson::TJsonValue> paramsSet;
+        while (gridIterator->Next(&paramsSet)) {
+            // paramsSet: {border_count, feature_border_type, nan_mode, [others]}
+            THalvingCandidate candidate;
+            candidate.QuantizationParamsSet.BinsCount = GetRandomValueIfNeeded(paramsSet[0], randDistGenerators).GetInteger();
+            candidate.QuantizationParamsSet.BorderType = FromString<EBorderSelectionType>(paramsSet[1].GetString());
+            candidate.QuantizationParamsSet.NanMode = FromString<ENanMode>(paramsSet[2].GetString());
+
+            AssignOptionsToJson(
+                TConstArrayRef<TString>(paramNames),
+                TConstArrayRef<NJson::TJsonValue>(
+                    paramsSet.begin() + IndexOfFirstTrainingParameter,
+                    paramsSet.end()
+                ), // Ignoring quantization params
+                randDistGenerators,
+                modelParamsToBeTried
+            );
+
+            NCatboostOptions::TCatBoostOptions catBoostOptions(ETaskType::CPU);
+            NCatboostOptions::TOutputFilesOptions outputFileOptions;
+            if (!ParseJsonParams(data->MetaInfo, *modelParamsToBeTried, &catBoostOptions, &outputFileOptions)) {
+                continue;
+            }
+            candidate.ModelParams = *modelParamsToBeTried;
+            candidate.IterationCount = catBoostOptions.BoostingOptions->IterationCount.Get();
+
+            auto sharedDataIt = FindIf(
+                sharedData,
+                [&] (const TSharedQuantizedData& shared) {
+                    return IsSameQuantization(shared.QuantizationParamsSet, candidate.QuantizationParamsSet);
+                }
+            );
+            if (sharedDataIt == sharedData.end()) {
+                InitializeEvalMetricIfNotSet(catBoostOptions.MetricOptions->ObjectiveMetric, &catBoostOptions.MetricOptions->EvalMetric);
+
+                TSharedQuantizedData shared;
+                shared.QuantizationParamsSet = candidate.QuantizationParamsSet;
+                TSetLogging inThisScope(catBoostOptions.LoggingLevel);
+                // perfect hash is kept in RAM: concurrent candidates would load it back from the file
+                QuantizeDataIfNeeded(
+                    /*allowWriteFiles*/ false,
+                    /*tmpDir*/ TString(),
+                    data->MetaInfo.FeaturesLayout,
+                    /*quantizedFeaturesInfo*/ nullptr,
+                    data,
+                    /*oldQuantizedParamsInfo*/ TQuantizationParamsInfo(),
+                    candidate.QuantizationParamsSet,
+                    &shared.LabelConverter,
+                    localExecutor,
+                    &rand,
+                    &catBoostOptions,
+                    &shared.QuantizedData
+                );
+                if (isSearchUsingTrainTestSplit) {
+                    shared.TrainTestData = PrepareTrainTestSplit(
+                        shared.QuantizedData,
+                        trainTestSplitParams,
+                        cpuUsedRamLimit,
+                        localExecutor
+                    );
+                    // features checksum is cached on first use, compute it before concurrent trainings
+                    shared.TrainTestData.CalcFeaturesCheckSum(localExecutor);
+                }
+                sharedData.push_back(std::move(shared));
+                sharedDataIt = sharedData.end() - 1;
+            }
+            candidate.SharedDataIdx = sharedDataIt - sharedData.begin();
+            candidates.push_back(std::move(candidate));
+        }
+        CB_ENSURE(!candidates.empty(), "Error: no valid parameter sets to search over");
+
+        const double eta = halvingParams.ReductionFactor;
+        const ui32 roundCount = 1 + static_cast<ui32>(floor(log(static_cast<double>(candidates.size())) / log(eta) + 1e-9));
+        const int threadCount = localExecutor->GetThreadCount() + 1;
+
+        TVector<size_t> survivors(candidates.size());
+        std::iota(survivors.begin(), survivors.end(), 0);
+
+        for (auto roundIdx : xrange(roundCount)) {
+            // budget is min_iterations * eta^roundIdx if min_iterations is set,
+            // otherwise it's derived from the full iteration count so that the last round uses all iterations
+            const auto getRoundIterationCount = [&] (const THalvingCandidate& candidate) {
+                const double iterations = halvingParams.MinIterations
+                    ? *halvingParams.MinIterations * pow(eta, static_cast<double>(roundIdx))
+                    : candidate.IterationCount * pow(eta, static_cast<double>(roundIdx) - static_cast<double>(roundCount - 1));
+                return Max<ui32>(1, static_cast<ui32>(Min<double>(ceil(iterations), candidate.IterationCount)));
+            };
+
+            const int parallelCandidates = Min<int>(halvingParams.ParallelCandidates, survivors.size());
+            const int threadsPerCandidate = Max(1, threadCount / parallelCandidates);
+            TVector<THolder<NPar::TLocalExecutor>> candidateExecutors;
+            for (auto workerIdx : xrange(parallelCandidates)) {
+                Y_UNUSED(workerIdx);
+                candidateExecutors.push_back(MakeHolder<NPar::TLocalExecutor>());
+                candidateExecutors.back()->RunAdditionalThreads(threadsPerCandidate - 1);
+            }
+
+            // candidates are taken dynamically so that uneven workloads don't leave workers idle
+            std::atomic<size_t> nextSurvivorIdx{0};
+            NPar::TLocalExecutor workersExecutor;
+            workersExecutor.RunAdditionalThreads(parallelCandidates - 1);
+            {
+                TSetLoggingSilent inThisScope;
+                workersExecutor.ExecRangeWithThrow(
+                    [&] (int workerIdx) {
+                        for (size_t survivorIdx = nextSurvivorIdx++;
+                             survivorIdx < survivors.size();
+                             survivorIdx = nextSurvivorIdx++)
+                        {
+                            auto& candidate = candidates[survivors[survivorIdx]];
+                            TrainHalvingCandidate(
+                                getRoundIterationCount(candidate),
+                                isSearchUsingTrainTestSplit,
+                                objectiveDescriptor,
+                                evalMetricDescriptor,
+                                cvParams,
+                                data->MetaInfo,
+                                data->RawTargetData.GetTargetDimension(),
+                                &sharedData[candidate.SharedDataIdx],
+                                candidateExecutors[workerIdx].Get(),
+                                &candidate
+                            );
+                        }
+                    },
+                    0,
+                    parallelCandidates,
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+            }
+
+            StableSort(
+                survivors,
+                [&] (size_t lhs, size_t rhs) {
+                    const auto& lhsCandidate = candidates[lhs];
+                    const auto& rhsCandidate = candidates[rhs];
+                    return lhsCandidate.MetricSign * lhsCandidate.MetricValue < rhsCandidate.MetricSign * rhsCandidate.MetricValue;
+                }
+            );
+            auto& roundResult = roundResults->emplace_back();
+            roundResult.IterationCount = getRoundIterationCount(candidates[survivors[0]]);
+            for (auto candidateIdx : survivors) {
+                roundResult.CandidateParams.push_back(
+                    GetSearchedParamsJson(candidates[candidateIdx], paramNames, generalQuantizeParamsInfo)
+                );
+                roundResult.MetricValues.push_back(candidates[candidateIdx].MetricValue);
+            }
+            if (verbose) {
+                TSetLogging inThisScope(ELoggingLevel::Verbose);
+                CATBOOST_NOTICE_LOG << "Successive halving round " << roundIdx << ": "
+                    << survivors.size() << " candidates, "
+                    << getRoundIterationCount(candidates[survivors[0]]) << " iterations, "
+                    << "best metric value " << candidates[survivors[0]].MetricValue << Endl;
+            }
+            if (roundIdx + 1 < roundCount) {
+                survivors.resize(Max<size_t>(1, static_cast<size_t>(floor(survivors.size() / eta))));
+            }
+        }
+
+        const auto& bestCandidate = candidates[survivors[0]];
+        bestGridParams->QuantizationParamsSet = bestCandidate.QuantizationParamsSet;
+        bestGridParams->QuantizedFeatureInfo
+            = sharedData[bestCandidate.SharedDataIdx].QuantizedData->ObjectsData->GetQuantizedFeaturesInfo();
+        bestGridParams->OthersParamsSet = bestCandidate.ModelParams;
+        bestGridParams->GridParamNames = paramNames;
+        if (isSearchUsingTrainTestSplit) {
+            *trainTestResult = bestCandidate.TrainTestResult;
+        } else {
+            *bestCvResult = bestCandidate.CvResult;
+        }
+        return bestCandidate.MetricValue;
+    }
 } // anonymous namespace
 
 namespace NCB {
+    TSuccessiveHalvingParams ParseSuccessiveHalvingParams(const NJson::TJsonValue& options) {
+        CB_ENSURE(options.IsMap(), "Error: successive halving options should be a map");
+        TSuccessiveHalvingParams params;
+        for (const auto& [name, value] : options.GetMap()) {
+            if (name == "reduction_factor") {
+                params.ReductionFactor = value.GetDoubleRobust();
+            } else if (name == "min_iterations") {
+                CB_ENSURE(value.GetIntegerRobust() > 0, "Error: successive halving min_iterations should be positive");
+                params.MinIterations = SafeIntegerCast<ui32>(value.GetIntegerRobust());
+            } else if (name == "parallel_candidates") {
+                CB_ENSURE(value.GetIntegerRobust() > 0, "Error: successive halving parallel_candidates should be positive");
+                params.ParallelCandidates = SafeIntegerCast<ui32>(value.GetIntegerRobust());
+            } else {
+                CB_ENSURE(false, "Error: unknown successive halving option " << name);
+            }
+        }
+        CB_ENSURE(params.ReductionFactor > 1.0, "Error: successive halving reduction_factor should be greater than 1");
+        return params;
+    }
+
     void TBestOptionValuesWithCvResult::SetOptionsFromJson(
         const THashMap<TString, NJson::TJsonValue>& options,
         const TVector<TString>& optionsNames) {
@@ -1188,7 +1572,8 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit,
         bool returnCvStat,
-        int verbose) {
+        int verbose,
+        const TMaybe<TSuccessiveHalvingParams>& successiveHalvingParams) {
 
         // CatBoost options
         NJson::TJsonValue jsonParams;
@@ -1202,6 +1587,8 @@ namespace NCB {
 
         InitializeEvalMetricIfNotSet(catBoostOptions.MetricOptions->ObjectiveMetric, &catBoostOptions.MetricOptions->EvalMetric);
 
+        bestOptionValuesWithCvResult->SuccessiveHalvingRounds.clear();
+
         NPar::TLocalExecutor localExecutor;
         localExecutor.RunAdditionalThreads(catBoostOptions.SystemOptions->NumThreads.Get() - 1);
 
@@ -1245,7 +1632,28 @@ namespace NCB {
                 TSetLogging inThisScope(ELoggingLevel::Verbose);
                 CATBOOST_NOTICE_LOG << "Grid #" << gridEnumerator << Endl;
             }
-            if (isSearchUsingTrainTestSplit) {
+            if (successiveHalvingParams) {
+                metricValue = TuneHyperparamsSuccessiveHalving(
+                    *successiveHalvingParams,
+                    isSearchUsingTrainTestSplit,
+                    paramNames,
+                    objectiveDescriptor,
+                    evalMetricDescriptor,
+                    trainTestSplitParams,
+                    cvParams,
+                    generalQuantizeParamsInfo,
+                    cpuUsedRamLimit,
+                    data,
+                    &gridIterator,
+                    &modelParamsToBeTried,
+                    &gridParams,
+                    trainTestResult,
+                    &bestCvResult,
+                    &bestOptionValuesWithCvResult->SuccessiveHalvingRounds,
+                    &localExecutor,
+                    verbose
+                );
+            } else if (isSearchUsingTrainTestSplit) {
                 metricValue = TuneHyperparamsTrainTest(
                     paramNames,
                     objectiveDescriptor,
@@ -1320,7 +1728,8 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit,
         bool returnCvStat,
-        int verbose) {
+        int verbose,
+        const TMaybe<TSuccessiveHalvingParams>& successiveHalvingParams) {
 
         // CatBoost options
         NJson::TJsonValue jsonParams;
@@ -1333,6 +1742,7 @@ namespace NCB {
         CB_ENSURE(!outputJsonParams["save_snapshot"].GetBoolean(), "Snapshots are not yet supported for RandomizedSearchCV");
 
         InitializeEvalMetricIfNotSet(catBoostOptions.MetricOptions->ObjectiveMetric, &catBoostOptions.MetricOptions->EvalMetric);
+        bestOptionValuesWithCvResult->SuccessiveHalvingRounds.clear();
         NPar::TLocalExecutor localExecutor;
         localExecutor.RunAdditionalThreads(catBoostOptions.SystemOptions->NumThreads.Get() - 1);
 
@@ -1371,7 +1781,29 @@ namespace NCB {
 
         TGridParamsInfo bestGridParams;
         TVector<TCVResult> cvResult;
-        if (isSearchUsingTrainTestSplit) {
+        if (successiveHalvingParams) {
+            TuneHyperparamsSuccessiveHalving(
+                *successiveHalvingParams,
+                isSearchUsingTrainTestSplit,
+                paramNames,
+                objectiveDescriptor,
+                evalMetricDescriptor,
+                trainTestSplitParams,
+                cvParams,
+                generalQuantizeParamsInfo,
+                cpuUsedRamLimit,
+                data,
+                &gridIterator,
+                &modelParamsToBeTried,
+                &bestGridParams,
+                trainTestResult,
+                &cvResult,
+                &bestOptionValuesWithCvResult->SuccessiveHalvingRounds,
+                &localExecutor,
+                verbose,
+                randDistGenerators
+            );
+        } else if (isSearchUsingTrainTestSplit) {
             TuneHyperparamsTrainTest(
                 paramNames,
                 objectiveDescriptor,
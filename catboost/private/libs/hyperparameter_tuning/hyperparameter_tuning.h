@@ -29,6 +29,33 @@ namespace NCB {
         TEvalFuncPtr EvalFunc = nullptr;
     };
 
+    // Successive halving: all candidates are trained with a small iteration budget, the best
+    // 1 / ReductionFactor of them are retrained with ReductionFactor times bigger budget and so on.
+    // Budgets never exceed the candidate's iteration count.
+    struct TSuccessiveHalvingParams {
+        double ReductionFactor = 3.0;
+
+        // Iteration budget of the first round, round k budget is MinIterations * ReductionFactor^k.
+        // If not set, it's derived from the full iteration count so that the last round uses all iterations
+        TMaybe<ui32> MinIterations;
+
+        // Number of candidates trained concurrently, threads are split evenly between them.
+        // Concurrent candidates share quantized data read-only, they are trained silently and without
+        //   writing files.
+        ui32 ParallelCandidates = 1;
+    };
+
+    // Options map with keys "reduction_factor", "min_iterations" and "parallel_candidates"
+    TSuccessiveHalvingParams ParseSuccessiveHalvingParams(const NJson::TJsonValue& options);
+
+    struct TSuccessiveHalvingRoundResult {
+        ui32 IterationCount = 0;
+
+        // Searched params (json map) and metric values of the candidates trained in the round, best first
+        TVector<TString> CandidateParams;
+        TVector<double> MetricValues;
+    };
+
     struct TBestOptionValuesWithCvResult {
     public:
         TVector<TCVResult> CvResult;
@@ -38,6 +65,7 @@ namespace NCB {
         THashMap<TString, double> DoubleOptions;
         THashMap<TString, TString> StringOptions;
         THashMap<TString, TVector<double>> ListOfDoublesOptions;
+        TVector<TSuccessiveHalvingRoundResult> SuccessiveHalvingRounds; // filled in successive halving mode only
     public:
         void SetOptionsFromJson(
             const THashMap<TString, NJson::TJsonValue>& options,
@@ -56,7 +84,8 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit = true,
         bool returnCvStat = true,
-        int verbose = 1);
+        int verbose = 1,
+        const TMaybe<TSuccessiveHalvingParams>& successiveHalvingParams = Nothing());
 
     void RandomizedSearch(
         ui32 numberOfTries,
@@ -72,5 +101,6 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit = true,
         bool returnCvStat = true,
-        int verbose = 1);
+        int verbose = 1,
+        const TMaybe<TSuccessiveHalvingParams>& successiveHalvingParams = Nothing());
 }
@@ -24,6 +24,7 @@ void TCrossValidationParams::Check() const {
         "MaxTimeSpentOnFixedCostRatio should be within (0, 1) range, got " << MaxTimeSpentOnFixedCostRatio
         << " instead"
     );
+    CB_ENSURE(ParallelFoldCount, "ParallelFoldCount is 0");
 }
 
 
@@ -23,6 +23,13 @@ struct TCrossValidationParams : public TSplitParams {
     ECrossValidation Type = ECrossValidation::Classical;
     bool IsCalledFromSearchHyperparameters = false;
 
+    /* if > 1 folds are trained independently (not in lockstep by batches of iterations) as concurrent
+     * tasks sharing the thread pool, fold learning state is released as soon as the fold is trained
+     * so peak memory is limited by ParallelFoldCount fold contexts instead of FoldCount.
+     * Supported only on CPU and without overfitting detector.
+     */
+    ui32 ParallelFoldCount = 1;
+
 public:
     bool Initialized() const {
         return FoldCount != 0;
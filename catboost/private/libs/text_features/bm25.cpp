@@ -2,6 +2,7 @@
 
 #include <catboost/private/libs/text_features/flatbuffers/feature_calcers.fbs.h>
 
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
 using namespace NCB;
@@ -23,33 +24,31 @@ static inline double CalcTruncatedInvClassFreq(TConstArrayRef<ui32> inClassFreq,
     return Max<double>(log(numClasses - classesWithTerm + 0.5) - log(classesWithTerm + 0.5), eps);
 }
 
-static inline void ExtractTermFreq(TConstArrayRef<TDenseHash<TTokenId, ui32>> freq,
-                                   TTokenId term,
-                                   TArrayRef<ui32> termFreq) {
-    for (ui32 clazz = 0; clazz < freq.size(); ++clazz) {
-        const auto& classFreqTable = freq[clazz];
-        auto termFreqIt = classFreqTable.find(term);
-        termFreq[clazz] = termFreqIt != classFreqTable.end() ? termFreqIt->second : 0;
-    }
-}
-
 static inline double Score(double termFreq, double k, double b, double meanLength, double classLength) {
     return termFreq * (k + 1) / (termFreq + k * (1.0 - b + b * meanLength / classLength));
 }
 
-void TBM25::Compute(const TText& text, TOutputFloatIterator iterator) const {
-    TVector<ui32> termFreqInClass(NumClasses);
-    TVector<double> scores(NumClasses);
+void TBM25::CalcScores(const TText& text, TArrayRef<double> scores) const {
+    Fill(scores.begin(), scores.end(), 0.0);
+    const double meanClassLength = TotalTokens * 1.0 / NumClasses;
 
     for (const auto& tokenToCount : text) {
-        ExtractTermFreq(Frequencies, tokenToCount.Token(), termFreqInClass);
-        double inverseClassFreq = CalcTruncatedInvClassFreq(termFreqInClass, TruncateBorder);
-        double meanClassLength = TotalTokens * 1.0 / NumClasses;
+        const auto termFreqInClass = Frequencies.GetClassCounts(tokenToCount.Token());
+        if (termFreqInClass.empty()) {
+            // unseen term has zero score for all classes
+            continue;
+        }
+        const double inverseClassFreq = CalcTruncatedInvClassFreq(termFreqInClass, TruncateBorder);
 
         for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
             scores[clazz] += inverseClassFreq * Score(termFreqInClass[clazz], K, B, meanClassLength,  ClassTotalTokens[clazz]);
         }
     }
+}
+
+void TBM25::Compute(const TText& text, TOutputFloatIterator iterator) const {
+    TVector<double> scores(NumClasses);
+    CalcScores(text, scores);
 
     ForEachActiveFeature(
         [&scores, &iterator](ui32 featureId){
@@ -59,6 +58,21 @@ void TBM25::Compute(const TText& text, TOutputFloatIterator iterator) const {
     );
 }
 
+void TBM25::ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+    const ui64 textCount = texts.size();
+    TVector<double> scores(NumClasses);
+    for (ui64 textIdx : xrange(textCount)) {
+        CalcScores(texts[textIdx], scores);
+        float* textResult = result.data() + textIdx;
+        ForEachActiveFeature(
+            [&](ui32 featureId) {
+                *textResult = scores[featureId];
+                textResult += textCount;
+            }
+        );
+    }
+}
+
 TTextFeatureCalcer::TFeatureCalcerFbs TBM25::SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const {
     using namespace NCatBoostFbs;
 
@@ -97,22 +111,20 @@ void TBM25::LoadParametersFromFB(const NCatBoostFbs::TFeatureCalcer* calcer) {
 }
 
 void TBM25::SaveLargeParameters(IOutputStream* stream) const {
-    ::Save(stream, Frequencies);
+    Frequencies.Save(stream);
 }
 
 void TBM25::LoadLargeParameters(IInputStream* stream) {
-    ::Load(stream, Frequencies);
+    Frequencies.Load(stream);
 }
 
 void TBM25Visitor::Update(ui32 classId, const TText& text, TTextFeatureCalcer* calcer) {
     auto bm25 = dynamic_cast<TBM25*>(calcer);
     Y_ASSERT(bm25);
 
-    auto& classCounts = bm25->Frequencies[classId];
-
     for (const auto& tokenToCount : text) {
         const ui32 count = tokenToCount.Count();
-        classCounts[tokenToCount.Token()] += count;
+        bm25->Frequencies.Add(classId, tokenToCount.Token(), count);
         bm25->ClassTotalTokens[classId] += count;
         bm25->TotalTokens += count;
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "feature_calcer.h"
+#include "token_class_frequencies.h"
 
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <util/system/types.h>
@@ -44,6 +45,8 @@ namespace NCB {
 
         void Compute(const TText& text, TOutputFloatIterator iterator) const override;
 
+        void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const override;
+
         static ui32 BaseFeatureCount(ui32 numClasses) {
             return numClasses;
         }
@@ -56,7 +59,10 @@ namespace NCB {
 
         ui64 TotalTokens;
         TVector<ui64> ClassTotalTokens;
-        TVector<TDenseHash<TTokenId, ui32>> Frequencies;
+        TTokenClassFrequencies Frequencies;
+
+    private:
+        void CalcScores(const TText& text, TArrayRef<double> scores) const;
 
     protected:
         TTextFeatureCalcer::TFeatureCalcerFbs SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const override;
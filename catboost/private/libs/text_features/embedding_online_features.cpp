@@ -4,6 +4,8 @@
 #include <cmath>
 #include <contrib/libs/clapack/clapack.h>
 
+#include <util/generic/xrange.h>
+
 static inline void SolveLinearSystemCholesky(TArrayRef<double> matrix,
                                              TArrayRef<double> vec) {
 
@@ -43,6 +45,27 @@ inline double LogProbNormal(TConstArrayRef<float> x, TConstArrayRef<double> mu,
     return result;
 }
 
+void NCB::TEmbeddingOnlineFeatures::ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+    // bounds the embeddings buffer size
+    constexpr ui64 EmbeddingBlockSize = 1024;
+
+    const ui64 textCount = texts.size();
+    const ui64 embeddingsDim = Embedding->Dim();
+    TVector<float> embeddings;
+    embeddings.yresize(Min(textCount, EmbeddingBlockSize) * embeddingsDim);
+    for (ui64 blockStart = 0; blockStart < textCount; blockStart += EmbeddingBlockSize) {
+        const ui64 blockSize = Min(textCount - blockStart, EmbeddingBlockSize);
+        const TArrayRef<float> blockEmbeddings(embeddings.data(), blockSize * embeddingsDim);
+        Embedding->Apply(texts.subspan(blockStart, blockSize), blockEmbeddings, &NPar::LocalExecutor());
+        for (ui64 idx : xrange(blockSize)) {
+            Compute(
+                blockEmbeddings.subspan(idx * embeddingsDim, embeddingsDim),
+                TOutputFloatIterator(result.data() + blockStart + idx, textCount, result.size())
+            );
+        }
+    }
+}
+
 void NCB::TEmbeddingOnlineFeatures::Compute(
     TConstArrayRef<float> embedding,
     TOutputFloatIterator outputFeaturesIterator) const {
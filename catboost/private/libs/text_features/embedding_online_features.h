@@ -75,10 +75,14 @@ namespace NCB {
 
         void Compute(const TText& text, TOutputFloatIterator iterator) const override {
             TVector<float> embedding;
-            Embedding->Apply(text, &embedding);
+            embedding.yresize(Embedding->Dim());
+            Embedding->Apply(text, MakeArrayRef(embedding));
             return Compute(embedding, iterator);
         }
 
+        // texts are embedded by blocks into one flat buffer
+        void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const override;
+
         void SetEmbedding(TEmbeddingPtr embedding) {
             Embedding = std::move(embedding);
         }
@@ -124,9 +128,9 @@ namespace NCB {
             auto embeddingCalcer = dynamic_cast<TEmbeddingOnlineFeatures*>(calcer);
             Y_ASSERT(embeddingCalcer);
 
-            TVector<float> embedding;
-            embeddingCalcer->Embedding->Apply(text, &embedding);
-            UpdateEmbedding(classIdx, embedding, embeddingCalcer);
+            EmbeddingBuffer.yresize(embeddingCalcer->Embedding->Dim());
+            embeddingCalcer->Embedding->Apply(text, MakeArrayRef(EmbeddingBuffer));
+            UpdateEmbedding(classIdx, EmbeddingBuffer, embeddingCalcer);
         }
 
         void UpdateEmbedding(
@@ -140,5 +144,7 @@ namespace NCB {
         const ui32 Dim;
         TVector<TVector<double>> Sums;
         TVector<TVector<double>> Sums2;
+        // reused between Update calls
+        TVector<float> EmbeddingBuffer;
     };
 }
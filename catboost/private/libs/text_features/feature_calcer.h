@@ -12,6 +12,7 @@
 #include <library/cpp/object_factory/object_factory.h>
 #include <util/generic/ptr.h>
 #include <util/generic/guid.h>
+#include <util/generic/xrange.h>
 #include <util/stream/input.h>
 #include <util/system/mutex.h>
 
@@ -85,6 +86,13 @@ namespace NCB {
             return result;
         }
 
+        // result is feature-major: result[featureIdx * texts.size() + textIdx]
+        virtual void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+            for (ui64 textIdx : xrange(texts.size())) {
+                Compute(texts[textIdx], TOutputFloatIterator(result.data() + textIdx, texts.size(), result.size()));
+            }
+        }
+
         void Save(IOutputStream* stream) const final;
         void Load(IInputStream* stream) final;
 
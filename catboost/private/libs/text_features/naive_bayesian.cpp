@@ -4,6 +4,7 @@
 #include <catboost/private/libs/text_features/flatbuffers/feature_calcers.fbs.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
 using namespace NCB;
@@ -11,57 +12,73 @@ using namespace NCB;
 TTextFeatureCalcerFactory::TRegistrator<TMultinomialNaiveBayes>
     NaiveBayesRegistrator(EFeatureCalcerType::NaiveBayes);
 
-double TMultinomialNaiveBayes::LogProb(
-    const TDenseHash<TTokenId, ui32>& freqTable,
-    double classSamples,
-    double classTokensCount,
-    const TText& text) const {
-
-    Y_UNUSED(text, freqTable);
-    double value = log(classSamples + ClassPrior);
+void TMultinomialNaiveBayes::CalcClassProbs(
+    const TText& text,
+    TArrayRef<double> classTokensCount,
+    TArrayRef<double> probs) const {
 
-    classTokensCount += TokenPrior * (NumSeenTokens + SEEN_TOKENS_PRIOR);
+    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+        probs[clazz] = log(ClassDocs[clazz] + ClassPrior);
+        classTokensCount[clazz] = ClassTotalTokens[clazz] + TokenPrior * (NumSeenTokens + SEEN_TOKENS_PRIOR);
+    }
+    const double logTokenPrior = log(TokenPrior);
     double textLen = 0;
 
     for (const auto& tokenToCount : text) {
-        textLen += tokenToCount.Count();
-
-        auto tokenCountPtr = freqTable.find(tokenToCount.Token());
-        double num = TokenPrior;
-
-        if (tokenCountPtr != freqTable.end()) {
-            num += tokenCountPtr->second;
-        } else {
-            //unseen word, adjust prior
-            classTokensCount += TokenPrior;
+        const double count = tokenToCount.Count();
+        textLen += count;
+
+        const auto classCounts = Frequencies.GetClassCounts(tokenToCount.Token());
+        for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+            if (classCounts.empty() || classCounts[clazz] == 0) {
+                //unseen word, adjust prior
+                classTokensCount[clazz] += TokenPrior;
+                probs[clazz] += count * logTokenPrior;
+            } else {
+                probs[clazz] += count * log(TokenPrior + classCounts[clazz]);
+            }
         }
-        value += tokenToCount.Count() * log(num);
     }
 
     //denum
-    value -= textLen * log(classTokensCount);
-
-    return value;
+    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+        probs[clazz] -= textLen * log(classTokensCount[clazz]);
+    }
+    Softmax(probs);
 }
 
 void TMultinomialNaiveBayes::Compute(
     const TText& text,
     TOutputFloatIterator outputFeaturesIterator) const {
 
-    TVector<double> logProbs(NumClasses);
-    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
-        logProbs[clazz] = LogProb(Frequencies[clazz], ClassDocs[clazz], ClassTotalTokens[clazz], text);
-    }
-    Softmax(logProbs);
+    TVector<double> classTokensCount(NumClasses);
+    TVector<double> probs(NumClasses);
+    CalcClassProbs(text, classTokensCount, probs);
 
     ForEachActiveFeature(
-        [&logProbs, &outputFeaturesIterator](ui32 featureId) {
-            *outputFeaturesIterator = logProbs[featureId];
+        [&probs, &outputFeaturesIterator](ui32 featureId) {
+            *outputFeaturesIterator = probs[featureId];
             ++outputFeaturesIterator;
         }
     );
 }
 
+void TMultinomialNaiveBayes::ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const {
+    const ui64 textCount = texts.size();
+    TVector<double> classTokensCount(NumClasses);
+    TVector<double> probs(NumClasses);
+    for (ui64 textIdx : xrange(textCount)) {
+        CalcClassProbs(texts[textIdx], classTokensCount, probs);
+        float* textResult = result.data() + textIdx;
+        ForEachActiveFeature(
+            [&](ui32 featureId) {
+                *textResult = probs[featureId];
+                textResult += textCount;
+            }
+        );
+    }
+}
+
 TTextFeatureCalcer::TFeatureCalcerFbs TMultinomialNaiveBayes::SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const {
     using namespace NCatBoostFbs;
 
@@ -109,22 +126,20 @@ void TMultinomialNaiveBayes::LoadParametersFromFB(const NCatBoostFbs::TFeatureCa
 }
 
 void TMultinomialNaiveBayes::SaveLargeParameters(IOutputStream* stream) const {
-    ::Save(stream, Frequencies);
+    Frequencies.Save(stream);
 }
 
 void TMultinomialNaiveBayes::LoadLargeParameters(IInputStream* stream) {
-    ::Load(stream, Frequencies);
+    Frequencies.Load(stream);
 }
 
 void TNaiveBayesVisitor::Update(ui32 classId, const TText& text, TTextFeatureCalcer* calcer) {
     auto naiveBayes = dynamic_cast<TMultinomialNaiveBayes*>(calcer);
     Y_ASSERT(naiveBayes);
 
-    auto& classCounts = naiveBayes->Frequencies[classId];
-
     for (const auto& tokenToCount : text) {
         SeenTokens.Insert(tokenToCount.Token());
-        classCounts[tokenToCount.Token()] += tokenToCount.Count();
+        naiveBayes->Frequencies.Add(classId, tokenToCount.Token(), tokenToCount.Count());
         naiveBayes->ClassTotalTokens[classId] += tokenToCount.Count();
     }
     naiveBayes->ClassDocs[classId] += 1;
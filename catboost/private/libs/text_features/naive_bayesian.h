@@ -1,6 +1,7 @@
 #pragma once
 
 #include "feature_calcer.h"
+#include "token_class_frequencies.h"
 
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <util/system/types.h>
@@ -35,6 +36,8 @@ namespace NCB {
 
         void Compute(const TText& text, TOutputFloatIterator iterator) const override;
 
+        void ComputeBlock(TConstArrayRef<TText> texts, TArrayRef<float> result) const override;
+
         static ui32 BaseFeatureCount(ui32 numClasses) {
             return numClasses > 2 ? numClasses : 1;
         }
@@ -48,11 +51,11 @@ namespace NCB {
         }
 
     private:
-        double LogProb(
-            const TDenseHash<TTokenId, ui32>& freqTable,
-            double classSamples,
-            double classTokensCount,
-            const TText& text
+        // classTokensCount is a buffer of size NumClasses
+        void CalcClassProbs(
+            const TText& text,
+            TArrayRef<double> classTokensCount,
+            TArrayRef<double> probs
         ) const;
 
     protected:
@@ -70,7 +73,7 @@ namespace NCB {
         ui64 NumSeenTokens;
         TVector<ui32> ClassDocs;
         TVector<ui64> ClassTotalTokens;
-        TVector<TDenseHash<TTokenId, ui32>> Frequencies;
+        TTokenClassFrequencies Frequencies;
 
         friend class TNaiveBayesVisitor;
     };
@@ -12,20 +12,15 @@
 #include <cstring>
 
 namespace NCB {
-    static void CalcFeatures(
+    static void ApplyDictionary(
         const TVector<TTokensWithBuffer>& tokens,
         const TDictionaryProxy& dictionary,
-        const TTextFeatureCalcer& calcer,
-        TArrayRef<float> result
+        TVector<TText>* texts
     ) {
         const ui64 docCount = tokens.size();
+        texts->resize(docCount);
         for (ui32 docId: xrange(docCount)) {
-            TText text = dictionary.Apply(tokens[docId].View);
-
-            calcer.Compute(
-                text,
-                TOutputFloatIterator(result.data() + docId, docCount, result.size())
-            );
+            dictionary.Apply(tokens[docId].View, &(*texts)[docId]);
         }
     }
 
@@ -54,6 +49,7 @@ namespace NCB {
         TVector<TTokensWithBuffer> tokens;
         tokens.yresize(docCount);
         TTokenizerPtr previousTokenizer;
+        TVector<TText> texts;
 
         for (ui32 digitizerId: PerFeatureDigitizers[textFeatureIdx]) {
             const auto& dictionary = Digitizers[digitizerId].Dictionary;
@@ -63,6 +59,7 @@ namespace NCB {
                 TokenizeTextFeature(textFeature, docCount, Digitizers[digitizerId].Tokenizer, &tokens);
                 previousTokenizer = Digitizers[digitizerId].Tokenizer;
             }
+            ApplyDictionary(tokens, *dictionary, &texts);
 
             for (ui32 calcerId: PerTokenizedFeatureCalcers[tokenizedFeatureIdx]) {
                 const auto& calcer = FeatureCalcers[calcerId];
@@ -74,7 +71,7 @@ namespace NCB {
                     result.data() + calcerOffset,
                     result.data() + calcerOffset + calculatedFeaturesSize
                 );
-                NCB::CalcFeatures(tokens, *dictionary, *calcer, currentResult);
+                calcer->ComputeBlock(texts, currentResult);
             }
         }
     }
@@ -512,4 +509,26 @@ namespace NCB {
         return evaluatedFeatures;
     }
 
+    void TTextProcessingCollection::ReplaceSharedParts(
+        const std::function<TDictionaryPtr(const TDictionaryPtr&)>& getDictionary,
+        const std::function<TTextFeatureCalcerPtr(const TTextFeatureCalcerPtr&)>& getCalcer
+    ) {
+        for (auto& digitizer : Digitizers) {
+            TDictionaryPtr dictionary = getDictionary(digitizer.Dictionary);
+            CB_ENSURE_INTERNAL(
+                dictionary->Id() == digitizer.Dictionary->Id(),
+                "Dictionary can be replaced only by dictionary with the same id"
+            );
+            digitizer.Dictionary = std::move(dictionary);
+        }
+        for (auto& calcer : FeatureCalcers) {
+            TTextFeatureCalcerPtr sharedCalcer = getCalcer(calcer);
+            CB_ENSURE_INTERNAL(
+                sharedCalcer->Id() == calcer->Id(),
+                "Feature calcer can be replaced only by calcer with the same id"
+            );
+            calcer = std::move(sharedCalcer);
+        }
+    }
+
 } // NCB
@@ -9,6 +9,8 @@
 #include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 
+#include <functional>
+
 namespace NCB {
     struct TEvaluatedFeature {
     public:
@@ -103,11 +105,23 @@ namespace NCB {
             return FeatureCalcers[calcerId];
         }
 
+        TDictionaryPtr GetDictionary(ui32 digitizerId) const {
+            return Digitizers[digitizerId].Dictionary;
+        }
+
         ui32 NumberOfOutputFeatures(ui32 textFeatureId) const;
         ui32 TotalNumberOfOutputFeatures() const;
 
         TVector<TEvaluatedFeature> GetProducedFeatures() const;
 
+        /* Replaces dictionaries and calcers with the ones returned by the callbacks that must have the same Id,
+         * used to share equal parts between collections (e.g. of different models)
+         */
+        void ReplaceSharedParts(
+            const std::function<TDictionaryPtr(const TDictionaryPtr&)>& getDictionary,
+            const std::function<TTextFeatureCalcerPtr(const TTextFeatureCalcerPtr&)>& getCalcer
+        );
+
         void Save(IOutputStream* s) const;
         void Load(IInputStream* s);
 
@@ -0,0 +1,33 @@
+#include "token_class_frequencies.h"
+
+#include <util/generic/xrange.h>
+#include <util/ysaveload.h>
+
+using namespace NCB;
+
+void TTokenClassFrequencies::Save(IOutputStream* stream) const {
+    TVector<TDenseHash<TTokenId, ui32>> classFrequencies(NumClasses);
+    for (const auto& [token, row] : TokenToRow) {
+        for (auto classId : xrange(NumClasses)) {
+            const ui32 count = Counts[(size_t)row * NumClasses + classId];
+            if (count) {
+                classFrequencies[classId][token] = count;
+            }
+        }
+    }
+    ::Save(stream, classFrequencies);
+}
+
+void TTokenClassFrequencies::Load(IInputStream* stream) {
+    TVector<TDenseHash<TTokenId, ui32>> classFrequencies;
+    ::Load(stream, classFrequencies);
+
+    NumClasses = classFrequencies.size();
+    TokenToRow = TDenseHash<TTokenId, ui32>();
+    Counts.clear();
+    for (auto classId : xrange(NumClasses)) {
+        for (const auto& [token, count] : classFrequencies[classId]) {
+            Add(classId, token, count);
+        }
+    }
+}
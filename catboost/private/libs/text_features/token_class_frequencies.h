@@ -0,0 +1,54 @@
+#pragma once
+
+#include <catboost/private/libs/data_types/text.h>
+
+#include <library/cpp/containers/dense_hash/dense_hash.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+namespace NCB {
+
+    /*
+     * Token-major token counts per class: one hash probe per token gives counts for all classes.
+     * Serialized as class-major TVector<TDenseHash<TTokenId, ui32>> for compatibility with saved models.
+     */
+    class TTokenClassFrequencies {
+    public:
+        explicit TTokenClassFrequencies(ui32 numClasses = 0)
+            : NumClasses(numClasses)
+        {}
+
+        ui32 GetNumClasses() const {
+            return NumClasses;
+        }
+
+        // empty if token was not seen in any class
+        TConstArrayRef<ui32> GetClassCounts(TTokenId token) const {
+            const ui32* row = TokenToRow.FindPtr(token);
+            if (!row) {
+                return {};
+            }
+            return MakeArrayRef(Counts.data() + (size_t)*row * NumClasses, NumClasses);
+        }
+
+        void Add(ui32 classId, TTokenId token, ui32 count) {
+            Y_ASSERT(classId < NumClasses);
+            const auto [rowIt, isNewToken] = TokenToRow.insert({token, (ui32)TokenToRow.Size()});
+            if (isNewToken) {
+                Counts.resize(Counts.size() + NumClasses, 0);
+            }
+            Counts[(size_t)rowIt->second * NumClasses + classId] += count;
+        }
+
+        void Save(IOutputStream* stream) const;
+        void Load(IInputStream* stream);
+
+    private:
+        ui32 NumClasses;
+        TDenseHash<TTokenId, ui32> TokenToRow;
+        TVector<ui32> Counts; // [row * NumClasses + classId]
+    };
+}
@@ -5,6 +5,7 @@
 
 #include <library/cpp/testing/unittest/registar.h>
 #include <util/generic/ylimits.h>
+#include <util/stream/str.h>
 
 using namespace NCB;
 
@@ -241,4 +242,96 @@ Y_UNIT_TEST_SUITE(TestFeatureCalcer) {
             );
         }
     }
+
+    template <class TCalcer, class TVisitor>
+    static void CheckComputeBlock(const TVector<TText>& texts, ui32 numClasses) {
+        TCalcer calcer(CreateGuid(), numClasses);
+        TVisitor visitor;
+        for (ui32 docId : xrange(texts.size())) {
+            visitor.Update(docId % numClasses, texts[docId], &calcer);
+        }
+
+        const ui32 featureCount = calcer.FeatureCount();
+        TVector<float> features(texts.size() * featureCount);
+        calcer.ComputeBlock(texts, features);
+
+        TStringStream stream;
+        calcer.Save(&stream);
+        TCalcer loadedCalcer;
+        loadedCalcer.Load(&stream);
+        TVector<float> loadedFeatures(texts.size() * featureCount);
+        loadedCalcer.ComputeBlock(texts, loadedFeatures);
+
+        for (ui32 docId : xrange(texts.size())) {
+            TVector<float> docFeatures = calcer.TTextFeatureCalcer::Compute(texts[docId]);
+            for (ui32 featureIdx : xrange(featureCount)) {
+                UNIT_ASSERT_EQUAL(docFeatures[featureIdx], features[featureIdx * texts.size() + docId]);
+                UNIT_ASSERT_EQUAL(docFeatures[featureIdx], loadedFeatures[featureIdx * texts.size() + docId]);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestComputeBlock) {
+        const ui32 dictionarySize = 50;
+        const ui32 numSamples = 200;
+        const ui32 numTokensPerText = 7;
+
+        TVector<TText> texts;
+        for (ui32 docId : xrange(numSamples)) {
+            TVector<ui32> tokenIds;
+            for (ui32 idx : xrange(numTokensPerText)) {
+                // ids >= dictionarySize are seen only in some classes
+                tokenIds.push_back((docId * 7 + idx * idx) % (dictionarySize + idx));
+            }
+            texts.emplace_back(std::move(tokenIds));
+        }
+
+        for (ui32 numClasses : {2, 3, 10}) {
+            CheckComputeBlock<TMultinomialNaiveBayes, TNaiveBayesVisitor>(texts, numClasses);
+            CheckComputeBlock<TBM25, TBM25Visitor>(texts, numClasses);
+        }
+    }
+
+    Y_UNIT_TEST(TestEmbeddingComputeBlock) {
+        const ui32 dictionarySize = 10;
+        // several embedding blocks
+        const ui32 numSamples = 2100;
+        const ui32 numTokensPerText = 4;
+
+        TVector<TText> texts;
+        for (ui32 docId : xrange(numSamples)) {
+            TVector<ui32> tokenIds;
+            for (ui32 idx : xrange(numTokensPerText)) {
+                tokenIds.push_back((docId * 7 + idx * idx) % dictionarySize);
+            }
+            texts.emplace_back(std::move(tokenIds));
+        }
+
+        const ui32 embeddingDim = dictionarySize;
+        TVector<ui32> tokenToRow(dictionarySize);
+        Iota(tokenToRow.begin(), tokenToRow.end(), 0);
+        TVector<float> rows(dictionarySize * embeddingDim);
+        for (ui32 tokenId : xrange(dictionarySize)) {
+            rows[tokenId * embeddingDim + tokenId] = 1.0f;
+        }
+        TEmbeddingPtr embedding = CreateEmbedding(embeddingDim, std::move(tokenToRow), std::move(rows));
+
+        for (ui32 numClasses : {2, 3}) {
+            TEmbeddingOnlineFeatures calcer(CreateGuid(), numClasses, embedding);
+            TEmbeddingFeaturesVisitor visitor(numClasses, embeddingDim);
+            for (ui32 docId : xrange(numSamples)) {
+                visitor.Update(docId % numClasses, texts[docId], &calcer);
+            }
+
+            const ui32 featureCount = calcer.FeatureCount();
+            TVector<float> features(texts.size() * featureCount);
+            calcer.ComputeBlock(texts, features);
+            for (ui32 docId : xrange(texts.size())) {
+                TVector<float> docFeatures = calcer.TTextFeatureCalcer::Compute(texts[docId]);
+                for (ui32 featureIdx : xrange(featureCount)) {
+                    UNIT_ASSERT_EQUAL(docFeatures[featureIdx], features[featureIdx * texts.size() + docId]);
+                }
+            }
+        }
+    }
 }
@@ -1,57 +1,113 @@
 #include "embedding.h"
 
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/xrange.h>
+
 using namespace NCB;
 
+void IEmbedding::Apply(const TText& text, TVector<float>* dst) const {
+    dst->yresize(Dim());
+    Apply(text, MakeArrayRef(*dst));
+}
+
 class TEmbedding final : public IEmbedding {
 public:
-    explicit TEmbedding(TDenseHash<TTokenId, TVector<float>>&& embedding)
-    : Embedding(std::move(embedding)) {
+    TEmbedding(ui32 dim, TVector<ui32>&& tokenToRow, TVector<float>&& rows)
+    : EmbeddingDim(dim)
+    , TokenToRow(std::move(tokenToRow))
+    , OwnedRows(std::move(rows))
+    , Rows(OwnedRows) {
+        CheckRows();
+    }
 
+    TEmbedding(ui32 dim, TVector<ui32>&& tokenToRow, TBlob rows)
+    : EmbeddingDim(dim)
+    , TokenToRow(std::move(tokenToRow))
+    , RowsBlob(std::move(rows))
+    , Rows((const float*)RowsBlob.Data(), RowsBlob.Size() / sizeof(float)) {
+        CB_ENSURE(RowsBlob.Size() % sizeof(float) == 0, "Embedding rows size is not a multiple of float size");
+        CheckRows();
     }
 
     ui64 Dim() const override {
-        return Embedding.begin()->second.size();
+        return EmbeddingDim;
     }
 
+    using IEmbedding::Apply;
 
-    void Apply(const TTextDataSet& ds, TVector<TVector<float>>* dst, NPar::TLocalExecutor* executor) const override {
-        dst->resize(ds.SamplesCount());
-        auto texts = ds.GetTexts();
+    void Apply(TConstArrayRef<TText> texts, TArrayRef<float> dst, NPar::TLocalExecutor* executor) const override {
+        CB_ENSURE_INTERNAL(dst.size() == texts.size() * EmbeddingDim, "Wrong embeddings buffer size");
         NPar::ParallelFor(*executor, 0, static_cast<ui32>(texts.size()), [&](ui32 idx) {
-            Apply(texts[idx], &(*dst)[idx]);
+            Apply(texts[idx], dst.subspan((size_t)idx * EmbeddingDim, EmbeddingDim));
         });
     }
 
-
-    void Apply(const TText& text, TVector<float>* dst) const {
-        dst->clear();
-        dst->resize(Dim());
-        auto& result = *dst;
+    void Apply(const TText& text, TArrayRef<float> dst) const override {
+        Y_ASSERT(dst.size() == EmbeddingDim);
+        Fill(dst.begin(), dst.end(), 0.0f);
         double count = 0.5;
         for (const auto& tokenToCount : text) {
-            auto embedding = Embedding.find(tokenToCount.Token());
-            if (embedding != Embedding.end()) {
-                AddVector(embedding->second, result);
+            const ui32 token = tokenToCount.Token();
+            if (token < TokenToRow.size() && TokenToRow[token] != TTokenId::ILLEGAL_TOKEN_ID) {
+                AddVector(Rows.data() + (size_t)TokenToRow[token] * EmbeddingDim, dst.data());
                 ++count;
             }
         }
-        for (ui64 i = 0; i < result.size(); ++i) {
-            result[i] /= count;
+        for (ui64 i = 0; i < dst.size(); ++i) {
+            dst[i] /= count;
         }
     }
 private:
 
-    void AddVector(TConstArrayRef<float> what, TArrayRef<float> to) const {
-        for (ui32 i = 0; i < to.size(); ++i) {
+    void AddVector(const float* __restrict what, float* __restrict to) const {
+        for (ui32 i = 0; i < EmbeddingDim; ++i) {
             to[i] += what[i];
         }
     }
-private:
-    TDenseHash<TTokenId, TVector<float>> Embedding;
 
+    void CheckRows() const {
+        CB_ENSURE(EmbeddingDim > 0, "Embedding dimension should be positive");
+        CB_ENSURE(Rows.size() % EmbeddingDim == 0, "Embedding rows size is not a multiple of embedding dimension");
+        const size_t rowCount = Rows.size() / EmbeddingDim;
+        for (ui32 row : TokenToRow) {
+            CB_ENSURE(row == TTokenId::ILLEGAL_TOKEN_ID || row < rowCount, "Embedding row index is out of range");
+        }
+    }
+private:
+    ui32 EmbeddingDim;
+    TVector<ui32> TokenToRow;
 
+    TVector<float> OwnedRows;
+    TBlob RowsBlob;
+    TConstArrayRef<float> Rows;
 };
 
 TEmbeddingPtr NCB::CreateEmbedding(TDenseHash<TTokenId, TVector<float>>&& hash) {
-    return new TEmbedding(std::move(hash));
+    CB_ENSURE(hash.begin() != hash.end(), "Embedding should not be empty");
+    const ui32 dim = hash.begin()->second.size();
+    ui32 maxTokenId = 0;
+    size_t rowCount = 0;
+    for (const auto& [tokenId, vector] : hash) {
+        CB_ENSURE(vector.size() == dim, "Embedding size should be equal for all tokens");
+        maxTokenId = Max<ui32>(maxTokenId, tokenId);
+        ++rowCount;
+    }
+    TVector<ui32> tokenToRow(maxTokenId + 1, TTokenId::ILLEGAL_TOKEN_ID);
+    TVector<float> rows;
+    rows.reserve(rowCount * dim);
+    for (const auto& [tokenId, vector] : hash) {
+        tokenToRow[tokenId] = rows.size() / dim;
+        rows.insert(rows.end(), vector.begin(), vector.end());
+    }
+    hash.Clear();
+    return CreateEmbedding(dim, std::move(tokenToRow), std::move(rows));
+}
+
+TEmbeddingPtr NCB::CreateEmbedding(ui32 dim, TVector<ui32>&& tokenToRow, TVector<float>&& rows) {
+    return new TEmbedding(dim, std::move(tokenToRow), std::move(rows));
+}
+
+TEmbeddingPtr NCB::CreateEmbedding(ui32 dim, TVector<ui32>&& tokenToRow, TBlob rows) {
+    return new TEmbedding(dim, std::move(tokenToRow), std::move(rows));
 }
@@ -5,8 +5,10 @@
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <library/cpp/threading/local_executor/local_executor.h>
 
-#include <util/system/types.h>
+#include <util/generic/array_ref.h>
 #include <util/generic/ptr.h>
+#include <util/memory/blob.h>
+#include <util/system/types.h>
 
 
 namespace NCB {
@@ -17,15 +19,25 @@ namespace NCB {
 
         virtual ui64 Dim() const = 0;
 
-        virtual void Apply(const TTextDataSet& ds, TVector<TVector<float>>* dst, NPar::TLocalExecutor* executor) const = 0;
+        // dst is row-major, texts.size() x Dim()
+        virtual void Apply(TConstArrayRef<TText> texts, TArrayRef<float> dst, NPar::TLocalExecutor* executor) const = 0;
+
+        // dst.size() == Dim()
+        virtual void Apply(const TText& text, TArrayRef<float> dst) const = 0;
 
-        virtual void Apply(const TText& text, TVector<float>* dst) const = 0;
+        void Apply(const TText& text, TVector<float>* dst) const;
     };
 
     using TEmbeddingPtr = TIntrusivePtr<IEmbedding>;
 
 
     TEmbeddingPtr CreateEmbedding(TDenseHash<TTokenId, TVector<float>>&& hash);
-}
 
+    /* Embedding vectors are stored as one row-major matrix, tokenToRow[tokenId] is the row of the token
+     * or TTokenId::ILLEGAL_TOKEN_ID if token has no embedding
+     */
+    TEmbeddingPtr CreateEmbedding(ui32 dim, TVector<ui32>&& tokenToRow, TVector<float>&& rows);
 
+    // rows can be mapped from file, e.g. TBlob::FromFile of raw float32 matrix
+    TEmbeddingPtr CreateEmbedding(ui32 dim, TVector<ui32>&& tokenToRow, TBlob rows);
+}
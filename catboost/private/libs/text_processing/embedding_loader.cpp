@@ -3,24 +3,19 @@
 #include <catboost/private/libs/data_util/line_data_reader.h>
 
 #include <util/generic/string.h>
+#include <util/memory/blob.h>
 #include <util/string/split.h>
 #include <util/stream/file.h>
 
 namespace NCB {
 
-    inline TVector<float> ConvertToFloat(TConstArrayRef<TString> words) {
-        TVector<float> result(words.size());
-        for (ui32 i = 0; i < result.size(); ++i) {
-            result[i] = FromString<float>(words[i]);
-        }
-        return result;
-    }
-
     TEmbeddingPtr LoadEmbedding(const TString& path,
                                 const TDictionaryProxy& dictionary) {
         const auto delim = '\t';
 
-        TDenseHash<TTokenId, TVector<float>> embeddings;
+        // rows are appended to one contiguous matrix
+        TVector<ui32> tokenToRow(dictionary.Size(), TTokenId::ILLEGAL_TOKEN_ID);
+        TVector<float> rows;
         const ui32 unknownToken = dictionary.GetUnknownTokenId();
 
         ui32 embeddingDim = 0;
@@ -29,22 +24,67 @@ namespace NCB {
         TString line;
         ui32 lineIdx = 0;
         for (lineIdx = 0; in.ReadLine(line); ++lineIdx) {
-            TVector<TString> vals;
-            StringSplitter(line).Split(delim).Collect(&vals);
-            const auto key = vals[0];
-            const auto wordEmbedding = MakeConstArrayRef(vals).Slice(1);
+            TStringBuf lineBuf(line);
+            const TStringBuf key = lineBuf.NextTok(delim);
+
+            const ui32 tokenId = dictionary.Apply(key);
+            if (tokenId != unknownToken) {
+                if (tokenId >= tokenToRow.size()) {
+                    tokenToRow.resize(tokenId + 1, TTokenId::ILLEGAL_TOKEN_ID);
+                }
+                const bool isNewToken = tokenToRow[tokenId] == TTokenId::ILLEGAL_TOKEN_ID;
+                const size_t rowBegin = isNewToken ? rows.size() : (size_t)tokenToRow[tokenId] * embeddingDim;
+                ui32 wordEmbeddingDim = 0;
+                for (const auto& value : StringSplitter(lineBuf).Split(delim)) {
+                    const float floatValue = FromString<float>(value.Token());
+                    if (isNewToken) {
+                        rows.push_back(floatValue);
+                    } else {
+                        CB_ENSURE(wordEmbeddingDim < embeddingDim, "Error: embedding size should be equal for all words. Line #" << lineIdx);
+                        rows[rowBegin + wordEmbeddingDim] = floatValue;
+                    }
+                    ++wordEmbeddingDim;
+                }
+                CB_ENSURE(wordEmbeddingDim > 0, "Error: empty embedding. Line #" << lineIdx);
+                CB_ENSURE(embeddingDim == 0 || embeddingDim == wordEmbeddingDim,
+                    "Error: embedding size should be equal for all words. Line #" << lineIdx << ": " << embeddingDim << " ≠ " << wordEmbeddingDim);
+                embeddingDim = wordEmbeddingDim;
+                if (isNewToken) {
+                    tokenToRow[tokenId] = rowBegin / embeddingDim;
+                }
+            }
+        }
+
+        rows.shrink_to_fit();
+        return CreateEmbedding(embeddingDim, std::move(tokenToRow), std::move(rows));
+    }
 
-            auto tokenId = dictionary.Apply(key);
+    TEmbeddingPtr LoadMappedEmbedding(const TString& tokensPath,
+                                      const TString& rowsPath,
+                                      const TDictionaryProxy& dictionary) {
+        TVector<ui32> tokenToRow(dictionary.Size(), TTokenId::ILLEGAL_TOKEN_ID);
+        const ui32 unknownToken = dictionary.GetUnknownTokenId();
+
+        TIFStream in(tokensPath);
+        TString line;
+        ui32 rowCount = 0;
+        for (rowCount = 0; in.ReadLine(line); ++rowCount) {
+            const ui32 tokenId = dictionary.Apply(line);
             if (tokenId != unknownToken) {
-                auto floatEmbedding = ConvertToFloat(wordEmbedding);
-                CB_ENSURE(embeddingDim == 0 || embeddingDim == floatEmbedding.size(),
-                    "Error: embedding size should be equal for all words. Line #" << lineIdx << ": " << embeddingDim << " ≠ " << floatEmbedding.size());
-                embeddingDim = floatEmbedding.size();
-                embeddings[TTokenId(tokenId)] = std::move(floatEmbedding);
+                if (tokenId >= tokenToRow.size()) {
+                    tokenToRow.resize(tokenId + 1, TTokenId::ILLEGAL_TOKEN_ID);
+                }
+                tokenToRow[tokenId] = rowCount;
             }
         }
-        Cout << embeddingDim << " " << lineIdx << Endl;
+        CB_ENSURE(rowCount > 0, "Error: empty embedding tokens file " << tokensPath);
 
-        return CreateEmbedding(std::move(embeddings));
+        // rows of tokens unknown to the dictionary are mapped too but never read
+        TBlob rows = TBlob::FromFile(rowsPath);
+        const size_t rowCountSize = (size_t)rowCount * sizeof(float);
+        CB_ENSURE(rows.Size() > 0 && rows.Size() % rowCountSize == 0,
+            "Error: size of " << rowsPath << " should be a multiple of " << rowCount << " float32 rows");
+        const ui32 embeddingDim = rows.Size() / rowCountSize;
+        return CreateEmbedding(embeddingDim, std::move(tokenToRow), std::move(rows));
     }
 }
@@ -7,4 +7,13 @@ namespace NCB {
 
     TEmbeddingPtr LoadEmbedding(const TString& path, const TDictionaryProxy& dictionary);
 
+    /* tokensPath has one token per line, rowsPath is a raw row-major float32 matrix with one row per token,
+     * the matrix is mapped to memory instead of being parsed
+     */
+    TEmbeddingPtr LoadMappedEmbedding(
+        const TString& tokensPath,
+        const TString& rowsPath,
+        const TDictionaryProxy& dictionary
+    );
+
 }
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "dictionary.h"
-#include "text_column_builder.h"
+#include "tokenizer.h"
 
 #include <catboost/libs/helpers/guid.h>
 
 #include <util/generic/map.h>
 #include <util/generic/set.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/str_stl.h>
 
 namespace NCB {
@@ -73,23 +74,42 @@ namespace NCB {
             TDigitizedTextWriter&& digitizedTextWriter,
             NPar::TLocalExecutor* localExecutor
         ) const {
-            TVector<std::pair<ui32, ui32>> sourceToDestinationPairs;
+            // per worker thread buffers, caller thread has id 0
+            TVector<TTokensWithBuffer> tokensBuffers(localExecutor->GetThreadCount() + 1);
+
             for (const auto& [sourceTextIdx, digitizedSetIndices]: SourceToDestinationIndexes) {
                 const auto sourceText = sourceTextAccessor(sourceTextIdx);
 
+                // each text is tokenized once for all dictionaries sharing a tokenizer
+                TMap<TGuid, TVector<ui32>> tokenizerToDigitizedTextIndices;
                 for (ui32 digitizedTextIdx: digitizedSetIndices) {
-                    const auto& dictionary = Digitizers.at(digitizedTextIdx).Dictionary;
                     const auto& tokenizer = Digitizers.at(digitizedTextIdx).Tokenizer;
+                    tokenizerToDigitizedTextIndices[tokenizer->Id()].push_back(digitizedTextIdx);
+                }
+
+                for (const auto& [tokenizerId, digitizedTextIndices]: tokenizerToDigitizedTextIndices) {
+                    const auto& tokenizer = Digitizers.at(digitizedTextIndices[0]).Tokenizer;
+                    TVector<TDictionaryPtr> dictionaries;
+                    TVector<TVector<TText>> digitizedTexts;
+                    for (ui32 digitizedTextIdx: digitizedTextIndices) {
+                        dictionaries.push_back(Digitizers.at(digitizedTextIdx).Dictionary);
+                        digitizedTexts.emplace_back(sourceText.Size());
+                    }
 
-                    TTextColumnBuilder textColumnBuilder(tokenizer, dictionary, sourceText.Size());
                     sourceText.ForEach(
                         [&](ui32 index, TStringBuf phrase) {
-                            textColumnBuilder.AddText(index, phrase);
+                            auto& tokens = tokensBuffers[localExecutor->GetWorkerThreadId()];
+                            tokenizer->Tokenize(phrase, &tokens);
+                            for (auto i: xrange(dictionaries.size())) {
+                                dictionaries[i]->Apply(tokens.View, &digitizedTexts[i][index]);
+                            }
                         },
                         localExecutor
                     );
 
-                    digitizedTextWriter(digitizedTextIdx, textColumnBuilder.Build());
+                    for (auto i: xrange(digitizedTextIndices.size())) {
+                        digitizedTextWriter(digitizedTextIndices[i], std::move(digitizedTexts[i]));
+                    }
                 }
             }
         }
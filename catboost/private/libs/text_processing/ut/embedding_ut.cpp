@@ -0,0 +1,50 @@
+#include <catboost/private/libs/text_processing/embedding.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+Y_UNIT_TEST_SUITE(TestEmbedding) {
+    Y_UNIT_TEST(TestApply) {
+        const ui32 dim = 3;
+        TDenseHash<TTokenId, TVector<float>> hash;
+        hash[TTokenId(0)] = {1.0f, 2.0f, 3.0f};
+        hash[TTokenId(5)] = {-1.0f, 0.0f, 0.5f};
+        auto embedding = CreateEmbedding(std::move(hash));
+        UNIT_ASSERT_VALUES_EQUAL(embedding->Dim(), dim);
+
+        // token 3 has no embedding, token 7 is out of token range
+        const TVector<TText> texts = {
+            TText(TVector<ui32>{0, 5}),
+            TText(TVector<ui32>{3, 7}),
+            TText(TVector<ui32>{5})
+        };
+        const TVector<TVector<float>> expected = {
+            {0.0f / 2.5f, 2.0f / 2.5f, 3.5f / 2.5f},
+            {0.0f, 0.0f, 0.0f},
+            {-1.0f / 1.5f, 0.0f, 0.5f / 1.5f}
+        };
+
+        TVector<float> result;
+        for (auto i : xrange(texts.size())) {
+            embedding->Apply(texts[i], &result);
+            UNIT_ASSERT_VALUES_EQUAL(result.size(), dim);
+            for (auto j : xrange(dim)) {
+                UNIT_ASSERT_DOUBLES_EQUAL(result[j], expected[i][j], 1e-6);
+            }
+        }
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(2);
+        TVector<float> flatResult(texts.size() * dim);
+        embedding->Apply(texts, flatResult, &executor);
+        for (auto i : xrange(texts.size())) {
+            for (auto j : xrange(dim)) {
+                UNIT_ASSERT_DOUBLES_EQUAL(flatResult[i * dim + j], expected[i][j], 1e-6);
+            }
+        }
+    }
+}
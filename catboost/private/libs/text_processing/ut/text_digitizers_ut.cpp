@@ -0,0 +1,82 @@
+#include <catboost/private/libs/options/text_processing_options.h>
+#include <catboost/private/libs/text_processing/text_column_builder.h>
+#include <catboost/private/libs/text_processing/text_digitizers.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+Y_UNIT_TEST_SUITE(TestTextDigitizers) {
+    Y_UNIT_TEST(TestApplyMatchesColumnBuilder) {
+        const TVector<TVector<TString>> texts = {
+            {"hi", "ha ha", "Ho ho HO", "hi ha ho 12", "", "ha  hi 12 hi"},
+            {"a b", "B a c", "c c", "", "a 1 b 2", "b"}
+        };
+
+        NTextProcessing::NTokenizer::TTokenizerOptions lowercasingOptions;
+        lowercasingOptions.Lowercasing = true;
+        NTextProcessing::NTokenizer::TTokenizerOptions skipNumbersOptions;
+        skipNumbersOptions.NumberProcessPolicy = NTextProcessing::NTokenizer::ETokenProcessPolicy::Skip;
+        // tokenizer modifying tokens and tokenizer returning views into the source text
+        const TVector<TTokenizerPtr> tokenizers = {
+            CreateTokenizer(lowercasingOptions),
+            CreateTokenizer(skipNumbersOptions)
+        };
+
+        NCatboostOptions::TTextColumnDictionaryOptions unigramOptions;
+        NTextProcessing::NDictionary::TDictionaryBuilderOptions builderOptions;
+        builderOptions.OccurrenceLowerBound = 1;
+        unigramOptions.DictionaryBuilderOptions.Set(builderOptions);
+        NCatboostOptions::TTextColumnDictionaryOptions bigramOptions = unigramOptions;
+        NTextProcessing::NDictionary::TDictionaryOptions bigramDictionaryOptions;
+        bigramDictionaryOptions.GramOrder = 2;
+        bigramOptions.DictionaryOptions.Set(bigramDictionaryOptions);
+
+        // several dictionaries share a tokenizer, so texts are tokenized once for them
+        TTextDigitizers digitizers;
+        TVector<std::pair<ui32, TDigitizer>> sourceAndDigitizers;
+        for (ui32 sourceTextIdx : xrange(texts.size())) {
+            for (const auto& tokenizer : tokenizers) {
+                for (const auto& dictionaryOptions : {unigramOptions, bigramOptions}) {
+                    TDigitizer digitizer{
+                        tokenizer,
+                        CreateDictionary(TIterableTextFeature(texts[sourceTextIdx]), dictionaryOptions, tokenizer)
+                    };
+                    digitizers.AddDigitizer(sourceTextIdx, sourceAndDigitizers.size(), digitizer);
+                    sourceAndDigitizers.emplace_back(sourceTextIdx, std::move(digitizer));
+                }
+            }
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TVector<TVector<TText>> digitizedTexts(sourceAndDigitizers.size());
+        digitizers.Apply(
+            [&](ui32 sourceTextIdx) {
+                return TIterableTextFeature(texts[sourceTextIdx]);
+            },
+            [&](ui32 digitizedTextIdx, TVector<TText>&& digitizedText) {
+                digitizedTexts[digitizedTextIdx] = std::move(digitizedText);
+            },
+            &localExecutor
+        );
+
+        for (auto digitizedTextIdx : xrange(sourceAndDigitizers.size())) {
+            const auto& [sourceTextIdx, digitizer] = sourceAndDigitizers[digitizedTextIdx];
+            const auto& sourceText = texts[sourceTextIdx];
+            TTextColumnBuilder textColumnBuilder(digitizer.Tokenizer, digitizer.Dictionary, sourceText.size());
+            for (auto i : xrange(sourceText.size())) {
+                textColumnBuilder.AddText(i, sourceText[i]);
+            }
+            const auto expectedTexts = textColumnBuilder.Build();
+            UNIT_ASSERT_VALUES_EQUAL(digitizedTexts[digitizedTextIdx].size(), expectedTexts.size());
+            for (auto i : xrange(expectedTexts.size())) {
+                UNIT_ASSERT_EQUAL(digitizedTexts[digitizedTextIdx][i], expectedTexts[i]);
+            }
+        }
+    }
+}
@@ -1285,6 +1285,7 @@ cdef extern from "catboost/private/libs/options/cross_validation_params.h":
         double MaxTimeSpentOnFixedCostRatio
         ui32 DevMaxIterationsBatchSize
         bool_t IsCalledFromSearchHyperparameters
+        ui32 ParallelFoldCount
 
 cdef extern from "catboost/private/libs/options/split_params.h":
     cdef cppclass TTrainTestSplitParams:
@@ -1368,6 +1369,21 @@ cdef extern from "catboost/private/libs/algo/apply.h":
             TVector[TVector[double]]* approx
         ) nogil except +ProcessException
 
+    cdef cppclass TStagedModelCalcerOnPool:
+        TStagedModelCalcerOnPool(
+            const TFullModel& model,
+            TIntrusivePtr[TObjectsDataProvider] objectsData,
+            TLocalExecutor* executor,
+            int treeBegin,
+            int treeEnd,
+            int evalPeriod
+        ) nogil except +ProcessException
+        bool_t Next() nogil except +ProcessException
+        void GetApprox(
+            const EPredictionType predictionType,
+            TVector[TVector[double]]* approx
+        ) nogil except +ProcessException
+
     cdef cppclass TLeafIndexCalcerOnPool:
         TLeafIndexCalcerOnPool(
             const TFullModel& model,
@@ -1390,6 +1406,19 @@ cdef extern from "catboost/private/libs/algo/apply.h":
         int threadCount
     ) nogil except +ProcessException
 
+    cdef void ApplyModelFlat(
+        const TFullModel& model,
+        TConstArrayRef[np.float32_t] features,
+        size_t objectCount,
+        size_t featureCount,
+        bool_t isColumnMajor,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount,
+        TArrayRef[double] results
+    ) nogil except +ProcessException
+
     cdef TVector[ui32] CalcLeafIndexesMulti(
         const TFullModel& model,
         TIntrusivePtr[TObjectsDataProvider] objectsData,
@@ -1657,6 +1686,16 @@ cdef extern from "catboost/private/libs/hyperparameter_tuning/hyperparameter_tun
         void* CustomData
         double (*EvalFunc)(void* customData) with gil
 
+    cdef cppclass TSuccessiveHalvingParams:
+        pass
+
+    cdef TSuccessiveHalvingParams ParseSuccessiveHalvingParams(const TJsonValue& options) nogil except +ProcessException
+
+    cdef cppclass TSuccessiveHalvingRoundResult:
+        ui32 IterationCount
+        TVector[TString] CandidateParams
+        TVector[double] MetricValues
+
     cdef cppclass TBestOptionValuesWithCvResult:
         TVector[TCVResult] CvResult
         THashMap[TString, bool_t] BoolOptions
@@ -1665,6 +1704,7 @@ cdef extern from "catboost/private/libs/hyperparameter_tuning/hyperparameter_tun
         THashMap[TString, double] DoubleOptions
         THashMap[TString, TString] StringOptions
         THashMap[TString, TVector[double]] ListOfDoublesOptions
+        TVector[TSuccessiveHalvingRoundResult] SuccessiveHalvingRounds
 
     cdef void GridSearch(
         const TJsonValue& grid,
@@ -1678,7 +1718,8 @@ cdef extern from "catboost/private/libs/hyperparameter_tuning/hyperparameter_tun
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool_t isSearchUsingCV,
         bool_t isReturnCvResults,
-        int verbose) nogil except +ProcessException
+        int verbose,
+        const TMaybe[TSuccessiveHalvingParams]& successiveHalvingParams) nogil except +ProcessException
 
     cdef void RandomizedSearch(
         ui32 numberOfTries,
@@ -1694,7 +1735,8 @@ cdef extern from "catboost/private/libs/hyperparameter_tuning/hyperparameter_tun
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool_t isSearchUsingCV,
         bool_t isReturnCvResults,
-        int verbose) nogil except +ProcessException
+        int verbose,
+        const TMaybe[TSuccessiveHalvingParams]& successiveHalvingParams) nogil except +ProcessException
 
 
 cpdef run_atexit_finalizers():
@@ -4858,6 +4900,46 @@ cdef class _CatBoost:
 
         return transform_predictions(pred, predictionType, thread_count, self.__model)
 
+    cpdef _base_predict_flat_into(self, np.ndarray features, np.ndarray out, str prediction_type, int ntree_start, int ntree_end, int thread_count):
+        cdef EPredictionType predictionType = string_to_prediction_type(prediction_type)
+        if features.ndim != 2 or features.dtype != np.float32:
+            raise CatBoostError("features must be a two-dimensional numpy.ndarray with dtype float32")
+        cdef bool_t is_column_major
+        if features.flags.c_contiguous:
+            is_column_major = False
+        elif features.flags.f_contiguous:
+            is_column_major = True
+        else:
+            raise CatBoostError("features must be C- or F-contiguous")
+        if out.dtype != np.float64 or not out.flags.c_contiguous or not out.flags.writeable:
+            raise CatBoostError("out must be a writeable C-contiguous numpy.ndarray with dtype float64")
+
+        cdef size_t object_count = features.shape[0]
+        cdef size_t feature_count = features.shape[1]
+        cdef const np.float32_t[:, :] features_view = features
+        cdef np.float64_t[::1] out_view = out.reshape(-1)
+        cdef TConstArrayRef[np.float32_t] features_ref
+        cdef TArrayRef[double] out_ref
+        if object_count * feature_count != 0:
+            features_ref = TConstArrayRef[np.float32_t](&features_view[0, 0], object_count * feature_count)
+        if out.size != 0:
+            out_ref = TArrayRef[double](&out_view[0], <size_t>out.size)
+        thread_count = UpdateThreadCount(thread_count)
+        with nogil:
+            ApplyModelFlat(
+                dereference(self.__model),
+                features_ref,
+                object_count,
+                feature_count,
+                is_column_major,
+                predictionType,
+                ntree_start,
+                ntree_end,
+                thread_count,
+                out_ref
+            )
+        return out
+
     cpdef _staged_predict_iterator(self, _PoolBase pool, str prediction_type, int ntree_start, int ntree_end, int eval_period, int thread_count, verbose):
         thread_count = UpdateThreadCount(thread_count);
         stagedPredictIterator = _StagedPredictIterator(prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
@@ -5180,7 +5262,7 @@ cdef class _CatBoost:
     cpdef _tune_hyperparams(self, list grids_list, _PoolBase train_pool, dict params, int n_iter,
                           int fold_count, int partition_random_seed, bool_t shuffle, bool_t stratified,
                           double train_size, bool_t choose_by_train_test_split, bool_t return_cv_results,
-                          custom_folds, int verbose):
+                          custom_folds, int verbose, successive_halving):
 
         prep_params = _PreprocessParams(params)
         prep_grids = _PreprocessGrids(grids_list)
@@ -5209,6 +5291,12 @@ cdef class _CatBoost:
         ttParams.Stratified = False
         ttParams.TrainPart = train_size
 
+        cdef TMaybe[TSuccessiveHalvingParams] successiveHalvingParams
+        if successive_halving is not None:
+            successiveHalvingParams = ParseSuccessiveHalvingParams(
+                ReadTJsonValue(to_arcadia_string(dumps(successive_halving, cls=_NumpyAwareEncoder)))
+            )
+
         cdef TBestOptionValuesWithCvResult results
         cdef TMetricsAndTimeLeftHistory trainTestResults
         with nogil:
@@ -5227,7 +5315,8 @@ cdef class _CatBoost:
                         &trainTestResults,
                         choose_by_train_test_split,
                         return_cv_results,
-                        verbose
+                        verbose,
+                        successiveHalvingParams
                     )
                 else:
                     RandomizedSearch(
@@ -5244,7 +5333,8 @@ cdef class _CatBoost:
                         &trainTestResults,
                         choose_by_train_test_split,
                         return_cv_results,
-                        verbose
+                        verbose,
+                        successiveHalvingParams
                     )
             finally:
                 ResetPythonInterruptHandler()
@@ -5285,6 +5375,17 @@ cdef class _CatBoost:
         search_result["params"] = best_params
         if return_cv_results:
             search_result["cv_results"] = cv_results
+        if successive_halving is not None:
+            halving_rounds = []
+            for round_idx in xrange(results.SuccessiveHalvingRounds.size()):
+                halving_rounds.append({
+                    "iterations": results.SuccessiveHalvingRounds[round_idx].IterationCount,
+                    "params": [
+                        loads(to_native_str(params)) for params in results.SuccessiveHalvingRounds[round_idx].CandidateParams
+                    ],
+                    "metric_values": list(results.SuccessiveHalvingRounds[round_idx].MetricValues),
+                })
+            search_result["successive_halving_rounds"] = halving_rounds
         return search_result
 
     cpdef _get_binarized_statistics(self, _PoolBase pool, catFeaturesNums, floatFeaturesNums, predictionType, int thread_count):
@@ -5513,7 +5614,7 @@ cdef TCustomTrainTestSubsets _make_train_test_subsets(_PoolBase pool, folds) exc
 
 
 cpdef _cv(dict params, _PoolBase pool, int fold_count, bool_t inverted, int partition_random_seed,
-          bool_t shuffle, bool_t stratified, bool_t as_pandas, folds, type):
+          bool_t shuffle, bool_t stratified, bool_t as_pandas, folds, type, int parallel_fold_count):
     prep_params = _PreprocessParams(params)
     cdef TCrossValidationParams cvParams
     cdef TVector[TCVResult] results
@@ -5522,6 +5623,7 @@ cpdef _cv(dict params, _PoolBase pool, int fold_count, bool_t inverted, int part
     cvParams.PartitionRandSeed = partition_random_seed
     cvParams.Shuffle = shuffle
     cvParams.Stratified = stratified
+    cvParams.ParallelFoldCount = parallel_fold_count
 
     if type == 'Classical':
         cvParams.Type = ECrossValidation_Classical
@@ -5594,12 +5696,11 @@ cdef _convert_to_visible_labels(EPredictionType predictionType, TVector[TVector[
 
 
 cdef class _StagedPredictIterator:
-    cdef TVector[double] __flatApprox
     cdef TVector[TVector[double]] __approx
     cdef TVector[TVector[double]] __pred
     cdef TFullModel* __model
     cdef TLocalExecutor __executor
-    cdef TModelCalcerOnPool* __modelCalcerOnPool
+    cdef TStagedModelCalcerOnPool* __stagedModelCalcer
     cdef EPredictionType predictionType
     cdef int ntree_start, ntree_end, eval_period, thread_count
     cdef bool_t verbose
@@ -5615,38 +5716,26 @@ cdef class _StagedPredictIterator:
 
     cdef _initialize_model_calcer(self, TFullModel* model, _PoolBase pool):
         self.__model = model
-        self.__modelCalcerOnPool = new TModelCalcerOnPool(
+        self.__stagedModelCalcer = new TStagedModelCalcerOnPool(
             dereference(self.__model),
             pool.__pool.Get()[0].ObjectsData,
-            &self.__executor
+            &self.__executor,
+            self.ntree_start,
+            self.ntree_end,
+            self.eval_period
         )
 
     def __dealloc__(self):
-        del self.__modelCalcerOnPool
+        del self.__stagedModelCalcer
 
     def __deepcopy__(self, _):
         raise CatBoostError('Can\'t deepcopy _StagedPredictIterator object')
 
     def __next__(self):
-        if self.ntree_start >= self.ntree_end:
+        if not dereference(self.__stagedModelCalcer).Next():
             raise StopIteration
 
-        dereference(self.__modelCalcerOnPool).ApplyModelMulti(
-            string_to_prediction_type('RawFormulaVal'),
-            self.ntree_start,
-            min(self.ntree_start + self.eval_period, self.ntree_end),
-            &self.__flatApprox,
-            &self.__pred
-        )
-
-        if self.__approx.empty():
-            self.__approx.swap(self.__pred)
-        else:
-            for i in range(self.__approx.size()):
-                for j in range(self.__approx[0].size()):
-                    self.__approx[i][j] += self.__pred[i][j]
-
-        self.ntree_start += self.eval_period
+        dereference(self.__stagedModelCalcer).GetApprox(string_to_prediction_type('RawFormulaVal'), &self.__approx)
         self.__pred = PrepareEvalForInternalApprox(self.predictionType, dereference(self.__model), self.__approx, self.thread_count)
 
         return transform_predictions(self.__pred, self.predictionType, self.thread_count, self.__model)
@@ -1306,6 +1306,9 @@ class _CatBoostBase(object):
     def _base_predict(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose):
         return self._object._base_predict(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def _base_predict_flat_into(self, features, out, prediction_type, ntree_start, ntree_end, thread_count):
+        return self._object._base_predict_flat_into(features, out, prediction_type, ntree_start, ntree_end, thread_count)
+
     def _staged_predict_iterator(self, pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         return self._object._staged_predict_iterator(pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
 
@@ -1998,6 +2001,56 @@ class CatBoost(_CatBoostBase):
         """
         return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, 'predict')
 
+    def predict_into(self, data, out, prediction_type='RawFormulaVal', ntree_start=0, ntree_end=0, thread_count=-1):
+        """
+        Predict with dense float features directly into a preallocated array.
+        Features are read in place and the GIL is released for the whole evaluation, so this method
+        can be used from several Python threads concurrently.
+        Only models without categorical and text features are supported.
+
+        Parameters
+        ----------
+        data : numpy.ndarray
+            Two-dimensional C- or F-contiguous array with dtype float32 and shape (number_of_objects x number_of_features).
+
+        out : numpy.ndarray
+            C-contiguous writeable array with dtype float64 for predictions. Its size must be
+            number_of_objects x 2 for 'Probability' of a binary classification model,
+            number_of_objects x number_of_classes for multiclassification models and
+            number_of_objects x number_of_model_dimensions otherwise.
+
+        prediction_type : string, optional (default='RawFormulaVal')
+            Can be:
+            - 'RawFormulaVal' : return raw value.
+            - 'Exponent' : return exponent of raw value (single-dimensional models only).
+            - 'Probability' : return probability for every class.
+            Predictions are the same as the ones returned by predict().
+
+        ntree_start: int, optional (default=0)
+            Model is applied on the interval [ntree_start, ntree_end) (zero-based indexing).
+
+        ntree_end: int, optional (default=0)
+            Model is applied on the interval [ntree_start, ntree_end) (zero-based indexing).
+            If value equals to 0 this parameter is ignored and ntree_end equal to tree_count_.
+
+        thread_count : int (default=-1)
+            The number of threads to use when applying the model.
+            If -1, then the number of threads is set to the number of CPU cores.
+
+        Returns
+        -------
+        out : numpy.ndarray
+            The same array that was passed in out.
+        """
+        if not self.is_fitted() or self.tree_count_ is None:
+            raise CatBoostError("There is no trained model to use predict_into(). "
+                                "Use fit() to train model. Then use this method.")
+        if not isinstance(data, np.ndarray) or not isinstance(out, np.ndarray):
+            raise CatBoostError("predict_into() expects numpy.ndarray data and out")
+        if prediction_type not in ('RawFormulaVal', 'Exponent', 'Probability'):
+            raise CatBoostError("Invalid value of prediction_type={}: must be RawFormulaVal, Exponent or Probability.".format(prediction_type))
+        return self._base_predict_flat_into(data, out, prediction_type, ntree_start, ntree_end, thread_count)
+
     def _staged_predict(self, data, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose, parent_method_name):
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
@@ -2526,6 +2579,9 @@ class CatBoost(_CatBoostBase):
                 - TopKLeaves (It is posible to set top size : TopKLeaves:top=2)
                 - AllPoints
             Description of the update set methods are given in section 3.1.3 of the paper.
+            Any method may be followed by top_trees=N (e.g. SinglePoint:top_trees=50 or TopKLeaves:top=2;top_trees=50)
+            to make each train object affect only the N trees its leaves depend on most.
+            This approximation is faster for models with many trees.
 
         thread_count : int, optional (default=-1)
             Number of threads.
@@ -3235,7 +3291,8 @@ class CatBoost(_CatBoostBase):
 
     def _tune_hyperparams(self, param_grid, X, y=None, cv=3, n_iter=10, partition_random_seed=0,
                           calc_cv_statistics=True, search_by_train_test_split=True,
-                          refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=1, plot=False):
+                          refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=1, plot=False,
+                          successive_halving=None):
 
         currently_not_supported_params = {
             'ignored_features',
@@ -3297,7 +3354,7 @@ class CatBoost(_CatBoostBase):
             cv_result = self._object._tune_hyperparams(
                 param_grid, train_params["train_pool"], params, n_iter,
                 fold_count, partition_random_seed, shuffle, stratified, train_size,
-                search_by_train_test_split, calc_cv_statistics, custom_folds, verbose
+                search_by_train_test_split, calc_cv_statistics, custom_folds, verbose, successive_halving
             )
 
         if refit:
@@ -3309,7 +3366,8 @@ class CatBoost(_CatBoostBase):
 
     def grid_search(self, param_grid, X, y=None, cv=3, partition_random_seed=0,
                     calc_cv_statistics=True, search_by_train_test_split=True,
-                    refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False):
+                    refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False,
+                    successive_halving=None):
         """
         Exhaustive search over specified parameter values for a model.
         Aafter calling this method model is fitted and can be used, if not specified otherwise (refit=False).
@@ -3376,12 +3434,29 @@ class CatBoost(_CatBoostBase):
 
         plot : bool, optional (default=False)
             If True, draw train and eval error for every set of parameters in Jupyter notebook
+
+        successive_halving : dict or None, optional (default=None)
+            If set, parameters are searched with successive halving: all candidates are trained with
+            a small number of iterations, the best 1 / reduction_factor of them are trained with
+            reduction_factor times more iterations and so on.
+            Possible keys:
+            - 'reduction_factor': float > 1, default 3
+            - 'min_iterations': int, number of iterations of the first round, round k uses
+                min_iterations * reduction_factor^k iterations capped by the number of iterations.
+                If not set, it is derived from the number of iterations and candidates so that
+                the last round uses all iterations
+            - 'parallel_candidates': int, default 1, number of candidates trained concurrently,
+                threads are split evenly between them
+            Candidates are trained silently and without writing files, 'iterations' can't be searched over.
         Returns
         -------
         dict with two fields:
             'params': dict of best found parameters
             'cv_results': dict or pandas.core.frame.DataFrame with cross-validation results
                 columns are: test-error-mean  test-error-std  train-error-mean  train-error-std
+            and, if successive_halving is set,
+            'successive_halving_rounds': list of dicts with fields 'iterations', 'params' and
+                'metric_values' for each round, candidates are sorted from the best one
         """
         if isinstance(param_grid, Mapping):
             param_grid = [param_grid]
@@ -3396,12 +3471,14 @@ class CatBoost(_CatBoostBase):
             param_grid=param_grid, X=X, y=y, cv=cv, n_iter=-1,
             partition_random_seed=partition_random_seed, calc_cv_statistics=calc_cv_statistics,
             search_by_train_test_split=search_by_train_test_split, refit=refit, shuffle=shuffle,
-            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot
+            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot,
+            successive_halving=successive_halving
         )
 
     def randomized_search(self, param_distributions, X, y=None, cv=3, n_iter=10, partition_random_seed=0,
                           calc_cv_statistics=True, search_by_train_test_split=True, refit=True,
-                          shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False):
+                          shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False,
+                          successive_halving=None):
         """
         Randomized search on hyper parameters.
         After calling this method model is fitted and can be used, if not specified otherwise (refit=False).
@@ -3475,12 +3552,29 @@ class CatBoost(_CatBoostBase):
 
         plot : bool, optional (default=False)
             If True, draw train and eval error for every set of parameters in Jupyter notebook
+
+        successive_halving : dict or None, optional (default=None)
+            If set, parameters are searched with successive halving: all candidates are trained with
+            a small number of iterations, the best 1 / reduction_factor of them are trained with
+            reduction_factor times more iterations and so on.
+            Possible keys:
+            - 'reduction_factor': float > 1, default 3
+            - 'min_iterations': int, number of iterations of the first round, round k uses
+                min_iterations * reduction_factor^k iterations capped by the number of iterations.
+                If not set, it is derived from the number of iterations and candidates so that
+                the last round uses all iterations
+            - 'parallel_candidates': int, default 1, number of candidates trained concurrently,
+                threads are split evenly between them
+            Candidates are trained silently and without writing files, 'iterations' can't be searched over.
         Returns
         -------
         dict with two fields:
             'params': dict of best found parameters
             'cv_results': dict or pandas.core.frame.DataFrame with cross-validation results
                 columns are: test-error-mean  test-error-std  train-error-mean  train-error-std
+            and, if successive_halving is set,
+            'successive_halving_rounds': list of dicts with fields 'iterations', 'params' and
+                'metric_values' for each round, candidates are sorted from the best one
         """
         if n_iter <= 0:
             assert CatBoostError("n_iter should be a positive number")
@@ -3494,7 +3588,8 @@ class CatBoost(_CatBoostBase):
             param_grid=param_distributions, X=X, y=y, cv=cv, n_iter=n_iter,
             partition_random_seed=partition_random_seed, calc_cv_statistics=calc_cv_statistics,
             search_by_train_test_split=search_by_train_test_split, refit=refit, shuffle=shuffle,
-            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot
+            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot,
+            successive_halving=successive_halving
         )
 
     def _convert_to_asymmetric_representation(self):
@@ -4975,7 +5070,8 @@ def cv(pool=None, params=None, dtrain=None, iterations=None, num_boost_round=Non
        fold_count=None, nfold=None, inverted=False, partition_random_seed=0, seed=None,
        shuffle=True, logging_level=None, stratified=None, as_pandas=True, metric_period=None,
        verbose=None, verbose_eval=None, plot=False, early_stopping_rounds=None,
-       save_snapshot=None, snapshot_file=None, snapshot_interval=None, folds=None, type='Classical'):
+       save_snapshot=None, snapshot_file=None, snapshot_interval=None, folds=None, type='Classical',
+       parallel_fold_count=1):
     """
     Cross-validate the CatBoost model.
 
@@ -5077,6 +5173,13 @@ def cv(pool=None, params=None, dtrain=None, iterations=None, num_boost_round=Non
         and have ``split`` method.
         if folds is not None, then all of fold_count, shuffle, partition_random_seed, inverted are None
 
+    parallel_fold_count : int, optional (default=1)
+        If greater than 1, folds are trained independently by this number of concurrent tasks that share
+        the threads (instead of advancing all folds together by batches of iterations), and the learning
+        state of each fold is released as soon as it is trained, which reduces peak memory usage.
+        Results are the same as with the default value.
+        Supported only on CPU and without overfitting detector (od_type, early_stopping_rounds).
+
     Returns
     -------
     cv results : pandas.core.frame.DataFrame with cross-validation results
@@ -5185,7 +5288,7 @@ def cv(pool=None, params=None, dtrain=None, iterations=None, num_boost_round=Non
 
     with log_fixup(), plot_wrapper(plot, [_get_train_dir(params)]):
         return _cv(params, pool, fold_count, inverted, partition_random_seed, shuffle, stratified,
-                   as_pandas, folds, type)
+                   as_pandas, folds, type, parallel_fold_count)
 
 
 class BatchMetricCalcer(_MetricCalcerBase):
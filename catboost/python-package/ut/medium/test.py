@@ -1149,6 +1149,45 @@ def test_raw_predict_equals_to_model_predict(task_type):
     assert np.all(np.isclose(model.get_test_eval(), pred, rtol=1.e-6))
 
 
+@pytest.mark.parametrize('loss_function', ['Logloss', 'MultiClass', 'MultiClassOneVsAll'])
+def test_predict_into_equals_to_predict(loss_function):
+    np.random.seed(0)
+    features = np.random.random((500, 10)).astype(np.float32)
+    labels = np.random.randint(0, 2 if loss_function == 'Logloss' else 3, size=500)
+    model = CatBoostClassifier(iterations=20, loss_function=loss_function, thread_count=2)
+    model.fit(features, labels)
+
+    for prediction_type in ['RawFormulaVal', 'Probability']:
+        expected = model.predict(features, prediction_type=prediction_type)
+        for order in ['C', 'F']:
+            out = np.empty(expected.shape, dtype=np.float64)
+            result = model.predict_into(np.asarray(features, order=order), out, prediction_type=prediction_type, thread_count=3)
+            assert result is out
+            assert np.allclose(out, expected, rtol=1.e-9, atol=1.e-12)
+
+    with pytest.raises(CatBoostError):
+        model.predict_into(features.astype(np.float64), np.empty(expected.shape, dtype=np.float64))
+    with pytest.raises(CatBoostError):
+        model.predict_into(features, np.empty(features.shape[0], dtype=np.float64), prediction_type='Probability')
+
+
+def test_predict_into_multi_dimensional_exponent():
+    np.random.seed(0)
+    features = np.random.random((500, 10)).astype(np.float32)
+    labels = np.random.random((500, 2))
+    model = CatBoostRegressor(iterations=20, loss_function='MultiRMSE', thread_count=2)
+    model.fit(features, labels)
+
+    expected = model.predict(features, prediction_type='RawFormulaVal')
+    out = np.empty(expected.shape, dtype=np.float64)
+    model.predict_into(features, out, prediction_type='RawFormulaVal')
+    assert np.allclose(out, expected, rtol=1.e-9, atol=1.e-12)
+
+    # Exponent of multi-dimensional models is rejected instead of returning class indices or raw values
+    with pytest.raises(CatBoostError):
+        model.predict_into(features, out, prediction_type='Exponent')
+
+
 @pytest.mark.parametrize('problem', ['Classifier', 'Regressor'])
 def test_predict_and_predict_proba_on_single_object(problem):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
@@ -1667,6 +1706,30 @@ def test_multiclass(task_type):
     return local_canonical_file(preds_path)
 
 
+@pytest.mark.parametrize('loss_function', ['MultiClass', 'MultiRMSE'])
+def test_multi_dimensional_leaves_do_not_depend_on_thread_count(loss_function):
+    prng = np.random.RandomState(seed=0)
+    object_count = 5000
+    features = prng.random_sample((object_count, 10))
+    if loss_function == 'MultiClass':
+        labels = prng.randint(0, 4, size=object_count)
+    else:
+        labels = prng.random_sample((object_count, 3))
+    pool = Pool(features, labels)
+
+    approxes = []
+    for thread_count in [1, 4]:
+        model = CatBoost({
+            'iterations': 10,
+            'loss_function': loss_function,
+            'thread_count': thread_count,
+            'random_seed': 0
+        })
+        model.fit(pool)
+        approxes.append(model.predict(pool, prediction_type='RawFormulaVal'))
+    assert np.array_equal(approxes[0], approxes[1])
+
+
 @pytest.mark.parametrize('missed_classes', [False, True], ids=['missed_classes=False', 'missed_classes=True'])
 def test_multiclass_classes_count(task_type, missed_classes):
     object_count = 100
@@ -2787,6 +2850,24 @@ def test_cv_overfitting_detector(with_metric_period, task_type):
     return local_canonical_file(remove_time_from_json(JSON_LOG_PATH))
 
 
+@pytest.mark.parametrize('metric_period', [1, 5])
+def test_cv_parallel_folds(metric_period):
+    pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    params = {
+        "iterations": 20,
+        "learning_rate": 0.03,
+        "loss_function": "Logloss",
+        "eval_metric": "AUC",
+        "thread_count": 4,
+    }
+    sequential_results = cv(pool, params, fold_count=4, metric_period=metric_period)
+    parallel_results = cv(pool, params, fold_count=4, metric_period=metric_period, parallel_fold_count=3)
+    assert sequential_results.equals(parallel_results)
+
+    with pytest.raises(CatBoostError):
+        cv(pool, params, fold_count=4, parallel_fold_count=3, early_stopping_rounds=7)
+
+
 @pytest.mark.parametrize('param_type', ['indices', 'strings'])
 def test_cv_with_cat_features_param(param_type):
     if param_type == 'indices':
@@ -3147,6 +3228,76 @@ def test_randomized_search_cv(task_type):
     assert results['params']['iterations'] in [1, 2, 3]
 
 
+@pytest.mark.parametrize('search_by_train_test_split', [True, False])
+def test_grid_search_successive_halving(search_by_train_test_split):
+    pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    learning_rates = [0.0001, 0.001, 0.1, 0.3]
+
+    def search(parallel_candidates):
+        model = CatBoost({'iterations': 20, 'loss_function': 'Logloss', 'thread_count': 4})
+        return model.grid_search(
+            {'learning_rate': learning_rates},
+            pool,
+            search_by_train_test_split=search_by_train_test_split,
+            refit=False,
+            verbose=False,
+            successive_halving={'reduction_factor': 2, 'parallel_candidates': parallel_candidates}
+        )
+
+    results = search(parallel_candidates=1)
+    rounds = results['successive_halving_rounds']
+    assert [halving_round['iterations'] for halving_round in rounds] == [5, 10, 20]
+    assert [len(halving_round['params']) for halving_round in rounds] == [4, 2, 1]
+    assert sorted(params['learning_rate'] for params in rounds[0]['params']) == learning_rates
+    for halving_round, next_round in zip(rounds, rounds[1:]):
+        survivors_count = len(next_round['params'])
+        by_learning_rate = lambda params: params['learning_rate']
+        assert sorted(halving_round['params'][:survivors_count], key=by_learning_rate) == sorted(next_round['params'], key=by_learning_rate)
+    for halving_round in rounds:
+        assert halving_round['metric_values'] == sorted(halving_round['metric_values'])
+
+    # with a few iterations the smallest learning rate is the worst
+    assert rounds[0]['params'][-1] == {'learning_rate': 0.0001}
+    assert results['params'] == rounds[-1]['params'][0]
+    assert results['params']['learning_rate'] in [0.1, 0.3]
+
+    # candidates trained concurrently on the shared data give the same results
+    parallel_rounds = search(parallel_candidates=3)['successive_halving_rounds']
+    assert [halving_round['params'] for halving_round in parallel_rounds] == [halving_round['params'] for halving_round in rounds]
+    for halving_round, parallel_round in zip(rounds, parallel_rounds):
+        assert np.allclose(halving_round['metric_values'], parallel_round['metric_values'], rtol=1e-6)
+
+
+def test_grid_search_successive_halving_min_iterations():
+    pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+
+    def get_round_iterations(min_iterations):
+        model = CatBoost({'iterations': 20, 'loss_function': 'Logloss', 'thread_count': 4})
+        results = model.grid_search(
+            {'learning_rate': [0.001, 0.01, 0.1, 0.3]},
+            pool,
+            refit=False,
+            verbose=False,
+            successive_halving={'reduction_factor': 2, 'min_iterations': min_iterations}
+        )
+        return [halving_round['iterations'] for halving_round in results['successive_halving_rounds']]
+
+    # budgets grow from min_iterations by reduction_factor and are capped by iterations
+    assert get_round_iterations(3) == [3, 6, 12]
+    assert get_round_iterations(8) == [8, 16, 20]
+
+
+def test_grid_search_successive_halving_wrong_params():
+    pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    model = CatBoost({'loss_function': 'Logloss'})
+    with pytest.raises(CatBoostError):
+        model.grid_search({'iterations': [5, 10]}, pool, verbose=False, successive_halving={})
+    with pytest.raises(CatBoostError):
+        model.grid_search({'depth': [4, 6]}, pool, verbose=False, successive_halving={'reduction_factor': 1})
+    with pytest.raises(CatBoostError):
+        model.grid_search({'depth': [4, 6]}, pool, verbose=False, successive_halving={'parallel': 2})
+
+
 def test_grid_search_with_class_weights_lists():
     pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     model = CatBoostClassifier(iterations=10)
@@ -3515,6 +3666,24 @@ def test_shap_feature_importance_asymmetric_and_symmetric(task_type):
     assert np.all(shap_symm - shap_asymm < 1e-8)
 
 
+@pytest.mark.parametrize('with_groups', [False, True], ids=['without_groups', 'with_groups'])
+def test_loss_function_change_symmetric_by_feature_trees(with_groups):
+    # symmetric trees subtract contributions of the trees of each feature,
+    # asymmetric representation of the same trees uses per-document SHAP values
+    if with_groups:
+        pool = Pool(QUERYWISE_TRAIN_FILE, column_description=QUERYWISE_CD_FILE)
+        model = CatBoost({'iterations': 20, 'depth': 4, 'learning_rate': 0.1, 'loss_function': 'QueryRMSE'})
+    else:
+        pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+        model = CatBoostClassifier(iterations=20, depth=4, learning_rate=0.1, max_ctr_complexity=1)
+    model.fit(pool)
+    loss_change_symm = np.array(model.get_feature_importance(type=EFstrType.LossFunctionChange, data=pool))
+    model._convert_to_asymmetric_representation()
+    loss_change_asymm = np.array(model.get_feature_importance(type=EFstrType.LossFunctionChange, data=pool))
+    assert np.any(loss_change_symm != 0)
+    assert np.allclose(loss_change_symm, loss_change_asymm, rtol=1e-6, atol=1e-9)
+
+
 def test_approximate_shap_feature_importance_asymmetric_and_symmetric(task_type):
     pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     model = CatBoostClassifier(
@@ -3909,6 +4078,30 @@ def test_object_importances(task_type):
     return local_canonical_file(oimp_path)
 
 
+def test_object_importances_top_trees():
+    train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    pool = Pool(TEST_FILE, column_description=CD_FILE)
+
+    model = CatBoost({'loss_function': 'RMSE', 'iterations': 10})
+    model.fit(train_pool)
+    indices, scores = model.get_object_importance(pool, train_pool, top_size=10, type='Average')
+    # using all trees does not change importances
+    all_trees_indices, all_trees_scores = model.get_object_importance(
+        pool, train_pool, top_size=10, type='Average', update_method='SinglePoint:top_trees=10'
+    )
+    assert np.array_equal(indices, all_trees_indices)
+    assert np.array_equal(scores, all_trees_scores)
+
+    _, top_trees_scores = model.get_object_importance(
+        pool, train_pool, top_size=10, type='Average', update_method='TopKLeaves:top=2;top_trees=3'
+    )
+    assert len(top_trees_scores) == 10
+    assert np.all(np.isfinite(top_trees_scores))
+
+    with pytest.raises(CatBoostError):
+        model.get_object_importance(pool, train_pool, update_method='SinglePoint:top_trees=0')
+
+
 def test_shap(task_type):
     train_pool = Pool([[0, 0], [0, 1], [1, 0], [1, 1]], [0, 1, 5, 8], cat_features=[])
     test_pool = Pool([[0, 0], [0, 1], [1, 0], [1, 1]])
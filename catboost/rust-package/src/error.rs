@@ -19,6 +19,13 @@ impl CatBoostError {
         }
     }
 
+    /// Create an error for invalid arguments detected before calling CatBoost.
+    pub(crate) fn new<S: Into<String>>(description: S) -> Self {
+        CatBoostError {
+            description: description.into(),
+        }
+    }
+
     /// Fetch current error message from CatBoost.
     fn fetch_catboost_error() -> Self {
         let c_str = unsafe { CStr::from_ptr(catboost_sys::GetErrorString()) };
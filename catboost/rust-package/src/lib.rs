@@ -10,4 +10,4 @@ mod error;
 pub use crate::error::{CatBoostError, CatBoostResult};
 
 mod model;
-pub use crate::model::Model;
+pub use crate::model::{hash_cat_features, Model};
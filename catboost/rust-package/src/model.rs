@@ -73,6 +73,55 @@ impl Model {
         Ok(prediction)
     }
 
+    /// Calculate raw model predictions on a contiguous row-major matrix of float features and a contiguous
+    /// row-major matrix of hashed categorical features (see `hash_cat_features`).
+    ///
+    /// Row `i` of float features is `float_features[i * float_features_stride..][..float_features_count]`,
+    /// the same layout is used for categorical features. Predictions are written to `prediction`, which
+    /// should hold exactly `doc_count * get_dimensions_count()` values.
+    /// No data is copied and nothing is allocated per object.
+    #[allow(clippy::too_many_arguments)]
+    pub fn calc_model_prediction_strided(
+        &self,
+        doc_count: usize,
+        float_features: &[f32],
+        float_features_count: usize,
+        float_features_stride: usize,
+        hashed_cat_features: &[i32],
+        cat_features_count: usize,
+        cat_features_stride: usize,
+        prediction: &mut [f64],
+    ) -> CatBoostResult<()> {
+        check_matrix_size(
+            "float features",
+            float_features.len(),
+            doc_count,
+            float_features_count,
+            float_features_stride,
+        )?;
+        check_matrix_size(
+            "cat features",
+            hashed_cat_features.len(),
+            doc_count,
+            cat_features_count,
+            cat_features_stride,
+        )?;
+        CatBoostError::check_return_value(unsafe {
+            catboost_sys::CalcModelPredictionWithHashedCatFeaturesStrided(
+                self.handle,
+                doc_count,
+                float_features.as_ptr(),
+                float_features_count,
+                float_features_stride,
+                hashed_cat_features.as_ptr(),
+                cat_features_count,
+                cat_features_stride,
+                prediction.as_mut_ptr(),
+                prediction.len(),
+            )
+        })
+    }
+
     /// Get expected float feature count for model
     pub fn get_float_features_count(&self) -> usize {
         unsafe { catboost_sys::GetFloatFeaturesCount(self.handle) }
@@ -94,6 +143,65 @@ impl Model {
     }
 }
 
+/// Calculate hashes of categorical feature values with a single FFI call.
+///
+/// `hashes` should have the same length as `cat_features`.
+pub fn hash_cat_features<S: AsRef<str>>(
+    cat_features: &[S],
+    hashes: &mut [i32],
+) -> CatBoostResult<()> {
+    if cat_features.len() != hashes.len() {
+        return Err(CatBoostError::new(format!(
+            "hashes size {} is not equal to cat features count {}",
+            hashes.len(),
+            cat_features.len()
+        )));
+    }
+    let data = cat_features
+        .iter()
+        .map(|x| x.as_ref().as_ptr() as *const std::os::raw::c_char)
+        .collect::<Vec<_>>();
+    let sizes = cat_features
+        .iter()
+        .map(|x| x.as_ref().len())
+        .collect::<Vec<_>>();
+    unsafe {
+        catboost_sys::GetStringCatFeatureHashes(
+            data.as_ptr() as *mut *const std::os::raw::c_char,
+            sizes.as_ptr(),
+            cat_features.len(),
+            hashes.as_mut_ptr(),
+        )
+    };
+    Ok(())
+}
+
+fn check_matrix_size(
+    name: &str,
+    size: usize,
+    row_count: usize,
+    column_count: usize,
+    row_stride: usize,
+) -> CatBoostResult<()> {
+    if row_stride < column_count {
+        return Err(CatBoostError::new(format!(
+            "{} row stride {} is less than column count {}",
+            name, row_stride, column_count
+        )));
+    }
+    if row_count == 0 || column_count == 0 {
+        return Ok(());
+    }
+    let required_size = (row_count - 1) * row_stride + column_count;
+    if size < required_size {
+        return Err(CatBoostError::new(format!(
+            "{} size {} is less than required {}",
+            name, size, required_size
+        )));
+    }
+    Ok(())
+}
+
 impl Drop for Model {
     fn drop(&mut self) {
         unsafe { catboost_sys::ModelCalcerDelete(self.handle) };
@@ -133,6 +241,47 @@ mod tests {
         assert_eq!(prediction[2], -0.0013677527881450977);
     }
 
+    #[test]
+    fn calc_prediction_strided() {
+        let model = Model::load("tmp/model.bin").unwrap();
+
+        // rows of float features are padded to check that stride is respected
+        let float_features = [
+            -10.0, 5.0, 753.0, 0.0, //
+            30.0, 1.0, 760.0, 0.0, //
+            40.0, 0.1, 705.0, 0.0,
+        ];
+        let mut hashed_cat_features = [0; 3];
+        hash_cat_features(&["north", "south", "south"], &mut hashed_cat_features).unwrap();
+
+        let mut prediction = [0.0; 3];
+        model
+            .calc_model_prediction_strided(
+                3,
+                &float_features,
+                3,
+                4,
+                &hashed_cat_features,
+                1,
+                1,
+                &mut prediction,
+            )
+            .unwrap();
+
+        assert_eq!(prediction[0], 0.9980003729960197);
+        assert_eq!(prediction[1], 0.00249414628534181);
+        assert_eq!(prediction[2], -0.0013677527881450977);
+    }
+
+    #[test]
+    fn calc_prediction_strided_insufficient_size() {
+        let model = Model::load("tmp/model.bin").unwrap();
+        let mut prediction = [0.0; 2];
+        let result =
+            model.calc_model_prediction_strided(2, &[0.0; 5], 3, 3, &[0; 2], 1, 1, &mut prediction);
+        assert!(result.is_err());
+    }
+
     #[test]
     fn get_model_stats() {
         let model = Model::load("tmp/model.bin").unwrap();
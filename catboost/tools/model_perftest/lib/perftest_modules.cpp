@@ -68,6 +68,37 @@ public:
 
 TPerftestModuleFactory::TRegistrator<TCPUCatboostAsymmetryModule> CPUCatboostAsymmetryModuleRegistar("CPUCatboostAsymmetry");
 
+class TCPUCatboostMergedTreesModule : public TBaseCatboostModule {
+public:
+    TCPUCatboostMergedTreesModule(const TFullModel& model) {
+        CB_ENSURE(model.IsOblivious(), "only oblivious trees can be merged");
+        TFullModel mergedModel = model;
+        mergedModel.ModelTrees.GetMutable()->MergeAndReorderObliviousTrees();
+        mergedModel.UpdateDynamicData();
+        ModelEvaluator = NCB::NModelEvaluation::CreateEvaluator(EFormulaEvaluatorType::CPU, mergedModel);
+        BaseName = "catboost cpu merged trees";
+    }
+};
+
+TPerftestModuleFactory::TRegistrator<TCPUCatboostMergedTreesModule> CPUCatboostMergedTreesModuleRegistar("CPUCatboostMergedTrees");
+
+template <NCB::NModelEvaluation::ELeafValuesPrecision Precision>
+class TCPUCatboostCompactLeafValuesModule : public TBaseCatboostModule {
+public:
+    TCPUCatboostCompactLeafValuesModule(const TFullModel& model) {
+        ModelEvaluator = NCB::NModelEvaluation::CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        ModelEvaluator->SetProperty("LeafValuesPrecision", ToString(Precision));
+        BaseName = "catboost cpu " + ToString(Precision) + " leaf values";
+    }
+};
+
+TPerftestModuleFactory::TRegistrator<TCPUCatboostCompactLeafValuesModule<NCB::NModelEvaluation::ELeafValuesPrecision::Float>>
+    CPUCatboostFloatLeafValuesModuleRegistar("CPUCatboostFloatLeafValues");
+TPerftestModuleFactory::TRegistrator<TCPUCatboostCompactLeafValuesModule<NCB::NModelEvaluation::ELeafValuesPrecision::UI16>>
+    CPUCatboostUI16LeafValuesModuleRegistar("CPUCatboostUI16LeafValues");
+TPerftestModuleFactory::TRegistrator<TCPUCatboostCompactLeafValuesModule<NCB::NModelEvaluation::ELeafValuesPrecision::UI8>>
+    CPUCatboostUI8LeafValuesModuleRegistar("CPUCatboostUI8LeafValues");
+
 class TGPUCatboostModule : public TBaseCatboostModule {
 public:
     TGPUCatboostModule(const TFullModel& model) {